@@ -101,6 +101,13 @@ typedef struct lookup_cache_context_s {
    int thecachecount;
    int currentpos;
    lookup_cache cache[SUBTREE_MAX_CACHE_SIZE];
+   /* sorted copy of the top level subtree list, see lookup_index_find() */
+   netsnmp_subtree **index;
+   size_t index_len;
+   size_t index_size;
+   u_int index_generation;
+   /* bumped by invalidate_lookup_cache(); zero is reserved for "no index" */
+   u_int generation;
 } lookup_cache_context;
 
 static lookup_cache_context *thecontextcache = NULL;
@@ -114,6 +121,13 @@ static lookup_cache_context *thecontextcache = NULL;
  * Bigger does NOT necessarily mean better.  Certainly 16 should be an
  * upper limit.  32 is the hard coded limit.
  *
+ * While caching is enabled, lookups use a sorted index of the
+ * registered subtrees (binary search) and only fall back to the cache
+ * and a walk of the subtree list if the index cannot be allocated.
+ * Registrations and unregistrations insert or remove their entries in
+ * the index of their context; it is only rebuilt on the next lookup when
+ * it has to grow or the subtree list changed in a way it cannot follow.
+ *
  * @param newsize set to the maximum size of a cache for a given
  * context.  Set to 0 to completely disable caching, or to -1 to set
  * to the default cache size (8), or to a number of your chosing.  The
@@ -159,6 +173,7 @@ get_context_lookup_cache(const char *context) {
             ptr = SNMP_MALLOC_TYPEDEF(lookup_cache_context);
             ptr->next = thecontextcache;
             ptr->context = strdup(context);
+            ptr->generation = 1;
             thecontextcache = ptr;
         } else {
             return NULL;
@@ -252,7 +267,181 @@ lookup_cache_find(const char *context, const oid *name, size_t name_len,
 }
 
 /** @private
- *  Clears cache count and position in Lookup Cache.
+ *  (Re)builds the lookup index of a context: an array holding the top
+ *  level subtrees in list order, i.e. sorted by their start OID.
+ *
+ *  @param cptr Lookup cache of the context.
+ *
+ *  @return 0 on success, -1 if no memory could be allocated.
+ */
+static int
+lookup_index_build(lookup_cache_context *cptr) {
+    netsnmp_subtree *s, *first;
+    size_t n = 0;
+
+    first = netsnmp_subtree_find_first(cptr->context);
+    for (s = first; s; s = s->next)
+        n++;
+
+    if (n > cptr->index_size) {
+        netsnmp_subtree **tmp;
+        size_t size = n + n / 2 + 16;   /* room for later registrations */
+        tmp = (netsnmp_subtree **)realloc(cptr->index, size * sizeof(*tmp));
+        if (tmp == NULL) {
+            cptr->index_generation = 0;
+            return -1;
+        }
+        cptr->index = tmp;
+        cptr->index_size = size;
+    }
+
+    n = 0;
+    for (s = first; s; s = s->next)
+        cptr->index[n++] = s;
+    cptr->index_len = n;
+    cptr->index_generation = cptr->generation;
+
+    DEBUGMSGTL(("subtree", "rebuilt lookup index for context \"%s\": %lu "
+                "entries\n", cptr->context, (unsigned long)n));
+    return 0;
+}
+
+/** @private
+ *  Returns the position of the first index entry whose start OID is
+ *  greater than the given OID.
+ */
+NETSNMP_STATIC_INLINE size_t
+lookup_index_upper(const lookup_cache_context *cptr, const oid *name,
+                   size_t name_len) {
+    size_t lo = 0, hi = cptr->index_len, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (snmp_oid_compare(name, name_len, cptr->index[mid]->start_a,
+                             cptr->index[mid]->start_len) < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+/** @private
+ *  Finds the last top level subtree whose start OID is not greater than
+ *  the given OID, using a binary search over the lookup index.  The
+ *  index is rebuilt first if the subtree list changed since it was built.
+ *
+ *  @param context  Case sensitive name of the context.
+ *
+ *  @param name     The OID we're searching for.
+ *
+ *  @param name_len Number of sub-ids (single integers) in the OID.
+ *
+ *  @param found    Set to the subtree found (may be NULL).
+ *
+ *  @return 0 if the index was used, -1 if the caller has to walk the list.
+ */
+NETSNMP_STATIC_INLINE int
+lookup_index_find(const char *context, const oid *name, size_t name_len,
+                  netsnmp_subtree **found) {
+    lookup_cache_context *cptr;
+    size_t pos;
+
+    if ((cptr = get_context_lookup_cache(context)) == NULL)
+        return -1;
+    if (cptr->index_generation != cptr->generation &&
+        lookup_index_build(cptr) != 0)
+        return -1;
+
+    pos = lookup_index_upper(cptr, name, name_len);
+    *found = pos ? cptr->index[pos - 1] : NULL;
+    return 0;
+}
+
+/** @private
+ *  Returns the lookup cache of a context if its index is up to date,
+ *  NULL if there is nothing to keep in step.
+ */
+NETSNMP_STATIC_INLINE lookup_cache_context *
+lookup_index_current(const char *context) {
+    lookup_cache_context *cptr = get_context_lookup_cache(context);
+
+    if (cptr == NULL || cptr->index_generation != cptr->generation)
+        return NULL;
+    return cptr;
+}
+
+/** @private
+ *  Adds a subtree that has just been linked into the top level list
+ *  to the lookup index.  The index is marked out of date instead if it
+ *  is full or the subtree does not follow its list predecessor in it.
+ */
+static void
+lookup_index_insert(const char *context, netsnmp_subtree *sub) {
+    lookup_cache_context *cptr;
+    size_t pos;
+
+    if ((cptr = lookup_index_current(context)) == NULL)
+        return;
+
+    pos = lookup_index_upper(cptr, sub->start_a, sub->start_len);
+    if (cptr->index_len == cptr->index_size ||
+        pos == 0 || cptr->index[pos - 1] != sub->prev) {
+        cptr->index_generation = 0;
+        return;
+    }
+    memmove(&cptr->index[pos + 1], &cptr->index[pos],
+            (cptr->index_len - pos) * sizeof(*cptr->index));
+    cptr->index[pos] = sub;
+    cptr->index_len++;
+}
+
+/** @private
+ *  Replaces a top level subtree in the lookup index by another one with
+ *  the same start OID, or removes it if new_sub is NULL.  The index is
+ *  marked out of date instead if the old subtree is not found in it.
+ */
+static void
+lookup_index_replace(const char *context, netsnmp_subtree *old_sub,
+                     netsnmp_subtree *new_sub) {
+    lookup_cache_context *cptr;
+    size_t pos;
+
+    if ((cptr = lookup_index_current(context)) == NULL)
+        return;
+
+    pos = lookup_index_upper(cptr, old_sub->start_a, old_sub->start_len);
+    if (pos == 0 || cptr->index[pos - 1] != old_sub) {
+        cptr->index_generation = 0;
+        return;
+    }
+    pos--;
+    if (new_sub) {
+        cptr->index[pos] = new_sub;
+        return;
+    }
+    memmove(&cptr->index[pos], &cptr->index[pos + 1],
+            (cptr->index_len - pos - 1) * sizeof(*cptr->index));
+    cptr->index_len--;
+}
+
+/** @private
+ *  Clears cache count and position in Lookup Cache of a context whose
+ *  lookup index has been kept in step with the subtree list.
+ */
+NETSNMP_STATIC_INLINE void
+reset_lookup_cache(const char *context) {
+    lookup_cache_context *cptr;
+    if ((cptr = get_context_lookup_cache(context)) != NULL) {
+        cptr->thecachecount = 0;
+        cptr->currentpos = 0;
+    }
+}
+
+/** @private
+ *  Clears cache count and position in Lookup Cache, and marks the lookup
+ *  index of the context as out of date.  The lookup data of the other
+ *  contexts is kept.
  */
 NETSNMP_STATIC_INLINE void
 invalidate_lookup_cache(const char *context) {
@@ -260,6 +449,8 @@ invalidate_lookup_cache(const char *context) {
     if ((cptr = get_context_lookup_cache(context)) != NULL) {
         cptr->thecachecount = 0;
         cptr->currentpos = 0;
+        if (++cptr->generation == 0)
+            cptr->generation = 1;
     }
 }
 
@@ -272,6 +463,7 @@ clear_lookup_cache(void) {
     while (ptr) {
 	next = ptr->next;
 	SNMP_FREE(ptr->context);
+	SNMP_FREE(ptr->index);
 	SNMP_FREE(ptr);
 	ptr = next;
     }
@@ -358,6 +550,7 @@ add_subtree(netsnmp_subtree *new_tree, const char *context_name)
     ptr->first_subtree = new_tree;
     ptr->context_name = strdup(context_name);
     context_subtrees = ptr;
+    invalidate_lookup_cache(context_name);
 
     return ptr->first_subtree;
 }
@@ -405,6 +598,7 @@ netsnmp_subtree_replace_first(netsnmp_subtree *new_tree,
         if (ptr->context_name != NULL &&
 	    strcmp(ptr->context_name, context_name) == 0) {
             ptr->first_subtree = new_tree;
+            invalidate_lookup_cache(context_name);
             return ptr->first_subtree;
         }
     }
@@ -837,6 +1031,8 @@ netsnmp_subtree_load(netsnmp_subtree *new_sub, const char *context_name)
 	    }
 #endif
 	}
+        /* the new subtree may have been split: rebuild the index */
+        invalidate_lookup_cache(context_name);
     } else {
 	/*  If the new subtree starts *within* an existing registration
 	    (rather than at the same point as it), then split the existing
@@ -846,6 +1042,8 @@ netsnmp_subtree_load(netsnmp_subtree *new_sub, const char *context_name)
 			     tree1->start_a,   tree1->start_len) != 0) {
 	    tree1 = netsnmp_subtree_split(tree1, new_sub->start_a, 
 					  new_sub->start_len);
+            if (tree1 != NULL)
+                lookup_index_insert(context_name, tree1);
 	}
 
         if (tree1 == NULL) {
@@ -868,7 +1066,9 @@ netsnmp_subtree_load(netsnmp_subtree *new_sub, const char *context_name)
 
 	case -1:
 	    /*  Existing subtree contains new one.  */
-	    netsnmp_subtree_split(tree1, new_sub->end_a, new_sub->end_len);
+	    tree2 = netsnmp_subtree_split(tree1, new_sub->end_a, new_sub->end_len);
+            if (tree2 != NULL)
+                lookup_index_insert(context_name, tree2);
 	    /* Fall Through */
 
 	case  0:
@@ -930,6 +1130,7 @@ netsnmp_subtree_load(netsnmp_subtree *new_sub, const char *context_name)
 		for (prev = new_sub->prev; prev != NULL;prev = prev->children){
                     netsnmp_subtree_change_next(prev, new_sub);
 		}
+                lookup_index_replace(context_name, tree1, new_sub);
 	    }
 	    break;
 
@@ -942,6 +1143,7 @@ netsnmp_subtree_load(netsnmp_subtree *new_sub, const char *context_name)
                 if (res != MIB_REGISTERED_OK) {
                     netsnmp_remove_subtree(new2);
                     netsnmp_subtree_free(new2);
+                    invalidate_lookup_cache(context_name);
                     return res;
                 }
                 return netsnmp_subtree_load(new2, context_name);
@@ -986,6 +1188,9 @@ netsnmp_subtree_find_prev(const oid *name, size_t len, netsnmp_subtree *subtree,
         myptr = subtree;
     } else {
 	/* look through everything */
+        if (lookup_cache_size &&
+            lookup_index_find(context_name, name, len, &previous) == 0)
+            return previous;
         if (lookup_cache_size) {
             lookup_cache = lookup_cache_find(context_name, name, len, &cmp);
             if (lookup_cache) {
@@ -1286,7 +1491,7 @@ netsnmp_register_mib(const char *moduleName,
     }
 
     netsnmp_set_lookup_cache_size(old_lookup_cache_val);
-    invalidate_lookup_cache(context);
+    reset_lookup_cache(context);
     return res;
 }
 
@@ -1619,7 +1824,7 @@ netsnmp_subtree_unload(netsnmp_subtree *sub, netsnmp_subtree *prev, const char *
 
     if (prev != NULL) {         /* non-leading entries are easy */
         prev->children = sub->children;
-        invalidate_lookup_cache(context);
+        reset_lookup_cache(context);
         return;
     }
     /*
@@ -1637,6 +1842,7 @@ netsnmp_subtree_unload(netsnmp_subtree *sub, netsnmp_subtree *prev, const char *
 	if (sub->prev == NULL) {
 	    netsnmp_subtree_replace_first(sub->next, context);
 	}
+        lookup_index_replace(context, sub, NULL);
 
     } else {
         for (ptr = sub->prev; ptr; ptr = ptr->children)
@@ -1647,8 +1853,9 @@ netsnmp_subtree_unload(netsnmp_subtree *sub, netsnmp_subtree *prev, const char *
 	if (sub->prev == NULL) {
 	    netsnmp_subtree_replace_first(sub->children, context);
 	}
+        lookup_index_replace(context, sub, sub->children);
     }
-    invalidate_lookup_cache(context);
+    reset_lookup_cache(context);
 }
 
 /**
@@ -1776,9 +1983,10 @@ unregister_mib_context(oid * name, size_t len, int priority,
     snmp_call_callbacks(SNMP_CALLBACK_APPLICATION,
                         SNMPD_CALLBACK_UNREGISTER_OID, &reg_parms);
 
+    /* context may belong to the registration that is freed with myptr */
+    reset_lookup_cache(context);
     netsnmp_subtree_free(myptr);
     netsnmp_set_lookup_cache_size(old_lookup_cache_val);
-    invalidate_lookup_cache(context);
     return MIB_UNREGISTERED_OK;
 }
 
@@ -2014,6 +2222,7 @@ unregister_mibs_by_session(netsnmp_session * ss)
             }
         }
         netsnmp_subtree_join(contextptr->first_subtree);
+        invalidate_lookup_cache(contextptr->context_name);
     }
 }
 
@@ -15,6 +15,12 @@
 
 #include <net-snmp/agent/bulk_to_next.h>
 
+#if HAVE_STRING_H
+#include <string.h>
+#else
+#include <strings.h>
+#endif
+
 /** @defgroup bulk_to_next bulk_to_next
  *  Convert GETBULK requests into GETNEXT requests for the handler.
  *  The only purpose of this handler is to convert a GETBULK request
@@ -80,6 +86,202 @@ netsnmp_bulk_to_next_fix_requests(netsnmp_request_info *requests)
     }
 }
 
+/*
+ * returns 1 if the request holds an answer that may be returned.  An
+ * answer that is not in the requester's view is marked for a retry, just
+ * like check_acm() does, so that the agent resumes the search after it.
+ */
+static int
+_bulk_to_next_answer_ok(netsnmp_agent_session *asp,
+                        netsnmp_request_info *request)
+{
+    netsnmp_variable_list *var = request->requestvb;
+
+    if (request->processed || request->delegated || request->status)
+        return 0;
+
+    switch (var->type) {
+    case ASN_NULL:
+    case ASN_PRIV_RETRY:
+    case SNMP_NOSUCHOBJECT:
+    case SNMP_NOSUCHINSTANCE:
+    case SNMP_ENDOFMIBVIEW:
+        return 0;
+    }
+
+    if (in_a_view(var->name, &var->name_length, asp->pdu,
+                  var->type) != VACM_SUCCESS) {
+        snmp_set_var_typed_value(var, ASN_PRIV_RETRY, NULL, 0);
+        request->inclusive = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/** checks whether a table helper may answer the next repetition of a
+ *  GETBULK request itself, without going back through the agent.
+ *
+ *  Table helpers see GETBULK requests as GETNEXT requests (see above) and
+ *  are normally called once per repetition.  When a helper can cheaply
+ *  find the rows following the one it just returned, it may use this
+ *  function together with netsnmp_bulk_to_next_advance() and
+ *  netsnmp_bulk_to_next_call_batch() to fill further repetitions in the
+ *  same pass.  Anything it does not fill is left for the agent's
+ *  getnext loop, as before.
+ *
+ *  The request qualifies if it is part of a GETBULK, has repetitions left,
+ *  holds an answer which is inside its registration's range and in the
+ *  requester's view, and the answers gathered so far for it fit into its
+ *  share of the response.
+ *
+ *  @return 1 if the request can be advanced, 0 otherwise.
+ */
+int
+netsnmp_bulk_to_next_repeatable(netsnmp_agent_request_info *reqinfo,
+                                netsnmp_request_info *request)
+{
+    netsnmp_agent_session *asp;
+    netsnmp_variable_list *var;
+    size_t          vb_size;
+    int             n, r;
+
+    if (NULL == reqinfo || NULL == request || NULL == reqinfo->asp ||
+        NULL == reqinfo->asp->pdu)
+        return 0;
+    asp = reqinfo->asp;
+    if (asp->pdu->command != SNMP_MSG_GETBULK ||
+        reqinfo->mode != MODE_GETNEXT)
+        return 0;
+
+    var = request->requestvb;
+    if (request->repeat <= 0 || NULL == var || NULL == var->next_variable)
+        return 0;
+
+    if (snmp_oid_compare(var->name, var->name_length,
+                         request->range_end, request->range_end_len) >= 0 ||
+        !_bulk_to_next_answer_ok(asp, request))
+        return 0;
+
+    /*
+     * keep this request within its share of the response, using the same
+     * rough size estimate as handle_getnext_loop(); the agent stops
+     * gathering once the whole response exceeds msgMaxSize.
+     */
+    n = asp->pdu->errstat < asp->vbcount ? asp->pdu->errstat : asp->vbcount;
+    r = asp->vbcount - n;
+    if (r <= 0)
+        return 0;
+    vb_size = var->name_length;
+    if (var->type == ASN_OBJECT_ID && sizeof(long) == 8)
+        vb_size += var->val_len / 2;
+    else
+        vb_size += var->val_len;
+    if ((request->orig_repeat - request->repeat + 2) * vb_size >
+        (size_t)(asp->pdu->msgMaxSize / r))
+        return 0;
+
+    return 1;
+}
+
+/** moves a request accepted by netsnmp_bulk_to_next_repeatable() on to
+ *  its next repetition, with name as the OID to return for it.
+ *
+ *  The new varbind gets type ASN_NULL and is ready to be filled in by the
+ *  handlers below the table helper, in MODE_GET.
+ *
+ *  @return 1 on success, 0 if name is beyond the registration's range (in
+ *          which case the request is left alone).
+ */
+int
+netsnmp_bulk_to_next_advance(netsnmp_request_info *request,
+                             const oid *name, size_t name_len)
+{
+    netsnmp_variable_list *next;
+
+    if (snmp_oid_compare(name, name_len, request->range_end,
+                         request->range_end_len) >= 0)
+        return 0;
+
+    next = request->requestvb->next_variable;
+    if (snmp_set_var_objid(next, name, name_len))
+        return 0;
+    snmp_set_var_typed_value(next, ASN_NULL, NULL, 0);
+
+    request->repeat--;
+    request->requestvb = next;
+    if (2 == request->inclusive)
+        request->inclusive = 0;
+    return 1;
+}
+
+/** drops the data that the handlers below a table helper attached to a
+ *  request, so that the next repetition starts out with the same request
+ *  data as the first one did.
+ *
+ *  @param name the last data node the table helper itself added; every
+ *         node after it is freed.
+ */
+void
+netsnmp_bulk_to_next_trim_data(netsnmp_request_info *request,
+                               const char *name)
+{
+    netsnmp_data_list *node;
+
+    for (node = request->parent_data; node; node = node->next)
+        if (0 == strcmp(node->name, name))
+            break;
+    if (node && node->next) {
+        netsnmp_free_all_list_data(node->next);
+        node->next = NULL;
+    }
+}
+
+/** calls the handlers below handler for a subset of the request list.
+ *
+ *  The count requests in batch (which must be in list order) are linked
+ *  into a list of their own for the duration of the call, so that the
+ *  handlers below only see the repetitions that were just set up with
+ *  netsnmp_bulk_to_next_advance().  The original links are restored
+ *  afterwards, and the new answers are checked against the requester's
+ *  view.
+ *
+ *  Delegated requests are no longer accepted by
+ *  netsnmp_bulk_to_next_repeatable(), so they drop out of the next batch.
+ *
+ *  @return the status returned by the handlers.
+ */
+int
+netsnmp_bulk_to_next_call_batch(netsnmp_mib_handler *handler,
+                                netsnmp_handler_registration *reginfo,
+                                netsnmp_agent_request_info *reqinfo,
+                                netsnmp_request_info **batch, int count)
+{
+    netsnmp_request_info **links;
+    int             i, ret;
+
+    links = (netsnmp_request_info **)
+        netsnmp_agent_arena_alloc(reqinfo->asp, 2 * count * sizeof(*links));
+    if (NULL == links)
+        return SNMP_ERR_GENERR;
+
+    for (i = 0; i < count; i++) {
+        links[2 * i] = batch[i]->prev;
+        links[2 * i + 1] = batch[i]->next;
+        batch[i]->prev = i > 0 ? batch[i - 1] : NULL;
+        batch[i]->next = i + 1 < count ? batch[i + 1] : NULL;
+    }
+
+    ret = netsnmp_call_next_handler(handler, reginfo, reqinfo, batch[0]);
+
+    for (i = 0; i < count; i++) {
+        batch[i]->prev = links[2 * i];
+        batch[i]->next = links[2 * i + 1];
+        _bulk_to_next_answer_ok(reqinfo->asp, batch[i]);
+    }
+
+    return ret;
+}
+
 /** @internal Implements the bulk_to_next handler */
 int
 netsnmp_bulk_to_next_helper(netsnmp_mib_handler *handler,
@@ -35,6 +35,7 @@ netsnmp_feature_child_of(cache_get_head, cache_handler);
 static netsnmp_cache  *cache_head = NULL;
 static int             cache_outstanding_valid = 0;
 static int             _cache_load( netsnmp_cache *cache );
+static void            _cache_schedule_reload( netsnmp_cache *cache );
 
 #define CACHE_RELEASE_FREQUENCY 60      /* Check for expired caches every 60s */
 
@@ -98,6 +99,16 @@ void            release_cached_resources(unsigned int regNo,
  *  not be used if cache is not synchronized automatically as it would
  *  result in stale cache information when if polling happens too fast.
  *
+ *  If NETSNMP_CACHE_BACKGROUND_RELOAD is set, each use of the cache
+ *  arms a one-shot timer which reloads it from the agent's main loop
+ *  shortly before it expires. A cache which is in use is then reloaded
+ *  between requests rather than by the request which finds it expired,
+ *  which keeps expensive loads (large /proc scans) out of the time a
+ *  manager waits for a response, e.g. in the middle of a walk. A cache
+ *  which has expired anyway (or was never loaded) is still loaded
+ *  inline, so no request is answered from expired contents, and a cache
+ *  which is no longer used is not reloaded again.
+ *
  *
  *  Here are some suggestions for some common situations.
  *
@@ -261,6 +272,9 @@ netsnmp_cache_free(netsnmp_cache *cache)
     if(0 != cache->timer_id)
         netsnmp_cache_timer_stop(cache);
 
+    if (0 != cache->reload_id)
+        snmp_alarm_unregister(cache->reload_id);
+
     if (cache->valid)
         _cache_free(cache);
 
@@ -519,8 +533,10 @@ netsnmp_cache_reqinfo_insert(netsnmp_cache* cache,
         DEBUGMSGTL(("verbose:helper:cache_handler", " adding '%s' to %p\n",
                     cache_name, reqinfo));
         netsnmp_agent_add_list_data(reqinfo,
-                                    netsnmp_create_data_list(cache_name,
-                                                             cache, NULL));
+                                    netsnmp_agent_arena_data_list(reqinfo,
+                                                                  cache_name,
+                                                                  cache,
+                                                                  NULL));
     }
     SNMP_FREE(cache_name);
 }
@@ -569,17 +585,21 @@ netsnmp_cache_check_expired(netsnmp_cache *cache)
 int
 netsnmp_cache_check_and_reload(netsnmp_cache * cache)
 {
+    int             ret = 0;
+
     if (!cache) {
         DEBUGMSGT(("helper:cache_handler", " no cache\n"));
         return 0;	/* ?? or -1 */
     }
     if (!cache->valid || netsnmp_cache_check_expired(cache))
-        return _cache_load( cache );
+        ret = _cache_load( cache );
     else {
         DEBUGMSGT(("helper:cache_handler", " cached (%d)\n",
                    cache->timeout));
-        return 0;
     }
+    if ((cache->flags & NETSNMP_CACHE_BACKGROUND_RELOAD) && cache->valid)
+        _cache_schedule_reload(cache);
+    return ret;
 }
 
 /** Is the cache valid for a given request? */
@@ -757,6 +777,53 @@ _cache_load( netsnmp_cache *cache )
     return ret;
 }
 
+/** callback function for a background reload */
+static void
+_background_reload(unsigned int regNo, void *clientargs)
+{
+    netsnmp_cache *cache = (netsnmp_cache *)clientargs;
+
+    cache->reload_id = 0;
+    /*
+     * a cache freed (by a SET, or by the auto-release) since the reload
+     * was armed is loaded by the next request which needs it.
+     */
+    if (!cache->valid)
+        return;
+
+    DEBUGMSGT(("helper:cache_handler", "background reload of %p\n", cache));
+    _cache_load(cache);
+}
+
+/** arm a reload of the cache, to be done just before it expires */
+static void
+_cache_schedule_reload( netsnmp_cache *cache )
+{
+    struct timeval  now, delay;
+    long            left, lead;
+
+    if ((0 != cache->reload_id) || (cache->timeout <= 0) ||
+        (NULL == cache->timestampM))
+        return;
+
+    /*
+     * reload a second before expiry, or a quarter of the timeout before
+     * it for short timeouts.
+     */
+    lead = (cache->timeout > 4) ? 1000 : 250L * cache->timeout;
+    netsnmp_get_monotonic_clock(&now);
+    left = 1000L * cache->timeout - lead -
+        (long) uatime_diff(cache->timestampM, &now);
+    if (left < 0)
+        left = 0;
+    delay.tv_sec = left / 1000;
+    delay.tv_usec = (left % 1000) * 1000;
+
+    cache->reload_id = snmp_alarm_register_hr(delay, 0, _background_reload,
+                                              cache);
+    DEBUGMSGT(("helper:cache_handler", " reload in %ld ms\n", left));
+}
+
 
 
 /** run regularly to automatically release cached resources.
@@ -138,6 +138,10 @@ typedef struct container_table_data_s {
  *    set, so that the sub-handler can skip any processing related to the
  *    request. The agent will notice this unsatisfied request, and attempt to
  *    pass it to the next appropriate handler.
+ *    For a GET-BULK, once the sub-handler has answered a request, the
+ *    following rows of the same column are passed down for the next
+ *    repetitions right away (for netsnmp_index keys), so the sub-handler
+ *    may be called several times in one pass.
  *
  *  SET
  *    If the hander did not register with the HANDLER_CAN_NOT_CREATE flag
@@ -698,6 +702,99 @@ _data_lookup(netsnmp_handler_registration *reginfo,
     }
 }
 
+/*
+ * GETBULK fast path: after the first repetition has been answered, keep
+ * walking the container from the row each request was answered from and
+ * let the handlers below fill in the following repetitions, instead of
+ * going back through the agent (and the table helper) for every one of
+ * them.  Requests that reach the end of their column are left to the
+ * agent, which moves them on to the next column as usual.
+ */
+static void
+_container_bulk_repeat(netsnmp_mib_handler *handler,
+                       netsnmp_handler_registration *reginfo,
+                       netsnmp_agent_request_info *agtreq_info,
+                       netsnmp_request_info *requests,
+                       container_table_data *tad)
+{
+    netsnmp_request_info *request, **batch;
+    netsnmp_table_request_info *tblreq_info;
+    netsnmp_index  *row;
+    oid             name[MAX_OID_LEN];
+    size_t          name_len;
+    int             count, rc = SNMP_ERR_NOERROR;
+
+    if (TABLE_CONTAINER_KEY_NETSNMP_INDEX != tad->key_type ||
+        NULL == agtreq_info->asp)
+        return;
+
+    for (count = 0, request = requests; request; request = request->next)
+        if (netsnmp_bulk_to_next_repeatable(agtreq_info, request))
+            ++count;
+    if (0 == count)
+        return;
+    batch = (netsnmp_request_info **)
+        netsnmp_agent_arena_alloc(agtreq_info->asp, count * sizeof(*batch));
+    if (NULL == batch)
+        return;
+
+    memcpy(name, reginfo->rootoid, reginfo->rootoid_len * sizeof(oid));
+    name[reginfo->rootoid_len] = 1;     /* table.entry node */
+
+    do {
+        count = 0;
+        for (request = requests; request; request = request->next) {
+            if (!netsnmp_bulk_to_next_repeatable(agtreq_info, request))
+                continue;
+            row = (netsnmp_index *)
+                netsnmp_container_table_row_extract(request);
+            tblreq_info = netsnmp_extract_table_info(request);
+            if (NULL == row || NULL == tblreq_info)
+                continue;
+            row = (netsnmp_index *)CONTAINER_NEXT(tad->table, row);
+            if (NULL == row ||
+                reginfo->rootoid_len + 2 + row->len > MAX_OID_LEN)
+                continue;
+
+            name[reginfo->rootoid_len + 1] = tblreq_info->colnum;
+            memcpy(&name[reginfo->rootoid_len + 2], row->oids,
+                   row->len * sizeof(oid));
+            name_len = reginfo->rootoid_len + 2 + row->len;
+            if (!netsnmp_bulk_to_next_advance(request, name, name_len))
+                continue;
+
+            tblreq_info->index_oid_len = row->len;
+            memcpy(tblreq_info->index_oid, row->oids, row->len * sizeof(oid));
+            netsnmp_update_variable_list_from_index(tblreq_info);
+
+            /*
+             * same request data as _data_lookup() left for the first pass
+             */
+            netsnmp_bulk_to_next_trim_data(request,
+                                           TABLE_CONTAINER_CONTAINER);
+            netsnmp_request_remove_list_data(request, TABLE_CONTAINER_ROW);
+            netsnmp_request_remove_list_data(request,
+                                             TABLE_CONTAINER_CONTAINER);
+            netsnmp_request_add_list_data(request,
+                                          netsnmp_create_data_list
+                                          (TABLE_CONTAINER_ROW, row, NULL));
+            netsnmp_request_add_list_data(request,
+                                          netsnmp_create_data_list
+                                          (TABLE_CONTAINER_CONTAINER,
+                                           tad->table, NULL));
+            batch[count++] = request;
+        }
+        if (0 == count)
+            break;
+
+        DEBUGMSGTL(("table_container:bulk", "%d more repetitions\n", count));
+        agtreq_info->mode = MODE_GET;
+        rc = netsnmp_bulk_to_next_call_batch(handler, reginfo, agtreq_info,
+                                             batch, count);
+        agtreq_info->mode = MODE_GETNEXT;
+    } while (SNMP_ERR_NOERROR == rc);
+}
+
 /**********************************************************************
  **********************************************************************
  *                                                                    *
@@ -795,6 +892,10 @@ _container_table_handler(netsnmp_mib_handler *handler,
             }
 
             agtreq_info->mode = oldmode; /* restore saved mode */
+
+            if (SNMP_ERR_NOERROR == rc)
+                _container_bulk_repeat(handler, reginfo, agtreq_info,
+                                       requests, tad);
         }
     }
 
@@ -72,6 +72,75 @@ netsnmp_feature_child_of(table_data_row_first, table_data_extras);
  *
  * ================================== */
 
+/*
+ * The rows of a table are kept in a list ordered by their index_oid,
+ * and in a table_container with the same order, which is used to find
+ * rows and to find where new rows go.  The container is created when
+ * it is first needed, so tables whose rows were linked in by hand are
+ * indexed too.  Without a container the list is searched instead.
+ */
+static int
+_table_data_row_compare(const void *lhs, const void *rhs)
+{
+    const netsnmp_table_row *lrow = (const netsnmp_table_row *) lhs;
+    const netsnmp_table_row *rrow = (const netsnmp_table_row *) rhs;
+
+    return snmp_oid_compare(lrow->index_oid, lrow->index_oid_len,
+                            rrow->index_oid, rrow->index_oid_len);
+}
+
+static netsnmp_container *
+_table_data_container(netsnmp_table_data *table)
+{
+    netsnmp_container *c;
+    netsnmp_table_row *row;
+
+    if (table->container)
+        return table->container;
+
+    c = netsnmp_container_find("table_data:table_container");
+    if (!c)
+        return NULL;
+    c->compare = _table_data_row_compare;
+
+    for (row = table->first_row; row; row = row->next) {
+        if (NULL == row->index_oid)
+            continue;
+        if (CONTAINER_INSERT(c, row) != 0) {
+            DEBUGMSGTL(("table_data", "rows of %s out of order, not indexed\n",
+                        table->name ? table->name : "table"));
+            CONTAINER_FREE(c);
+            return NULL;
+        }
+    }
+    table->container = c;
+    return c;
+}
+
+/*
+ * returns the first row whose index comes after the given one
+ */
+static netsnmp_table_row *
+_table_data_next_row(netsnmp_table_data *table, oid *instance, size_t len)
+{
+    netsnmp_container *c = _table_data_container(table);
+    netsnmp_table_row key, *row;
+
+    if (c) {
+        key.index_oid = instance;
+        key.index_oid_len = len;
+        return (netsnmp_table_row *) CONTAINER_NEXT(c, &key);
+    }
+
+    for (row = table->first_row; row; row = row->next) {
+        if (row->index_oid &&
+            snmp_oid_compare(row->index_oid, row->index_oid_len,
+                             instance, len) > 0)
+            return row;
+    }
+    return NULL;
+}
+
 /*
  * generates the index portion of an table oid from a varlist.
  */
@@ -110,6 +179,8 @@ netsnmp_table_data_clone_row(netsnmp_table_row *row)
     newrow = netsnmp_memdup(row, sizeof(netsnmp_table_row));
     if (!newrow)
         return NULL;
+    newrow->columns = NULL;
+    newrow->columns_len = 0;
 
     if (row->indexes) {
         newrow->indexes = snmp_clone_varbind(newrow->indexes);
@@ -148,6 +219,7 @@ netsnmp_table_data_delete_row(netsnmp_table_row *row)
     if (row->indexes)
         snmp_free_varbind(row->indexes);
     SNMP_FREE(row->index_oid);
+    SNMP_FREE(row->columns);
     data = row->data;
     free(row);
 
@@ -169,6 +241,7 @@ netsnmp_table_data_add_row(netsnmp_table_data *table,
 {
     int rc, dup = 0;
     netsnmp_table_row *nextrow = NULL, *prevrow;
+    netsnmp_container *c;
 
     if (!row || !table)
         return SNMPERR_GENERR;
@@ -192,10 +265,24 @@ netsnmp_table_data_add_row(netsnmp_table_data *table,
         return SNMPERR_GENERR;
     }
 
+    if (NULL != (c = _table_data_container(table))) {
+        /*
+         * the index finds duplicates, and the row that follows this one
+         */
+        rc = 0;
+        if (CONTAINER_FIND(c, row))
+            dup = 1;
+        else if (CONTAINER_INSERT(c, row) != 0)
+            return SNMPERR_GENERR;
+        else {
+            nextrow = (netsnmp_table_row *) CONTAINER_NEXT(c, row);
+            prevrow = nextrow ? nextrow->prev : table->last_row;
+        }
+    }
     /*
-     * check for simple append
+     * otherwise check for simple append
      */
-    if ((prevrow = table->last_row) != NULL) {
+    else if ((prevrow = table->last_row) != NULL) {
         rc = snmp_oid_compare(prevrow->index_oid, prevrow->index_oid_len,
                               row->index_oid, row->index_oid_len);
         if (0 == rc)
@@ -284,6 +371,9 @@ netsnmp_table_data_remove_row(netsnmp_table_data *table,
     if (!row || !table)
         return NULL;
 
+    if (table->container && CONTAINER_FIND(table->container, row) == row)
+        CONTAINER_REMOVE(table->container, row);
+
     if (row->prev)
         row->prev->next = row->next;
     else
@@ -348,6 +438,8 @@ netsnmp_table_data_delete_table( netsnmp_table_data *table )
         /* Can't delete table-specific entry memory */
     }
     table->first_row = NULL;
+    if (table->container)
+        CONTAINER_FREE(table->container);
 
     SNMP_FREE(table->name);
     SNMP_FREE(table);
@@ -377,6 +469,8 @@ netsnmp_table_data_copy_row( netsnmp_table_row  *old_row,
         return -1;
 
     memcpy(new_row, old_row, sizeof(netsnmp_table_row));
+    new_row->columns = NULL;
+    new_row->columns_len = 0;
 
     if (old_row->indexes)
         new_row->indexes = snmp_clone_varbind(old_row->indexes);
@@ -573,34 +667,13 @@ netsnmp_table_data_helper_handler(netsnmp_mib_handler *handler,
                 row = table->first_row;
             } else {
                 /*
-                 * loop through all rows looking for the first one
-                 * that is equal to the request or greater than it 
+                 * the first row after the index of the request
                  */
-                for (row = table->first_row; row; row = row->next) {
-                    /*
-                     * compare the index of the request to the row 
-                     */
-                    result =
-                        snmp_oid_compare(row->index_oid,
-                                         row->index_oid_len,
-                                         request->requestvb->name + 2 +
-                                         reginfo->rootoid_len,
-                                         request->requestvb->name_length -
-                                         2 - reginfo->rootoid_len);
-                    if (result == 0) {
-                        /*
-                         * equal match, return the next row 
-                         */
-                        row = row->next;
-                        break;
-                    } else if (result > 0) {
-                        /*
-                         * the current row is greater than the
-                         * request, use it 
-                         */
-                        break;
-                    }
-                }
+                row = _table_data_next_row(table,
+                                           request->requestvb->name + 2 +
+                                           reginfo->rootoid_len,
+                                           request->requestvb->name_length -
+                                           2 - reginfo->rootoid_len);
             }
             if (!row) {
                 table_info->colnum++;
@@ -898,10 +971,17 @@ netsnmp_table_row *
 netsnmp_table_data_get_from_oid(netsnmp_table_data *table,
                                 oid * searchfor, size_t searchfor_len)
 {
-    netsnmp_table_row *row;
+    netsnmp_container *c;
+    netsnmp_table_row *row, key;
     if (!table)
         return NULL;
 
+    if (NULL != (c = _table_data_container(table))) {
+        key.index_oid = searchfor;
+        key.index_oid_len = searchfor_len;
+        return (netsnmp_table_row *) CONTAINER_FIND(c, &key);
+    }
+
     for (row = table->first_row; row != NULL; row = row->next) {
         if (row->index_oid &&
             snmp_oid_compare(searchfor, searchfor_len,
@@ -918,6 +998,8 @@ netsnmp_table_data_num_rows(netsnmp_table_data *table)
     netsnmp_table_row *row;
     if (!table)
         return 0;
+    if (table->container)
+        return CONTAINER_SIZE(table->container);
     for (row = table->first_row; row; row = row->next) {
         i++;
     }
@@ -964,18 +1046,10 @@ netsnmp_table_row *
 netsnmp_table_data_row_next_byoid(netsnmp_table_data *table,
                                   oid *instance, size_t len)
 {
-    netsnmp_table_row *row;
-
     if (!table || !instance)
         return NULL;
-    
-    for (row = table->first_row; row; row = row->next) {
-        if (snmp_oid_compare(row->index_oid,
-                             row->index_oid_len,
-                             instance, len) > 0)
-            return row;
-    }
-    return NULL;
+
+    return _table_data_next_row(table, instance, len);
 }
 
 netsnmp_table_row *
@@ -75,6 +75,52 @@ typedef struct newrow_stash_s {
     int             deleted;
 } newrow_stash;
 
+/*
+ * Besides the storage list in row->data, each row keeps a pointer to
+ * its columns in row->columns, indexed by column number, so finding a
+ * column does not walk the list.  The array is filled in as columns are
+ * created or looked up; columns numbered DATASET_DENSE_COLUMNS or more
+ * are only found through the list.
+ */
+#define DATASET_DENSE_COLUMNS 256
+
+static void
+_dataset_column_add(netsnmp_table_row *row,
+                    netsnmp_table_data_set_storage *data)
+{
+    void          **columns;
+    unsigned int    len;
+
+    if (data->column >= DATASET_DENSE_COLUMNS)
+        return;
+    if (data->column >= row->columns_len) {
+        len = (data->column + 8) & ~7U;
+        columns = (void **) realloc(row->columns, len * sizeof(void *));
+        if (!columns)
+            return;
+        memset(columns + row->columns_len, 0,
+               (len - row->columns_len) * sizeof(void *));
+        row->columns = columns;
+        row->columns_len = len;
+    }
+    row->columns[data->column] = data;
+}
+
+static netsnmp_table_data_set_storage *
+_dataset_column(netsnmp_table_row *row, unsigned int column)
+{
+    netsnmp_table_data_set_storage *data;
+
+    if (column < row->columns_len && row->columns[column])
+        return (netsnmp_table_data_set_storage *) row->columns[column];
+
+    data = netsnmp_table_data_set_find_column(
+        (netsnmp_table_data_set_storage *) row->data, column);
+    if (data)
+        _dataset_column_add(row, data);
+    return data;
+}
+
 /** @defgroup table_dataset table_dataset
  *  Helps you implement a table with automatted storage.
  *  @ingroup table_data
@@ -639,8 +685,7 @@ netsnmp_table_data_set_helper_handler(netsnmp_mib_handler *handler,
             }
         }
 
-        data =
-            netsnmp_table_data_set_find_column(data, table_info->colnum);
+        data = row ? _dataset_column(row, table_info->colnum) : NULL;
 
         switch (reqinfo->mode) {
         case MODE_GET:
@@ -911,12 +956,11 @@ netsnmp_table_data_set_storage *
 netsnmp_extract_table_data_set_column(netsnmp_request_info *request,
                                      unsigned int column)
 {
-    netsnmp_table_data_set_storage *data =
-        (netsnmp_table_data_set_storage*)netsnmp_extract_table_row_data( request );
-    if (data) {
-        data = netsnmp_table_data_set_find_column(data, column);
-    }
-    return data;
+    netsnmp_table_row *row = netsnmp_extract_table_row(request);
+
+    if (row && row->data)
+        return _dataset_column(row, column);
+    return NULL;
 }
 #endif /* NETSNMP_FEATURE_REMOVE_TABLE_DATA_SET_COLUMN */
 
@@ -1359,8 +1403,7 @@ netsnmp_mark_row_column_writable(netsnmp_table_row *row, int column,
     if (!row)
         return SNMPERR_GENERR;
 
-    data = (netsnmp_table_data_set_storage *) row->data;
-    data = netsnmp_table_data_set_find_column(data, column);
+    data = _dataset_column(row, column);
 
     if (!data) {
         /*
@@ -1375,6 +1418,7 @@ netsnmp_mark_row_column_writable(netsnmp_table_row *row, int column,
         data->writable = writable;
         data->next = (struct netsnmp_table_data_set_storage_s*)row->data;
         row->data = data;
+        _dataset_column_add(row, data);
     } else {
         data->writable = writable;
     }
@@ -1411,8 +1455,7 @@ netsnmp_set_row_column(netsnmp_table_row *row, unsigned int column,
     if (!row)
         return SNMPERR_GENERR;
 
-    data = (netsnmp_table_data_set_storage *) row->data;
-    data = netsnmp_table_data_set_find_column(data, column);
+    data = _dataset_column(row, column);
 
     if (!data) {
         /*
@@ -1428,6 +1471,7 @@ netsnmp_set_row_column(netsnmp_table_row *row, unsigned int column,
         data->type = type;
         data->next = (struct netsnmp_table_data_set_storage_s*)row->data;
         row->data = data;
+        _dataset_column_add(row, data);
     }
 
     /* Transitions from / to SNMP_NOSUCHINSTANCE are allowed, but no other transitions. */
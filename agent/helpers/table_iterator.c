@@ -373,6 +373,14 @@ netsnmp_insert_iterator_context(netsnmp_request_info *request, void *data)
 
 #define TI_REQUEST_CACHE "ti_cache"
 
+/* a row following the best match, for the GETBULK fast path */
+typedef struct ti_bulk_row_s {
+   oid *name;
+   size_t name_len;
+   void *data_context;
+   netsnmp_variable_list *indexes;
+} ti_bulk_row;
+
 typedef struct ti_cache_info_s {
    oid best_match[MAX_OID_LEN];
    size_t best_match_len;
@@ -380,11 +388,25 @@ typedef struct ti_cache_info_s {
    Netsnmp_Free_Data_Context *free_context;
    netsnmp_iterator_info *iinfo;
    netsnmp_variable_list *results;
+
+   /* GETBULK: the best rows after the requested OID, in order */
+   ti_bulk_row *bulk;
+   int bulk_count, bulk_max, bulk_next;
+   int bulk_full, bulk_done;
 } ti_cache_info;
 
+static void
+_ti_bulk_row_free(ti_bulk_row *row) {
+    SNMP_FREE(row->name);
+    if (row->indexes)
+        snmp_free_varbind(row->indexes);
+    row->indexes = NULL;
+}
+
 static void
 netsnmp_free_ti_cache(void *it) {
     ti_cache_info *beer = (ti_cache_info*)it;
+    int i;
     if (!it) return;
     if (beer->data_context && beer->free_context) {
             (beer->free_context)(beer->data_context, beer->iinfo);
@@ -392,9 +414,179 @@ netsnmp_free_ti_cache(void *it) {
     if (beer->results) {
         snmp_free_varbind(beer->results);
     }
+    for (i = 0; i < beer->bulk_count; i++)
+        _ti_bulk_row_free(&beer->bulk[i]);
+    SNMP_FREE(beer->bulk);
     free(beer);
 }
 
+/*
+ * GETBULK fast path.
+ *
+ * A GETNEXT search has to look at every data point anyway, so for a
+ * request that is part of a GETBULK we keep the best bulk_max rows after
+ * the requested OID while walking, rather than just the best one.  Once
+ * the first repetition has been answered, _ti_bulk_repeat() hands the
+ * following rows to the handlers below, so the table is walked once per
+ * pass instead of once per repetition.  Data contexts are only kept if
+ * the iterator neither creates nor frees them, since several of them are
+ * held at the same time.
+ */
+static void
+_ti_bulk_setup(netsnmp_agent_request_info *reqinfo,
+               netsnmp_request_info *request,
+               netsnmp_iterator_info *iinfo, ti_cache_info *ti_info)
+{
+    if (ti_info->bulk || NULL == reqinfo->asp || NULL == reqinfo->asp->pdu ||
+        reqinfo->asp->pdu->command != SNMP_MSG_GETBULK ||
+        request->repeat <= 0 || NULL == request->requestvb->next_variable ||
+        iinfo->make_data_context || iinfo->free_data_context)
+        return;
+
+    ti_info->bulk = (ti_bulk_row *)calloc(request->repeat + 1,
+                                          sizeof(ti_bulk_row));
+    if (ti_info->bulk)
+        ti_info->bulk_max = request->repeat + 1;
+}
+
+/*
+ * remember this data point if it is among the best rows seen so far.
+ * Returns 1 when the list of rows has just become full.
+ */
+static int
+_ti_bulk_collect(netsnmp_request_info *request, ti_cache_info *ti_info,
+                 oid *coloid, size_t coloid_len,
+                 netsnmp_variable_list *index_search, void *data_context)
+{
+    oid             myname[MAX_OID_LEN];
+    size_t          myname_len;
+    ti_bulk_row     row;
+    int             lo, hi, mid, cmp;
+
+    build_oid_noalloc(myname, MAX_OID_LEN, &myname_len,
+                      coloid, coloid_len, index_search);
+    if (snmp_oid_compare(myname, myname_len, request->requestvb->name,
+                         request->requestvb->name_length) <= 0)
+        return 0;
+
+    for (lo = 0, hi = ti_info->bulk_count; lo < hi; ) {
+        mid = (lo + hi) / 2;
+        cmp = snmp_oid_compare(ti_info->bulk[mid].name,
+                               ti_info->bulk[mid].name_len,
+                               myname, myname_len);
+        if (cmp == 0)
+            return 0;           /* the first one seen wins */
+        if (cmp < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo >= ti_info->bulk_max)
+        return 0;
+
+    row.name = (oid *)netsnmp_memdup(myname, myname_len * sizeof(oid));
+    row.name_len = myname_len;
+    row.indexes = snmp_clone_varbind(index_search);
+    row.data_context = data_context;
+    if (NULL == row.name || NULL == row.indexes) {
+        _ti_bulk_row_free(&row);
+        return 0;
+    }
+
+    if (ti_info->bulk_count == ti_info->bulk_max)
+        _ti_bulk_row_free(&ti_info->bulk[--ti_info->bulk_count]);
+    memmove(&ti_info->bulk[lo + 1], &ti_info->bulk[lo],
+            (ti_info->bulk_count - lo) * sizeof(ti_bulk_row));
+    ti_info->bulk[lo] = row;
+    ti_info->bulk_count++;
+
+    if (ti_info->bulk_count == ti_info->bulk_max && !ti_info->bulk_full) {
+        ti_info->bulk_full = 1;
+        return 1;
+    }
+    return 0;
+}
+
+static void
+_ti_bulk_repeat(netsnmp_mib_handler *handler,
+                netsnmp_handler_registration *reginfo,
+                netsnmp_agent_request_info *reqinfo,
+                netsnmp_request_info *requests)
+{
+    netsnmp_request_info *request, **batch;
+    netsnmp_table_request_info *table_info;
+    ti_cache_info  *ti_info;
+    ti_bulk_row    *row;
+    int             count, rc = SNMP_ERR_NOERROR;
+
+    if (NULL == reqinfo->asp || NULL == reqinfo->asp->pdu ||
+        reqinfo->asp->pdu->command != SNMP_MSG_GETBULK)
+        return;
+
+    for (count = 0, request = requests; request; request = request->next) {
+        ti_info = (ti_cache_info*)
+            netsnmp_request_get_list_data(request, TI_REQUEST_CACHE);
+        if (NULL == ti_info || ti_info->bulk_count < 2)
+            continue;
+        /*
+         * the first row must be the one that was just returned, and the
+         * handlers below must have seen a data context to replace.
+         */
+        if (snmp_oid_compare(ti_info->bulk[0].name, ti_info->bulk[0].name_len,
+                             request->requestvb->name,
+                             request->requestvb->name_length) != 0 ||
+            NULL == netsnmp_request_get_list_data(request,
+                                                  TABLE_ITERATOR_NAME))
+            continue;
+        ti_info->bulk_next = 1;
+        ++count;
+    }
+    if (0 == count)
+        return;
+    batch = (netsnmp_request_info **)
+        netsnmp_agent_arena_alloc(reqinfo->asp, count * sizeof(*batch));
+    if (NULL == batch)
+        return;
+
+    do {
+        count = 0;
+        for (request = requests; request; request = request->next) {
+            ti_info = (ti_cache_info*)
+                netsnmp_request_get_list_data(request, TI_REQUEST_CACHE);
+            if (NULL == ti_info || 0 == ti_info->bulk_next ||
+                ti_info->bulk_next >= ti_info->bulk_count ||
+                !netsnmp_bulk_to_next_repeatable(reqinfo, request))
+                continue;
+            table_info = netsnmp_extract_table_info(request);
+            row = &ti_info->bulk[ti_info->bulk_next];
+            if (NULL == table_info ||
+                !netsnmp_bulk_to_next_advance(request, row->name,
+                                              row->name_len))
+                continue;
+            ti_info->bulk_next++;
+
+            snmp_free_varbind(table_info->indexes);
+            table_info->indexes = row->indexes;
+            row->indexes = NULL;
+            netsnmp_bulk_to_next_trim_data(request, TABLE_ITERATOR_NAME);
+            netsnmp_request_remove_list_data(request, TABLE_ITERATOR_NAME);
+            netsnmp_request_add_list_data(request,
+                                          netsnmp_create_data_list
+                                          (TABLE_ITERATOR_NAME,
+                                           row->data_context, NULL));
+            batch[count++] = request;
+        }
+        if (0 == count)
+            break;
+
+        DEBUGMSGTL(("table_iterator:bulk", "%d more repetitions\n", count));
+        reqinfo->mode = MODE_GET;
+        rc = netsnmp_bulk_to_next_call_batch(handler, reginfo, reqinfo,
+                                             batch, count);
+        reqinfo->mode = MODE_GETNEXT;
+    } while (SNMP_ERR_NOERROR == rc);
+}
+
 /* caches information (in the request) we'll need at a later point in time */
 static ti_cache_info *
 netsnmp_iterator_remember(netsnmp_request_info *request,
@@ -567,6 +759,7 @@ netsnmp_table_iterator_helper_handler(netsnmp_mib_handler *handler,
                                                ti_info,
                                                netsnmp_free_ti_cache));
             }
+            _ti_bulk_setup(reqinfo, request, iinfo, ti_info);
 
             /* XXX: if no valid requests, don't even loop below */
         }
@@ -764,6 +957,14 @@ netsnmp_table_iterator_helper_handler(netsnmp_mib_handler *handler,
 #endif  /* NETSNMP_FEATURE_REMOVE_STASH_CACHE */
 
                     case MODE_GETNEXT:
+                        /* remember the following rows for GETBULK */
+                        if (ti_info->bulk && !ti_info->bulk_done &&
+                            _ti_bulk_collect(request, ti_info, coloid,
+                                             coloid_len, index_search,
+                                             callback_data_context) &&
+                            (iinfo->flags & NETSNMP_ITERATOR_FLAG_SORTED))
+                            request_count--;
+
                         /* looking for "next" matches */
                         if (netsnmp_check_getnext_reply
                             (request, coloid, coloid_len, index_search,
@@ -788,9 +989,11 @@ netsnmp_table_iterator_helper_handler(netsnmp_mib_handler *handler,
                             /*
                              *  If we've been told that the rows are sorted,
                              *   then the first valid one we find
-                             *   must be the right one.
+                             *   must be the right one (unless we want the
+                             *   ones after it as well, see above).
                              */
-                            if (iinfo->flags & NETSNMP_ITERATOR_FLAG_SORTED)
+                            if ((iinfo->flags & NETSNMP_ITERATOR_FLAG_SORTED)
+                                && !ti_info->bulk)
                                 request_count--;
                         
                         } else {
@@ -849,7 +1052,9 @@ netsnmp_table_iterator_helper_handler(netsnmp_mib_handler *handler,
                     ti_info = (ti_cache_info*)
                         netsnmp_request_get_list_data(request,
                                                       TI_REQUEST_CACHE);
-                    if (!ti_info->results) {
+                    if (ti_info->results)
+                        ti_info->bulk_done = 1;
+                    else {
                         int nc;
 
                         table_info = netsnmp_extract_table_info(request);
@@ -957,6 +1162,8 @@ netsnmp_table_iterator_helper_handler(netsnmp_mib_handler *handler,
     /* reverse the previously saved mode if we were a getnext */
     if (oldmode == MODE_GETNEXT) {
         reqinfo->mode = oldmode;
+        if (SNMP_ERR_NOERROR == ret)
+            _ti_bulk_repeat(handler, reginfo, reqinfo, requests);
     }
 
     /* cleanup */
@@ -81,7 +81,11 @@ netsnmp_swinst_container_load( netsnmp_container *user_container, int flags )
     /*
      * call the arch specific code to load the container
      */
+    CONTAINER_BULK_BEGIN(container);
     arch_rc = netsnmp_swinst_arch_load( container, flags );
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func*)netsnmp_swinst_entry_free_cb,
+                       NULL);
     if (arch_rc && (flags & NETSNMP_SWINST_ALL_OR_NONE)) {
         /*
          * caller does not want a partial load, so empty the container.
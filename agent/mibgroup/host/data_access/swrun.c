@@ -35,6 +35,7 @@ static int _swrun_init = 0;
        int _swrun_max  = 0;
 static netsnmp_cache     *swrun_cache     = NULL;
 static netsnmp_container *swrun_container = NULL;
+static u_int              swrun_generation_count = 0;
 
 /*
  * local static prototypes
@@ -67,6 +68,18 @@ shutdown_swrun(void)
 
 }
 
+/**
+ * reload the process list if needed, and return a number which changes
+ * whenever the list is reloaded or freed.  Callers can use it to keep
+ * results computed from the list until it changes.
+ */
+u_int
+swrun_generation(void)
+{
+    netsnmp_cache_check_and_reload(swrun_cache);
+    return swrun_generation_count;
+}
+
 int
 swrun_count_processes(int include_kthreads)
 {
@@ -162,7 +175,8 @@ swrun_count_processes_by_name( char *name )
 static int
 _cache_load( netsnmp_cache *cache,  void *magic )
 {
-    netsnmp_swrun_container_load( swrun_container, 0 );
+    netsnmp_swrun_container_load( swrun_container, NETSNMP_SWRUN_UPDATE );
+    ++swrun_generation_count;
     return 0;
 }
 
@@ -170,6 +184,7 @@ static void
 _cache_free( netsnmp_cache *cache,  void *magic )
 {
     netsnmp_swrun_container_free_items( swrun_container );
+    ++swrun_generation_count;
     return;
 }
 
@@ -187,7 +202,17 @@ netsnmp_swrun_cache(void)
                            _cache_load,  _cache_free,
                            hrSWRunTable_oid, hrSWRunTable_oid_len);
         if (swrun_cache)
-            swrun_cache->flags = NETSNMP_CACHE_DONT_INVALIDATE_ON_SET;
+            swrun_cache->flags = NETSNMP_CACHE_DONT_INVALIDATE_ON_SET |
+                NETSNMP_CACHE_BACKGROUND_RELOAD;
+#ifdef NETSNMP_ARCH_SWRUN_UPDATE
+        /*
+         * keep the entries between loads, so that the next load only
+         * has to read what changed
+         */
+        if (swrun_cache)
+            swrun_cache->flags |= NETSNMP_CACHE_DONT_FREE_BEFORE_LOAD |
+                NETSNMP_CACHE_DONT_FREE_EXPIRED;
+#endif
     }
     return swrun_cache;
 }
@@ -226,6 +251,9 @@ netsnmp_swrun_container(void)
  *                  pass NULL to have the function create one.
  * @param load_flags flags to modify behaviour. Examples:
  *                   NETSNMP_SWRUN_ALL_OR_NONE
+ *                   NETSNMP_SWRUN_UPDATE: the container holds the
+ *                   results of a previous load, which are updated if
+ *                   the arch loader can do so and freed otherwise.
  *
  * @retval NULL  error
  * @retval !NULL pointer to container
@@ -246,7 +274,22 @@ netsnmp_swrun_container_load(netsnmp_container* user_container, u_int load_flags
         return NULL;
     }
 
+#ifndef NETSNMP_ARCH_SWRUN_UPDATE
+    if (load_flags & NETSNMP_SWRUN_UPDATE) {
+        netsnmp_swrun_container_free_items(container);
+        load_flags &= ~NETSNMP_SWRUN_UPDATE;
+    }
+#endif
+
+    /*
+     * new entries are sorted in once the arch code is done; in update
+     * mode it only looks up the entries which were already there.
+     */
+    CONTAINER_BULK_BEGIN(container);
     rc =  netsnmp_arch_swrun_container_load(container, load_flags);
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func*)_swrun_entry_release,
+                       NULL);
     if (0 != rc) {
         if (NULL == user_container) {
             netsnmp_swrun_container_free(container, NETSNMP_SWRUN_NOFLAGS);
@@ -1,3 +1,14 @@
 extern void netsnmp_arch_swrun_init(void);
 extern int netsnmp_arch_swrun_container_load(netsnmp_container* container,
                                              u_int load_flags);
+
+/*
+ * arch loaders which can refresh the entries of the previous load in
+ * place, instead of starting with an empty container
+ */
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_PROCFS_STATUS_MODULE
+#define NETSNMP_ARCH_SWRUN_UPDATE 1
+#endif
+
+netsnmp_swrun_entry *
+netsnmp_swrun_entry_get_by_index(netsnmp_container *container, oid index);
@@ -33,6 +33,7 @@
 
 static long pagesize;
 static long sc_clk_tck;
+static u_int _generation;
 
 /* ---------------------------------------------------------------------
  */
@@ -49,16 +50,202 @@ netsnmp_arch_swrun_init(void)
 }
 
 /* ---------------------------------------------------------------------
+ * read /proc/PID/stat into entry
+ *
+ *   PID (COMM) STATUS  {xxx}*10  UTIME STIME  {xxx}*6 STARTTIME {xxx} RSS
+ *
+ * The process name (COMM) is copied to comm, if given.
+ *
+ * @retval  0 success
+ * @retval -1 the process has gone away
+ */
+static int
+_load_stat(netsnmp_swrun_entry *entry, char *comm, size_t comm_size)
+{
+    FILE                *fp;
+    int                  i;
+    unsigned long long   value, cpu = 0, rss = 0;
+    char                 buf[BUFSIZ], *cp, *cp1;
+
+    snprintf( buf, BUFSIZ, "/proc/%d/stat", (int)entry->hrSWRunIndex );
+    fp = fopen( buf, "r" );
+    if (!fp)
+        return -1; /* file (process) probably went away */
+    if (fgets( buf, BUFSIZ-1, fp ) == NULL) {
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    /*
+     * the name may contain spaces and brackets, so look for the last ')'
+     */
+    cp = strchr( buf, '(' );
+    cp1 = strrchr( buf, ')' );
+    if (NULL == cp || NULL == cp1 || cp1 < cp || '\0' == cp1[1])
+        return -1;
+    if (comm)
+        snprintf( comm, comm_size, "%.*s", (int)(cp1 - cp - 1), cp + 1 );
+    cp = cp1 + 2;
+
+    switch (*cp) {
+    case 'R':  entry->hrSWRunStatus = HRSWRUNSTATUS_RUNNING;
+               break;
+    case 'S':  entry->hrSWRunStatus = HRSWRUNSTATUS_RUNNABLE;
+               break;
+    case 'D':
+    case 'T':  entry->hrSWRunStatus = HRSWRUNSTATUS_NOTRUNNABLE;
+               break;
+    case 'Z':
+    default:   entry->hrSWRunStatus = HRSWRUNSTATUS_INVALID;
+               break;
+    }
+
+    /*
+     * numeric fields 4 (ppid) to 24 (rss)
+     */
+    cp++;
+    for (i = 4; i <= 24; i++) {
+        value = strtoull( cp, &cp, 10 );
+        switch (i) {
+        case 14: cpu  = value;                 /*  utime */
+                 break;
+        case 15: cpu += value;                 /* +stime */
+                 break;
+        case 22: entry->start_time = value;
+                 break;
+        case 24: rss  = value;
+                 break;
+        }
+    }
+    entry->hrSWRunPerfCPU  = cpu * 100 / sc_clk_tck;
+    entry->hrSWRunPerfMem  = rss * (pagesize/1024);  /* in kB */
+
+    return 0;
+}
+
+/* ---------------------------------------------------------------------
+ * read all of the information about a process which is new to us
+ *
+ * @retval  0 success
+ * @retval -1 the process has gone away
+ */
+static int
+_load_entry(netsnmp_swrun_entry *entry)
+{
+    FILE                *fp;
+    int                  pid = entry->hrSWRunIndex, ret;
+    char                 buf[BUFSIZ], buf2[BUFSIZ], *cp;
+
+    /*
+     * Now extract the interesting information
+     *   from the various /proc{PID}/ interface files
+     */
+
+    /*
+     *   Name:  process name
+     */
+    snprintf( buf2, BUFSIZ, "/proc/%d/status", pid );
+    fp = fopen( buf2, "r" );
+    if (!fp)
+        return -1; /* file (process) probably went away */
+    memset(buf, 0, sizeof(buf));
+    if (fgets( buf, BUFSIZ-1, fp ) == NULL) {
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+
+    for ( cp = buf; *cp != ':'; cp++ )
+        ;
+    while (isspace(*(++cp)))	/* Skip ':' and following spaces */
+        ;
+    entry->hrSWRunName_len = snprintf(entry->hrSWRunName,
+                               sizeof(entry->hrSWRunName)-1, "%s", cp);
+    if ( '\n' == entry->hrSWRunName[ entry->hrSWRunName_len-1 ]) {
+        entry->hrSWRunName[ entry->hrSWRunName_len-1 ] = '\0';
+        entry->hrSWRunName_len--;           /* Stamp on trailing newline */
+    }
+
+    /*
+     *  Command Line:
+     *     argv[0] '\0' argv[1] '\0' ....
+     */
+    snprintf( buf2, BUFSIZ, "/proc/%d/cmdline", pid );
+    fp = fopen( buf2, "r" );
+    if (!fp)
+        return -1; /* file (process) probably went away */
+    entry->hrSWRunType = HRSWRUNTYPE_APPLICATION;
+    memset(buf, 0, sizeof(buf));
+    cp = fgets( buf, BUFSIZ-1, fp );
+    fclose(fp);
+    if (cp != NULL) {
+        /*
+         *     argv[0]   is hrSWRunPath
+         */
+        ret = snprintf(entry->hrSWRunPath, sizeof(entry->hrSWRunPath),
+                       "%s", buf);
+
+        if (ret < sizeof(entry->hrSWRunPath))
+            entry->hrSWRunPath_len = ret;
+        else
+            entry->hrSWRunPath_len = sizeof(entry->hrSWRunPath) - 1;
+
+        /*
+         * Stitch together argv[1..] to construct hrSWRunParameters
+         */
+        for (cp = buf + ret; ! (*cp == '\0' && *(cp + 1) == '\0'); cp++)
+                if (*cp == '\0')
+                        *cp = ' ';
+
+        entry->hrSWRunParameters_len
+            = sprintf(entry->hrSWRunParameters, "%.*s",
+                      (int)sizeof(entry->hrSWRunParameters) - 1,
+                      buf + ret + 1);
+    } else {
+        /* empty /proc/PID/cmdline, it's probably a kernel thread */
+        entry->hrSWRunPath_len = 0;
+        entry->hrSWRunParameters_len = 0;
+        entry->hrSWRunType = HRSWRUNTYPE_OPERATINGSYSTEM;
+    }
+
+    return _load_stat(entry, NULL, 0);
+}
+
+/* ---------------------------------------------------------------------
+ */
+struct _stale_list {
+    netsnmp_swrun_entry **entries;
+    size_t                count;
+    size_t                max;
+};
+
+static void
+_collect_stale(netsnmp_swrun_entry *entry, void *context)
+{
+    struct _stale_list *stale = (struct _stale_list *)context;
+
+    if (entry->generation != _generation && stale->count < stale->max)
+        stale->entries[stale->count++] = entry;
+}
+
+/* ---------------------------------------------------------------------
+ *
+ * With NETSNMP_SWRUN_UPDATE the container holds the entries of the
+ * previous load.  A process which is still there (same pid, same start
+ * time and name) only has /proc/PID/stat read again; name, path and
+ * parameters are kept.  Everything is read for new processes, and the
+ * entries of processes which have gone away are removed.
  */
 int
 netsnmp_arch_swrun_container_load( netsnmp_container *container, u_int flags)
 {
     DIR                 *procdir = NULL;
     struct dirent       *procentry_p;
-    FILE                *fp;
-    int                  pid, i, ret;
-    unsigned long long   cpu;
-    char                 buf[BUFSIZ], buf2[BUFSIZ], *cp, *cp1;
+    struct _stale_list   stale;
+    size_t               seen = 0, i;
+    int                  pid, update, added = 0;
+    char                 comm[sizeof(((netsnmp_swrun_entry *)0)->hrSWRunName)];
     netsnmp_swrun_entry *entry;
     
     procdir = opendir("/proc");
@@ -67,6 +254,9 @@ netsnmp_arch_swrun_container_load( netsnmp_container *container, u_int flags)
         return -1;
     }
 
+    update = (flags & NETSNMP_SWRUN_UPDATE) && CONTAINER_SIZE(container);
+    ++_generation;
+
     /*
      * Walk through the list of processes in the /proc tree
      */
@@ -75,149 +265,64 @@ netsnmp_arch_swrun_container_load( netsnmp_container *container, u_int flags)
         if ( 0 == pid )
             continue;   /* Presumably '.' or '..' */
 
-        entry = netsnmp_swrun_entry_create(pid);
-        if (NULL == entry)
-            continue;   /* error already logged by function */
-
-        /*
-         * Now extract the interesting information
-         *   from the various /proc{PID}/ interface files
-         */
-
-        /*
-         *   Name:  process name
-         */
-        snprintf( buf2, BUFSIZ, "/proc/%d/status", pid );
-        fp = fopen( buf2, "r" );
-        if (!fp) {
-            netsnmp_swrun_entry_free(entry);
-            continue; /* file (process) probably went away */
-	}
-        memset(buf, 0, sizeof(buf));
-        if (fgets( buf, BUFSIZ-1, fp ) == NULL) {
-            fclose(fp);
-            netsnmp_swrun_entry_free(entry);
-            continue;
-        }
-        fclose(fp);
-
-        for ( cp = buf; *cp != ':'; cp++ )
-            ;
-        while (isspace(*(++cp)))	/* Skip ':' and following spaces */
-            ;
-        entry->hrSWRunName_len = snprintf(entry->hrSWRunName,
-                                   sizeof(entry->hrSWRunName)-1, "%s", cp);
-        if ( '\n' == entry->hrSWRunName[ entry->hrSWRunName_len-1 ]) {
-            entry->hrSWRunName[ entry->hrSWRunName_len-1 ] = '\0';
-            entry->hrSWRunName_len--;           /* Stamp on trailing newline */
-        }
-
-        /*
-         *  Command Line:
-         *     argv[0] '\0' argv[1] '\0' ....
-         */
-        snprintf( buf2, BUFSIZ, "/proc/%d/cmdline", pid );
-        fp = fopen( buf2, "r" );
-        if (!fp) {
-            netsnmp_swrun_entry_free(entry);
-            continue; /* file (process) probably went away */
-        }
-        entry->hrSWRunType = HRSWRUNTYPE_APPLICATION;
-        memset(buf, 0, sizeof(buf));
-        cp = fgets( buf, BUFSIZ-1, fp );
-        fclose(fp);
-        if (cp != NULL) {
-            /*
-             *     argv[0]   is hrSWRunPath
-             */
-            ret = snprintf(entry->hrSWRunPath, sizeof(entry->hrSWRunPath),
-                           "%s", buf);
-
-            if (ret < sizeof(entry->hrSWRunPath))
-                entry->hrSWRunPath_len = ret;
-            else
-                entry->hrSWRunPath_len = sizeof(entry->hrSWRunPath) - 1;
+        if (update &&
+            NULL != (entry = netsnmp_swrun_entry_get_by_index(container,
+                                                              pid))) {
+            u_long start_time = entry->start_time;
 
+            if (0 == _load_stat(entry, comm, sizeof(comm)) &&
+                entry->start_time == start_time &&
+                0 == strcmp(comm, entry->hrSWRunName)) {
+                entry->generation = _generation;
+                ++seen;
+                continue;
+            }
             /*
-             * Stitch together argv[1..] to construct hrSWRunParameters
+             * gone, pid reused or new program: start over
              */
-            for (cp = buf + ret; ! (*cp == '\0' && *(cp + 1) == '\0'); cp++)
-                    if (*cp == '\0')
-                            *cp = ' ';
-
-            entry->hrSWRunParameters_len
-                = sprintf(entry->hrSWRunParameters, "%.*s",
-                          (int)sizeof(entry->hrSWRunParameters) - 1,
-                          buf + ret + 1);
-        } else {
-            /* empty /proc/PID/cmdline, it's probably a kernel thread */
-            entry->hrSWRunPath_len = 0;
-            entry->hrSWRunParameters_len = 0;
-            entry->hrSWRunType = HRSWRUNTYPE_OPERATINGSYSTEM;
+            CONTAINER_REMOVE(container, entry);
+            netsnmp_swrun_entry_free(entry);
         }
 
-        /*
-         *   {xxx} {xxx} STATUS  {xxx}*10  UTIME STIME  {xxx}*8 RSS
-         */
-        snprintf( buf, BUFSIZ, "/proc/%d/stat", pid );
-        fp = fopen( buf, "r" );
-        if (!fp) {
-            netsnmp_swrun_entry_free(entry);
-            continue; /* file (process) probably went away */
-	}
-        if (fgets( buf, BUFSIZ-1, fp ) == NULL) {
-            fclose(fp);
+        entry = netsnmp_swrun_entry_create(pid);
+        if (NULL == entry)
+            continue;   /* error already logged by function */
+
+        if (_load_entry(entry) < 0) {
             netsnmp_swrun_entry_free(entry);
             continue;
         }
-        fclose(fp);
+        entry->generation = _generation;
+        CONTAINER_INSERT(container, entry);
+        ++seen;
+        ++added;
+    }
+    closedir( procdir );
 
-        cp = buf;
-        while ( ' ' != *(cp++))    /* Skip first field */
-            ;
-        cp1 = cp;                  /* Skip second field */
-        while (*cp1) {
-            if (*cp1 == ')') cp = cp1;
-            cp1++;
-        }
-        cp += 2;
-        
-        switch (*cp) {
-        case 'R':  entry->hrSWRunStatus = HRSWRUNSTATUS_RUNNING;
-                   break;
-        case 'S':  entry->hrSWRunStatus = HRSWRUNSTATUS_RUNNABLE;
-                   break;
-        case 'D':
-        case 'T':  entry->hrSWRunStatus = HRSWRUNSTATUS_NOTRUNNABLE;
-                   break;
-        case 'Z':
-        default:   entry->hrSWRunStatus = HRSWRUNSTATUS_INVALID;
-                   break;
-        }
-        for (i=11; i; i--) {   /* Skip STATUS + 10 fields */
-            while (' ' != *(++cp))
-                ;
-            cp++;
+    /*
+     * remove processes which have gone away
+     */
+    if (update && CONTAINER_SIZE(container) > seen) {
+        stale.max = CONTAINER_SIZE(container) - seen;
+        stale.count = 0;
+        stale.entries = (netsnmp_swrun_entry **)
+            malloc(stale.max * sizeof(netsnmp_swrun_entry *));
+        if (NULL == stale.entries) {
+            snmp_log(LOG_ERR, "malloc failed for stale swrun entries\n");
+            return -1;
         }
-        cpu  = atol( cp );                     /*  utime */
-        while ( ' ' != *(++cp))
-            ;
-        cpu += atol( cp );                     /* +stime */
-        entry->hrSWRunPerfCPU  = cpu * 100 / sc_clk_tck;
-
-        for (i=9; i; i--) {   /* Skip stime + 8 fields */
-            while (' ' != *(++cp))
-                ;
-            cp++;
+        CONTAINER_FOR_EACH(container,
+                           (netsnmp_container_obj_func *)_collect_stale,
+                           &stale);
+        for (i = 0; i < stale.count; i++) {
+            CONTAINER_REMOVE(container, stale.entries[i]);
+            netsnmp_swrun_entry_free(stale.entries[i]);
         }
-        entry->hrSWRunPerfMem  = atol( cp );       /* rss   */
-        entry->hrSWRunPerfMem *= (pagesize/1024);  /* in kB */
-        CONTAINER_INSERT(container, entry);
+        free(stale.entries);
     }
-    closedir( procdir );
 
-    DEBUGMSGTL(("swrun:load:arch"," loaded %" NETSNMP_PRIz "d entries\n",
-                CONTAINER_SIZE(container)));
+    DEBUGMSGTL(("swrun:load:arch"," loaded %" NETSNMP_PRIz "d entries (%d new)\n",
+                CONTAINER_SIZE(container), added));
 
     return 0;
 }
@@ -177,7 +177,11 @@ netsnmp_access_interface_container_load(netsnmp_container* container, u_int load
         return NULL;
     }
 
+    CONTAINER_BULK_BEGIN(container);
     rc =  netsnmp_arch_interface_container_load(container, load_flags);
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func*)_access_interface_entry_release,
+                       NULL);
     if (0 != rc) {
         netsnmp_access_interface_container_free(container,
                                                 NETSNMP_ACCESS_INTERFACE_FREE_NOFLAGS);
@@ -186,7 +190,52 @@ netsnmp_access_interface_container_load(netsnmp_container* container, u_int load
 
     return container;
 }
+#endif /* NETSNMP_ACCESS_INTERFACE_NOARCH */
 
+/**
+ * start watching for interface changes
+ *
+ * changed is called with a freshly loaded entry (which it must either
+ * keep or free) when an interface is added or changes state, and with
+ * a NULL entry when one goes away. An if_index of 0 means that changes
+ * were lost and the caller should reload everything.
+ *
+ * Only one caller can watch interfaces at a time.
+ *
+ * @retval  0 : success
+ * @retval -1 : not supported on this platform, or already started
+ */
+int
+netsnmp_access_interface_monitor_start(NetsnmpAccessInterfaceChange *changed,
+                                       void *data)
+{
+#if !defined(NETSNMP_ACCESS_INTERFACE_NOARCH) && \
+    defined(NETSNMP_ARCH_INTERFACE_MONITOR)
+    DEBUGMSGTL(("access:interface:container", "monitor start\n"));
+    netsnmp_assert(1 == _access_interface_init);
+
+    if (NULL == changed)
+        return -1;
+
+    return netsnmp_arch_interface_monitor_start(changed, data);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * stop watching for interface changes
+ */
+void
+netsnmp_access_interface_monitor_stop(void)
+{
+#if !defined(NETSNMP_ACCESS_INTERFACE_NOARCH) && \
+    defined(NETSNMP_ARCH_INTERFACE_MONITOR)
+    netsnmp_arch_interface_monitor_stop();
+#endif
+}
+
+#ifndef NETSNMP_ACCESS_INTERFACE_NOARCH
 void
 netsnmp_access_interface_container_free(netsnmp_container *container, u_int free_flags)
 {
@@ -521,16 +570,59 @@ _access_interface_entry_save_name(const char *name, oid index)
         }
 }
 
-/**
- * update stats
- *
- * @retval  0 : success
- * @retval -1 : error
+/*
+ * point counters to the 64-bit counters of stats
  */
-int
-netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
-                                            netsnmp_interface_entry * new_vals)
+static void
+_entry_counters(netsnmp_interface_stats *stats,
+                netsnmp_interface_counters *counters)
+{
+    counters->ibytes = &stats->ibytes;
+    counters->iucast = &stats->iucast;
+    counters->imcast = &stats->imcast;
+    counters->ibcast = &stats->ibcast;
+    counters->obytes = &stats->obytes;
+    counters->oucast = &stats->oucast;
+    counters->omcast = &stats->omcast;
+    counters->obcast = &stats->obcast;
+}
+
+/*
+ * move the 64-bit counters of stats to counters, leaving them zero
+ */
+static void
+_entry_counters_move(netsnmp_interface_stats *stats,
+                     const netsnmp_interface_counters *counters)
+{
+    netsnmp_interface_counters from;
+
+    _entry_counters(stats, &from);
+#define MOVE_COUNTER(field)                                             \
+    do {                                                                \
+        *counters->field = *from.field;                                 \
+        memset(from.field, 0, sizeof(*from.field));                     \
+    } while (0)
+    MOVE_COUNTER(ibytes);
+    MOVE_COUNTER(iucast);
+    MOVE_COUNTER(imcast);
+    MOVE_COUNTER(ibcast);
+    MOVE_COUNTER(obytes);
+    MOVE_COUNTER(oucast);
+    MOVE_COUNTER(omcast);
+    MOVE_COUNTER(obcast);
+#undef MOVE_COUNTER
+}
+
+/*
+ * update stats, with the 64-bit counters in counters if not NULL
+ */
+static int
+_entry_update_stats(netsnmp_interface_entry * prev_vals,
+                    netsnmp_interface_entry * new_vals,
+                    const netsnmp_interface_counters *counters)
 {
+    netsnmp_interface_counters own;
+
     DEBUGMSGTL(("access:interface", "check_wrap\n"));
     
     /*
@@ -546,9 +638,16 @@ netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
      */
     if (0 == need_wrap_check) {
         memcpy(&prev_vals->stats, &new_vals->stats, sizeof(new_vals->stats));
+        if (counters)
+            _entry_counters_move(&prev_vals->stats, counters);
         return 0;
     }
 
+    if (NULL == counters) {
+        _entry_counters(&prev_vals->stats, &own);
+        counters = &own;
+    }
+
     if (NULL == prev_vals->old_stats) {
         /*
          * if we don't have old stats, copy previous stats
@@ -558,9 +657,19 @@ netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
             return -2;
         }
         memcpy(prev_vals->old_stats, &prev_vals->stats, sizeof(prev_vals->stats));
+        if (counters != &own) {
+            prev_vals->old_stats->ibytes = *counters->ibytes;
+            prev_vals->old_stats->iucast = *counters->iucast;
+            prev_vals->old_stats->imcast = *counters->imcast;
+            prev_vals->old_stats->ibcast = *counters->ibcast;
+            prev_vals->old_stats->obytes = *counters->obytes;
+            prev_vals->old_stats->oucast = *counters->oucast;
+            prev_vals->old_stats->omcast = *counters->omcast;
+            prev_vals->old_stats->obcast = *counters->obcast;
+        }
     }
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.ibytes,
+        if (0 != netsnmp_c64_check32_and_update(counters->ibytes,
                                        &new_vals->stats.ibytes,
                                        &prev_vals->old_stats->ibytes,
                                        &need_wrap_check))
@@ -575,7 +684,7 @@ netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
                 DEBUGMSGTL(("access:interface",
                         "Error expanding packet count to 64bits\n"));
         } else {
-            if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.iucast,
+            if (0 != netsnmp_c64_check32_and_update(counters->iucast,
                                            &new_vals->stats.iucast,
                                            &prev_vals->old_stats->iucast,
                                            &need_wrap_check))
@@ -583,49 +692,49 @@ netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
                         "Error expanding ifHCInUcastPkts to 64bits\n"));
         }
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.iucast,
+        if (0 != netsnmp_c64_check32_and_update(counters->iucast,
                                        &new_vals->stats.iucast,
                                        &prev_vals->old_stats->iucast,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCInUcastPkts to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.imcast,
+        if (0 != netsnmp_c64_check32_and_update(counters->imcast,
                                        &new_vals->stats.imcast,
                                        &prev_vals->old_stats->imcast,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCInMulticastPkts to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.ibcast,
+        if (0 != netsnmp_c64_check32_and_update(counters->ibcast,
                                        &new_vals->stats.ibcast,
                                        &prev_vals->old_stats->ibcast,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCInBroadcastPkts to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.obytes,
+        if (0 != netsnmp_c64_check32_and_update(counters->obytes,
                                        &new_vals->stats.obytes,
                                        &prev_vals->old_stats->obytes,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCOutOctets to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.oucast,
+        if (0 != netsnmp_c64_check32_and_update(counters->oucast,
                                        &new_vals->stats.oucast,
                                        &prev_vals->old_stats->oucast,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCOutUcastPkts to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.omcast,
+        if (0 != netsnmp_c64_check32_and_update(counters->omcast,
                                        &new_vals->stats.omcast,
                                        &prev_vals->old_stats->omcast,
                                        &need_wrap_check))
             DEBUGMSGTL(("access:interface",
                     "Error expanding ifHCOutMulticastPkts to 64bits\n"));
 
-        if (0 != netsnmp_c64_check32_and_update(&prev_vals->stats.obcast,
+        if (0 != netsnmp_c64_check32_and_update(counters->obcast,
                                        &new_vals->stats.obcast,
                                        &prev_vals->old_stats->obcast,
                                        &need_wrap_check))
@@ -663,22 +772,84 @@ netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
 }
 
 /**
- * Calculate stats
+ * update stats
  *
  * @retval  0 : success
  * @retval -1 : error
  */
 int
-netsnmp_access_interface_entry_calculate_stats(netsnmp_interface_entry *entry)
+netsnmp_access_interface_entry_update_stats(netsnmp_interface_entry * prev_vals,
+                                            netsnmp_interface_entry * new_vals)
+{
+    return _entry_update_stats(prev_vals, new_vals, NULL);
+}
+
+/*
+ * calculate stats, with the 64-bit counters in counters if not NULL
+ */
+static int
+_entry_calculate_stats(netsnmp_interface_entry *entry,
+                       const netsnmp_interface_counters *counters)
 {
     DEBUGMSGTL(("access:interface", "calculate_stats\n"));
     if (entry->ns_flags & NETSNMP_INTERFACE_FLAGS_CALCULATE_UCAST) {
-        u64Subtract(&entry->stats.iall, &entry->stats.imcast,
-                &entry->stats.iucast);
+        if (counters)
+            u64Subtract(&entry->stats.iall, counters->imcast,
+                        counters->iucast);
+        else
+            u64Subtract(&entry->stats.iall, &entry->stats.imcast,
+                        &entry->stats.iucast);
     }
     return 0;
 }
 
+/**
+ * Calculate stats
+ *
+ * @retval  0 : success
+ * @retval -1 : error
+ */
+int
+netsnmp_access_interface_entry_calculate_stats(netsnmp_interface_entry *entry)
+{
+    return _entry_calculate_stats(entry, NULL);
+}
+
+/**
+ * copy interface counters (after checking for counter wraps)
+ *
+ * @retval -2 : malloc failed
+ * @retval -1 : interfaces not the same
+ * @retval  0 : no error
+ */
+int
+netsnmp_access_interface_entry_copy_stats(netsnmp_interface_entry * lhs,
+                                          netsnmp_interface_entry * rhs)
+{
+    return netsnmp_access_interface_entry_copy_stats_to(lhs, rhs, NULL);
+}
+
+/**
+ * copy interface counters (after checking for counter wraps), storing
+ * the 64-bit ones in counters instead of lhs->stats if counters is not
+ * NULL
+ *
+ * @retval -2 : malloc failed
+ * @retval -1 : interfaces not the same
+ * @retval  0 : no error
+ */
+int
+netsnmp_access_interface_entry_copy_stats_to(netsnmp_interface_entry * lhs,
+                                             netsnmp_interface_entry * rhs,
+                                  const netsnmp_interface_counters *counters)
+{
+    int rc = _entry_update_stats(lhs, rhs, counters);
+
+    _entry_calculate_stats(lhs, counters);
+
+    return rc;
+}
+
 /**
  * copy interface entry data (after checking for counter wraps)
  *
@@ -689,6 +860,23 @@ netsnmp_access_interface_entry_calculate_stats(netsnmp_interface_entry *entry)
 int
 netsnmp_access_interface_entry_copy(netsnmp_interface_entry * lhs,
                                     netsnmp_interface_entry * rhs)
+{
+    return netsnmp_access_interface_entry_copy_to(lhs, rhs, NULL);
+}
+
+/**
+ * copy interface entry data (after checking for counter wraps), storing
+ * the 64-bit counters in counters instead of lhs->stats if counters is
+ * not NULL
+ *
+ * @retval -2 : malloc failed
+ * @retval -1 : interfaces not the same
+ * @retval  0 : no error
+ */
+int
+netsnmp_access_interface_entry_copy_to(netsnmp_interface_entry * lhs,
+                                       netsnmp_interface_entry * rhs,
+                                       const netsnmp_interface_counters *counters)
 {
     DEBUGMSGTL(("access:interface", "copy\n"));
     
@@ -700,8 +888,7 @@ netsnmp_access_interface_entry_copy(netsnmp_interface_entry * lhs,
     /*
      * update stats
      */
-    netsnmp_access_interface_entry_update_stats(lhs, rhs);
-    netsnmp_access_interface_entry_calculate_stats(lhs);
+    netsnmp_access_interface_entry_copy_stats_to(lhs, rhs, counters);
 
     /*
      * update data
@@ -101,9 +101,15 @@ typedef __u8 u8;           /* ditto */
 #define SIOCGMIIREG 0x8948
 #endif
 
-#ifdef NETSNMP_ENABLE_IPV6
 #if defined(HAVE_LINUX_RTNETLINK_H)
 #include <linux/rtnetlink.h>
+#ifdef IFLA_RTA
+#define SUPPORT_RTM_GETLINK 1
+#endif  /* IFLA_RTA */
+#endif  /* HAVE_LINUX_RTNETLINK_H */
+
+#ifdef NETSNMP_ENABLE_IPV6
+#if defined(HAVE_LINUX_RTNETLINK_H)
 #ifdef RTMGRP_IPV6_PREFIX
 #define SUPPORT_PREFIX_FLAGS 1
 #endif  /* RTMGRP_IPV6_PREFIX */
@@ -314,6 +320,51 @@ _arch_interface_has_ipv6(oid if_index, u_int *flags,
 #endif
 }
 
+/**
+ * @internal
+ * set the address type flags of a single interface, without listing the
+ * addresses of every interface.
+ */
+static void
+_arch_interface_ip_flags_get(int fd, const char *name, oid if_index,
+                             u_int *flags)
+{
+    struct ifreq    ifr;
+#ifdef NETSNMP_ENABLE_IPV6
+    FILE           *fin;
+    char            line[256];
+    unsigned int    index;
+#endif
+
+    *flags &= ~(NETSNMP_INTERFACE_FLAGS_HAS_IPV4 |
+                NETSNMP_INTERFACE_FLAGS_HAS_IPV6);
+
+    memset(&ifr, 0, sizeof(ifr));
+    strlcpy(ifr.ifr_name, name, sizeof(ifr.ifr_name));
+    ifr.ifr_addr.sa_family = AF_INET;
+    if (ioctl(fd, SIOCGIFADDR, &ifr) == 0)
+        *flags |= NETSNMP_INTERFACE_FLAGS_HAS_IPV4;
+
+#ifdef NETSNMP_ENABLE_IPV6
+    /*
+     * address index prefix_len scope status if_name
+     */
+    if (!(fin = fopen("/proc/net/if_inet6", "r"))) {
+        DEBUGMSGTL(("access:interface",
+                    "Failed to open /proc/net/if_inet6\n"));
+        return;
+    }
+    while (fgets(line, sizeof(line), fin)) {
+        if ((1 == sscanf(line, "%*s %08x", &index)) &&
+            (index == if_index)) {
+            *flags |= NETSNMP_INTERFACE_FLAGS_HAS_IPV6;
+            break;
+        }
+    }
+    fclose(fin);
+#endif
+}
+
 /**
  * @internal
  */
@@ -472,6 +523,56 @@ _arch_interface_flags_v6_get(netsnmp_interface_entry *entry)
 }
 #endif /* NETSNMP_ENABLE_IPV6 */
 
+/**
+ * @internal
+ */
+static void
+_set_stats(netsnmp_interface_entry *entry,
+           uintmax_t rec_oct, uintmax_t rec_pkt, uintmax_t rec_err,
+           uintmax_t rec_drop, uintmax_t rec_mcast,
+           uintmax_t snd_oct, uintmax_t snd_pkt, uintmax_t snd_err,
+           uintmax_t snd_drop, uintmax_t coll)
+{
+    entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_ACTIVE;
+    
+    /*
+     * linux previous to 1.3.~13 may miss transmitted loopback pkts: 
+     */
+    if (!strcmp(entry->name, "lo") && rec_pkt > 0 && !snd_pkt)
+        snd_pkt = rec_pkt;
+    
+    /*
+     * subtract out multicast packets from rec_pkt before
+     * we store it as unicast counter.
+     */
+    entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_CALCULATE_UCAST;
+    entry->stats.ibytes.low = rec_oct & 0xffffffff;
+    entry->stats.iall.low = rec_pkt & 0xffffffff;
+    entry->stats.imcast.low = rec_mcast & 0xffffffff;
+    entry->stats.obytes.low = snd_oct & 0xffffffff;
+    entry->stats.oucast.low = snd_pkt & 0xffffffff;
+    entry->stats.ibytes.high = rec_oct >> 32;
+    entry->stats.iall.high = rec_pkt >> 32;
+    entry->stats.imcast.high = rec_mcast >> 32;
+    entry->stats.obytes.high = snd_oct >> 32;
+    entry->stats.oucast.high = snd_pkt >> 32;
+    entry->stats.ierrors   = rec_err;
+    entry->stats.idiscards = rec_drop;
+    entry->stats.oerrors   = snd_err;
+    entry->stats.odiscards = snd_drop;
+    entry->stats.collisions = coll;
+    
+    /*
+     * calculated stats.
+     *
+     *  we have imcast, but not ibcast.
+     */
+    entry->stats.inucast = entry->stats.imcast.low +
+        entry->stats.ibcast.low;
+    entry->stats.onucast = entry->stats.omcast.low +
+        entry->stats.obcast.low;
+}
+
 /**
  * @internal
  */
@@ -554,383 +655,893 @@ _parse_stats(netsnmp_interface_entry *entry, char *stats, int expected)
                  expected, scan_count);
         return scan_count;
     }
-    entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_ACTIVE;
-    
-    /*
-     * linux previous to 1.3.~13 may miss transmitted loopback pkts: 
-     */
-    if (!strcmp(entry->name, "lo") && rec_pkt > 0 && !snd_pkt)
-        snd_pkt = rec_pkt;
-    
-    /*
-     * subtract out multicast packets from rec_pkt before
-     * we store it as unicast counter.
-     */
-    entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_CALCULATE_UCAST;
-    entry->stats.ibytes.low = rec_oct & 0xffffffff;
-    entry->stats.iall.low = rec_pkt & 0xffffffff;
-    entry->stats.imcast.low = rec_mcast & 0xffffffff;
-    entry->stats.obytes.low = snd_oct & 0xffffffff;
-    entry->stats.oucast.low = snd_pkt & 0xffffffff;
-    entry->stats.ibytes.high = rec_oct >> 32;
-    entry->stats.iall.high = rec_pkt >> 32;
-    entry->stats.imcast.high = rec_mcast >> 32;
-    entry->stats.obytes.high = snd_oct >> 32;
-    entry->stats.oucast.high = snd_pkt >> 32;
-    entry->stats.ierrors   = rec_err;
-    entry->stats.idiscards = rec_drop;
-    entry->stats.oerrors   = snd_err;
-    entry->stats.odiscards = snd_drop;
-    entry->stats.collisions = coll;
-    
-    /*
-     * calculated stats.
-     *
-     *  we have imcast, but not ibcast.
-     */
-    entry->stats.inucast = entry->stats.imcast.low +
-        entry->stats.ibcast.low;
-    entry->stats.onucast = entry->stats.omcast.low +
-        entry->stats.obcast.low;
+
+    _set_stats(entry, rec_oct, rec_pkt, rec_err, rec_drop, rec_mcast,
+               snd_oct, snd_pkt, snd_err, snd_drop, coll);
     
     return 0;
 }
 
 /*
- *
- * @retval  0 success
- * @retval -1 no container specified
- * @retval -2 could not open /proc/net/dev
- * @retval -3 could not create entry (probably malloc)
+ * what an RTM_GETLINK dump tells us about an interface
  */
-int
-netsnmp_arch_interface_container_load(netsnmp_container* container,
-                                      u_int load_flags)
+struct _if_link {
+    oid             index;
+    char            name[IF_NAMESIZE];
+    unsigned int    flags;
+    unsigned int    mtu;
+    int             type;           /* ARPHRD_xxx */
+    u_char          addr[IFHWADDRLEN];
+    int             has_stats;
+    uintmax_t       rx_bytes, rx_packets, rx_errors, rx_dropped, multicast;
+    uintmax_t       tx_bytes, tx_packets, tx_errors, tx_dropped, collisions;
+    int             has_carrier_changes;
+    unsigned int    carrier_changes;
+};
+
+/*
+ * Asking the driver for the link speed is the most expensive part of
+ * loading an interface, and the speed only changes along with the
+ * carrier. So remember it per interface, and ask again only if the
+ * kernel reports a carrier change (or the entry is getting old, for
+ * bonds and the like whose speed changes with their slaves).
+ */
+#define IF_SPEED_CACHE_BUCKETS  64
+#define IF_SPEED_CACHE_MAX_AGE  60      /* seconds */
+
+struct _if_speed {
+    oid                 index;
+    unsigned int        carrier_changes;
+    unsigned long long  defaultspeed;
+    unsigned long long  speed;
+    time_t              when;
+    unsigned int        generation;
+    struct _if_speed   *next;
+};
+static struct _if_speed *_if_speed_cache[IF_SPEED_CACHE_BUCKETS];
+static unsigned int      _if_speed_generation;
+
+/**
+ * @internal
+ */
+static unsigned long long
+_arch_interface_speed_get(int fd, netsnmp_interface_entry *entry,
+                          const struct _if_link *link,
+                          unsigned long long defaultspeed)
 {
-    FILE           *devin;
-    char            line[256];
-    netsnmp_interface_entry *entry = NULL;
-    static char     scan_expected = 0;
-    int             fd;
-    int             interfaces = 0;
-    struct ifconf   ifc;
-#ifdef NETSNMP_ENABLE_IPV6
-    netsnmp_container *addr_container;
-#endif
+    struct _if_speed *sp;
+    struct timeval    now;
 
-    DEBUGMSGTL(("access:interface:container:arch", "load (flags %x)\n",
-                load_flags));
+    if ((NULL == link) || !link->has_carrier_changes)
+        return netsnmp_linux_interface_get_if_speed(fd, entry->name,
+                                                    defaultspeed);
 
-    if (NULL == container) {
-        snmp_log(LOG_ERR, "no container specified/found for interface\n");
-        return -1;
+    netsnmp_get_monotonic_clock(&now);
+    for (sp = _if_speed_cache[entry->index % IF_SPEED_CACHE_BUCKETS]; sp;
+         sp = sp->next)
+        if (sp->index == entry->index)
+            break;
+    if (NULL == sp) {
+        sp = SNMP_MALLOC_TYPEDEF(struct _if_speed);
+        if (NULL == sp)
+            return netsnmp_linux_interface_get_if_speed(fd, entry->name,
+                                                        defaultspeed);
+        sp->index = entry->index;
+        sp->next = _if_speed_cache[entry->index % IF_SPEED_CACHE_BUCKETS];
+        _if_speed_cache[entry->index % IF_SPEED_CACHE_BUCKETS] = sp;
     }
-
-    if (!(devin = fopen("/proc/net/dev", "r"))) {
-        DEBUGMSGTL(("access:interface",
-                    "Failed to load Interface Table (linux1)\n"));
-        snmp_log_perror("interface_linux: cannot open /proc/net/dev");
-        return -2;
+    else if ((sp->carrier_changes == link->carrier_changes) &&
+             (sp->defaultspeed == defaultspeed) &&
+             (now.tv_sec - sp->when < IF_SPEED_CACHE_MAX_AGE)) {
+        sp->generation = _if_speed_generation;
+        return sp->speed;
     }
 
-    /*
-     * create socket for ioctls
-     */
-    fd = socket(AF_INET, SOCK_DGRAM, 0);
-    if(fd < 0) {
-        snmp_log_perror("interface_linux: could not create socket");
-        fclose(devin);
-        return -2;
+    sp->speed = netsnmp_linux_interface_get_if_speed(fd, entry->name,
+                                                     defaultspeed);
+    sp->carrier_changes = link->carrier_changes;
+    sp->defaultspeed = defaultspeed;
+    sp->when = now.tv_sec;
+    sp->generation = _if_speed_generation;
+    return sp->speed;
+}
+
+/**
+ * @internal
+ * forget the speed of interfaces that didn't show up in the last load
+ */
+static void
+_arch_interface_speed_cache_prune(void)
+{
+    struct _if_speed **spp, *sp;
+    int                i;
+
+    for (i = 0; i < IF_SPEED_CACHE_BUCKETS; i++) {
+        for (spp = &_if_speed_cache[i]; (sp = *spp) != NULL; ) {
+            if (sp->generation != _if_speed_generation) {
+                *spp = sp->next;
+                free(sp);
+            }
+            else
+                spp = &sp->next;
+        }
     }
+}
 
-#ifdef NETSNMP_ENABLE_IPV6
-    /*
-     * get ipv6 addresses
-     */
-    addr_container = netsnmp_access_ipaddress_container_load(NULL, 0);
-#endif
+#ifdef SUPPORT_RTM_GETLINK
+/**
+ * @internal
+ * fill link from an RTM_NEWLINK or RTM_DELLINK message
+ *
+ * @retval 1 link filled in
+ * @retval 0 not an interface message
+ */
+static int
+_arch_interface_link_parse(struct nlmsghdr *h, struct _if_link *link)
+{
+    struct ifinfomsg *ifi;
+    struct rtattr  *rta;
+    int             alen;
+
+    if (((RTM_NEWLINK != h->nlmsg_type) && (RTM_DELLINK != h->nlmsg_type)) ||
+        (h->nlmsg_len < NLMSG_LENGTH(sizeof(*ifi))))
+        return 0;
+
+    ifi = (struct ifinfomsg *) NLMSG_DATA(h);
+    if (AF_UNSPEC != ifi->ifi_family)
+        return 0;               /* e.g. AF_BRIDGE port messages */
+
+    memset(link, 0, sizeof(*link));
+    link->index = ifi->ifi_index;
+    link->flags = ifi->ifi_flags & 0xffff; /* as SIOCGIFFLAGS */
+    link->type = ifi->ifi_type;
+
+    alen = IFLA_PAYLOAD(h);
+    for (rta = IFLA_RTA(ifi); RTA_OK(rta, alen); rta = RTA_NEXT(rta, alen)) {
+        switch (rta->rta_type) {
+        case IFLA_IFNAME:
+            strlcpy(link->name, (char *) RTA_DATA(rta),
+                    SNMP_MIN(sizeof(link->name), RTA_PAYLOAD(rta)));
+            break;
+        case IFLA_MTU:
+            if (RTA_PAYLOAD(rta) >= sizeof(__u32))
+                link->mtu = *(__u32 *) RTA_DATA(rta);
+            break;
+        case IFLA_ADDRESS:
+            memcpy(link->addr, RTA_DATA(rta),
+                   SNMP_MIN(sizeof(link->addr), RTA_PAYLOAD(rta)));
+            break;
+        case IFLA_STATS64: {
+            struct rtnl_link_stats64 st;
 
-    /*
-     * Read the first two lines of the file, containing the header
-     * This indicates which version of the kernel we're working with,
-     * and hence which statistics are actually available.
-     *
-     * Wes originally suggested parsing the field names in this header
-     * to detect the position of individual fields directly,
-     * but I suspect this is probably more trouble than it's worth.
-     */
-    NETSNMP_IGNORE_RESULT(fgets(line, sizeof(line), devin));
-    NETSNMP_IGNORE_RESULT(fgets(line, sizeof(line), devin));
-
-    if( 0 == scan_expected ) {
-        if (strstr(line, "compressed")) {
-            scan_expected = 10;
-            DEBUGMSGTL(("access:interface",
-                        "using linux 2.2 kernel /proc/net/dev\n"));
-        } else {
-            scan_expected = 5;
-            DEBUGMSGTL(("access:interface",
-                        "using linux 2.0 kernel /proc/net/dev\n"));
+            /*
+             * counters as /proc/net/dev shows them
+             */
+            memset(&st, 0, sizeof(st));
+            memcpy(&st, RTA_DATA(rta), SNMP_MIN(sizeof(st), RTA_PAYLOAD(rta)));
+            link->rx_bytes = st.rx_bytes;
+            link->rx_packets = st.rx_packets;
+            link->rx_errors = st.rx_errors;
+            link->rx_dropped = st.rx_dropped + st.rx_missed_errors;
+            link->multicast = st.multicast;
+            link->tx_bytes = st.tx_bytes;
+            link->tx_packets = st.tx_packets;
+            link->tx_errors = st.tx_errors;
+            link->tx_dropped = st.tx_dropped;
+            link->collisions = st.collisions;
+            link->has_stats = 1;
+            break;
+        }
+        case IFLA_CARRIER_CHANGES:
+            if (RTA_PAYLOAD(rta) >= sizeof(__u32)) {
+                link->carrier_changes = *(__u32 *) RTA_DATA(rta);
+                link->has_carrier_changes = 1;
+            }
+            break;
         }
     }
 
-    interfaces = netsnmp_access_ipaddress_ioctl_get_interface_count(fd, &ifc);
-    if (interfaces < 0) {
-        snmp_log(LOG_ERR,"get interface count failed\n");
-        fclose(devin);
-        close(fd);
-        return -2;
+    return 1;
+}
+
+/**
+ * @internal
+ * get all interfaces with one RTM_GETLINK dump
+ *
+ * @retval NULL  netlink not usable, *count is not set
+ * @retval !NULL array of *count interfaces, to be freed by the caller
+ */
+static struct _if_link *
+_arch_interface_links_get(int *count)
+{
+    struct {
+        struct nlmsghdr  n;
+        struct ifinfomsg i;
+    }               req;
+    struct sockaddr_nl nladdr;
+    struct _if_link *links, *tmp;
+    struct nlmsghdr *h;
+    char            buf[32768];
+    int             nl, len, n = 0, size = 64, done = 0;
+
+    nl = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
+    if (nl < 0) {
+        DEBUGMSGTL(("access:interface:container:arch",
+                    "netlink socket: %s\n", strerror(errno)));
+        return NULL;
     }
-    netsnmp_assert(NULL != ifc.ifc_buf);
 
+    memset(&req, 0, sizeof(req));
+    req.n.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+    req.n.nlmsg_type = RTM_GETLINK;
+    req.n.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.n.nlmsg_seq = 1;
+    req.i.ifi_family = AF_UNSPEC;
+
+    memset(&nladdr, 0, sizeof(nladdr));
+    nladdr.nl_family = AF_NETLINK;
+    links = (struct _if_link *) calloc(size, sizeof(*links));
+    if ((NULL == links) ||
+        (sendto(nl, &req, req.n.nlmsg_len, 0, (struct sockaddr *) &nladdr,
+                sizeof(nladdr)) < 0))
+        goto fail;
+
+    while (!done) {
+        len = recv(nl, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (EINTR == errno)
+                continue;
+            goto fail;
+        }
+        if (0 == len)
+            goto fail;
 
-    /*
-     * The rest of the file provides the statistics for each interface.
-     * Read in each line in turn, isolate the interface name
-     *   and retrieve (or create) the corresponding data structure.
-     */
-    while (fgets(line, sizeof(line), devin)) {
-        char           *stats, *ifstart = line;
-        u_int           flags;
-        oid             if_index;
+        for (h = (struct nlmsghdr *) buf; NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            if (NLMSG_DONE == h->nlmsg_type) {
+                done = 1;
+                break;
+            }
+            if (NLMSG_ERROR == h->nlmsg_type)
+                goto fail;
+
+            if (n == size) {
+                tmp = (struct _if_link *) realloc(links,
+                                                  2 * size * sizeof(*links));
+                if (NULL == tmp)
+                    goto fail;
+                links = tmp;
+                size *= 2;
+            }
+            if (_arch_interface_link_parse(h, &links[n]) &&
+                links[n].name[0])
+                ++n;
+        }
+    }
 
-        flags = 0;
-        if (line[strlen(line) - 1] == '\n')
-            line[strlen(line) - 1] = '\0';
+    close(nl);
+    DEBUGMSGTL(("access:interface:container:arch",
+                "RTM_GETLINK dump: %d interfaces\n", n));
+    *count = n;
+    return links;
+
+  fail:
+    DEBUGMSGTL(("access:interface:container:arch",
+                "RTM_GETLINK dump failed\n"));
+    close(nl);
+    free(links);
+    return NULL;
+}
+#endif /* SUPPORT_RTM_GETLINK */
 
-        while (*ifstart && *ifstart == ' ')
-            ifstart++;
+/**
+ * @internal
+ * set the counters from link, or else from the /proc/net/dev line
+ */
+static void
+_arch_interface_stats_get(netsnmp_interface_entry *entry,
+                          const struct _if_link *link,
+                          char *stats, int scan_expected)
+{
+    if (NULL == link)
+        _parse_stats(entry, stats, scan_expected);
+    else if (link->has_stats) {
+        entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_HAS_BYTES |
+            NETSNMP_INTERFACE_FLAGS_HAS_DROPS |
+            NETSNMP_INTERFACE_FLAGS_HAS_MCAST_PKTS |
+            NETSNMP_INTERFACE_FLAGS_HAS_HIGH_SPEED |
+            NETSNMP_INTERFACE_FLAGS_HAS_HIGH_BYTES |
+            NETSNMP_INTERFACE_FLAGS_HAS_HIGH_PACKETS;
+        _set_stats(entry, link->rx_bytes, link->rx_packets,
+                   link->rx_errors, link->rx_dropped, link->multicast,
+                   link->tx_bytes, link->tx_packets, link->tx_errors,
+                   link->tx_dropped, link->collisions);
+    }
+}
 
-        if ((!*ifstart) || ((stats = strrchr(ifstart, ':')) == NULL)) {
-            snmp_log(LOG_ERR,
-                     "interface data format error 1, line ==|%s|\n", line);
-            continue;
-        }
-        if ((scan_expected == 10) && ((stats - line) < 6)) {
-            snmp_log(LOG_ERR,
-                     "interface data format error 2 (%d < 6), line ==|%s|\n",
-                     (int)(stats - line), line);
-        }
+/**
+ * @internal
+ * create the entry for one interface and add it to the container
+ *
+ * Information comes from link if we have it, otherwise from ioctls and
+ * the /proc/net/dev statistics line.
+ *
+ * @retval  0 success (or interface skipped)
+ * @retval -3 could not create entry (probably malloc)
+ */
+static int
+_arch_interface_entry_load(netsnmp_container *container, u_int load_flags,
+                           int fd, struct ifconf *ifc,
+                           netsnmp_container *addr_container,
+                           const char *name, const struct _if_link *link,
+                           char *stats, int scan_expected)
+{
+    netsnmp_interface_entry *entry;
+    u_int           flags = 0;
+    oid             if_index = 0;
+    int             type;
 
-        DEBUGMSGTL(("9:access:ifcontainer", "processing '%s'\n", ifstart));
+    if (!netsnmp_access_interface_include(name))
+        return 0;
 
-        /*
-         * get index via ioctl.
-         * If we've met this interface before, use the same index.
-         * Otherwise find an unused index value and use that.
-         */
-        *stats++ = 0; /* null terminate name */
+    if (netsnmp_access_interface_max_reached(name))
+        /* we may need to stop tracking ifaces if a max was set */
+        return 0;
 
-	if (!netsnmp_access_interface_include(ifstart))
-		continue;
+    if (NULL != link)
+        if_index = link->index;
 
-	if (netsnmp_access_interface_max_reached(ifstart))
-		/* we may need to stop tracking ifaces if a max was set */
-		continue;
+    if (load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_STATS_ONLY) {
         /*
-         * set address type flags.
-         * the only way I know of to check an interface for
-         * ip version is to look for ip addresses. If anyone
-         * knows a better way, put it here!
+         * only the counters and the interface state; the caller keeps
+         * track of everything else itself.
          */
+        entry = netsnmp_access_interface_entry_create(name, if_index);
+        if(NULL == entry)
+            return -3;
+        if (NULL != link)
+            netsnmp_access_interface_ioctl_flags_update(entry, link->flags);
+        else
+            netsnmp_access_interface_ioctl_flags_get(fd, entry);
+        _arch_interface_stats_get(entry, link, stats, scan_expected);
+        CONTAINER_INSERT(container, entry);
+        return 0;
+    }
+
+    /*
+     * set address type flags.
+     * the only way I know of to check an interface for
+     * ip version is to look for ip addresses. If anyone
+     * knows a better way, put it here!
+     */
+    if (0 == if_index)
+        if_index = netsnmp_arch_interface_index_find(name);
+    if (NULL == ifc->ifc_buf)
+        _arch_interface_ip_flags_get(fd, name, if_index, &flags);
+    else {
 #ifdef NETSNMP_ENABLE_IPV6
-        if_index = netsnmp_arch_interface_index_find(ifstart);
         _arch_interface_has_ipv6(if_index, &flags, addr_container);
 #endif
-        netsnmp_access_interface_ioctl_has_ipv4(fd, ifstart, 0, &flags, &ifc);
+        netsnmp_access_interface_ioctl_has_ipv4(fd, name, 0, &flags, ifc);
+    }
 
-        /*
-         * do we only want one address type?
-         */
-        if (((load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_IP4_ONLY) &&
-             ((flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV4) == 0)) ||
-            ((load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_IP6_ONLY) &&
-             ((flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV6) == 0))) {
-            DEBUGMSGTL(("9:access:ifcontainer",
-                        "interface '%s' excluded by ip version\n",
-                        ifstart));
-            continue;
-        }
+    /*
+     * do we only want one address type?
+     */
+    if (((load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_IP4_ONLY) &&
+         ((flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV4) == 0)) ||
+        ((load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_IP6_ONLY) &&
+         ((flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV6) == 0))) {
+        DEBUGMSGTL(("9:access:ifcontainer",
+                    "interface '%s' excluded by ip version\n",
+                    name));
+        return 0;
+    }
 
-        entry = netsnmp_access_interface_entry_create(ifstart, 0);
-        if(NULL == entry) {
-#ifdef NETSNMP_ENABLE_IPV6
-            netsnmp_access_ipaddress_container_free(addr_container, 0);
-#endif
-            netsnmp_access_interface_container_free(container,
-                                                    NETSNMP_ACCESS_INTERFACE_FREE_NOFLAGS);
-            fclose(devin);
-            close(fd);
-            free(ifc.ifc_buf);
-            return -3;
-        }
-        entry->ns_flags = flags; /* initial flags; we'll set more later */
+    entry = netsnmp_access_interface_entry_create(name, if_index);
+    if(NULL == entry)
+        return -3;
+    entry->ns_flags = flags; /* initial flags; we'll set more later */
 
 #ifdef HAVE_PCI_LOOKUP_NAME
 	_arch_interface_description_get(entry);
 #endif
 
 
+    if (NULL != link) {
+        /*
+         * RTM_GETLINK told us, no need for ioctls
+         */
+        entry->paddr = (char*)malloc(IFHWADDRLEN);
+        if (NULL != entry->paddr) {
+            memcpy(entry->paddr, link->addr, IFHWADDRLEN);
+            entry->paddr_len = IFHWADDRLEN;
+        }
+        type = netsnmp_access_interface_ioctl_arphrd_type(link->type);
+        if (0 != type)
+            entry->type = type;
+    }
+    else {
         /*
          * use ioctls for some stuff
          *  (ignore rc, so we get as much info as possible)
          */
         netsnmp_access_interface_ioctl_physaddr_get(fd, entry);
+    }
 
-        /*
-         * physaddr should have set type. make some guesses (based
-         * on name) if not.
-         */
-        if(0 == entry->type) {
-            typedef struct _match_if {
-               int             mi_type;
-               const char     *mi_name;
-            }              *pmatch_if, match_if;
-            
-            static match_if lmatch_if[] = {
-                {IANAIFTYPE_SOFTWARELOOPBACK, "lo"},
-                {IANAIFTYPE_ETHERNETCSMACD, "eth"},
-                {IANAIFTYPE_ETHERNETCSMACD, "vmnet"},
-                {IANAIFTYPE_ISO88025TOKENRING, "tr"},
-                {IANAIFTYPE_FASTETHER, "feth"},
-                {IANAIFTYPE_GIGABITETHERNET,"gig"},
-                {IANAIFTYPE_INFINIBAND,"ib"},
-                {IANAIFTYPE_PPP, "ppp"},
-                {IANAIFTYPE_SLIP, "sl"},
-                {IANAIFTYPE_TUNNEL, "sit"},
-                {IANAIFTYPE_BASICISDN, "ippp"},
-                {IANAIFTYPE_PROPVIRTUAL, "bond"}, /* Bonding driver find fastest slave */
-                {IANAIFTYPE_PROPVIRTUAL, "vad"},  /* ANS driver - ?speed? */
-                {0, NULL}                  /* end of list */
-            };
-
-            int             len;
-            register pmatch_if pm;
-            
-            for (pm = lmatch_if; pm->mi_name; pm++) {
-                len = strlen(pm->mi_name);
-                if (0 == strncmp(entry->name, pm->mi_name, len)) {
-                    entry->type = pm->mi_type;
-                    break;
-                }
+    /*
+     * physaddr should have set type. make some guesses (based
+     * on name) if not.
+     */
+    if(0 == entry->type) {
+        typedef struct _match_if {
+           int             mi_type;
+           const char     *mi_name;
+        }              *pmatch_if, match_if;
+        
+        static match_if lmatch_if[] = {
+            {IANAIFTYPE_SOFTWARELOOPBACK, "lo"},
+            {IANAIFTYPE_ETHERNETCSMACD, "eth"},
+            {IANAIFTYPE_ETHERNETCSMACD, "vmnet"},
+            {IANAIFTYPE_ISO88025TOKENRING, "tr"},
+            {IANAIFTYPE_FASTETHER, "feth"},
+            {IANAIFTYPE_GIGABITETHERNET,"gig"},
+            {IANAIFTYPE_INFINIBAND,"ib"},
+            {IANAIFTYPE_PPP, "ppp"},
+            {IANAIFTYPE_SLIP, "sl"},
+            {IANAIFTYPE_TUNNEL, "sit"},
+            {IANAIFTYPE_BASICISDN, "ippp"},
+            {IANAIFTYPE_PROPVIRTUAL, "bond"}, /* Bonding driver find fastest slave */
+            {IANAIFTYPE_PROPVIRTUAL, "vad"},  /* ANS driver - ?speed? */
+            {0, NULL}                  /* end of list */
+        };
+
+        int             len;
+        register pmatch_if pm;
+        
+        for (pm = lmatch_if; pm->mi_name; pm++) {
+            len = strlen(pm->mi_name);
+            if (0 == strncmp(entry->name, pm->mi_name, len)) {
+                entry->type = pm->mi_type;
+                break;
             }
-            if(NULL == pm->mi_name)
-                entry->type = IANAIFTYPE_OTHER;
         }
+        if(NULL == pm->mi_name)
+            entry->type = IANAIFTYPE_OTHER;
+    }
 
-        /*
-         * interface identifier is specified based on physaddr and type
-         */
-        switch (entry->type) {
-        case IANAIFTYPE_ETHERNETCSMACD:
-        case IANAIFTYPE_ETHERNET3MBIT:
-        case IANAIFTYPE_FASTETHER:
-        case IANAIFTYPE_FASTETHERFX:
-        case IANAIFTYPE_GIGABITETHERNET:
-        case IANAIFTYPE_FDDI:
-        case IANAIFTYPE_ISO88025TOKENRING:
-            if (NULL != entry->paddr && ETH_ALEN != entry->paddr_len)
-                break;
+    /*
+     * interface identifier is specified based on physaddr and type
+     */
+    switch (entry->type) {
+    case IANAIFTYPE_ETHERNETCSMACD:
+    case IANAIFTYPE_ETHERNET3MBIT:
+    case IANAIFTYPE_FASTETHER:
+    case IANAIFTYPE_FASTETHERFX:
+    case IANAIFTYPE_GIGABITETHERNET:
+    case IANAIFTYPE_FDDI:
+    case IANAIFTYPE_ISO88025TOKENRING:
+        if (NULL != entry->paddr && ETH_ALEN != entry->paddr_len)
+            break;
 
-            entry->v6_if_id_len = entry->paddr_len + 2;
-            memcpy(entry->v6_if_id, entry->paddr, 3);
-            memcpy(entry->v6_if_id + 5, entry->paddr + 3, 3);
-            entry->v6_if_id[0] ^= 2;
-            entry->v6_if_id[3] = 0xFF;
-            entry->v6_if_id[4] = 0xFE;
+        entry->v6_if_id_len = entry->paddr_len + 2;
+        memcpy(entry->v6_if_id, entry->paddr, 3);
+        memcpy(entry->v6_if_id + 5, entry->paddr + 3, 3);
+        entry->v6_if_id[0] ^= 2;
+        entry->v6_if_id[3] = 0xFF;
+        entry->v6_if_id[4] = 0xFE;
 
-            entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_HAS_V6_IFID;
-            break;
+        entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_HAS_V6_IFID;
+        break;
 
-        case IANAIFTYPE_SOFTWARELOOPBACK:
-            entry->v6_if_id_len = 0;
-            entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_HAS_V6_IFID;
-            break;
-        }
+    case IANAIFTYPE_SOFTWARELOOPBACK:
+        entry->v6_if_id_len = 0;
+        entry->ns_flags |= NETSNMP_INTERFACE_FLAGS_HAS_V6_IFID;
+        break;
+    }
 
-        if (IANAIFTYPE_ETHERNETCSMACD == entry->type) {
-            unsigned long long speed;
-            unsigned long long defaultspeed = NOMINAL_LINK_SPEED;
-            if (!(entry->os_flags & IFF_RUNNING)) {
-                /*
-                 * use speed 0 if the if speed cannot be determined *and* the
-                 * interface is down
-                 */
-                defaultspeed = 0;
-            }
-            speed = netsnmp_linux_interface_get_if_speed(fd,
-                    entry->name, defaultspeed);
-            if (speed > 0xffffffffL) {
-                entry->speed = 0xffffffff;
-            } else
-                entry->speed = speed;
-            entry->speed_high = speed / 1000000LL;
+    if (IANAIFTYPE_ETHERNETCSMACD == entry->type) {
+        unsigned long long speed;
+        unsigned long long defaultspeed = NOMINAL_LINK_SPEED;
+        if (!(entry->os_flags & IFF_RUNNING)) {
+            /*
+             * use speed 0 if the if speed cannot be determined *and* the
+             * interface is down
+             */
+            defaultspeed = 0;
         }
+        speed = _arch_interface_speed_get(fd, entry, link, defaultspeed);
+        if (speed > 0xffffffffL) {
+            entry->speed = 0xffffffff;
+        } else
+            entry->speed = speed;
+        entry->speed_high = speed / 1000000LL;
+    }
 #ifdef APPLIED_PATCH_836390   /* xxx-rks ifspeed fixes */
-        else if (IANAIFTYPE_PROPVIRTUAL == entry->type)
-            entry->speed = _get_bonded_if_speed(entry);
+    else if (IANAIFTYPE_PROPVIRTUAL == entry->type)
+        entry->speed = _get_bonded_if_speed(entry);
 #endif
-        else
-            netsnmp_access_interface_entry_guess_speed(entry);
-        
+    else
+        netsnmp_access_interface_entry_guess_speed(entry);
+    
+    if (NULL != link) {
+        netsnmp_access_interface_ioctl_flags_update(entry, link->flags);
+        entry->mtu = link->mtu;
+    }
+    else {
         netsnmp_access_interface_ioctl_flags_get(fd, entry);
 
         netsnmp_access_interface_ioctl_mtu_get(fd, entry);
+    }
+
+    /*
+     * Zero speed means link problem.
+     * - i'm not sure this is always true...
+     */
+    if((entry->speed == 0) && (entry->os_flags & IFF_UP)) {
+        entry->os_flags &= ~IFF_RUNNING;
+    }
+
+    /*
+     * check for promiscuous mode.
+     *  NOTE: there are 2 ways to set promiscuous mode in Linux
+     *  (kernels later than 2.2.something) - using ioctls and
+     *  using setsockopt. The ioctl method tested here does not
+     *  detect if an interface was set using setsockopt. google
+     *  on IFF_PROMISC and linux to see lots of arguments about it.
+     */
+    if(entry->os_flags & IFF_PROMISC) {
+        entry->promiscuous = 1; /* boolean */
+    }
+
+    /*
+     * hardcoded max packet size
+     * (see ip_frag_reasm: if(len > 65535) goto out_oversize;)
+     */
+    entry->reasm_max_v4 = entry->reasm_max_v6 = 65535;
+    entry->ns_flags |= 
+        NETSNMP_INTERFACE_FLAGS_HAS_V4_REASMMAX |
+        NETSNMP_INTERFACE_FLAGS_HAS_V6_REASMMAX;
+
+    netsnmp_access_interface_entry_overrides(entry);
+
+    if (! (load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_NO_STATS))
+        _arch_interface_stats_get(entry, link, stats, scan_expected);
+
+    if (flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV4)
+        _arch_interface_flags_v4_get(entry);
+
+#ifdef NETSNMP_ENABLE_IPV6
+    if (flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV6)
+        _arch_interface_flags_v6_get(entry);
+#endif /* NETSNMP_ENABLE_IPV6 */
+
+    /*
+     * add to container
+     */
+    CONTAINER_INSERT(container, entry);
+
+    return 0;
+}
+
+/**
+ * @internal
+ * load the interfaces in links, or from /proc/net/dev if links is NULL
+ *
+ * @retval  0 success
+ * @retval -2 could not open /proc/net/dev
+ * @retval -3 could not create entry (probably malloc)
+ */
+static int
+_arch_interface_load(netsnmp_container* container, u_int load_flags,
+                     const struct _if_link *links, int nlinks)
+{
+    FILE           *devin = NULL;
+    char            line[256];
+    static char     scan_expected = 0;
+    int             fd, i, rc = 0;
+    int             interfaces = 0;
+    struct ifconf   ifc;
+    netsnmp_container *addr_container = NULL;
+
+    if ((NULL == links) && !(devin = fopen("/proc/net/dev", "r"))) {
+        DEBUGMSGTL(("access:interface",
+                    "Failed to load Interface Table (linux1)\n"));
+        snmp_log_perror("interface_linux: cannot open /proc/net/dev");
+        return -2;
+    }
+
+    /*
+     * create socket for ioctls
+     */
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0) {
+        snmp_log_perror("interface_linux: could not create socket");
+        if (devin)
+            fclose(devin);
+        return -2;
+    }
 
+    /*
+     * addresses are only needed to tell ipv4 from ipv6 interfaces. For a
+     * single interface (a link notification), _arch_interface_entry_load
+     * looks up the addresses of that interface alone.
+     */
+    memset(&ifc, 0, sizeof(ifc));
+    if (!(load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_STATS_ONLY) &&
+        ((NULL == links) || (nlinks > 1))) {
+#ifdef NETSNMP_ENABLE_IPV6
         /*
-         * Zero speed means link problem.
-         * - i'm not sure this is always true...
+         * get ipv6 addresses
          */
-        if((entry->speed == 0) && (entry->os_flags & IFF_UP)) {
-            entry->os_flags &= ~IFF_RUNNING;
+        addr_container = netsnmp_access_ipaddress_container_load(NULL, 0);
+#endif
+
+        interfaces =
+            netsnmp_access_ipaddress_ioctl_get_interface_count(fd, &ifc);
+        if (interfaces < 0) {
+            snmp_log(LOG_ERR,"get interface count failed\n");
+#ifdef NETSNMP_ENABLE_IPV6
+            netsnmp_access_ipaddress_container_free(addr_container, 0);
+#endif
+            if (devin)
+                fclose(devin);
+            close(fd);
+            return -2;
         }
+        netsnmp_assert(NULL != ifc.ifc_buf);
+    }
 
+    if (NULL != links) {
+        for (i = 0; (0 == rc) && (i < nlinks); i++)
+            rc = _arch_interface_entry_load(container, load_flags, fd, &ifc,
+                                            addr_container, links[i].name,
+                                            &links[i], NULL, 0);
+    }
+    else {
         /*
-         * check for promiscuous mode.
-         *  NOTE: there are 2 ways to set promiscuous mode in Linux
-         *  (kernels later than 2.2.something) - using ioctls and
-         *  using setsockopt. The ioctl method tested here does not
-         *  detect if an interface was set using setsockopt. google
-         *  on IFF_PROMISC and linux to see lots of arguments about it.
+         * Read the first two lines of the file, containing the header
+         * This indicates which version of the kernel we're working with,
+         * and hence which statistics are actually available.
+         *
+         * Wes originally suggested parsing the field names in this header
+         * to detect the position of individual fields directly,
+         * but I suspect this is probably more trouble than it's worth.
          */
-        if(entry->os_flags & IFF_PROMISC) {
-            entry->promiscuous = 1; /* boolean */
+        NETSNMP_IGNORE_RESULT(fgets(line, sizeof(line), devin));
+        NETSNMP_IGNORE_RESULT(fgets(line, sizeof(line), devin));
+
+        if( 0 == scan_expected ) {
+            if (strstr(line, "compressed")) {
+                scan_expected = 10;
+                DEBUGMSGTL(("access:interface",
+                            "using linux 2.2 kernel /proc/net/dev\n"));
+            } else {
+                scan_expected = 5;
+                DEBUGMSGTL(("access:interface",
+                            "using linux 2.0 kernel /proc/net/dev\n"));
+            }
         }
 
         /*
-         * hardcoded max packet size
-         * (see ip_frag_reasm: if(len > 65535) goto out_oversize;)
+         * The rest of the file provides the statistics for each interface.
+         * Read in each line in turn, isolate the interface name
+         *   and retrieve (or create) the corresponding data structure.
          */
-        entry->reasm_max_v4 = entry->reasm_max_v6 = 65535;
-        entry->ns_flags |= 
-            NETSNMP_INTERFACE_FLAGS_HAS_V4_REASMMAX |
-            NETSNMP_INTERFACE_FLAGS_HAS_V6_REASMMAX;
+        while ((0 == rc) && fgets(line, sizeof(line), devin)) {
+            char           *stats, *ifstart = line;
 
-        netsnmp_access_interface_entry_overrides(entry);
+            if (line[strlen(line) - 1] == '\n')
+                line[strlen(line) - 1] = '\0';
 
-        if (! (load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_NO_STATS))
-            _parse_stats(entry, stats, scan_expected);
+            while (*ifstart && *ifstart == ' ')
+                ifstart++;
 
-        if (flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV4)
-            _arch_interface_flags_v4_get(entry);
+            if ((!*ifstart) || ((stats = strrchr(ifstart, ':')) == NULL)) {
+                snmp_log(LOG_ERR,
+                         "interface data format error 1, line ==|%s|\n", line);
+                continue;
+            }
+            if ((scan_expected == 10) && ((stats - line) < 6)) {
+                snmp_log(LOG_ERR,
+                         "interface data format error 2 (%d < 6), line ==|%s|\n",
+                         (int)(stats - line), line);
+            }
 
-#ifdef NETSNMP_ENABLE_IPV6
-        if (flags & NETSNMP_INTERFACE_FLAGS_HAS_IPV6)
-            _arch_interface_flags_v6_get(entry);
-#endif /* NETSNMP_ENABLE_IPV6 */
+            DEBUGMSGTL(("9:access:ifcontainer", "processing '%s'\n", ifstart));
 
-        /*
-         * add to container
-         */
-        CONTAINER_INSERT(container, entry);
+            *stats++ = 0; /* null terminate name */
+
+            rc = _arch_interface_entry_load(container, load_flags, fd, &ifc,
+                                            addr_container, ifstart, NULL,
+                                            stats, scan_expected);
+        }
+        fclose(devin);
     }
+
 #ifdef NETSNMP_ENABLE_IPV6
-    netsnmp_access_ipaddress_container_free(addr_container, 0);
+    if (NULL != addr_container)
+        netsnmp_access_ipaddress_container_free(addr_container, 0);
 #endif
-    fclose(devin);
     close(fd);
     free(ifc.ifc_buf);
+
+    return rc;
+}
+
+/*
+ *
+ * @retval  0 success
+ * @retval -1 no container specified
+ * @retval -2 could not open /proc/net/dev
+ * @retval -3 could not create entry (probably malloc)
+ */
+int
+netsnmp_arch_interface_container_load(netsnmp_container* container,
+                                      u_int load_flags)
+{
+    struct _if_link *links = NULL;
+    int             nlinks = 0, rc;
+
+    DEBUGMSGTL(("access:interface:container:arch", "load (flags %x)\n",
+                load_flags));
+
+    if (NULL == container) {
+        snmp_log(LOG_ERR, "no container specified/found for interface\n");
+        return -1;
+    }
+
+#ifdef SUPPORT_RTM_GETLINK
+    /*
+     * one RTM_GETLINK dump gives names, indexes, flags, mtu, hardware
+     * addresses and 64 bit counters of all interfaces. Fall back to
+     * /proc/net/dev and ioctls if that doesn't work.
+     */
+    links = _arch_interface_links_get(&nlinks);
+#endif
+
+    if (load_flags & NETSNMP_ACCESS_INTERFACE_LOAD_STATS_ONLY)
+        rc = _arch_interface_load(container, load_flags, links, nlinks);
+    else {
+        ++_if_speed_generation;
+        rc = _arch_interface_load(container, load_flags, links, nlinks);
+        _arch_interface_speed_cache_prune();
+    }
+    free(links);
+
+    return rc;
+}
+
+#ifdef SUPPORT_RTM_GETLINK
+static int      _if_monitor_fd = -1;
+static NetsnmpAccessInterfaceChange *_if_monitor_changed;
+static void    *_if_monitor_data;
+
+/**
+ * @internal
+ * pass link notifications on to the monitor callback
+ */
+static void
+_arch_interface_monitor_read(int fd, void *unused)
+{
+    netsnmp_container *container;
+    netsnmp_interface_entry *entry;
+    struct _if_link link;
+    struct nlmsghdr *h;
+    char            buf[16384];
+    int             len;
+
+    do {
+        len = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    } while ((len < 0) && (EINTR == errno));
+    if (len < 0) {
+        if (EAGAIN == errno)
+            return;
+        /*
+         * the kernel dropped notifications (ENOBUFS). Nothing is known
+         * about what we missed, so have the caller start over.
+         */
+        snmp_log(LOG_WARNING, "interface netlink buffer overrun\n");
+        _if_monitor_changed(0, NULL, _if_monitor_data);
+        return;
+    }
+
+    for (h = (struct nlmsghdr *) buf; NLMSG_OK(h, len);
+         h = NLMSG_NEXT(h, len)) {
+        if (!_arch_interface_link_parse(h, &link) || (0 == link.index))
+            continue;
+
+        if (RTM_DELLINK == h->nlmsg_type) {
+            DEBUGMSGTL(("access:interface:monitor",
+                        "%s (%" NETSNMP_PRIo "u) removed\n", link.name,
+                        link.index));
+            _if_monitor_changed(link.index, NULL, _if_monitor_data);
+            continue;
+        }
+
+        DEBUGMSGTL(("access:interface:monitor",
+                    "%s (%" NETSNMP_PRIo "u) changed\n", link.name,
+                    link.index));
+        container = netsnmp_access_interface_container_init(
+            NETSNMP_ACCESS_INTERFACE_INIT_NOFLAGS);
+        if (NULL == container)
+            break;
+        entry = NULL;
+        if (0 == _arch_interface_load(container, 0, &link, 1))
+            entry = netsnmp_access_interface_entry_get_by_index(container,
+                                                                link.index);
+        if (NULL != entry) {
+            CONTAINER_REMOVE(container, entry);
+            _if_monitor_changed(link.index, entry, _if_monitor_data);
+        }
+        netsnmp_access_interface_container_free(container,
+                                                NETSNMP_ACCESS_INTERFACE_FREE_NOFLAGS);
+    }
+}
+#endif /* SUPPORT_RTM_GETLINK */
+
+/**
+ * subscribe to rtnetlink link notifications
+ *
+ * @retval  0 success
+ * @retval -1 netlink not available, or already monitoring
+ */
+int
+netsnmp_arch_interface_monitor_start(NetsnmpAccessInterfaceChange *changed,
+                                     void *data)
+{
+#ifdef SUPPORT_RTM_GETLINK
+    struct sockaddr_nl sa;
+    int             fd;
+
+    if (_if_monitor_fd >= 0)
+        return -1;
+
+    fd = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
+    if (fd < 0) {
+        snmp_log_perror("interface_linux: netlink socket create error");
+        return -1;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = RTMGRP_LINK;
+    if (bind(fd, (struct sockaddr *) &sa, sizeof(sa)) < 0) {
+        snmp_log_perror("interface_linux: netlink bind failed");
+        close(fd);
+        return -1;
+    }
+
+    if (register_readfd(fd, _arch_interface_monitor_read, NULL) != 0) {
+        snmp_log(LOG_ERR, "interface_linux: error registering netlink socket\n");
+        close(fd);
+        return -1;
+    }
+
+    DEBUGMSGTL(("access:interface:monitor", "started\n"));
+    _if_monitor_fd = fd;
+    _if_monitor_changed = changed;
+    _if_monitor_data = data;
     return 0;
+#else
+    return -1;
+#endif
+}
+
+void
+netsnmp_arch_interface_monitor_stop(void)
+{
+#ifdef SUPPORT_RTM_GETLINK
+    if (_if_monitor_fd < 0)
+        return;
+
+    DEBUGMSGTL(("access:interface:monitor", "stopped\n"));
+    unregister_readfd(_if_monitor_fd);
+    close(_if_monitor_fd);
+    _if_monitor_fd = -1;
+    _if_monitor_changed = NULL;
+    _if_monitor_data = NULL;
+#endif
 }
 
 #ifndef NETSNMP_FEATURE_REMOVE_INTERFACE_ARCH_SET_ADMIN_STATUS
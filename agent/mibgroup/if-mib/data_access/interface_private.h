@@ -10,3 +10,15 @@ int netsnmp_arch_interface_container_load(struct netsnmp_container_s* container,
 oid netsnmp_arch_interface_index_find(const char *name);
 int netsnmp_arch_set_admin_status(struct netsnmp_interface_entry_s * entry,
                                   int ifAdminStatus_val);
+
+#if defined(linux)
+/*
+ * see netsnmp_access_interface_monitor_start()
+ */
+#define NETSNMP_ARCH_INTERFACE_MONITOR 1
+int netsnmp_arch_interface_monitor_start(void (*changed)(oid if_index,
+                                                         struct netsnmp_interface_entry_s *entry,
+                                                         void *data),
+                                         void *data);
+void netsnmp_arch_interface_monitor_stop(void);
+#endif
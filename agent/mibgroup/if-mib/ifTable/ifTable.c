@@ -220,6 +220,15 @@ ifTable_rowreq_ctx_init(ifTable_rowreq_ctx * rowreq_ctx,
         rowreq_ctx->data.ifentry =
             (netsnmp_interface_entry *) user_init_ctx;
 
+    if (ifTable_counters_attach(rowreq_ctx) != 0) {
+        /*
+         * the caller still owns user_init_ctx
+         */
+        if (NULL != user_init_ctx)
+            rowreq_ctx->data.ifentry = NULL;
+        return MFD_ERROR;
+    }
+
     return MFD_SUCCESS;
 }                               /* ifTable_rowreq_ctx_init */
 
@@ -237,6 +246,7 @@ ifTable_rowreq_ctx_cleanup(ifTable_rowreq_ctx * rowreq_ctx)
     /*
      * TODO:211:o: |-> Perform extra ifTable rowreq cleanup.
      */
+    ifTable_counters_detach(rowreq_ctx);
     if (NULL != rowreq_ctx->data.ifentry) {
         netsnmp_access_interface_entry_free(rowreq_ctx->data.ifentry);
         rowreq_ctx->data.ifentry = NULL;
@@ -1019,7 +1029,8 @@ ifInOctets_get(ifTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifInOctets data.
      * copy (* ifInOctets_val_ptr ) from rowreq_ctx->data
      */
-    (*ifInOctets_val_ptr) = rowreq_ctx->data.ifInOctets;
+    (*ifInOctets_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IBYTES).low;
 
     return MFD_SUCCESS;
 }                               /* ifInOctets_get */
@@ -1078,7 +1089,8 @@ ifInUcastPkts_get(ifTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifInUcastPkts data.
      * copy (* ifInUcastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifInUcastPkts_val_ptr) = rowreq_ctx->data.ifInUcastPkts;
+    (*ifInUcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IUCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifInUcastPkts_get */
@@ -1387,7 +1399,8 @@ ifOutOctets_get(ifTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifOutOctets data.
      * copy (* ifOutOctets_val_ptr ) from rowreq_ctx->data
      */
-    (*ifOutOctets_val_ptr) = rowreq_ctx->data.ifOutOctets;
+    (*ifOutOctets_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OBYTES).low;
 
     return MFD_SUCCESS;
 }                               /* ifOutOctets_get */
@@ -1447,7 +1460,8 @@ ifOutUcastPkts_get(ifTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifOutUcastPkts data.
      * copy (* ifOutUcastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifOutUcastPkts_val_ptr) = rowreq_ctx->data.ifOutUcastPkts;
+    (*ifOutUcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OUCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifOutUcastPkts_get */
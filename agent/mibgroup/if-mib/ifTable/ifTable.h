@@ -27,6 +27,7 @@ extern          "C" {
 config_require(if-mib/data_access/interface)
 config_require(if-mib/ifTable/ifTable_interface)
 config_require(if-mib/ifTable/ifTable_data_access)
+config_require(util_funcs/counter_columns)
 /*
  * conflicts with mibII/interfaces
  */
@@ -327,6 +328,7 @@ config_exclude(mibII/interfaces)
          */
         char            known_missing;
 	u_char          undo_ref_count;
+        int             counter_slot;   /* in ifTable_counters, or -1 */
 
         /*
          * storage for future expansion
@@ -21,6 +21,7 @@ netsnmp_feature_require(container_linked_list);
 #include "ifTable_defs.h"
 
 #include "ifTable_data_access.h"
+#include "mibgroup/util_funcs/counter_columns.h"
 
 #ifdef USING_IP_MIB_IPV4INTERFACETABLE_IPV4INTERFACETABLE_MODULE
 #   include "mibgroup/ip-mib/ipv4InterfaceTable/ipv4InterfaceTable.h"
@@ -49,6 +50,27 @@ static int fadeout = IFTABLE_REMOVE_MISSING_AFTER;
  * Value of interface_replace_old config option
  */
 static int replace_old = 0;
+/*
+ * Value of interface_resync config option
+ */
+static int resync = IFTABLE_RESYNC_INTERVAL;
+
+/*
+ * While we get interface change notifications, a cache reload only
+ * refreshes the counters, and everything else is reloaded every
+ * resync seconds (or when we notice we missed something).
+ */
+static netsnmp_cache *_ifTable_cache = NULL;
+static int      _monitoring = 0;
+static int      _full_reload = 1;
+static u_long   _last_full_reload = 0;
+
+/*
+ * The 64-bit counters of all rows, by column.  This is the only copy:
+ * the interface entries of the rows leave them zero.
+ */
+static netsnmp_counter_columns _ifTable_counters =
+    NETSNMP_COUNTER_COLUMNS_INIT(IFTABLE_COUNTER_COLUMNS);
 
 static void
 _delete_missing_interface(ifTable_rowreq_ctx *rowreq_ctx,
@@ -100,6 +122,11 @@ parse_interface_replace_old(const char *token, char *line)
     snmp_log(LOG_ERR, "Invalid value of interface_replace_old parameter: '%s'\n",
             line);
 }
+static void
+parse_interface_resync(const char *token, char *line)
+{
+    resync = atoi(line);
+}
 
 /**
  * initialization for ifTable data access
@@ -125,6 +152,8 @@ ifTable_init_data(ifTable_registration * ifTable_reg)
             "interface_fadeout seconds");
     snmpd_register_config_handler("interface_replace_old",
             parse_interface_replace_old, NULL, "interface_replace_old yes|no");
+    snmpd_register_config_handler("interface_resync", parse_interface_resync,
+            NULL, "interface_resync seconds");
 
     return MFD_SUCCESS;
 }                               /* ifTable_init_data */
@@ -205,6 +234,8 @@ ifTable_container_init(netsnmp_container **container_ptr_ptr,
         (NETSNMP_CACHE_DONT_AUTO_RELEASE | NETSNMP_CACHE_DONT_FREE_EXPIRED
          | NETSNMP_CACHE_DONT_FREE_BEFORE_LOAD | NETSNMP_CACHE_PRELOAD |
          NETSNMP_CACHE_AUTO_RELOAD | NETSNMP_CACHE_DONT_INVALIDATE_ON_SET);
+
+    _ifTable_cache = cache;
 }                               /* ifTable_container_init */
 
 void
@@ -305,24 +336,99 @@ send_linkUpDownNotifications(oid *notification_oid, size_t notification_oid_len,
     snmp_free_varbind(notification_vars);
 }
 
+/*
+ * point counters to the slot of a row, for the interface entry copies
+ */
+static void
+_ifTable_counters_get(ifTable_rowreq_ctx * rowreq_ctx,
+                      netsnmp_interface_counters *counters)
+{
+#define IFTABLE_COUNTER_GET(column, field)                              \
+    counters->field = ifTable_counter(rowreq_ctx, IFTABLE_COUNTER_##column)
+    IFTABLE_COUNTER_GET(IBYTES, ibytes);
+    IFTABLE_COUNTER_GET(IUCAST, iucast);
+    IFTABLE_COUNTER_GET(IMCAST, imcast);
+    IFTABLE_COUNTER_GET(IBCAST, ibcast);
+    IFTABLE_COUNTER_GET(OBYTES, obytes);
+    IFTABLE_COUNTER_GET(OUCAST, oucast);
+    IFTABLE_COUNTER_GET(OMCAST, omcast);
+    IFTABLE_COUNTER_GET(OBCAST, obcast);
+#undef IFTABLE_COUNTER_GET
+}
+
 /**
- * check entry for update
+ * give a new row a slot for its counters, and move the counters of its
+ * interface entry there
  *
+ * @retval  0 : success
+ * @retval -1 : out of memory
+ */
+int
+ifTable_counters_attach(ifTable_rowreq_ctx * rowreq_ctx)
+{
+    netsnmp_interface_stats *stats;
+
+    rowreq_ctx->counter_slot =
+        netsnmp_counter_columns_attach(&_ifTable_counters);
+    if (rowreq_ctx->counter_slot < 0)
+        return -1;
+    if (NULL == rowreq_ctx->data.ifentry)
+        return 0;
+
+    stats = &rowreq_ctx->data.ifentry->stats;
+#define IFTABLE_COUNTER_MOVE(column, field)                             \
+    do {                                                                \
+        *ifTable_counter(rowreq_ctx, IFTABLE_COUNTER_##column) =        \
+            stats->field;                                               \
+        memset(&stats->field, 0, sizeof(stats->field));                 \
+    } while (0)
+    IFTABLE_COUNTER_MOVE(IBYTES, ibytes);
+    IFTABLE_COUNTER_MOVE(IUCAST, iucast);
+    IFTABLE_COUNTER_MOVE(IMCAST, imcast);
+    IFTABLE_COUNTER_MOVE(IBCAST, ibcast);
+    IFTABLE_COUNTER_MOVE(OBYTES, obytes);
+    IFTABLE_COUNTER_MOVE(OUCAST, oucast);
+    IFTABLE_COUNTER_MOVE(OMCAST, omcast);
+    IFTABLE_COUNTER_MOVE(OBCAST, obcast);
+#undef IFTABLE_COUNTER_MOVE
+    return 0;
+}
+
+/**
+ * release the counter slot of a row
+ */
+void
+ifTable_counters_detach(ifTable_rowreq_ctx * rowreq_ctx)
+{
+    netsnmp_counter_columns_detach(&_ifTable_counters,
+                                   rowreq_ctx->counter_slot);
+    rowreq_ctx->counter_slot = -1;
+}
+
+/**
+ * the counter of a row in one of the IFTABLE_COUNTER_* columns
+ */
+struct counter64 *
+ifTable_counter(ifTable_rowreq_ctx * rowreq_ctx, int column)
+{
+    netsnmp_assert(rowreq_ctx->counter_slot >= 0);
+    return &NETSNMP_COUNTER_COLUMN(&_ifTable_counters, column,
+                                   rowreq_ctx->counter_slot);
+}
+
+/**
+ * update entry from ifentry (NULL if the interface is missing)
+ *
+ * ifentry is claimed or released, and removed from cdc->current if set.
  */
 static void
-_check_interface_entry_for_updates(ifTable_rowreq_ctx * rowreq_ctx,
-                                   cd_container *cdc)
+_update_interface_entry(ifTable_rowreq_ctx * rowreq_ctx,
+                        netsnmp_interface_entry *ifentry,
+                        cd_container *cdc)
 {
+    netsnmp_interface_counters counters;
     char            oper_changed = 0;
     int lastchanged = rowreq_ctx->data.ifLastChange;
-    netsnmp_container *ifcontainer = cdc->current;
-
-    /*
-     * check for matching entry. We can do this directly, since
-     * both containers use the same index.
-     */
-    netsnmp_interface_entry *ifentry =
-        (netsnmp_interface_entry*)CONTAINER_FIND(ifcontainer, rowreq_ctx);
 
 #ifdef USING_IP_MIB_IPV4INTERFACETABLE_IPV4INTERFACETABLE_MODULE
     /*
@@ -406,13 +512,15 @@ _check_interface_entry_for_updates(ifTable_rowreq_ctx * rowreq_ctx,
         if ((!(ifentry->ns_flags & NETSNMP_INTERFACE_FLAGS_HAS_LASTCHANGE))
             && (rowreq_ctx->data.ifOperStatus != ifentry->oper_status))
             oper_changed = 1;
-        netsnmp_access_interface_entry_copy(rowreq_ctx->data.ifentry,
-                                            ifentry);
+        _ifTable_counters_get(rowreq_ctx, &counters);
+        netsnmp_access_interface_entry_copy_to(rowreq_ctx->data.ifentry,
+                                               ifentry, &counters);
 
         /*
          * remove entry from temporary ifcontainer
          */
-        CONTAINER_REMOVE(ifcontainer, ifentry);
+        if (NULL != cdc->current)
+            CONTAINER_REMOVE(cdc->current, ifentry);
         netsnmp_access_interface_entry_free(ifentry);
     }
 
@@ -444,6 +552,65 @@ _check_interface_entry_for_updates(ifTable_rowreq_ctx * rowreq_ctx,
         rowreq_ctx->data.ifLastChange = lastchanged;
 }
 
+/**
+ * check entry for update
+ *
+ */
+static void
+_check_interface_entry_for_updates(ifTable_rowreq_ctx * rowreq_ctx,
+                                   cd_container *cdc)
+{
+    /*
+     * check for matching entry. We can do this directly, since
+     * both containers use the same index.
+     */
+    netsnmp_interface_entry *ifentry =
+        (netsnmp_interface_entry*)CONTAINER_FIND(cdc->current, rowreq_ctx);
+
+    _update_interface_entry(rowreq_ctx, ifentry, cdc);
+}
+
+/**
+ * refresh the counters of an entry
+ *
+ * Anything that doesn't match what we know from change notifications
+ * means we missed one, so a full reload is done instead.
+ */
+static void
+_refresh_interface_stats(ifTable_rowreq_ctx * rowreq_ctx,
+                         cd_container *cdc)
+{
+    netsnmp_interface_entry *ifentry =
+        (netsnmp_interface_entry*)CONTAINER_FIND(cdc->current, rowreq_ctx);
+    netsnmp_interface_counters counters;
+
+    if (_full_reload)
+        return;
+
+    if (rowreq_ctx->known_missing) {
+        if (NULL == ifentry)
+            _update_interface_entry(rowreq_ctx, NULL, cdc); /* fadeout */
+        else
+            _full_reload = 1;
+        return;
+    }
+
+    if ((NULL == ifentry) ||
+        (ifentry->admin_status != rowreq_ctx->data.ifentry->admin_status) ||
+        (ifentry->oper_status != rowreq_ctx->data.ifentry->oper_status)) {
+        DEBUGMSGTL(("ifTable:access", "entry %s out of sync\n",
+                    rowreq_ctx->data.ifName));
+        _full_reload = 1;
+        return;
+    }
+
+    _ifTable_counters_get(rowreq_ctx, &counters);
+    netsnmp_access_interface_entry_copy_stats_to(rowreq_ctx->data.ifentry,
+                                                 ifentry, &counters);
+    CONTAINER_REMOVE(cdc->current, ifentry);
+    netsnmp_access_interface_entry_free(ifentry);
+}
+
 /**
  * Remove all old interfaces with the same name as the newly added one.
  */
@@ -544,6 +711,97 @@ _delete_missing_interface(ifTable_rowreq_ctx *rowreq_ctx,
     ifTable_release_rowreq_ctx(rowreq_ctx);
 }
 
+/**
+ * remove the entries collected in cdc->deleted
+ */
+static void
+_delete_missing_interfaces(cd_container *cdc, netsnmp_container *container)
+{
+    if (NULL != cdc->deleted) {
+       CONTAINER_FOR_EACH(cdc->deleted,
+                          (netsnmp_container_obj_func *) _delete_missing_interface,
+                          container);
+       CONTAINER_FREE(cdc->deleted);
+       cdc->deleted = NULL;
+    }
+}
+
+/**
+ * interface change notification
+ */
+static void
+_interface_changed(oid if_index, netsnmp_interface_entry *ifentry,
+                   void *data)
+{
+    netsnmp_container *container = (netsnmp_container *) data;
+    ifTable_rowreq_ctx *rowreq_ctx;
+    netsnmp_index   tmp;
+    cd_container    cdc;
+
+    if (0 == if_index) {
+        /*
+         * we lost track, reload everything on the next request
+         */
+        _full_reload = 1;
+        if (NULL != _ifTable_cache)
+            _ifTable_cache->expired = 1;
+        return;
+    }
+
+    tmp.len = 1;
+    tmp.oids = &if_index;
+    rowreq_ctx = (ifTable_rowreq_ctx *) CONTAINER_FIND(container, &tmp);
+    if (NULL == rowreq_ctx) {
+        if (NULL != ifentry)
+            _add_new_interface(ifentry, container);
+        return;
+    }
+
+    cdc.current = NULL;
+    cdc.deleted = NULL;
+    _update_interface_entry(rowreq_ctx, ifentry, &cdc);
+    _delete_missing_interfaces(&cdc, container);
+}
+
+/**
+ * refresh the counters of all entries
+ *
+ * @retval MFD_SUCCESS              : success (check _full_reload).
+ * @retval MFD_RESOURCE_UNAVAILABLE : Can't access data source
+ */
+static int
+_ifTable_container_refresh(netsnmp_container *container)
+{
+    cd_container cdc;
+
+    cdc.current =
+        netsnmp_access_interface_container_load(NULL,
+                                                NETSNMP_ACCESS_INTERFACE_LOAD_STATS_ONLY);
+    if (NULL == cdc.current)
+        return MFD_RESOURCE_UNAVAILABLE;        /* msg already logged */
+
+    cdc.deleted = NULL; /* created as needed */
+
+    CONTAINER_FOR_EACH(container, (netsnmp_container_obj_func *)
+                       _refresh_interface_stats, &cdc);
+    _delete_missing_interfaces(&cdc, container);
+
+    /*
+     * anything left is an interface we haven't been told about
+     */
+    if (CONTAINER_SIZE(cdc.current))
+        _full_reload = 1;
+    netsnmp_access_interface_container_free(cdc.current,
+                                            NETSNMP_ACCESS_INTERFACE_FREE_NOFLAGS);
+
+    DEBUGMSGT(("verbose:ifTable:ifTable_cache_load",
+               "refreshed %lu records%s\n",
+               (unsigned long)CONTAINER_SIZE(container),
+               _full_reload ? ", need full reload" : ""));
+
+    return MFD_SUCCESS;
+}
+
 /**
  * container shutdown
  *
@@ -570,6 +828,10 @@ ifTable_container_shutdown(netsnmp_container *container_ptr)
         return;
     }
 
+    if (_monitoring) {
+        netsnmp_access_interface_monitor_stop();
+        _monitoring = 0;
+    }
 }                               /* ifTable_container_shutdown */
 
 /**
@@ -618,6 +880,16 @@ ifTable_container_load(netsnmp_container *container)
      * set the index(es) [and data, optionally] and insert into
      * the container.
      */
+    /*
+     * with change notifications, only the counters need refreshing
+     */
+    if (_monitoring && !_full_reload &&
+        ((netsnmp_get_agent_uptime() - _last_full_reload) / 100 <
+         (u_long)resync) &&
+        (MFD_SUCCESS == _ifTable_container_refresh(container)) &&
+        !_full_reload)
+        return MFD_SUCCESS;
+
     /*
      * ifTable gets its data from the netsnmp_interface API.
      */
@@ -639,12 +911,7 @@ ifTable_container_load(netsnmp_container *container)
     /*
      * now remove any missing interfaces
      */
-    if (NULL != cdc.deleted) {
-       CONTAINER_FOR_EACH(cdc.deleted,
-                          (netsnmp_container_obj_func *) _delete_missing_interface,
-                          container);
-       CONTAINER_FREE(cdc.deleted);
-    }
+    _delete_missing_interfaces(&cdc, container);
 
     /*
      * now add any new interfaces
@@ -666,6 +933,13 @@ ifTable_container_load(netsnmp_container *container)
     if (_first_load)
         _first_load = 0;
 
+    _full_reload = 0;
+    _last_full_reload = netsnmp_get_agent_uptime();
+    if (!_monitoring && (resync > 0) &&
+        (0 == netsnmp_access_interface_monitor_start(_interface_changed,
+                                                     container)))
+        _monitoring = 1;
+
     return MFD_SUCCESS;
 }                               /* ifTable_container_load */
 
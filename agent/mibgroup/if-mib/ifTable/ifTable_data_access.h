@@ -50,6 +50,11 @@ extern          "C" {
 
 #define IFTABLE_REMOVE_MISSING_AFTER     (5 * 60) /* seconds */
 
+    /*
+     * full reload interval while interface changes are monitored
+     */
+#define IFTABLE_RESYNC_INTERVAL          60 /* seconds */
+
     void            ifTable_container_init(netsnmp_container
                                            **container_ptr_ptr,
                                            netsnmp_cache * cache);
@@ -76,6 +81,32 @@ extern          "C" {
 
     int             ifTable_row_prep(ifTable_rowreq_ctx * rowreq_ctx);
 
+    /*
+     * The 64-bit counters of every row are kept by column (see
+     * util_funcs/counter_columns.h) rather than in its interface entry,
+     * so walking a counter column doesn't read each entry.
+     * IFTABLE_COUNTER reads one of them.
+     */
+    enum {
+        IFTABLE_COUNTER_IBYTES,
+        IFTABLE_COUNTER_IUCAST,
+        IFTABLE_COUNTER_IMCAST,
+        IFTABLE_COUNTER_IBCAST,
+        IFTABLE_COUNTER_OBYTES,
+        IFTABLE_COUNTER_OUCAST,
+        IFTABLE_COUNTER_OMCAST,
+        IFTABLE_COUNTER_OBCAST,
+        IFTABLE_COUNTER_COLUMNS
+    };
+
+    int             ifTable_counters_attach(ifTable_rowreq_ctx * rowreq_ctx);
+    void            ifTable_counters_detach(ifTable_rowreq_ctx * rowreq_ctx);
+    struct counter64 *ifTable_counter(ifTable_rowreq_ctx * rowreq_ctx,
+                                      int column);
+
+#define IFTABLE_COUNTER(rowreq_ctx, column)                             \
+    (*ifTable_counter(rowreq_ctx, IFTABLE_COUNTER_##column))
+
 
 
 
@@ -496,7 +496,8 @@ ifInMulticastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifInMulticastPkts data.
      * copy (* ifInMulticastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifInMulticastPkts_val_ptr) = rowreq_ctx->data.ifInMulticastPkts;
+    (*ifInMulticastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IMCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifInMulticastPkts_get */
@@ -555,7 +556,8 @@ ifInBroadcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifInBroadcastPkts data.
      * copy (* ifInBroadcastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifInBroadcastPkts_val_ptr) = rowreq_ctx->data.ifInBroadcastPkts;
+    (*ifInBroadcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IBCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifInBroadcastPkts_get */
@@ -616,7 +618,8 @@ ifOutMulticastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifOutMulticastPkts data.
      * copy (* ifOutMulticastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifOutMulticastPkts_val_ptr) = rowreq_ctx->data.ifOutMulticastPkts;
+    (*ifOutMulticastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OMCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifOutMulticastPkts_get */
@@ -677,7 +680,8 @@ ifOutBroadcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> Extract the current value of the ifOutBroadcastPkts data.
      * copy (* ifOutBroadcastPkts_val_ptr ) from rowreq_ctx->data
      */
-    (*ifOutBroadcastPkts_val_ptr) = rowreq_ctx->data.ifOutBroadcastPkts;
+    (*ifOutBroadcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OBCAST).low;
 
     return MFD_SUCCESS;
 }                               /* ifOutBroadcastPkts_get */
@@ -731,8 +735,8 @@ ifHCInOctets_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCInOctets data.
      * get (* ifHCInOctets_val_ptr ).low and (* ifHCInOctets_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCInOctets_val_ptr).high = rowreq_ctx->data.ifHCInOctets.high;
-    (*ifHCInOctets_val_ptr).low = rowreq_ctx->data.ifHCInOctets.low;
+    (*ifHCInOctets_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IBYTES);
 
 
     return MFD_SUCCESS;
@@ -788,9 +792,8 @@ ifHCInUcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCInUcastPkts data.
      * get (* ifHCInUcastPkts_val_ptr ).low and (* ifHCInUcastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCInUcastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCInUcastPkts.high;
-    (*ifHCInUcastPkts_val_ptr).low = rowreq_ctx->data.ifHCInUcastPkts.low;
+    (*ifHCInUcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IUCAST);
 
 
     return MFD_SUCCESS;
@@ -847,10 +850,8 @@ ifHCInMulticastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCInMulticastPkts data.
      * get (* ifHCInMulticastPkts_val_ptr ).low and (* ifHCInMulticastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCInMulticastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCInMulticastPkts.high;
-    (*ifHCInMulticastPkts_val_ptr).low =
-        rowreq_ctx->data.ifHCInMulticastPkts.low;
+    (*ifHCInMulticastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IMCAST);
 
 
     return MFD_SUCCESS;
@@ -906,10 +907,8 @@ ifHCInBroadcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCInBroadcastPkts data.
      * get (* ifHCInBroadcastPkts_val_ptr ).low and (* ifHCInBroadcastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCInBroadcastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCInBroadcastPkts.high;
-    (*ifHCInBroadcastPkts_val_ptr).low =
-        rowreq_ctx->data.ifHCInBroadcastPkts.low;
+    (*ifHCInBroadcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, IBCAST);
 
 
     return MFD_SUCCESS;
@@ -964,8 +963,8 @@ ifHCOutOctets_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCOutOctets data.
      * get (* ifHCOutOctets_val_ptr ).low and (* ifHCOutOctets_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCOutOctets_val_ptr).high = rowreq_ctx->data.ifHCOutOctets.high;
-    (*ifHCOutOctets_val_ptr).low = rowreq_ctx->data.ifHCOutOctets.low;
+    (*ifHCOutOctets_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OBYTES);
 
 
     return MFD_SUCCESS;
@@ -1022,10 +1021,8 @@ ifHCOutUcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCOutUcastPkts data.
      * get (* ifHCOutUcastPkts_val_ptr ).low and (* ifHCOutUcastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCOutUcastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCOutUcastPkts.high;
-    (*ifHCOutUcastPkts_val_ptr).low =
-        rowreq_ctx->data.ifHCOutUcastPkts.low;
+    (*ifHCOutUcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OUCAST);
 
 
     return MFD_SUCCESS;
@@ -1083,10 +1080,8 @@ ifHCOutMulticastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCOutMulticastPkts data.
      * get (* ifHCOutMulticastPkts_val_ptr ).low and (* ifHCOutMulticastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCOutMulticastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCOutMulticastPkts.high;
-    (*ifHCOutMulticastPkts_val_ptr).low =
-        rowreq_ctx->data.ifHCOutMulticastPkts.low;
+    (*ifHCOutMulticastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OMCAST);
 
 
     return MFD_SUCCESS;
@@ -1143,10 +1138,8 @@ ifHCOutBroadcastPkts_get(ifXTable_rowreq_ctx * rowreq_ctx,
      * TODO:231:o: |-> copy ifHCOutBroadcastPkts data.
      * get (* ifHCOutBroadcastPkts_val_ptr ).low and (* ifHCOutBroadcastPkts_val_ptr ).high from rowreq_ctx->data
      */
-    (*ifHCOutBroadcastPkts_val_ptr).high =
-        rowreq_ctx->data.ifHCOutBroadcastPkts.high;
-    (*ifHCOutBroadcastPkts_val_ptr).low =
-        rowreq_ctx->data.ifHCOutBroadcastPkts.low;
+    (*ifHCOutBroadcastPkts_val_ptr) =
+        IFTABLE_COUNTER(rowreq_ctx, OBCAST);
 
 
     return MFD_SUCCESS;
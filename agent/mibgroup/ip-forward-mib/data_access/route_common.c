@@ -18,6 +18,26 @@
  */
 static void _access_route_entry_release(netsnmp_route_entry * entry, void *unused);
 
+/**---------------------------------------------------------------------*/
+/*
+ * initialization
+ */
+
+/**
+ * set up route data access (config tokens). Safe to call more than once.
+ */
+void
+netsnmp_access_route_init(void)
+{
+    static int      initialized = 0;
+
+    if (initialized)
+        return;
+    initialized = 1;
+
+    netsnmp_arch_route_init();
+}
+
 /**---------------------------------------------------------------------*/
 /*
  * container functions
@@ -18,6 +18,69 @@
 #include "route.h"
 #include "route_private.h"
 
+#ifdef HAVE_LINUX_RTNETLINK_H
+#include <errno.h>
+#ifdef HAVE_ARPA_INET_H
+#include <arpa/inet.h>
+#endif
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#ifdef RTM_GETROUTE
+#define NETSNMP_ROUTE_NETLINK 1
+#endif
+#endif
+
+#ifdef NETSNMP_ROUTE_NETLINK
+/*
+ * route_filter_* configuration: which routes to load
+ */
+#define ROUTE_FILTER_MAX 16
+
+typedef struct route_filter_prefix_s {
+    int             family;
+    u_char          addr[16];
+    u_char          len;
+} route_filter_prefix;
+
+static uint32_t _filter_tables[ROUTE_FILTER_MAX];
+static int      _filter_table_count = 0;
+static u_char   _filter_protocols[ROUTE_FILTER_MAX];
+static int      _filter_protocol_count = 0;
+static route_filter_prefix _filter_prefixes[ROUTE_FILTER_MAX];
+static int      _filter_prefix_count = 0;
+
+static const struct {
+    const char     *name;
+    int             value;
+} _route_names[] = {
+    /* tables */
+    { "default", RT_TABLE_DEFAULT },
+    { "main", RT_TABLE_MAIN },
+    { "local", RT_TABLE_LOCAL },
+    /* protocols */
+    { "redirect", RTPROT_REDIRECT },
+    { "kernel", RTPROT_KERNEL },
+    { "boot", RTPROT_BOOT },
+    { "static", RTPROT_STATIC },
+#ifdef RTPROT_ZEBRA
+    { "zebra", RTPROT_ZEBRA },
+#endif
+#ifdef RTPROT_BIRD
+    { "bird", RTPROT_BIRD },
+#endif
+#ifdef RTPROT_DHCP
+    { "dhcp", RTPROT_DHCP },
+#endif
+#ifdef RTPROT_BGP
+    { "bgp", RTPROT_BGP },
+    { "isis", RTPROT_ISIS },
+    { "ospf", RTPROT_OSPF },
+    { "rip", RTPROT_RIP },
+#endif
+    { NULL, 0 }
+};
+#endif /* NETSNMP_ROUTE_NETLINK */
+
 static int
 _type_from_flags(unsigned int flags)
 {
@@ -338,11 +401,476 @@ _load_ipv6(netsnmp_container* container, u_long *index )
 }
 #endif
 
+#ifdef NETSNMP_ROUTE_NETLINK
+/*
+ * parse a table or protocol number or name
+ */
+static int
+_route_filter_value(const char *token, const char *word, int max)
+{
+    char           *end;
+    long            value;
+    int             i;
+
+    value = strtol(word, &end, 0);
+    if (('\0' == *end) && (value >= 0) && (value <= max))
+        return value;
+
+    for (i = 0; _route_names[i].name; i++)
+        if ((0 == strcmp(word, _route_names[i].name)) &&
+            (_route_names[i].value <= max))
+            return _route_names[i].value;
+
+    config_perror("unknown table or protocol");
+    DEBUGMSGTL(("access:route:config", "%s: bad value '%s'\n", token, word));
+    return -1;
+}
+
+static void
+_parse_route_filter(const char *token, char *line)
+{
+    char           *word, *st = NULL, *slash;
+    route_filter_prefix *pfx;
+    int             value, max;
+
+    for (word = strtok_r(line, " \t", &st); word;
+         word = strtok_r(NULL, " \t", &st)) {
+        if (0 == strcmp(token, "route_filter_table")) {
+            if (_filter_table_count == ROUTE_FILTER_MAX)
+                goto full;
+            value = _route_filter_value(token, word, 0x7fffffff);
+            if (value >= 0)
+                _filter_tables[_filter_table_count++] = value;
+        }
+        else if (0 == strcmp(token, "route_filter_protocol")) {
+            if (_filter_protocol_count == ROUTE_FILTER_MAX)
+                goto full;
+            value = _route_filter_value(token, word, 255);
+            if (value >= 0)
+                _filter_protocols[_filter_protocol_count++] = value;
+        }
+        else {
+            if (_filter_prefix_count == ROUTE_FILTER_MAX)
+                goto full;
+            pfx = &_filter_prefixes[_filter_prefix_count];
+            memset(pfx, 0, sizeof(*pfx));
+            slash = strchr(word, '/');
+            if (slash)
+                *slash++ = '\0';
+            if (inet_pton(AF_INET, word, pfx->addr) == 1) {
+                pfx->family = AF_INET;
+                max = 32;
+            }
+#ifdef NETSNMP_ENABLE_IPV6
+            else if (inet_pton(AF_INET6, word, pfx->addr) == 1) {
+                pfx->family = AF_INET6;
+                max = 128;
+            }
+#endif
+            else {
+                config_perror("bad prefix address");
+                continue;
+            }
+            value = slash ? atoi(slash) : max;
+            if ((value < 0) || (value > max)) {
+                config_perror("bad prefix length");
+                continue;
+            }
+            pfx->len = value;
+            ++_filter_prefix_count;
+        }
+    }
+    return;
+
+  full:
+    config_perror("too many values");
+}
+
+static void
+_free_route_filter(void)
+{
+    _filter_table_count = 0;
+    _filter_protocol_count = 0;
+    _filter_prefix_count = 0;
+}
+
+/*
+ * is the route to dst/dst_len in table, added by proto, wanted?
+ *
+ * Without route_filter_table, only the main table is loaded for IPv4
+ * (like /proc/net/route), and all tables for IPv6 (like
+ * /proc/net/ipv6_route).
+ */
+static int
+_route_filter_match(int family, uint32_t table, u_char proto,
+                    const u_char *dst, int dst_len)
+{
+    int             i, bytes, bits;
+
+    if (_filter_table_count) {
+        for (i = 0; i < _filter_table_count; i++)
+            if (_filter_tables[i] == table)
+                break;
+        if (i == _filter_table_count)
+            return 0;
+    }
+    else if ((AF_INET == family) && (RT_TABLE_MAIN != table))
+        return 0;
+
+    if (_filter_protocol_count) {
+        for (i = 0; i < _filter_protocol_count; i++)
+            if (_filter_protocols[i] == proto)
+                break;
+        if (i == _filter_protocol_count)
+            return 0;
+    }
+
+    if (0 == _filter_prefix_count)
+        return 1;
+
+    for (i = 0; i < _filter_prefix_count; i++) {
+        const route_filter_prefix *pfx = &_filter_prefixes[i];
+
+        if ((pfx->family != family) || (pfx->len > dst_len))
+            continue;
+        bytes = pfx->len / 8;
+        bits = pfx->len % 8;
+        if (memcmp(pfx->addr, dst, bytes))
+            continue;
+        if (bits &&
+            ((pfx->addr[bytes] ^ dst[bytes]) & (0xff00 >> bits) & 0xff))
+            continue;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * add one route (one next hop of a multipath route) to the container
+ */
+static void
+_load_netlink_entry(netsnmp_container *container, u_long *index,
+                    const struct rtmsg *r, const u_char *dst,
+                    const u_char *gw, int oif, uint32_t metric)
+{
+    netsnmp_route_entry *entry;
+    int             addr_len = (AF_INET == r->rtm_family) ? 4 : 16;
+
+    entry = netsnmp_access_route_entry_create();
+    if (NULL == entry)
+        return;
+
+    entry->if_index = oif;
+    entry->rt_metric1 = metric;
+
+    /*
+     * arbitrary index
+     */
+    entry->ns_rt_index = ++(*index);
+
+    entry->rt_dest_type = entry->rt_nexthop_type =
+        (AF_INET == r->rtm_family) ? INETADDRESSTYPE_IPV4 :
+        INETADDRESSTYPE_IPV6;
+    entry->rt_dest_len = entry->rt_nexthop_len = addr_len;
+    if (dst)
+        memcpy(entry->rt_dest, dst, addr_len);
+    if (gw)
+        memcpy(entry->rt_nexthop, gw, addr_len);
+    entry->rt_pfx_len = r->rtm_dst_len;
+
+#ifdef USING_IP_FORWARD_MIB_IPCIDRROUTETABLE_IPCIDRROUTETABLE_MODULE
+    if ((AF_INET == r->rtm_family) && r->rtm_dst_len)
+        entry->rt_mask = htonl(0xffffffffU << (32 - r->rtm_dst_len));
+#endif
+
+#ifdef USING_IP_FORWARD_MIB_INETCIDRROUTETABLE_INETCIDRROUTETABLE_MODULE
+    /*
+     * same policies as the /proc loaders below
+     */
+    if (AF_INET != r->rtm_family) {
+        entry->rt_policy = calloc(3, sizeof(oid));
+        if (entry->rt_policy) {
+            entry->rt_policy[2] = entry->ns_rt_index;
+            entry->rt_policy_len = sizeof(oid)*3;
+        }
+    }
+    else if (NULL == gw) {
+        entry->rt_policy = calloc(3, sizeof(oid));
+        if (entry->rt_policy) {
+            entry->rt_policy[2] = entry->if_index;
+            entry->rt_policy_len = sizeof(oid)*3;
+        }
+    }
+#endif
+
+    switch (r->rtm_type) {
+    case RTN_BLACKHOLE:
+        entry->rt_type = INETCIDRROUTETYPE_BLACKHOLE;
+        break;
+    case RTN_UNREACHABLE:
+    case RTN_PROHIBIT:
+    case RTN_THROW:
+        entry->rt_type = INETCIDRROUTETYPE_REJECT;
+        break;
+    default:
+        entry->rt_type = gw ? INETCIDRROUTETYPE_REMOTE :
+            INETCIDRROUTETYPE_LOCAL;
+        break;
+    }
+
+    switch (r->rtm_protocol) {
+    case RTPROT_REDIRECT:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_ICMP;
+        break;
+    case RTPROT_STATIC:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_NETMGMT;
+        break;
+#ifdef RTPROT_BGP
+    case RTPROT_BGP:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_BGP;
+        break;
+    case RTPROT_ISIS:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_ISIS;
+        break;
+    case RTPROT_OSPF:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_OSPF;
+        break;
+    case RTPROT_RIP:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_RIP;
+        break;
+#endif
+    default:
+        entry->rt_proto = IANAIPROUTEPROTOCOL_LOCAL;
+        break;
+    }
+
+    /*
+     * insert into container
+     */
+    if (CONTAINER_INSERT(container, entry) < 0) {
+        DEBUGMSGTL(("access:route:container", "error with route_entry: insert into container failed.\n"));
+        netsnmp_access_route_entry_free(entry);
+    }
+}
+
+/*
+ * add the routes of one RTM_NEWROUTE message to the container
+ */
+static void
+_load_netlink_route(netsnmp_container *container, u_long *index,
+                    struct nlmsghdr *h)
+{
+    struct rtmsg   *r = (struct rtmsg *) NLMSG_DATA(h);
+    struct rtattr  *rta;
+    struct rtnexthop *nh = NULL;
+    const u_char   *dst = NULL, *gw = NULL;
+    uint32_t        table, metric = 0;
+    int             len, nh_len = 0, oif = 0;
+    int             addr_len = (AF_INET == r->rtm_family) ? 4 : 16;
+
+    if ((RTM_NEWROUTE != h->nlmsg_type) ||
+        (h->nlmsg_len < NLMSG_LENGTH(sizeof(*r))) ||
+        (r->rtm_flags & RTM_F_CLONED))
+        return;
+
+    table = r->rtm_table;
+    len = RTM_PAYLOAD(h);
+    for (rta = RTM_RTA(r); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+        switch (rta->rta_type) {
+        case RTA_DST:
+            if (RTA_PAYLOAD(rta) >= addr_len)
+                dst = (u_char *) RTA_DATA(rta);
+            break;
+        case RTA_GATEWAY:
+            if (RTA_PAYLOAD(rta) >= addr_len)
+                gw = (u_char *) RTA_DATA(rta);
+            break;
+        case RTA_OIF:
+            if (RTA_PAYLOAD(rta) >= sizeof(int))
+                oif = *(int *) RTA_DATA(rta);
+            break;
+        case RTA_PRIORITY:
+            if (RTA_PAYLOAD(rta) >= sizeof(uint32_t))
+                metric = *(uint32_t *) RTA_DATA(rta);
+            break;
+        case RTA_TABLE:
+            if (RTA_PAYLOAD(rta) >= sizeof(uint32_t))
+                table = *(uint32_t *) RTA_DATA(rta);
+            break;
+        case RTA_MULTIPATH:
+            nh = (struct rtnexthop *) RTA_DATA(rta);
+            nh_len = RTA_PAYLOAD(rta);
+            break;
+        }
+    }
+
+    if (dst == NULL) {
+        static const u_char zero[16];
+        dst = zero;
+    }
+    if (!_route_filter_match(r->rtm_family, table, r->rtm_protocol, dst,
+                             r->rtm_dst_len))
+        return;
+
+    if (NULL == nh) {
+        _load_netlink_entry(container, index, r, dst, gw, oif, metric);
+        return;
+    }
+
+    /*
+     * one entry per next hop
+     */
+    for (; RTNH_OK(nh, nh_len);
+         nh_len -= NLMSG_ALIGN(nh->rtnh_len), nh = RTNH_NEXT(nh)) {
+        gw = NULL;
+        len = nh->rtnh_len - sizeof(*nh);
+        for (rta = RTNH_DATA(nh); RTA_OK(rta, len); rta = RTA_NEXT(rta, len))
+            if ((RTA_GATEWAY == rta->rta_type) &&
+                (RTA_PAYLOAD(rta) >= addr_len))
+                gw = (u_char *) RTA_DATA(rta);
+        _load_netlink_entry(container, index, r, dst, gw, nh->rtnh_ifindex,
+                            metric);
+    }
+}
+
+/*
+ * load the routes of one address family with an RTM_GETROUTE dump
+ *
+ * The entries are added as the kernel sends them, so memory use does
+ * not depend on the size of a text dump.
+ *
+ * @retval  0 success
+ * @retval -1 the dump broke off, the container holds part of the routes
+ * @retval -2 netlink not usable, nothing loaded
+ */
+static int
+_load_netlink(netsnmp_container* container, u_long *index, int family)
+{
+    struct {
+        struct nlmsghdr n;
+        struct rtmsg    r;
+    }               req;
+    struct nlmsghdr *h;
+    char            buf[32768];
+    int             fd, len, done = 0;
+    u_long          first = *index;
+
+    DEBUGMSGTL(("access:route:container",
+                "route_container_arch_load netlink (family %d)\n", family));
+
+    fd = socket(PF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
+    if (fd < 0) {
+        DEBUGMSGTL(("access:route:container", "netlink socket: %s\n",
+                    strerror(errno)));
+        return -2;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.n.nlmsg_len = NLMSG_LENGTH(sizeof(struct rtmsg));
+    req.n.nlmsg_type = RTM_GETROUTE;
+    req.n.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.n.nlmsg_seq = 1;
+    req.r.rtm_family = family;
+
+#if defined(SOL_NETLINK) && defined(NETLINK_GET_STRICT_CHK)
+    {
+        /*
+         * have the kernel do the table and protocol filtering, if it
+         * can. We check again anyway.
+         */
+        int             one = 1;
+
+        if (setsockopt(fd, SOL_NETLINK, NETLINK_GET_STRICT_CHK, &one,
+                       sizeof(one)) == 0) {
+            if ((1 == _filter_table_count) && (_filter_tables[0] < 256))
+                req.r.rtm_table = _filter_tables[0];
+            else if ((0 == _filter_table_count) && (AF_INET == family))
+                req.r.rtm_table = RT_TABLE_MAIN;
+            if (1 == _filter_protocol_count)
+                req.r.rtm_protocol = _filter_protocols[0];
+        }
+    }
+#endif
+
+    if (send(fd, &req, req.n.nlmsg_len, 0) < 0) {
+        DEBUGMSGTL(("access:route:container", "netlink send: %s\n",
+                    strerror(errno)));
+        close(fd);
+        return -2;
+    }
+
+    while (!done) {
+        len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (EINTR == errno)
+                continue;
+            break;
+        }
+        if (0 == len)
+            break;
+
+        for (h = (struct nlmsghdr *) buf; NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            if (NLMSG_DONE == h->nlmsg_type) {
+                done = 1;
+                break;
+            }
+            if (NLMSG_ERROR == h->nlmsg_type) {
+                struct nlmsgerr *err = (struct nlmsgerr *) NLMSG_DATA(h);
+
+                /* ENOENT: the filtered table doesn't exist */
+                if ((h->nlmsg_len >= NLMSG_LENGTH(sizeof(*err))) &&
+                    (-ENOENT == err->error))
+                    done = 1;
+                else
+                    len = -1;
+                break;
+            }
+            _load_netlink_route(container, index, h);
+        }
+        if (len < 0)
+            break;
+    }
+    close(fd);
+
+    if (!done) {
+        DEBUGMSGTL(("access:route:container", "netlink dump failed\n"));
+        if (first == *index)
+            return -2;
+        snmp_log(LOG_ERR, "route_linux: netlink route dump incomplete\n");
+        return -1;
+    }
+
+    DEBUGMSGTL(("access:route:container", "netlink: %lu routes\n",
+                *index - first));
+    return 0;
+}
+#endif /* NETSNMP_ROUTE_NETLINK */
+
+/*
+ * register the route_filter_* tokens
+ */
+void
+netsnmp_arch_route_init(void)
+{
+#ifdef NETSNMP_ROUTE_NETLINK
+    snmpd_register_config_handler("route_filter_table", _parse_route_filter,
+                                  _free_route_filter,
+                                  "table [table...]");
+    snmpd_register_config_handler("route_filter_protocol",
+                                  _parse_route_filter, _free_route_filter,
+                                  "protocol [protocol...]");
+    snmpd_register_config_handler("route_filter_prefix", _parse_route_filter,
+                                  _free_route_filter,
+                                  "address/length [address/length...]");
+#endif
+}
+
 /** arch specific load
  * @internal
  *
  * @retval  0 success
- * @retval -1 no container specified
+ * @retval -1 no container specified, or incomplete netlink dump
  * @retval -2 could not open data file
  */
 int
@@ -360,6 +888,10 @@ netsnmp_access_route_container_arch_load(netsnmp_container* container,
         return -1;
     }
 
+#ifdef NETSNMP_ROUTE_NETLINK
+    rc = _load_netlink(container, &count, AF_INET);
+    if (-2 == rc)
+#endif
     rc = _load_ipv4(container, &count);
     
 #ifdef NETSNMP_ENABLE_IPV6
@@ -370,6 +902,10 @@ netsnmp_access_route_container_arch_load(netsnmp_container* container,
      * load ipv6. ipv6 module might not be loaded,
      * so ignore -2 err (file not found)
      */
+#ifdef NETSNMP_ROUTE_NETLINK
+    rc = _load_netlink(container, &count, AF_INET6);
+    if (-2 == rc)
+#endif
     rc = _load_ipv6(container, &count);
     if (-2 == rc)
         rc = 0;
@@ -1,6 +1,7 @@
 struct netsnmp_container_s;
 struct netsnmp_route_s;
 
+void netsnmp_arch_route_init(void);
 int netsnmp_access_route_container_arch_load(struct netsnmp_container_s* container,
                                              u_int load_flags);
 int netsnmp_arch_route_create(struct netsnmp_route_s *entry);
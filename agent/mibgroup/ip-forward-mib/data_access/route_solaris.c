@@ -23,6 +23,14 @@
 static int _load_v4(netsnmp_container *container);
 static int _load_v6(netsnmp_container *container);
 
+/*
+ * no arch specific configuration
+ */
+void
+netsnmp_arch_route_init(void)
+{
+}
+
 /** arch specific load
  * @internal
  *
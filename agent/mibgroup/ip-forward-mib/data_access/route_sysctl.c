@@ -33,6 +33,14 @@ static int _delete_ipv6(netsnmp_route_entry *);
 #define SA_SIZE(x) RT_ROUNDUP(((struct sockaddr *)(x))->sa_len)
 #endif
 
+/*
+ * no arch specific configuration
+ */
+void
+netsnmp_arch_route_init(void)
+{
+}
+
 /** arch specific load
  * @internal
  *
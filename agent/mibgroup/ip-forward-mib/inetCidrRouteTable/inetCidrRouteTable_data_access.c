@@ -62,6 +62,7 @@ inetCidrRouteTable_init_data(inetCidrRouteTable_registration *
     /*
      * TODO:303:o: Initialize inetCidrRouteTable data.
      */
+    netsnmp_access_route_init();
 
     return MFD_SUCCESS;
 }                               /* inetCidrRouteTable_init_data */
@@ -63,6 +63,7 @@ ipCidrRouteTable_init_data(ipCidrRouteTable_registration *
     /*
      * TODO:303:o: Initialize ipCidrRouteTable data.
      */
+    netsnmp_access_route_init();
 
     return MFD_SUCCESS;
 }                               /* ipCidrRouteTable_init_data */
@@ -156,7 +156,11 @@ netsnmp_access_ipaddress_container_load(netsnmp_container* container,
         return NULL;
     }
 
+    CONTAINER_BULK_BEGIN(container);
     rc =  netsnmp_arch_ipaddress_container_load(container, load_flags);
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func*)_access_ipaddress_entry_release,
+                       NULL);
     if (0 != rc) {
         netsnmp_access_ipaddress_container_free(container,
                                                 NETSNMP_ACCESS_IPADDRESS_FREE_NOFLAGS);
@@ -695,6 +695,7 @@ vacm_parse_view(const char *token, char *param)
     }
     memcpy(vp->viewMask, viewMask, sizeof(viewMask));
     vp->viewMaskLen = mask_len;
+    vacm_viewEntryChanged(vp);
     vp->viewType = inclexcl;
     vp->viewStorageType = SNMP_STORAGE_PERMANENT;
     vp->viewStatus = SNMP_ROW_ACTIVE;
@@ -1768,11 +1768,13 @@ write_vacmViewMask(int action,
             length = vptr->viewMaskLen;
             memcpy(vptr->viewMask, var_val, var_val_len);
             vptr->viewMaskLen = var_val_len;
+            vacm_viewEntryChanged(vptr);
         }
     } else if (action == FREE) {
         if ((vptr = view_parse_viewEntry(name, name_len)) != NULL) {
             memcpy(vptr->viewMask, string, length);
             vptr->viewMaskLen = length;
+            vacm_viewEntryChanged(vptr);
         }
     }
     return SNMP_ERR_NOERROR;
@@ -921,6 +921,7 @@ write_usmUserAuthKeyChange(int action,
             return SNMP_ERR_RESOURCEUNAVAILABLE;
         }
         uptr->authKeyLen = buflen;
+        sc_hmac_cache_free(&uptr->authHmacCache);
     } else if (action == COMMIT) {
         SNMP_FREE(oldkey);
     } else if (action == UNDO) {
@@ -928,6 +929,7 @@ write_usmUserAuthKeyChange(int action,
             SNMP_FREE(uptr->authKey);
             uptr->authKey = oldkey;
             uptr->authKeyLen = oldkeylen;
+            sc_hmac_cache_free(&uptr->authHmacCache);
         }
     }
 
@@ -37,6 +37,8 @@ struct myproc {
     int             min;
     int             max;
     struct myproc  *next;
+    struct myproc  *hash_next;  /* same name hash bucket */
+    int             count;      /* processes found in the last pass */
 };
 
 /*
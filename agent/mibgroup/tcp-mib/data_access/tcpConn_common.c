@@ -63,7 +63,11 @@ netsnmp_access_tcpconn_container_load(netsnmp_container* container, u_int load_f
         return NULL;
     }
 
+    CONTAINER_BULK_BEGIN(container);
     rc =  netsnmp_arch_tcpconn_container_load(container, load_flags);
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func*)_access_tcpconn_entry_release,
+                       NULL);
     if (0 != rc) {
         netsnmp_access_tcpconn_container_free(container,
                                                 NETSNMP_ACCESS_TCPCONN_FREE_NOFLAGS);
@@ -12,6 +12,8 @@
 #include "tcp-mib/tcpConnectionTable/tcpConnectionTable_constants.h"
 #include "tcp-mib/data_access/tcpConn_private.h"
 #include "mibgroup/util_funcs/get_pid_from_inode.h"
+#include "mibgroup/util_funcs/sock_diag.h"
+
 static int
 linux_states[12] = { 1, 5, 3, 4, 6, 7, 11, 1, 8, 9, 2, 10 };
 
@@ -19,6 +21,10 @@ static int _load4(netsnmp_container *container, u_int flags);
 #if defined (NETSNMP_ENABLE_IPV6)
 static int _load6(netsnmp_container *container, u_int flags);
 #endif
+#ifdef NETSNMP_SOCK_DIAG
+static int _load_diag(netsnmp_container *container, int fd, int family,
+                      u_int flags);
+#endif
 
 /*
  * initialize arch specific storage
@@ -80,6 +86,9 @@ netsnmp_arch_tcpconn_container_load(netsnmp_container *container,
                                     u_int load_flags )
 {
     int rc = 0;
+#ifdef NETSNMP_SOCK_DIAG
+    int fd;
+#endif
 
     DEBUGMSGTL(("access:tcpconn:container",
                 "tcpconn_container_arch_load (flags %x)\n", load_flags));
@@ -92,21 +101,44 @@ netsnmp_arch_tcpconn_container_load(netsnmp_container *container,
         return -1;
     }
 
+#ifdef NETSNMP_SOCK_DIAG
+    /*
+     * ask the kernel for the sockets via sock_diag if possible, which
+     * is much cheaper than parsing /proc/net/tcp* on busy systems.  A
+     * family sock_diag can't report (-2) is read from procfs instead.
+     */
+    fd = netsnmp_sock_diag_open();
+    if (fd >= 0)
+        rc = _load_diag(container, fd, AF_INET, load_flags);
+    if (fd < 0 || -2 == rc)
+        rc = _load4(container, load_flags);
+#else
     rc = _load4(container, load_flags);
+#endif
 
 #if defined (NETSNMP_ENABLE_IPV6)
-    if((0 != rc) || (load_flags & NETSNMP_ACCESS_TCPCONN_LOAD_IPV4_ONLY))
-        return rc;
-
-    /*
-     * load ipv6. ipv6 module might not be loaded,
-     * so ignore -2 err (file not found)
-     */
-    rc = _load6(container, load_flags);
-    if (-2 == rc)
-        rc = 0;
+    if ((0 == rc) && !(load_flags & NETSNMP_ACCESS_TCPCONN_LOAD_IPV4_ONLY)) {
+        /*
+         * load ipv6. ipv6 module might not be loaded,
+         * so ignore -2 err (file not found)
+         */
+#ifdef NETSNMP_SOCK_DIAG
+        if (fd >= 0)
+            rc = _load_diag(container, fd, AF_INET6, load_flags);
+        if (fd < 0 || -2 == rc)
+            rc = _load6(container, load_flags);
+#else
+        rc = _load6(container, load_flags);
+#endif
+        if (-2 == rc)
+            rc = 0;
+    }
 #endif
 
+#ifdef NETSNMP_SOCK_DIAG
+    if (fd >= 0)
+        close(fd);
+#endif
     return rc;
 }
 
@@ -400,3 +432,73 @@ _load6(netsnmp_container *container, u_int load_flags)
     return 0;
 }
 #endif /* NETSNMP_ENABLE_IPV6 */
+
+#ifdef NETSNMP_SOCK_DIAG
+/*
+ * sock_diag callback: add one socket to the container
+ */
+static int
+_add_diag_entry(const struct inet_diag_msg *r, void *context)
+{
+    netsnmp_container *container = (netsnmp_container *) context;
+    netsnmp_tcpconn_entry *entry;
+    int             alen, state;
+
+    alen = (AF_INET == r->idiag_family) ? 4 : 16;
+    if (alen > (int) sizeof(entry->loc_addr))
+        return 0;
+
+    entry = netsnmp_access_tcpconn_entry_create();
+    if (NULL == entry)
+        return -3;
+
+    state = r->idiag_state & 0xf;
+    entry->tcpConnState = state < 12 ? linux_states[state] : 2;
+    entry->loc_port = ntohs(r->id.idiag_sport);
+    entry->rmt_port = ntohs(r->id.idiag_dport);
+    memcpy(entry->loc_addr, r->id.idiag_src, alen);
+    entry->loc_addr_len = alen;
+    memcpy(entry->rmt_addr, r->id.idiag_dst, alen);
+    entry->rmt_addr_len = alen;
+    entry->pid = netsnmp_get_pid_from_inode(r->idiag_inode);
+
+    entry->arbitrary_index = CONTAINER_SIZE(container) + 1;
+    CONTAINER_INSERT(container, entry);
+    return 0;
+}
+
+/**
+ * load the sockets of one address family via NETLINK_SOCK_DIAG
+ *
+ * The kernel does the listen/non-listen filtering for us.
+ *
+ * @retval  0 no errors
+ * @retval -2 sock_diag not usable for this family, nothing loaded
+ * @retval !0 other errors
+ */
+static int
+_load_diag(netsnmp_container *container, int fd, int family, u_int load_flags)
+{
+    unsigned int    states;
+    int             rc;
+
+    netsnmp_assert(NULL != container);
+
+    /*
+     * kernel TCP states run from 1 (ESTABLISHED) to 12 (NEW_SYN_RECV,
+     * reported as SYN_RECV); 10 is LISTEN.
+     */
+    if (load_flags & NETSNMP_ACCESS_TCPCONN_LOAD_ONLYLISTEN)
+        states = 1 << 10;
+    else if (load_flags & NETSNMP_ACCESS_TCPCONN_LOAD_NOLISTEN)
+        states = 0x1ffe & ~(1 << 10);
+    else
+        states = 0x1ffe;
+
+    rc = netsnmp_sock_diag_dump(fd, family, IPPROTO_TCP, states,
+                                _add_diag_entry, container);
+    DEBUGMSGTL(("access:tcpconn:container",
+                "sock_diag loaded %d entries (family %d)\n", rc, family));
+    return rc < 0 ? rc : 0;
+}
+#endif /* NETSNMP_SOCK_DIAG */
@@ -130,7 +130,8 @@ tcpConnectionTable_container_init(netsnmp_container **container_ptr_ptr,
      * cache->enabled to 0.
      */
     cache->timeout = TCPCONNECTIONTABLE_CACHE_TIMEOUT;  /* seconds */
-    cache->flags |= NETSNMP_CACHE_DONT_INVALIDATE_ON_SET;
+    cache->flags |= NETSNMP_CACHE_DONT_INVALIDATE_ON_SET |
+        NETSNMP_CACHE_BACKGROUND_RELOAD;
 }                               /* tcpConnectionTable_container_init */
 
 /**
@@ -206,6 +207,18 @@ _add_connection(netsnmp_tcpconn_entry *entry, netsnmp_container *container)
     }
 }
 
+/**
+ * release a row whose index was already loaded
+ */
+static void
+_drop_duplicate(tcpConnectionTable_rowreq_ctx *rowreq_ctx, void *context)
+{
+    NETSNMP_LOGONCE((LOG_DEBUG,
+                     "Error inserting entry to tcpConnectionTable,"\
+                     " entry already exists.\n"));
+    tcpConnectionTable_release_rowreq_ctx(rowreq_ctx);
+}
+
 /**
  * load initial data
  *
@@ -252,10 +265,14 @@ tcpConnectionTable_container_load(netsnmp_container *container)
         return MFD_RESOURCE_UNAVAILABLE;        /* msg already logged */
 
     /*
-     * got all the connections. pull out the active ones.
+     * got all the connections. pull out the active ones, and sort
+     * them in once they have all been added.
      */
+    CONTAINER_BULK_BEGIN(container);
     CONTAINER_FOR_EACH(raw_data, (netsnmp_container_obj_func *)
                        _add_connection, container);
+    CONTAINER_BULK_END(container,
+                       (netsnmp_container_obj_func *)_drop_duplicate, NULL);
 
     /*
      * free the container. we've either claimed each entry, or released it,
@@ -131,7 +131,8 @@ tcpListenerTable_container_init(netsnmp_container **container_ptr_ptr,
      * cache->enabled to 0.
      */
     cache->timeout = TCPLISTENERTABLE_CACHE_TIMEOUT;    /* seconds */
-    cache->flags |= NETSNMP_CACHE_DONT_INVALIDATE_ON_SET;
+    cache->flags |= NETSNMP_CACHE_DONT_INVALIDATE_ON_SET |
+        NETSNMP_CACHE_BACKGROUND_RELOAD;
 }                               /* tcpListenerTable_container_init */
 
 /**
@@ -30,6 +30,7 @@
 #if defined (linux)
 /* for stat() */
 #include <ctype.h>
+#include <stddef.h>
 #include <sys/stat.h>
 #endif
 
@@ -117,6 +118,12 @@ static void diskio_free_config(void);
 
 #define DISK_INCR 2
 
+/*
+ * one sample a minute is kept for the 1, 5 and 15 minute rates
+ */
+#define DISKIO_RATE_SLOTS 16
+#define DISKIO_RATE_SPACING 60000      /* ms between kept samples */
+
 typedef struct linux_diskio
 {
     int major;
@@ -136,11 +143,27 @@ typedef struct linux_diskio
     unsigned long  aveq;
 } linux_diskio;
 
-/* disk load averages */
+/* counters at a point in time, for the rates */
+typedef struct linux_diskio_sample
+{
+    unsigned long time;                /* monotonic, in ms */
+    unsigned long rsect;
+    unsigned long wsect;
+    unsigned long rio;
+    unsigned long wio;
+} linux_diskio_sample;
+
+/* disk load averages and rates, per device */
 typedef struct linux_diskio_la
 {
+    int major;
+    int minor;
     unsigned long use_prev;
     double la1, la5, la15;
+    linux_diskio_sample last;          /* latest sample */
+    linux_diskio_sample ring[DISKIO_RATE_SLOTS];
+    int ring_next;                     /* slot for the next kept sample */
+    int ring_count;
 } linux_diskio_la;
 
 typedef struct linux_diskio_header
@@ -253,6 +276,32 @@ init_diskio(void)
          var_diskio, 1, {13}},
         {DISKIO_BUSYTIME, ASN_COUNTER64, NETSNMP_OLDAPI_RONLY,
          var_diskio, 1, {14}},
+#ifdef linux
+        {DISKIO_NREADRATE1, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {15}},
+        {DISKIO_NREADRATE5, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {16}},
+        {DISKIO_NREADRATE15, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {17}},
+        {DISKIO_NWRITTENRATE1, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {18}},
+        {DISKIO_NWRITTENRATE5, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {19}},
+        {DISKIO_NWRITTENRATE15, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {20}},
+        {DISKIO_READSRATE1, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {21}},
+        {DISKIO_READSRATE5, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {22}},
+        {DISKIO_READSRATE15, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {23}},
+        {DISKIO_WRITESRATE1, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {24}},
+        {DISKIO_WRITESRATE5, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {25}},
+        {DISKIO_WRITESRATE15, ASN_GAUGE, NETSNMP_OLDAPI_RONLY,
+         var_diskio, 1, {26}},
+#endif
     };
 
     /*
@@ -1257,10 +1306,146 @@ var_diskio(struct variable * vp,
 #ifdef linux
 
 
+/*
+ * find the load average/rate state of a device in the previous list,
+ * starting at the position it had there
+ */
+static linux_diskio_la *
+devla_find(linux_diskio_la *list, int length, int hint,
+           int major, int minor)
+{
+    int i, idx;
+
+    for (i = 0; i < length; i++) {
+        idx = (hint + i) % length;
+        if (list[idx].major == major && list[idx].minor == minor)
+            return &list[idx];
+    }
+    return NULL;
+}
+
+/*
+ * make la_head.indices[idx] belong to head.indices[idx], keeping the
+ * state of devices which were already known
+ */
+static int
+devla_align(void)
+{
+    linux_diskio_la *la;
+    linux_diskio_la *old;
+    int idx;
+
+    if (la_head.length == head.length) {
+        for (idx = 0; idx < head.length; idx++)
+            if (la_head.indices[idx].major != head.indices[idx].major ||
+                la_head.indices[idx].minor != head.indices[idx].minor)
+                break;
+        if (idx == head.length)
+            return 0;
+    }
+
+    la = (linux_diskio_la *) calloc(head.length > 0 ? head.length : 1,
+                                    sizeof(linux_diskio_la));
+    if (!la)
+        return -1;
+    for (idx = 0; idx < head.length; idx++) {
+        old = devla_find(la_head.indices, la_head.length, idx,
+                         head.indices[idx].major, head.indices[idx].minor);
+        if (old) {
+            la[idx] = *old;
+        } else {
+            la[idx].major = head.indices[idx].major;
+            la[idx].minor = head.indices[idx].minor;
+            la[idx].use_prev = head.indices[idx].use;
+        }
+    }
+    free(la_head.indices);
+    la_head.indices = la;
+    la_head.length = head.length;
+    return 0;
+}
+
+/*
+ * record the counters of a device: always as its latest sample, and in
+ * the ring if the last kept sample is about a minute old
+ */
+static void
+devla_sample(linux_diskio_la *la, const linux_diskio *d, unsigned long now)
+{
+    linux_diskio_sample *newest;
+
+    if (la->ring_count &&
+        (d->rsect < la->last.rsect || d->wsect < la->last.wsect ||
+         d->rio < la->last.rio || d->wio < la->last.wio)) {
+        /* counters went back (device replaced?), start over */
+        la->ring_count = 0;
+        la->ring_next = 0;
+    }
+
+    la->last.time = now;
+    la->last.rsect = d->rsect;
+    la->last.wsect = d->wsect;
+    la->last.rio = d->rio;
+    la->last.wio = d->wio;
+
+    newest = &la->ring[(la->ring_next + DISKIO_RATE_SLOTS - 1) %
+                       DISKIO_RATE_SLOTS];
+    if (la->ring_count && now - newest->time <
+        DISKIO_RATE_SPACING - DISKIO_SAMPLE_INTERVAL * 1000 / 2)
+        return;
+    la->ring[la->ring_next] = la->last;
+    la->ring_next = (la->ring_next + 1) % DISKIO_RATE_SLOTS;
+    if (la->ring_count < DISKIO_RATE_SLOTS)
+        la->ring_count++;
+}
+
+/*
+ * the sample from which a rate over the last minutes is computed: the
+ * newest one which is at least that old, or else the oldest one
+ */
+static const linux_diskio_sample *
+devla_rate_base(const linux_diskio_la *la, int minutes)
+{
+    const linux_diskio_sample *sample = NULL;
+    int i;
+
+    for (i = 1; i <= la->ring_count; i++) {
+        sample = &la->ring[(la->ring_next + DISKIO_RATE_SLOTS - i) %
+                           DISKIO_RATE_SLOTS];
+        if (la->last.time - sample->time >=
+            (unsigned long) minutes * 60000)
+            break;
+    }
+    return sample;
+}
+
+/*
+ * per second rate of a counter over the last minutes
+ */
+static unsigned long
+devla_rate(const linux_diskio_la *la, int minutes, size_t offset)
+{
+    const linux_diskio_sample *base = devla_rate_base(la, minutes);
+    unsigned long dt;
+    double delta;
+
+    if (!base)
+        return 0;
+    dt = la->last.time - base->time;
+    if (!dt)
+        return 0;
+    delta = *(const unsigned long *)((const char *)&la->last + offset) -
+            *(const unsigned long *)((const char *)base + offset);
+    delta = delta * 1000. / dt;
+    return delta > 0xffffffffUL ? 0xffffffffUL : (unsigned long) delta;
+}
+
 void devla_getstats(unsigned int regno, void * dummy) {
 
     static double expon1, expon5, expon15;
     double busy_time, busy_percent;
+    struct timeval tv;
+    unsigned long now;
     int idx;
 
     if (getstats() == 1) {
@@ -1268,26 +1453,19 @@ void devla_getstats(unsigned int regno, void * dummy) {
         return;
     }
 
-    if (!la_head.length) {
-        la_head.indices = (linux_diskio_la *) malloc(head.length * sizeof(linux_diskio_la));
-        for (idx=0; idx<head.length; idx++) {
-            la_head.indices[idx].la1 = la_head.indices[idx].la5 = la_head.indices[idx].la15 = 0.; 
-            la_head.indices[idx].use_prev = head.indices[idx].use;
-        }
-        la_head.length = head.length;
+    if (expon1 == 0.) {
         expon1 = exp(-(((double)DISKIO_SAMPLE_INTERVAL) / ((double)60)));
         expon5 = exp(-(((double)DISKIO_SAMPLE_INTERVAL) / ((double)300)));
         expon15 = exp(-(((double)DISKIO_SAMPLE_INTERVAL) / ((double)900)));
     }
-    else if (head.length - la_head.length) {
-        la_head.indices = (linux_diskio_la *) realloc(la_head.indices, head.length * sizeof(linux_diskio_la));
-        for (idx=la_head.length; idx<head.length; idx++) {
-            la_head.indices[idx].la1 = la_head.indices[idx].la5 = la_head.indices[idx].la15 = 0.; 
-            la_head.indices[idx].use_prev = head.indices[idx].use;
-        }
-        la_head.length = head.length;
+    if (devla_align() < 0) {
+        ERROR_MSG("can't allocate diskio load averages\n");
+        return;
     }
 
+    netsnmp_get_monotonic_clock(&tv);
+    now = tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
     for (idx=0; idx<head.length; idx++) {
         busy_time = head.indices[idx].use - la_head.indices[idx].use_prev;
         busy_percent = busy_time * 100. / ((double) DISKIO_SAMPLE_INTERVAL) / 1000.;
@@ -1299,9 +1477,99 @@ void devla_getstats(unsigned int regno, void * dummy) {
           idx, la_head.indices[idx].la1, la_head.indices[idx].la5, la_head.indices[idx].la15);   
         */
         la_head.indices[idx].use_prev = head.indices[idx].use;
+        devla_sample(&la_head.indices[idx], &head.indices[idx], now);
     }
 }
 
+/*
+ * read the next number of a line of /proc/diskstats or a sysfs stat
+ * file, skipping blanks before it.
+ *
+ * @retval  1 a number was read into *value
+ * @retval  0 end of line
+ */
+static int
+diskio_next_field(char **cp, unsigned long *value)
+{
+    char *p = *cp;
+    unsigned long v = 0;
+
+    while (*p == ' ' || *p == '\t')
+        p++;
+    if (*p < '0' || *p > '9')
+        return 0;
+    while (*p >= '0' && *p <= '9')
+        v = v * 10 + (*p++ - '0');
+    *cp = p;
+    *value = v;
+    return 1;
+}
+
+/*
+ * read the I/O statistics which follow the device name in a line of
+ * /proc/diskstats or a sysfs stat file: eleven of them, or four (reads,
+ * read sectors, writes, written sectors) for partitions on early 2.6
+ * kernels.  Fields added by later kernels are ignored.
+ *
+ * @retval  0 success
+ * @retval -1 unexpected format
+ */
+static int
+diskio_parse_stats(char *cp, linux_diskio *d)
+{
+    unsigned long v[11];
+    int n;
+
+    for (n = 0; n < 11 && diskio_next_field(&cp, &v[n]); n++)
+        ;
+    if (n == 11) {
+        d->rio = v[0];
+        d->rmerge = v[1];
+        d->rsect = v[2];
+        d->ruse = v[3];
+        d->wio = v[4];
+        d->wmerge = v[5];
+        d->wsect = v[6];
+        d->wuse = v[7];
+        d->running = v[8];
+        d->use = v[9];
+        d->aveq = v[10];
+    } else if (n == 4) {
+        d->rio = v[0];
+        d->rsect = v[1];
+        d->wio = v[2];
+        d->wsect = v[3];
+    } else
+        return -1;
+    return 0;
+}
+
+/*
+ * parse a line of /proc/diskstats:  MAJOR MINOR NAME STATS...
+ */
+static int
+diskio_parse_diskstats(char *cp, linux_diskio *d)
+{
+    unsigned long v;
+    size_t len;
+
+    if (!diskio_next_field(&cp, &v))
+        return -1;
+    d->major = v;
+    if (!diskio_next_field(&cp, &v))
+        return -1;
+    d->minor = v;
+    while (*cp == ' ' || *cp == '\t')
+        cp++;
+    for (len = 0; cp[len] && !isspace((unsigned char)cp[len]); len++)
+        ;
+    if (!len || len >= sizeof(d->name))
+        return -1;
+    memcpy(d->name, cp, len);
+    d->name[len] = '\0';
+    return diskio_parse_stats(cp + len, d);
+}
+
 int is_excluded(const char *name)
 {
     if (netsnmp_ds_get_boolean(NETSNMP_DS_APPLICATION_ID,
@@ -1345,16 +1613,11 @@ static int get_sysfs_stats(void)
             head.indices = (linux_diskio *) realloc(head.indices, head.alloc*sizeof(linux_diskio));
         }
         pTemp = &head.indices[head.length];
+        memset(pTemp, 0, sizeof(*pTemp));
         pTemp->major = disks[i].major;
         pTemp->minor = disks[i].minor;
         strlcpy( pTemp->name, disks[i].shortname, sizeof(pTemp->name) - 1 );
-        if (sscanf (buffer, "%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu\n",
-                &pTemp->rio, &pTemp->rmerge, &pTemp->rsect, &pTemp->ruse,
-                &pTemp->wio, &pTemp->wmerge, &pTemp->wsect, &pTemp->wuse,
-                &pTemp->running, &pTemp->use, &pTemp->aveq) != 11)
-            sscanf (buffer, "%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu%*[ \n\t]%lu\n",
-                &pTemp->rio, &pTemp->rsect,
-                &pTemp->wio, &pTemp->wsect);
+        diskio_parse_stats(buffer, pTemp);
         head.length++;
         fclose(f);
     }
@@ -1399,16 +1662,9 @@ getstats(void)
 		head.indices = (linux_diskio *)realloc(head.indices, head.alloc*sizeof(linux_diskio));
 	    }
 	    pTemp = &head.indices[head.length];
-	    sscanf (buffer, "%d %d", &pTemp->major, &pTemp->minor);
- 	    if (sscanf (buffer, "%d %d %s %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu %lu\n",
-		    &pTemp->major, &pTemp->minor, pTemp->name,
-		    &pTemp->rio, &pTemp->rmerge, &pTemp->rsect, &pTemp->ruse,
-		    &pTemp->wio, &pTemp->wmerge, &pTemp->wsect, &pTemp->wuse,
- 		    &pTemp->running, &pTemp->use, &pTemp->aveq) != 14)
-		sscanf (buffer, "%d %d %s %lu %lu %lu %lu\n",
-		    &pTemp->major, &pTemp->minor, pTemp->name,
-		    &pTemp->rio, &pTemp->rsect,
-		    &pTemp->wio, &pTemp->wsect);
+	    memset(pTemp, 0, sizeof(*pTemp));
+	    if (diskio_parse_diskstats(buffer, pTemp) < 0)
+	        continue;
             if (!is_excluded(pTemp->name))
 	        head.length++;
 	}
@@ -1475,6 +1731,7 @@ var_diskio(struct variable * vp,
     unsigned int indx;
     static unsigned long long_ret;
     static struct counter64 c64_ret;
+    linux_diskio_la *la;
 
     if (getstats() == 1) {
 	return NULL;
@@ -1490,6 +1747,13 @@ var_diskio(struct variable * vp,
   if (indx >= head.length)
     return NULL;
 
+  /* load averages and rates, unless the device list changed since */
+  la = NULL;
+  if (indx < la_head.length &&
+      la_head.indices[indx].major == head.indices[indx].major &&
+      la_head.indices[indx].minor == head.indices[indx].minor)
+      la = &la_head.indices[indx];
+
   switch (vp->magic) {
     case DISKIO_INDEX:
       long_ret = indx+1;
@@ -1510,23 +1774,64 @@ var_diskio(struct variable * vp,
       long_ret = head.indices[indx].wio & 0xffffffff;
       return (u_char *) & long_ret;
     case DISKIO_LA1:
-      if (la_head.length > indx)
-          long_ret = la_head.indices[indx].la1;
+      if (la)
+          long_ret = la->la1;
       else
           long_ret = 0; /* we don't have the load yet */
       return (u_char *) & long_ret;
     case DISKIO_LA5:
-      if (la_head.length > indx)
-          long_ret = la_head.indices[indx].la5;
+      if (la)
+          long_ret = la->la5;
       else
           long_ret = 0; /* we don't have the load yet */
       return (u_char *) & long_ret;
     case DISKIO_LA15:
-      if (la_head.length > indx)
-          long_ret = la_head.indices[indx].la15;
+      if (la)
+          long_ret = la->la15;
       else
           long_ret = 0;
       return (u_char *) & long_ret;
+#define DISKIO_RATE(m, field) \
+      (la ? devla_rate(la, m, offsetof(linux_diskio_sample, field)) : 0)
+    /* kilobytes per second: sectors are 512 bytes */
+    case DISKIO_NREADRATE1:
+      long_ret = DISKIO_RATE(1, rsect) / 2;
+      return (u_char *) & long_ret;
+    case DISKIO_NREADRATE5:
+      long_ret = DISKIO_RATE(5, rsect) / 2;
+      return (u_char *) & long_ret;
+    case DISKIO_NREADRATE15:
+      long_ret = DISKIO_RATE(15, rsect) / 2;
+      return (u_char *) & long_ret;
+    case DISKIO_NWRITTENRATE1:
+      long_ret = DISKIO_RATE(1, wsect) / 2;
+      return (u_char *) & long_ret;
+    case DISKIO_NWRITTENRATE5:
+      long_ret = DISKIO_RATE(5, wsect) / 2;
+      return (u_char *) & long_ret;
+    case DISKIO_NWRITTENRATE15:
+      long_ret = DISKIO_RATE(15, wsect) / 2;
+      return (u_char *) & long_ret;
+    /* operations per second */
+    case DISKIO_READSRATE1:
+      long_ret = DISKIO_RATE(1, rio);
+      return (u_char *) & long_ret;
+    case DISKIO_READSRATE5:
+      long_ret = DISKIO_RATE(5, rio);
+      return (u_char *) & long_ret;
+    case DISKIO_READSRATE15:
+      long_ret = DISKIO_RATE(15, rio);
+      return (u_char *) & long_ret;
+    case DISKIO_WRITESRATE1:
+      long_ret = DISKIO_RATE(1, wio);
+      return (u_char *) & long_ret;
+    case DISKIO_WRITESRATE5:
+      long_ret = DISKIO_RATE(5, wio);
+      return (u_char *) & long_ret;
+    case DISKIO_WRITESRATE15:
+      long_ret = DISKIO_RATE(15, wio);
+      return (u_char *) & long_ret;
+#undef DISKIO_RATE
     case DISKIO_BUSYTIME:
       *var_len = sizeof(struct counter64);
       c64_ret.low = head.indices[indx].use*1000 & 0xffffffff;
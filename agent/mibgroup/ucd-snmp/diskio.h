@@ -35,5 +35,17 @@ config_add_mib(UCD-DISKIO-MIB)
 #define DISKIO_NREADX           12
 #define DISKIO_NWRITTENX        13
 #define DISKIO_BUSYTIME		14
+#define DISKIO_NREADRATE1       15
+#define DISKIO_NREADRATE5       16
+#define DISKIO_NREADRATE15      17
+#define DISKIO_NWRITTENRATE1    18
+#define DISKIO_NWRITTENRATE5    19
+#define DISKIO_NWRITTENRATE15   20
+#define DISKIO_READSRATE1       21
+#define DISKIO_READSRATE5       22
+#define DISKIO_READSRATE15      23
+#define DISKIO_WRITESRATE1      24
+#define DISKIO_WRITESRATE5      25
+#define DISKIO_WRITESRATE15     26
 
 #endif                          /* _MIBGROUP_DISKIO_H */
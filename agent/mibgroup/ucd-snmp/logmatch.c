@@ -18,6 +18,16 @@
 #include <errno.h>
 #include <regex.h>
 #include <time.h>
+#ifdef HAVE_FCNTL_H
+#include <fcntl.h>
+#endif
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if defined(linux)
+#include <sys/inotify.h>
+#define NETSNMP_LOGMATCH_INOTIFY 1
+#endif
 
 #include <net-snmp/net-snmp-includes.h>
 #include <net-snmp/agent/net-snmp-agent-includes.h>
@@ -92,12 +102,385 @@ struct logmatchstat {
     int             virgin;
     int             thisIndex;
     int             frequency;
+    struct logmatchfile *file;
+    int             dirty;
+};
+
+/*
+ * One open log file, shared by all logmatch entries currently scanning
+ * it.  The file is kept open between reads and read in large blocks from
+ * position on; every line is matched against the patterns of all these
+ * entries in one pass.
+ */
+struct logmatchfile {
+    char            filename[256];
+    const char     *base;       /* file name part of filename */
+    int             fd;
+    dev_t           dev;
+    ino_t           ino;
+    long            position;   /* of the first byte not yet scanned */
+    int             skip_line;  /* in an overlong line, matched already */
+    int             wd;         /* inotify watch of the directory */
+    int             pending;
+    struct logmatchfile *next;
 };
 
 #define MAXLOGMATCH   250
+#define LOGMATCH_BUFSIZE 65536
 
 static struct logmatchstat logmatchTable[MAXLOGMATCH];
 static int                 logmatchCount = 0;
+static struct logmatchfile *logmatchFiles = NULL;
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+static int                 logmatchInotify = -1;
+#endif
+
+/*
+ * returns the entries scanning file f, in table order
+ */
+static int
+logmatch_file_entries(struct logmatchfile *f, struct logmatchstat **list)
+{
+    int             i, n = 0;
+
+    for (i = 0; i < logmatchCount; i++)
+        if (logmatchTable[i].file == f)
+            list[n++] = &logmatchTable[i];
+    return n;
+}
+
+static void logmatch_file_read(struct logmatchfile *f);
+
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+/*
+ * inotify reports changes to the files of a watched directory by name,
+ * which also covers a log file being rotated away and created again.
+ */
+static void
+logmatch_inotify_read(int fd, void *data)
+{
+    union {
+        struct inotify_event ev;
+        char            buf[4096];
+    } u;
+    struct inotify_event *ev;
+    struct logmatchfile *f;
+    ssize_t         len, off;
+
+    len = read(fd, u.buf, sizeof(u.buf));
+    if (len <= 0)
+        return;
+
+    for (off = 0; off + (ssize_t) sizeof(*ev) <= len;
+         off += sizeof(*ev) + ev->len) {
+        ev = (struct inotify_event *) (u.buf + off);
+        for (f = logmatchFiles; f; f = f->next)
+            if ((ev->mask & IN_Q_OVERFLOW) ||
+                (ev->wd == f->wd &&
+                 (ev->len == 0 || strcmp(ev->name, f->base) == 0)))
+                f->pending = 1;
+    }
+
+    for (f = logmatchFiles; f; f = f->next)
+        if (f->pending) {
+            DEBUGMSGTL(("ucd-snmp/logmatch", "%s changed\n", f->filename));
+            f->pending = 0;
+            logmatch_file_read(f);
+        }
+}
+
+static void
+logmatch_file_watch(struct logmatchfile *f)
+{
+    char            dir[256];
+    size_t          len = f->base - f->filename;
+
+    if (logmatchInotify < 0) {
+        logmatchInotify = inotify_init();
+        if (logmatchInotify < 0) {
+            DEBUGMSGTL(("ucd-snmp/logmatch", "inotify_init: %s\n",
+                        strerror(errno)));
+            return;
+        }
+        fcntl(logmatchInotify, F_SETFL, O_NONBLOCK);
+        register_readfd(logmatchInotify, logmatch_inotify_read, NULL);
+    }
+
+    if (len == 0)
+        strcpy(dir, ".");
+    else if (len == 1)
+        strcpy(dir, "/");
+    else {
+        memcpy(dir, f->filename, len - 1);
+        dir[len - 1] = '\0';
+    }
+    f->wd = inotify_add_watch(logmatchInotify, dir,
+                              IN_MODIFY | IN_CREATE | IN_DELETE |
+                              IN_MOVED_FROM | IN_MOVED_TO);
+    if (f->wd < 0)
+        snmp_log(LOG_WARNING, "logmatch: cannot watch %s (%s), "
+                 "polling it instead\n", dir, strerror(errno));
+}
+
+static void
+logmatch_file_unwatch(struct logmatchfile *f)
+{
+    struct logmatchfile *o;
+
+    if (f->wd < 0 || logmatchInotify < 0)
+        return;
+    for (o = logmatchFiles; o; o = o->next)
+        if (o != f && o->wd == f->wd)
+            return;
+    inotify_rm_watch(logmatchInotify, f->wd);
+}
+#endif /* NETSNMP_LOGMATCH_INOTIFY */
+
+/*
+ * returns the file state for filename, creating it if necessary
+ */
+static struct logmatchfile *
+logmatch_file_get(const char *filename)
+{
+    struct logmatchfile *f;
+
+    for (f = logmatchFiles; f; f = f->next)
+        if (strcmp(f->filename, filename) == 0)
+            return f;
+
+    f = SNMP_MALLOC_TYPEDEF(struct logmatchfile);
+    if (f == NULL)
+        return NULL;
+    strlcpy(f->filename, filename, sizeof(f->filename));
+    f->base = strrchr(f->filename, '/');
+    f->base = f->base ? f->base + 1 : f->filename;
+    f->fd = -1;
+    f->wd = -1;
+    f->position = -1;
+    f->next = logmatchFiles;
+    logmatchFiles = f;
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+    logmatch_file_watch(f);
+#endif
+    return f;
+}
+
+/*
+ * drops the file state once no entry scans the file anymore
+ */
+static void
+logmatch_file_release(struct logmatchfile *f)
+{
+    struct logmatchfile **fp;
+    int             i;
+
+    if (f == NULL)
+        return;
+    for (i = 0; i < logmatchCount; i++)
+        if (logmatchTable[i].file == f)
+            return;
+
+    for (fp = &logmatchFiles; *fp; fp = &(*fp)->next)
+        if (*fp == f) {
+            *fp = f->next;
+            break;
+        }
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+    logmatch_file_unwatch(f);
+#endif
+    if (f->fd >= 0)
+        close(f->fd);
+    free(f);
+}
+
+/*
+ * the file was replaced or truncated: start over at its beginning
+ */
+static void
+logmatch_file_reset(struct logmatchfile *f)
+{
+    struct logmatchstat *list[MAXLOGMATCH];
+    int             i, n;
+
+    n = logmatch_file_entries(f, list);
+    for (i = 0; i < n; i++) {
+        list[i]->currentFilePosition = 0;
+        list[i]->currentMatchCounter = 0;
+        list[i]->dirty = TRUE;
+    }
+    f->position = 0;
+    f->skip_line = 0;
+}
+
+/*
+ * matches the line at offset against all patterns for the file.  Entries
+ * which restored a later position from persistent storage have counted
+ * this line already and skip it.
+ */
+static void
+logmatch_match_line(struct logmatchstat **list, int n, const char *line,
+                    long offset, long next)
+{
+    int             i;
+
+    for (i = 0; i < n; i++) {
+        if (list[i]->currentFilePosition > offset)
+            continue;
+        if (regexec(&list[i]->regexBuffer, line, 0, NULL, REG_NOTEOL) == 0) {
+            list[i]->globalMatchCounter++;
+            list[i]->currentMatchCounter++;
+            list[i]->matchCounter++;
+            list[i]->dirty = TRUE;
+        }
+        list[i]->currentFilePosition = next;
+    }
+}
+
+/*
+ * scans the data appended to the open file since the last call.  A
+ * trailing line without newline is left for the next call, unless final
+ * is set because nothing more will be written to this file.
+ */
+static void
+logmatch_file_scan(struct logmatchfile *f, int final)
+{
+    static char    *buf = NULL;
+    struct logmatchstat *list[MAXLOGMATCH];
+    struct stat     sb;
+    size_t          len = 0, start;
+    ssize_t         got;
+    char           *nl;
+    int             i, n;
+
+    if (buf == NULL && (buf = malloc(LOGMATCH_BUFSIZE + 1)) == NULL)
+        return;
+
+    if (fstat(f->fd, &sb) == 0 && sb.st_size < f->position) {
+        DEBUGMSGTL(("ucd-snmp/logmatch", "%s truncated\n", f->filename));
+        logmatch_file_reset(f);
+    }
+    if (lseek(f->fd, f->position, SEEK_SET) < 0)
+        return;
+
+    n = logmatch_file_entries(f, list);
+    while ((got = read(f->fd, buf + len, LOGMATCH_BUFSIZE - len)) > 0) {
+        len += got;
+        start = 0;
+        if (f->skip_line) {
+            /* the rest of a line which was matched by its first piece */
+            nl = memchr(buf, '\n', len);
+            if (nl != NULL) {
+                start = nl - buf + 1;
+                f->skip_line = 0;
+            } else
+                start = len;
+            for (i = 0; i < n; i++)
+                if (list[i]->currentFilePosition == f->position)
+                    list[i]->currentFilePosition += start;
+        }
+        while ((nl = memchr(buf + start, '\n', len - start)) != NULL) {
+            *nl = '\0';
+            logmatch_match_line(list, n, buf + start, f->position + start,
+                                f->position + (nl - buf) + 1);
+            start = nl - buf + 1;
+        }
+        if (start == 0 && len == LOGMATCH_BUFSIZE) {
+            /* longer than the buffer: match its start, skip the rest */
+            buf[len] = '\0';
+            logmatch_match_line(list, n, buf, f->position,
+                                f->position + len);
+            f->skip_line = 1;
+            start = len;
+        }
+        f->position += start;
+        len -= start;
+        memmove(buf, buf + start, len);
+    }
+
+    if (final && len > 0 && !f->skip_line) {
+        buf[len] = '\0';
+        logmatch_match_line(list, n, buf, f->position, f->position + len);
+        f->position += len;
+    }
+}
+
+/*
+ * brings the counters for a file up to date.  A file that has been
+ * renamed or removed is first read up to its end through the descriptor
+ * that is still open, so rotation does not lose its last lines; the new
+ * file is then scanned from its start.
+ */
+static void
+logmatch_file_read(struct logmatchfile *f)
+{
+    struct logmatchstat *list[MAXLOGMATCH];
+    struct stat     sb;
+    int             i, n, fd;
+
+    if (stat(f->filename, &sb) < 0) {
+        if (f->fd >= 0)
+            logmatch_file_scan(f, 0);
+        return;
+    }
+
+    if (f->fd >= 0 && (sb.st_dev != f->dev || sb.st_ino != f->ino)) {
+        DEBUGMSGTL(("ucd-snmp/logmatch", "%s rotated\n", f->filename));
+        logmatch_file_scan(f, 1);
+        close(f->fd);
+        f->fd = -1;
+        logmatch_file_reset(f);
+    }
+
+    if (f->fd < 0) {
+        fd = open(f->filename, O_RDONLY);
+        if (fd < 0)
+            return;
+        if (fstat(fd, &sb) < 0) {
+            close(fd);
+            return;
+        }
+        f->fd = fd;
+        f->dev = sb.st_dev;
+        f->ino = sb.st_ino;
+        if (f->position < 0) {
+            /*
+             * first look at this file: continue where the entries
+             * stopped before (see the persistent data in updateLogmatch)
+             */
+            n = logmatch_file_entries(f, list);
+            f->position = n ? list[0]->currentFilePosition : 0;
+            for (i = 1; i < n; i++)
+                if (list[i]->currentFilePosition < f->position)
+                    f->position = list[i]->currentFilePosition;
+        }
+    }
+
+    logmatch_file_scan(f, 0);
+}
+
+/*
+ * saves the position and counters of entry iindex in its persistent
+ * data file
+ */
+static void
+logmatch_save(int iindex)
+{
+    char            perfilename[1024];
+    FILE           *perfile;
+
+    snprintf(perfilename, sizeof(perfilename), "%s/snmpd_logmatch_%s.pos",
+             get_persistent_directory(), logmatchTable[iindex].name);
+
+    if ((perfile = fopen(perfilename, "w"))) {
+        fprintf(perfile, "%lu %lu %lu %s\n",
+                logmatchTable[iindex].currentFilePosition,
+                logmatchTable[iindex].currentMatchCounter,
+                logmatchTable[iindex].globalMatchCounter,
+                logmatchTable[iindex].filename);
+        fclose(perfile);
+    }
+    logmatchTable[iindex].dirty = FALSE;
+}
 
 /***************************************************************
 *                                                              *
@@ -110,16 +493,11 @@ static void
 updateLogmatch(int iindex)
 {
 
-    int             matchResultCode;
-    char            inbuf[1024];
     char            perfilename[1024];
     FILE           *perfile;
     unsigned long   pos, ccounter, counter;
-    int             result;
-    int             toobig;
-    int             anyChanges = FALSE;
-    struct stat     sb;
     char            lastFilename[256];
+    struct logmatchfile *file;
 
     if (iindex >= MAXLOGMATCH)
         return;
@@ -230,16 +608,37 @@ updateLogmatch(int iindex)
     /*
      * -------------------------------------------
      * check if a new input file needs to be opened
-     * if yes, reset counter and position
+     * if yes, finish the old one and reset counter
+     * and position
      * -------------------------------------------
      */
 
     if (logmatch_update_filename(logmatchTable[iindex].filenamePattern,
                                  logmatchTable[iindex].filename) == 1) {
+        file = logmatchTable[iindex].file;
+        if (file) {
+            logmatch_file_read(file);
+            logmatchTable[iindex].file = NULL;
+            logmatch_file_release(file);
+        }
         logmatchTable[iindex].currentFilePosition = 0; 
         logmatchTable[iindex].currentMatchCounter = 0;
+        logmatchTable[iindex].dirty = TRUE;
     }
 
+    if (logmatchTable[iindex].file == NULL) {
+        file = logmatch_file_get(logmatchTable[iindex].filename);
+        if (file == NULL)
+            return;
+        logmatchTable[iindex].file = file;
+
+        /*
+         * the file may already be scanned for other entries; let it go
+         * back to where this one is, the others skip what they have seen
+         */
+        if (file->position > logmatchTable[iindex].currentFilePosition)
+            file->position = logmatchTable[iindex].currentFilePosition;
+    }
 
     /*
      * ------------------------------------ 
@@ -250,62 +649,7 @@ updateLogmatch(int iindex)
      * ------------------------------------ 
      */
 
-    if (stat(logmatchTable[iindex].filename, &sb) == 0) {
-
-        if (logmatchTable[iindex].currentFilePosition > sb.st_size) {
-            toobig = TRUE;
-        } else {
-            toobig = FALSE;
-        }
-
-        if ((logmatchTable[iindex].logfile =
-            fopen(logmatchTable[iindex].filename, "r"))) {
-
-            result =
-                fseek(logmatchTable[iindex].logfile,
-                      logmatchTable[iindex].currentFilePosition, SEEK_SET);
-
-            if (result || toobig || (errno == EINVAL)
-                || feof(logmatchTable[iindex].logfile)) {
-
-
-                /*
-                 * ------------------------------------ 
-                 * when we are here that means we       
-                 * could't set the file position maybe  
-                 * the file was rotated; let's reset    
-                 * the filepointer, but not the counter 
-                 * ------------------------------------ 
-                 */
-
-
-                logmatchTable[iindex].currentFilePosition = 0;
-                logmatchTable[iindex].currentMatchCounter = 0;
-                fseek(logmatchTable[iindex].logfile, 0, SEEK_SET);
-                anyChanges = TRUE;
-            }
-
-            while (fgets
-                   (inbuf, sizeof(inbuf), logmatchTable[iindex].logfile)) {
-
-                matchResultCode =
-                    regexec(&(logmatchTable[iindex].regexBuffer),
-                            inbuf, 0, NULL, REG_NOTEOL);
-
-                if (matchResultCode == 0) {
-                    logmatchTable[iindex].globalMatchCounter++;
-                    logmatchTable[iindex].currentMatchCounter++;
-                    logmatchTable[iindex].matchCounter++;
-                    anyChanges = TRUE;
-                }
-            }
-
-            logmatchTable[iindex].currentFilePosition =
-                ftell(logmatchTable[iindex].logfile);
-            fclose(logmatchTable[iindex].logfile);
-        }
-    }
-
+    logmatch_file_read(logmatchTable[iindex].file);
 
     /*
      * ------------------------------------ 
@@ -318,24 +662,8 @@ updateLogmatch(int iindex)
      * ------------------------------------ 
      */
 
-    if (anyChanges && (perfile = fopen(perfilename, "w"))) {
-
-
-        /*
-         * ------------------------------------ 
-         * o.k. lets write out our variable     
-         * ------------------------------------ 
-         */
-
-        fprintf(perfile, "%lu %lu %lu %s\n",
-                logmatchTable[iindex].currentFilePosition,
-                logmatchTable[iindex].currentMatchCounter,
-                logmatchTable[iindex].globalMatchCounter,
-                logmatchTable[iindex].filename);
-
-        fclose(perfile);
-    }
-
+    if (logmatchTable[iindex].dirty)
+        logmatch_save(iindex);
 }
 
 
@@ -377,6 +705,8 @@ logmatch_parse_config(const char *token, char *cptr)
         logmatchTable[logmatchCount].matchCounter = 0;
         logmatchTable[logmatchCount].virgin = TRUE;
         logmatchTable[logmatchCount].currentFilePosition = 0;
+        logmatchTable[logmatchCount].file = NULL;
+        logmatchTable[logmatchCount].dirty = FALSE;
 
 
         /*
@@ -449,11 +779,22 @@ logmatch_parse_config(const char *token, char *cptr)
                      "\n since regcomp() failed with - %s\n",
                      logmatchTable[logmatchCount].regEx, regexErrorString);
         }
-        else if (logmatchTable[logmatchCount].frequency > 0) {
-            snmp_alarm_register(logmatchTable[logmatchCount].frequency,
-                                SA_REPEAT,
+        else {
+            if (logmatchTable[logmatchCount].frequency > 0)
+                snmp_alarm_register(logmatchTable[logmatchCount].frequency,
+                                    SA_REPEAT,
+                                    (SNMPAlarmCallback *)
+                                    updateLogmatch_Scheduled,
+                                    &logmatchTable[logmatchCount]);
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+            /*
+             * open and watch the file right away; the alarm above then
+             * only has to notice a new file name (or missed changes)
+             */
+            snmp_alarm_register(0, 0,
                                 (SNMPAlarmCallback *) updateLogmatch_Scheduled,
                                 &logmatchTable[logmatchCount]);
+#endif
         }
 
         logmatchCount++;
@@ -474,15 +815,28 @@ logmatch_free_config(void)
 
     /*
      * ------------------------------------
-     * the only memory we have allocated
-     * is the memory allocated by regcomp
+     * save what has not been saved yet and
+     * free the memory allocated by regcomp
+     * and the open files
      * ------------------------------------
      */
 
     for (i = 0; i < logmatchCount; i++) {
+        if (logmatchTable[i].dirty)
+            logmatch_save(i);
         if (logmatchTable[i].myRegexError == 0)
             regfree(&logmatchTable[i].regexBuffer);
+        logmatchTable[i].file = NULL;
+    }
+    while (logmatchFiles)
+        logmatch_file_release(logmatchFiles);
+#ifdef NETSNMP_LOGMATCH_INOTIFY
+    if (logmatchInotify >= 0) {
+        unregister_readfd(logmatchInotify);
+        close(logmatchInotify);
+        logmatchInotify = -1;
     }
+#endif
     logmatchCount = 0;
 }
 
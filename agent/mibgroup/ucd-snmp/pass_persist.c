@@ -44,6 +44,19 @@
 
 netsnmp_feature_require(get_exten_instance);
 netsnmp_feature_require(parse_miboid);
+netsnmp_feature_require(handler_mark_requests_as_delegated);
+
+/*
+ * A batch of get/getnext/getbulk commands written to a script in one go,
+ * for all varbinds of one request that fall into its subtree.  The
+ * requests are delegated until the replies have been read.
+ */
+struct persist_batch {
+    netsnmp_delegated_cache *cache;
+    int             count;
+    char           *ops;        /* 'g'et, get 'n'ext or get'b'ulk */
+    struct persist_batch *next;
+};
 
 struct extensible *persistpassthrus = NULL;
 int             numpersistpassthrus = 0;
@@ -51,6 +64,10 @@ struct persist_pipe_type {
     FILE           *fIn, *fOut;
     int             fdIn, fdOut;
     netsnmp_pid_t   pid;
+    int             batch;      /* script accepts batched requests */
+    struct persist_batch *pending, *last;       /* sent, oldest first */
+    char           *rbuf;       /* replies read for pending batches */
+    size_t          rlen, rsize;
 }              *persist_pipes = (struct persist_pipe_type *) NULL;
 static unsigned pipe_check_alarm_id;
 static int      init_persist_pipes(void);
@@ -59,6 +76,8 @@ static int      open_persist_pipe(int iindex, char *command);
 static void     check_persist_pipes(unsigned clientreg, void *clientarg);
 static void     destruct_persist_pipes(void);
 static int      write_persist_pipe(int iindex, const char *data);
+static Netsnmp_Node_Handler pass_persist_handler;
+static void     read_persist_pipe(int fd, void *data);
 
 /*
  * the relocatable extensible commands variables 
@@ -128,6 +147,44 @@ pass_persist_group(struct extensible *persistpassthrus)
 }
 #endif /* USING_SINGLE_COMMON_PASSPERSIST_INSTANCE */
 
+/*
+ * registers the subtree of a pass_persist line, like register_mib_priority()
+ * would, but with pass_persist_handler() in front of the old API handler so
+ * that GET and GETNEXT requests can be batched
+ */
+static void
+pass_persist_register(struct extensible *persistpassthru)
+{
+    netsnmp_handler_registration *reginfo;
+    netsnmp_mib_handler *handler;
+
+    handler = netsnmp_create_handler("old_api", netsnmp_old_api_helper);
+    if (handler == NULL)
+        return;
+    handler->myvoid = extensible_persist_passthru_variables;
+
+    reginfo = netsnmp_handler_registration_create("pass_persist", handler,
+                                                  persistpassthru->miboid,
+                                                  persistpassthru->miblen,
+                                                  HANDLER_CAN_RWRITE);
+    if (reginfo == NULL) {
+        netsnmp_handler_free(handler);
+        return;
+    }
+    reginfo->priority = persistpassthru->mibpriority;
+
+    handler = netsnmp_create_handler("pass_persist", pass_persist_handler);
+    if (handler == NULL ||
+        netsnmp_inject_handler(reginfo, handler) != SNMPERR_SUCCESS) {
+        netsnmp_handler_free(handler);
+        netsnmp_handler_registration_free(reginfo);
+        return;
+    }
+    handler->myvoid = persistpassthru;
+
+    netsnmp_register_handler(reginfo);
+}
+
 void
 pass_persist_parse_config(const char *token, char *cptr)
 {
@@ -207,10 +264,7 @@ pass_persist_parse_config(const char *token, char *cptr)
     strlcpy((*ppass)->name, (*ppass)->command, sizeof((*ppass)->name));
     (*ppass)->next = NULL;
 
-    register_mib_priority("pass_persist",
-                 (struct variable *) extensible_persist_passthru_variables,
-                 sizeof(struct variable2), 1, (*ppass)->miboid,
-                 (*ppass)->miblen, (*ppass)->mibpriority);
+    pass_persist_register(*ppass);
 
     /*
      * argggg -- pasthrus must be sorted 
@@ -486,6 +540,324 @@ setPassPersist(int action,
     return SNMP_ERR_NOSUCHNAME;
 }
 
+/*
+ * Sends all GET or GETNEXT requests for a subtree to a script which
+ * announced "batch" in its PONG as one batch, and delegates them until
+ * read_persist_pipe() has read the replies.  Everything else goes to the
+ * old API handler below, which asks the script one varbind at a time.
+ */
+static int
+pass_persist_handler(netsnmp_mib_handler *handler,
+                     netsnmp_handler_registration *reginfo,
+                     netsnmp_agent_request_info *reqinfo,
+                     netsnmp_request_info *requests)
+{
+    struct extensible *persistpassthru =
+        (struct extensible *) handler->myvoid;
+    struct extensible *ptmp;
+    struct persist_pipe_type *pipe;
+    struct persist_batch *batch;
+    netsnmp_request_info *request;
+    netsnmp_variable_list *var;
+    char            buf[SNMP_MAXBUF], num[32];
+    u_char         *cmd = NULL;
+    size_t          cmd_len = 0, cmd_off = 0;
+    int             pipe_idx, count, rtest, ok;
+
+    if (reqinfo->mode != MODE_GET && reqinfo->mode != MODE_GETNEXT)
+        return netsnmp_call_next_handler(handler, reginfo, reqinfo,
+                                         requests);
+
+    init_persist_pipes();
+    for (pipe_idx = 1, ptmp = persistpassthrus;
+         ptmp != NULL && ptmp != persistpassthru;
+         ptmp = ptmp->next, pipe_idx++);
+#ifdef USING_SINGLE_COMMON_PASSPERSIST_INSTANCE
+    if (ptmp != NULL)
+        pipe_idx = get_exten_group_id(persistpassthru->passpersist_inst,
+                                      pipe_idx);
+#endif /* USING_SINGLE_COMMON_PASSPERSIST_INSTANCE */
+
+    /*
+     * the old API handler starts the script and finds out whether it
+     * knows about batches
+     */
+    if (ptmp == NULL || persist_pipes == NULL ||
+        pipe_idx > numpersistpassthrus)
+        return netsnmp_call_next_handler(handler, reginfo, reqinfo,
+                                         requests);
+    pipe = &persist_pipes[pipe_idx];
+    if (pipe->pid == NETSNMP_NO_SUCH_PROCESS || !pipe->batch)
+        return netsnmp_call_next_handler(handler, reginfo, reqinfo,
+                                         requests);
+
+    for (count = 0, request = requests; request;
+         request = request->next, count++);
+    snprintf(num, sizeof(num), "batch\n%d\n", count);
+    ok = snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, num);
+
+    batch = SNMP_MALLOC_TYPEDEF(struct persist_batch);
+    if (batch)
+        batch->ops = (char *) malloc(count);
+    if (batch == NULL || batch->ops == NULL)
+        ok = 0;
+
+    for (count = 0, request = requests; ok && request;
+         request = request->next, count++) {
+        var = request->requestvb;
+        rtest = snmp_oidtree_compare(var->name, var->name_length,
+                                     persistpassthru->miboid,
+                                     persistpassthru->miblen);
+        if (persistpassthru->miblen >= var->name_length || rtest < 0)
+            sprint_mib_oid(buf, persistpassthru->miboid,
+                           persistpassthru->miblen);
+        else
+            sprint_mib_oid(buf, var->name, var->name_length);
+
+        if (reqinfo->mode == MODE_GET) {
+            batch->ops[count] = 'g';
+            ok = snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, "get\n");
+        } else if (reqinfo->asp->pdu->command == SNMP_MSG_GETBULK &&
+                   request->repeat > 0) {
+            batch->ops[count] = 'b';
+            ok = snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, "getbulk\n");
+        } else {
+            batch->ops[count] = 'n';
+            ok = snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, "getnext\n");
+        }
+        ok = ok && snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, buf) &&
+            snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, "\n");
+        if (batch->ops[count] == 'b') {
+            snprintf(num, sizeof(num), "%d\n", request->repeat + 1);
+            ok = ok && snmp_cstrcat(&cmd, &cmd_len, &cmd_off, 1, num);
+        }
+    }
+    if (ok)
+        batch->cache = netsnmp_create_delegated_cache(handler, reginfo,
+                                                      reqinfo, requests,
+                                                      NULL);
+
+    DEBUGMSGTL(("ucd-snmp/pass_persist", "persistpass-sending:\n%s",
+                ok ? (char *) cmd : ""));
+    if (!ok || batch->cache == NULL ||
+        !write_persist_pipe(pipe_idx, (char *) cmd)) {
+        /*
+         * close_persist_pipe is called in write_persist_pipe; the old API
+         * handler starts the script again
+         */
+        free(cmd);
+        if (batch) {
+            free(batch->ops);
+            netsnmp_free_delegated_cache(batch->cache);
+            free(batch);
+        }
+        return netsnmp_call_next_handler(handler, reginfo, reqinfo,
+                                         requests);
+    }
+    free(cmd);
+
+    batch->count = count;
+    if (pipe->pending == NULL) {
+        register_readfd(pipe->fdIn, read_persist_pipe, pipe);
+        pipe->pending = batch;
+    } else
+        pipe->last->next = batch;
+    pipe->last = batch;
+
+    netsnmp_handler_mark_requests_as_delegated(requests,
+                                               REQUEST_IS_DELEGATED);
+    return SNMP_ERR_NOERROR;
+}
+
+/*
+ * copies the next reply line, like fgets() would
+ */
+static void
+persist_reply_line(const char **cp, const char *end, char *line,
+                   size_t size)
+{
+    const char     *nl = memchr(*cp, '\n', end - *cp);
+    size_t          len = nl - *cp + 1;
+
+    if (len >= size)
+        len = size - 1;
+    memcpy(line, *cp, len);
+    line[len] = '\0';
+    *cp = nl + 1;
+}
+
+/*
+ * returns the length of the replies to batch if they have all been read,
+ * 0 otherwise
+ */
+static size_t
+persist_batch_replies(struct persist_pipe_type *pipe,
+                      struct persist_batch *batch)
+{
+    const char     *cp = pipe->rbuf, *end = pipe->rbuf + pipe->rlen;
+    const char     *nl;
+    int             i, lines, none;
+
+    for (i = 0; i < batch->count; i++) {
+        do {
+            if ((nl = memchr(cp, '\n', end - cp)) == NULL)
+                return 0;
+            none = !strncmp(cp, "NONE", 4);
+            cp = nl + 1;
+            for (lines = none ? 0 : 2; lines > 0; lines--) {
+                if ((nl = memchr(cp, '\n', end - cp)) == NULL)
+                    return 0;
+                cp = nl + 1;
+            }
+        } while (batch->ops[i] == 'b' && !none);
+    }
+    return cp - pipe->rbuf;
+}
+
+/*
+ * puts the replies to a batch into its requests, which are no longer
+ * delegated afterwards.  A getbulk reply may hold further repetitions,
+ * which are filled in as far as the request allows.
+ */
+static void
+finish_persist_batch(struct persist_pipe_type *pipe,
+                     struct persist_batch *batch, size_t len)
+{
+    netsnmp_delegated_cache *cache;
+    netsnmp_request_info *request;
+    struct variable var;
+    const char     *cp = pipe->rbuf, *end = pipe->rbuf + len;
+    char            buf[SNMP_MAXBUF];
+    static char     buf2[SNMP_MAXBUF];
+    oid             newname[MAX_OID_LEN];
+    u_char         *val;
+    size_t          var_len;
+    int             i, n, newlen, mode, ok;
+
+    cache = netsnmp_handler_check_cache(batch->cache);
+    request = cache ? cache->requests : NULL;
+
+    for (i = 0; i < batch->count; i++) {
+        if (request)
+            request->delegated = REQUEST_IS_NOT_DELEGATED;
+        for (n = 0, ok = 1; cp < end; n++) {
+            persist_reply_line(&cp, end, buf, sizeof(buf));
+            /*
+             * persistent scripts return "NONE\n" on invalid items 
+             */
+            if (!strncmp(buf, "NONE", 4))
+                break;
+            newlen = parse_miboid(buf, newname);
+            persist_reply_line(&cp, end, buf, sizeof(buf));
+            persist_reply_line(&cp, end, buf2, sizeof(buf2));
+
+            if (request && ok && newlen > 0) {
+                val = netsnmp_internal_pass_parse(buf, buf2, &var_len,
+                                                  &var);
+                if (n > 0) {
+                    mode = cache->reqinfo->mode;
+                    cache->reqinfo->mode = MODE_GETNEXT;
+                    ok = val != NULL &&
+                        netsnmp_bulk_to_next_repeatable(cache->reqinfo,
+                                                        request) &&
+                        netsnmp_bulk_to_next_advance(request, newname,
+                                                     newlen);
+                    cache->reqinfo->mode = mode;
+                } else
+                    snmp_set_var_objid(request->requestvb, newname, newlen);
+                if (ok && val)
+                    snmp_set_var_typed_value(request->requestvb, var.type,
+                                             val, var_len);
+            }
+            if (batch->ops[i] != 'b')
+                break;
+        }
+        if (request)
+            request = request->next;
+    }
+
+    if (cache && cache->reqinfo->mode == MODE_GETBULK)
+        netsnmp_bulk_to_next_fix_requests(cache->requests);
+}
+
+/*
+ * fails the batches still waiting for replies
+ */
+static void
+fail_persist_batches(struct persist_pipe_type *pipe)
+{
+    struct persist_batch *batch;
+    netsnmp_delegated_cache *cache;
+
+    if (pipe->pending)
+        unregister_readfd(pipe->fdIn);
+    while ((batch = pipe->pending) != NULL) {
+        pipe->pending = batch->next;
+        cache = netsnmp_handler_check_cache(batch->cache);
+        if (cache)
+            netsnmp_handler_mark_requests_as_delegated(cache->requests,
+                                                       REQUEST_IS_NOT_DELEGATED);
+        netsnmp_free_delegated_cache(batch->cache);
+        free(batch->ops);
+        free(batch);
+    }
+    pipe->last = NULL;
+    SNMP_FREE(pipe->rbuf);
+    pipe->rlen = pipe->rsize = 0;
+}
+
+/*
+ * reads replies to pending batches, called when the script's output
+ * becomes readable
+ */
+static void
+read_persist_pipe(int fd, void *data)
+{
+    struct persist_pipe_type *pipe = (struct persist_pipe_type *) data;
+    struct persist_batch *batch;
+    char           *rbuf;
+    ssize_t         got;
+    size_t          len;
+
+    if (pipe->rsize - pipe->rlen < 1024) {
+        len = pipe->rsize ? 2 * pipe->rsize : SNMP_MAXBUF;
+        rbuf = (char *) realloc(pipe->rbuf, len);
+        if (rbuf == NULL) {
+            close_persist_pipe(pipe - persist_pipes);
+            return;
+        }
+        pipe->rbuf = rbuf;
+        pipe->rsize = len;
+    }
+
+    got = read(fd, pipe->rbuf + pipe->rlen, pipe->rsize - pipe->rlen);
+    if (got <= 0) {
+        if (got < 0 && errno == EINTR)
+            return;
+        DEBUGMSGTL(("ucd-snmp/pass_persist",
+                    "read_persist_pipe: no more replies\n"));
+        close_persist_pipe(pipe - persist_pipes);
+        return;
+    }
+    pipe->rlen += got;
+
+    while ((batch = pipe->pending) != NULL &&
+           (len = persist_batch_replies(pipe, batch)) > 0) {
+        finish_persist_batch(pipe, batch, len);
+        pipe->rlen -= len;
+        memmove(pipe->rbuf, pipe->rbuf + len, pipe->rlen);
+
+        pipe->pending = batch->next;
+        netsnmp_free_delegated_cache(batch->cache);
+        free(batch->ops);
+        free(batch);
+    }
+    if (pipe->pending == NULL) {
+        unregister_readfd(fd);
+        pipe->last = NULL;
+    }
+}
+
 int
 pass_persist_compare(const void *a, const void *b)
 {
@@ -524,6 +896,10 @@ init_persist_pipes(void)
             persist_pipes[i].fIn = persist_pipes[i].fOut = (FILE *) 0;
             persist_pipes[i].fdIn = persist_pipes[i].fdOut = -1;
             persist_pipes[i].pid = NETSNMP_NO_SUCH_PROCESS;
+            persist_pipes[i].batch = 0;
+            persist_pipes[i].pending = persist_pipes[i].last = NULL;
+            persist_pipes[i].rbuf = NULL;
+            persist_pipes[i].rlen = persist_pipes[i].rsize = 0;
         }
     }
     return persist_pipes ? 1 : 0;
@@ -601,6 +977,12 @@ open_persist_pipe(int iindex, char *command)
 
     DEBUGMSGTL(("ucd-snmp/pass_persist", "open_persist_pipe(%d,'%s') recurse=%d\n",
                 iindex, command, recurse));
+    /*
+     * The replies to batches already sent come first
+     */
+    while (persist_pipes[iindex].pending)
+        read_persist_pipe(persist_pipes[iindex].fdIn,
+                          &persist_pipes[iindex]);
     /*
      * Open if it's not already open 
      */
@@ -674,6 +1056,11 @@ open_persist_pipe(int iindex, char *command)
             recurse = 0;
             return 0;
         }
+
+        /*
+         * "PONG batch" announces that the script understands batches
+         */
+        persist_pipes[iindex].batch = !strncmp(buf + 4, " batch", 6);
     }
 
     recurse = 0;
@@ -771,6 +1158,8 @@ close_persist_pipe(int iindex)
     /*
      * Check and nix every item 
      */
+    fail_persist_batches(&persist_pipes[iindex]);
+    persist_pipes[iindex].batch = 0;
     if (persist_pipes[iindex].fOut) {
         fclose(persist_pipes[iindex].fOut);
         persist_pipes[iindex].fOut = (FILE *) 0;
@@ -53,6 +53,7 @@
 #include "proc.h"
 #ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
 #include <net-snmp/data_access/swrun.h>
+#include "host/data_access/swrun.h"
 #endif
 #ifdef USING_UCD_SNMP_ERRORMIB_MODULE
 #include "errormib.h"
@@ -66,6 +67,16 @@ static struct myproc *get_proc_instance(struct myproc *, oid);
 struct myproc  *procwatch = NULL;
 static struct extensible fixproc;
 int             numprocs = 0;
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
+/*
+ * the counts in procwatch are valid for this generation of the
+ * process list, unless the configuration has changed since.
+ */
+static int      proc_counts_valid = 0;
+static u_int    proc_counts_generation;
+#define PROC_HASH_SIZE 256
+static struct myproc *proc_hash[PROC_HASH_SIZE];
+#endif
 
 void
 init_proc(void)
@@ -140,6 +151,9 @@ proc_free_config(void)
     }
     procwatch = NULL;
     numprocs = 0;
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
+    proc_counts_valid = 0;
+#endif
 }
 
 /*
@@ -207,6 +221,9 @@ proc_parse_config(const char *token, char *cptr)
     if (*procp == NULL)
         return;                 /* memory alloc error */
     numprocs++;
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
+    proc_counts_valid = 0;
+#endif
 #if HAVE_PCRE_H
     (*procp)->regexp.regex_ptr = NULL;
 #endif
@@ -383,18 +400,102 @@ get_proc_instance(struct myproc *proc, oid inst)
     return (proc);
 }
 
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
+static u_int
+proc_hash_name(const char *name)
+{
+    u_int           h = 5381;
+
+    while (*name)
+        h = h * 33 + (u_char) *name++;
+    return h % PROC_HASH_SIZE;
+}
+
+/*
+ * count the processes of all proc entries in one pass over the process
+ * list.  Entries without a regexp are found through a hash of their
+ * names, the others are matched against every process as before.  The
+ * counts are kept until the process list is reloaded.
+ */
+static void
+proc_count_all(void)
+{
+    netsnmp_container   *container;
+    netsnmp_iterator    *it;
+    netsnmp_swrun_entry *entry;
+    struct myproc       *proc;
+    u_int                generation;
+#if HAVE_PCRE_H
+    int                  have_regexp = 0;
+    int                  found_ndx[30];
+    char                 fullCommand[64 + 128 + 128 + 3];
+#endif
+
+    generation = swrun_generation();
+    if (proc_counts_valid && generation == proc_counts_generation)
+        return;
+
+    memset(proc_hash, 0, sizeof(proc_hash));
+    for (proc = procwatch; proc; proc = proc->next) {
+        u_int           h;
+
+        proc->count = 0;
+#if HAVE_PCRE_H
+        if (proc->regexp.regex_ptr != NULL) {
+            have_regexp = 1;
+            continue;
+        }
+#endif
+        h = proc_hash_name(proc->name);
+        proc->hash_next = proc_hash[h];
+        proc_hash[h] = proc;
+    }
+
+    container = netsnmp_swrun_container();
+    it = container ? CONTAINER_ITERATOR(container) : NULL;
+    if (NULL == it)
+        return;
+    while ((entry = (netsnmp_swrun_entry *) ITERATOR_NEXT(it)) != NULL) {
+        for (proc = proc_hash[proc_hash_name(entry->hrSWRunName)]; proc;
+             proc = proc->hash_next)
+            if (0 == strcmp(proc->name, entry->hrSWRunName)) {
+                proc->count++;
+                break;          /* names are unique */
+            }
+#if HAVE_PCRE_H
+        if (!have_regexp)
+            continue;
+        /* need to assemble full command back so regexps can get full picture */
+        sprintf(fullCommand, "%s %s", entry->hrSWRunPath,
+                entry->hrSWRunParameters);
+        for (proc = procwatch; proc; proc = proc->next)
+            if (proc->regexp.regex_ptr != NULL &&
+                pcre_exec(proc->regexp.regex_ptr, NULL, fullCommand,
+                          strlen(fullCommand), 0, 0, found_ndx, 30) > 0)
+                proc->count++;
+#endif
+    }
+    ITERATOR_RELEASE(it);
+
+    DEBUGMSGTL(("ucd-snmp/proc", "counted %d entries, generation %u\n",
+                numprocs, generation));
+    proc_counts_generation = generation;
+    proc_counts_valid = 1;
+}
+#endif /* USING_HOST_DATA_ACCESS_SWRUN_MODULE */
+
 int
 sh_count_myprocs(struct myproc *proc)
 {
     if (proc == NULL)
         return 0;
 
-#if defined(USING_HOST_DATA_ACCESS_SWRUN_MODULE) && defined(HAVE_PCRE_H)
-    if (proc->regexp.regex_ptr != NULL)
-      return sh_count_procs_by_regex(proc->name, proc->regexp);
-#endif
-
+#ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
+    proc_count_all();
+    return proc->count;
+#else
     return sh_count_procs(proc->name);
+#endif
 }
 
 #ifdef USING_HOST_DATA_ACCESS_SWRUN_MODULE
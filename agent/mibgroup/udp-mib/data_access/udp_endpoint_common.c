@@ -22,6 +22,8 @@ netsnmp_feature_child_of(udp_endpoint_entry_create, udp_endpoint_common);
 /*
  * local static vars
  */
+static void _netsnmp_access_udp_endpoint_entry_free(void *data,
+                                                    void *context);
 
 
 /**---------------------------------------------------------------------*/
@@ -78,8 +80,11 @@ netsnmp_access_udp_endpoint_container_load(netsnmp_container* container,
         return NULL;
     }
 
+    CONTAINER_BULK_BEGIN(container);
     rc =
         netsnmp_arch_udp_endpoint_container_load(container, load_flags);
+    CONTAINER_BULK_END(container, _netsnmp_access_udp_endpoint_entry_free,
+                       NULL);
     if (0 != rc) {
         netsnmp_access_udp_endpoint_container_free(container, 0);
         container = NULL;
@@ -19,11 +19,13 @@
 
 #include "udp-mib/udpEndpointTable/udpEndpointTable_constants.h"
 #include "mibgroup/util_funcs/get_pid_from_inode.h"
+#include "mibgroup/util_funcs/sock_diag.h"
 #include "udp_endpoint_private.h"
 
 #include <fcntl.h>
 
 netsnmp_feature_require(text_utils);
+netsnmp_feature_require(udp_endpoint_entry_create);
 netsnmp_feature_child_of(udp_endpoint_all, libnetsnmpmibs);
 netsnmp_feature_child_of(udp_endpoint_writable, udp_endpoint_all);
 
@@ -31,6 +33,9 @@ static int _load4(netsnmp_container *container, u_int flags);
 #if defined (NETSNMP_ENABLE_IPV6)
 static int _load6(netsnmp_container *container, u_int flags);
 #endif
+#ifdef NETSNMP_SOCK_DIAG
+static int _load_diag(netsnmp_container *container, int fd, int family);
+#endif
 
 /*
  * initialize arch specific storage
@@ -93,26 +98,62 @@ netsnmp_arch_udp_endpoint_container_load(netsnmp_container *container,
                                     u_int load_flags )
 {
     int rc = 0;
+#ifdef NETSNMP_SOCK_DIAG
+    int fd;
+#endif
 
     /* Setup the pid_from_inode table, and fill it.*/
     netsnmp_get_pid_from_inode_init();
 
+#ifdef NETSNMP_SOCK_DIAG
+    /*
+     * ask the kernel for the sockets via sock_diag if possible, which
+     * is much cheaper than parsing /proc/net/udp* on busy systems.  A
+     * family sock_diag can't report (-2, e.g. no udp_diag module) is
+     * read from procfs instead.
+     */
+    fd = netsnmp_sock_diag_open();
+    if (fd >= 0)
+        rc = _load_diag(container, fd, AF_INET);
+    if (fd < 0 || -2 == rc)
+        rc = _load4(container, load_flags);
+#else
     rc = _load4(container, load_flags);
+#endif
     if(rc < 0) {
         u_int flags = NETSNMP_ACCESS_UDP_ENDPOINT_FREE_KEEP_CONTAINER;
         netsnmp_access_udp_endpoint_container_free(container, flags);
+#ifdef NETSNMP_SOCK_DIAG
+        if (fd >= 0)
+            close(fd);
+#endif
         return rc;
     }
 
 #if defined (NETSNMP_ENABLE_IPV6)
+#ifdef NETSNMP_SOCK_DIAG
+    if (fd >= 0)
+        rc = _load_diag(container, fd, AF_INET6);
+    if (fd < 0 || -2 == rc)
+        rc = _load6(container, load_flags);
+#else
     rc = _load6(container, load_flags);
+#endif
     if(rc < 0) {
         u_int flags = NETSNMP_ACCESS_UDP_ENDPOINT_FREE_KEEP_CONTAINER;
         netsnmp_access_udp_endpoint_container_free(container, flags);
+#ifdef NETSNMP_SOCK_DIAG
+        if (fd >= 0)
+            close(fd);
+#endif
         return rc;
     }
 #endif
 
+#ifdef NETSNMP_SOCK_DIAG
+    if (fd >= 0)
+        close(fd);
+#endif
     return 0;
 }
 
@@ -314,3 +355,71 @@ _load6(netsnmp_container *container, u_int load_flags)
     return (NULL == container);
 }
 #endif /* NETSNMP_ENABLE_IPV6 */
+
+#ifdef NETSNMP_SOCK_DIAG
+/*
+ * sock_diag callback: add one socket to the container
+ */
+static int
+_add_diag_entry(const struct inet_diag_msg *r, void *context)
+{
+    netsnmp_container *container = (netsnmp_container *) context;
+    netsnmp_udp_endpoint_entry *ep;
+    int             alen;
+
+    alen = (AF_INET == r->idiag_family) ? 4 : 16;
+    if (alen > (int) sizeof(ep->loc_addr))
+        return 0;
+
+    ep = netsnmp_access_udp_endpoint_entry_create();
+    if (NULL == ep)
+        return -3;
+
+    memcpy(ep->loc_addr, r->id.idiag_src, alen);
+    ep->loc_addr_len = alen;
+    ep->loc_port = ntohs(r->id.idiag_sport);
+    memcpy(ep->rmt_addr, r->id.idiag_dst, alen);
+    ep->rmt_addr_len = alen;
+    ep->rmt_port = ntohs(r->id.idiag_dport);
+    ep->state = r->idiag_state;
+    ep->instance = (u_int)r->idiag_inode;
+    ep->pid = netsnmp_get_pid_from_inode(r->idiag_inode);
+
+    /*
+     * same numbering as the procfs loaders: one index per socket, in
+     * the order they are reported, starting at 0.
+     */
+    ep->index = CONTAINER_SIZE(container);
+
+    if (CONTAINER_INSERT(container, ep) < 0) {
+        DEBUGMSGTL(("access:udp_endpoint:container",
+                    "error inserting entry\n"));
+        netsnmp_access_udp_endpoint_entry_free(ep);
+    }
+    return 0;
+}
+
+/**
+ * load the UDP sockets of one address family via NETLINK_SOCK_DIAG
+ *
+ * @retval  0 no errors
+ * @retval -2 sock_diag not usable for this family, nothing loaded
+ * @retval !0 other errors
+ */
+static int
+_load_diag(netsnmp_container *container, int fd, int family)
+{
+    int             rc;
+
+    if (NULL == container)
+        return -1;
+
+    /* unbound and bound sockets are TCP_CLOSE (7), connected ones
+     * TCP_ESTABLISHED (1); /proc/net/udp lists them all */
+    rc = netsnmp_sock_diag_dump(fd, family, IPPROTO_UDP, ~0U,
+                                _add_diag_entry, container);
+    DEBUGMSGTL(("access:udp_endpoint:container",
+                "sock_diag loaded %d entries (family %d)\n", rc, family));
+    return rc < 0 ? rc : 0;
+}
+#endif /* NETSNMP_SOCK_DIAG */
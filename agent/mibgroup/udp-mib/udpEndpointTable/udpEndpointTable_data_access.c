@@ -212,6 +212,12 @@ _address_type_from_len(int addrlen) {
 	}
 }
 
+static void
+_release_rowreq_ctx(void *rowreq_ctx, void *context)
+{
+    udpEndpointTable_release_rowreq_ctx(rowreq_ctx);
+}
+
 int
 udpEndpointTable_container_load(netsnmp_container *container)
 {
@@ -243,6 +249,10 @@ udpEndpointTable_container_load(netsnmp_container *container)
         netsnmp_access_udp_endpoint_container_free(ep_c, 0);
         return MFD_RESOURCE_UNAVAILABLE;
     }
+    /*
+     * rows are sorted in once they have all been added
+     */
+    CONTAINER_BULK_BEGIN(container);
     for (ep = (netsnmp_udp_endpoint_entry*)ITERATOR_FIRST(ep_it); ep;
          ep = (netsnmp_udp_endpoint_entry*)ITERATOR_NEXT (ep_it)) {
 
@@ -252,6 +262,7 @@ udpEndpointTable_container_load(netsnmp_container *container)
         rowreq_ctx = udpEndpointTable_allocate_rowreq_ctx();
         if (NULL == rowreq_ctx) {
             snmp_log(LOG_ERR, "memory allocation failed\n");
+            CONTAINER_BULK_END(container, _release_rowreq_ctx, NULL);
             return MFD_RESOURCE_UNAVAILABLE;
         }
         udpEndpointLocalAddressType = _address_type_from_len(ep->loc_addr_len);
@@ -291,6 +302,7 @@ udpEndpointTable_container_load(netsnmp_container *container)
     }
 
     ITERATOR_RELEASE(ep_it);
+    CONTAINER_BULK_END(container, _release_rowreq_ctx, NULL);
 
     netsnmp_access_udp_endpoint_container_free(ep_c, 0);
 
@@ -0,0 +1,91 @@
+#include <net-snmp/net-snmp-config.h>
+#include <net-snmp/net-snmp-includes.h>
+
+#include "counter_columns.h"
+
+#if HAVE_STRING_H
+#include <string.h>
+#else
+#include <strings.h>
+#endif
+
+/*
+ * double the slots of each column, moving every column to its new place
+ */
+static int
+_counter_columns_grow(netsnmp_counter_columns *cc)
+{
+    struct counter64 *values;
+    size_t          slots, *free_slots, c;
+
+    slots = cc->slots ? cc->slots * 2 : 16;
+    if (slots > ((size_t)-1) / sizeof(struct counter64) / cc->columns)
+        return -1;
+
+    values = (struct counter64 *) calloc(slots * cc->columns,
+                                         sizeof(struct counter64));
+    if (NULL == values)
+        return -1;
+    free_slots = (size_t *) realloc(cc->free_slots, slots * sizeof(size_t));
+    if (NULL == free_slots) {
+        free(values);
+        return -1;
+    }
+    cc->free_slots = free_slots;
+
+    for (c = 0; c < cc->columns && cc->used; ++c)
+        memcpy(&values[c * slots], &cc->values[c * cc->slots],
+               cc->used * sizeof(struct counter64));
+    free(cc->values);
+    cc->values = values;
+    cc->slots = slots;
+
+    return 0;
+}
+
+/**
+ * give a new row a slot, with all its counters zero
+ *
+ * @retval >=0 the slot
+ * @retval  -1 out of memory
+ */
+int
+netsnmp_counter_columns_attach(netsnmp_counter_columns *cc)
+{
+    int             slot;
+
+    if (cc->free_count)
+        slot = cc->free_slots[--cc->free_count];
+    else {
+        if ((cc->used == cc->slots) && (_counter_columns_grow(cc) != 0)) {
+            snmp_log(LOG_ERR, "no memory for counter columns\n");
+            return -1;
+        }
+        slot = cc->used++;
+    }
+    ++cc->count;
+    return slot;
+}
+
+/**
+ * release the slot of a row (a negative slot is ignored)
+ */
+void
+netsnmp_counter_columns_detach(netsnmp_counter_columns *cc, int slot)
+{
+    size_t          c;
+
+    if (slot < 0)
+        return;
+
+    if (0 == --cc->count) {
+        SNMP_FREE(cc->values);
+        SNMP_FREE(cc->free_slots);
+        cc->slots = cc->used = cc->free_count = 0;
+        return;
+    }
+    for (c = 0; c < cc->columns; ++c)
+        memset(&NETSNMP_COUNTER_COLUMN(cc, c, slot), 0,
+               sizeof(struct counter64));
+    cc->free_slots[cc->free_count++] = slot;
+}
@@ -0,0 +1,48 @@
+/*
+ * util_funcs/counter_columns.h:  counter64 columns of a table, stored by
+ * column instead of in each row.
+ */
+#ifndef NETSNMP_MIBGROUP_UTIL_FUNCS_COUNTER_COLUMNS_H
+#define NETSNMP_MIBGROUP_UTIL_FUNCS_COUNTER_COLUMNS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * A table opts in by keeping one netsnmp_counter_columns for its
+ * counter64 columns, giving each row a slot when its rowreq_ctx is
+ * initialized (netsnmp_counter_columns_attach()) and releasing it on
+ * cleanup.  Its loader then writes the counters of a row straight into
+ * NETSNMP_COUNTER_COLUMN(), which is the only place they are kept, and
+ * the column getters read them from there.  A column walk thus reads
+ * consecutive memory rather than one data structure per row.
+ *
+ * Column c of the row in slot s is at values[c * slots + s].  The
+ * values are allocated with the first slot and freed with the last one;
+ * released slots are reused first.
+ */
+typedef struct netsnmp_counter_columns_s {
+    size_t          columns;
+    struct counter64 *values;
+    size_t          slots;      /* per column */
+    size_t          used;       /* slots handed out so far */
+    size_t          count;      /* slots in use */
+    size_t         *free_slots; /* released slots */
+    size_t          free_count;
+} netsnmp_counter_columns;
+
+#define NETSNMP_COUNTER_COLUMNS_INIT(columns) { columns, NULL, 0, 0, 0, NULL, 0 }
+
+#define NETSNMP_COUNTER_COLUMN(cc, column, slot)                        \
+    ((cc)->values[(size_t)(column) * (cc)->slots + (size_t)(slot)])
+
+int             netsnmp_counter_columns_attach(netsnmp_counter_columns *cc);
+void            netsnmp_counter_columns_detach(netsnmp_counter_columns *cc,
+                                               int slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NETSNMP_MIBGROUP_UTIL_FUNCS_COUNTER_COLUMNS_H */
@@ -0,0 +1,126 @@
+#include <net-snmp/net-snmp-config.h>
+
+#include "sock_diag.h"
+
+#include <net-snmp/output_api.h>
+
+#include <errno.h>
+#if HAVE_STRING_H
+#include <string.h>
+#else
+#include <strings.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#ifdef NETSNMP_SOCK_DIAG
+
+/*
+ * open a netlink socket for netsnmp_sock_diag_dump()
+ *
+ * @retval >=0 the socket, to be closed by the caller
+ * @retval  <0 sock_diag is not available
+ */
+int
+netsnmp_sock_diag_open(void)
+{
+    int             fd;
+
+    fd = socket(AF_NETLINK, SOCK_DGRAM, NETLINK_SOCK_DIAG);
+    if (fd < 0)
+        DEBUGMSGTL(("sock_diag", "socket: %s\n", strerror(errno)));
+    return fd;
+}
+
+/*
+ * dump the sockets of one address family and protocol whose state is in
+ * the states bit mask (bit n set for kernel state n), and hand each of
+ * them to callback in the order the kernel reports them.
+ *
+ * @retval >=0 number of sockets passed to callback
+ * @retval  -2 the kernel can't report these sockets (e.g. the diag module
+ *             for the protocol isn't available); callback was not called
+ * @retval  -1 the dump failed after some sockets had been reported
+ * @retval  <0 other values are returned by callback
+ *
+ * After -1 or an error from callback the rest of the dump may still be
+ * pending on fd, so it should not be used for another request.
+ */
+int
+netsnmp_sock_diag_dump(int fd, int family, int protocol, unsigned int states,
+                       NetsnmpSockDiagCallback *callback, void *context)
+{
+    struct {
+        struct nlmsghdr nlh;
+        struct inet_diag_req_v2 r;
+    } req;
+    struct sockaddr_nl nladdr;
+    struct nlmsghdr *h;
+    char            buf[32768];
+    int             len, count = 0, rc;
+    __u32           seq = (__u32) family << 8 | protocol;
+
+    memset(&req, 0, sizeof(req));
+    req.nlh.nlmsg_len = sizeof(req);
+    req.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nlh.nlmsg_seq = seq;
+    req.r.sdiag_family = family;
+    req.r.sdiag_protocol = protocol;
+    req.r.idiag_states = states;
+
+    memset(&nladdr, 0, sizeof(nladdr));
+    nladdr.nl_family = AF_NETLINK;
+    if (sendto(fd, &req, sizeof(req), 0, (struct sockaddr *) &nladdr,
+               sizeof(nladdr)) < 0) {
+        DEBUGMSGTL(("sock_diag", "send: %s\n", strerror(errno)));
+        return -2;
+    }
+
+    for (;;) {
+        len = recv(fd, buf, sizeof(buf), 0);
+        if (len < 0) {
+            if (errno == EINTR)
+                continue;
+            snmp_log(LOG_ERR, "sock_diag: recv: %s\n", strerror(errno));
+            return count ? -1 : -2;
+        }
+        if (len == 0)
+            return count ? -1 : -2;
+
+        for (h = (struct nlmsghdr *) buf; NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            struct inet_diag_msg *r;
+
+            if (h->nlmsg_seq != seq)
+                continue;
+            if (h->nlmsg_type == NLMSG_DONE) {
+                DEBUGMSGTL(("sock_diag", "%d sockets (family %d proto %d)\n",
+                            count, family, protocol));
+                return count;
+            }
+            if (h->nlmsg_type == NLMSG_ERROR) {
+                struct nlmsgerr *err = (struct nlmsgerr *) NLMSG_DATA(h);
+
+                DEBUGMSGTL(("sock_diag", "error %d (family %d proto %d)\n",
+                            err->error, family, protocol));
+                return count ? -1 : -2;
+            }
+            if (h->nlmsg_type != SOCK_DIAG_BY_FAMILY ||
+                h->nlmsg_len < NLMSG_LENGTH(sizeof(*r)))
+                continue;
+
+            r = (struct inet_diag_msg *) NLMSG_DATA(h);
+            if (r->idiag_family != family)
+                continue;
+
+            rc = (*callback)(r, context);
+            if (rc < 0)
+                return rc;
+            ++count;
+        }
+    }
+}
+
+#endif /* NETSNMP_SOCK_DIAG */
@@ -0,0 +1,36 @@
+/*
+ * util_funcs/sock_diag.h:  utility functions to dump the sockets of one
+ * protocol via the linux NETLINK_SOCK_DIAG (inet_diag) interface.
+ */
+#ifndef NETSNMP_MIBGROUP_UTIL_FUNCS_SOCK_DIAG_H
+#define NETSNMP_MIBGROUP_UTIL_FUNCS_SOCK_DIAG_H
+
+#ifndef linux
+config_error(sock_diag is only suppored on linux)
+#endif
+
+#ifdef HAVE_LINUX_NETLINK_H
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#ifdef SOCK_DIAG_BY_FAMILY
+#define NETSNMP_SOCK_DIAG 1
+#endif
+#endif
+
+#ifdef NETSNMP_SOCK_DIAG
+/*
+ * called for every socket reported by the kernel.  A negative return
+ * value stops the dump and is passed on to the caller.
+ */
+typedef int (NetsnmpSockDiagCallback)(const struct inet_diag_msg *msg,
+                                      void *context);
+
+int netsnmp_sock_diag_open(void);
+int netsnmp_sock_diag_dump(int fd, int family, int protocol,
+                           unsigned int states,
+                           NetsnmpSockDiagCallback *callback, void *context);
+#endif /* NETSNMP_SOCK_DIAG */
+
+#endif /* NETSNMP_MIBGROUP_UTIL_FUNCS_SOCK_DIAG_H */
@@ -82,6 +82,7 @@ SOFTWARE.
 #include <net-snmp/net-snmp-includes.h>
 #include <net-snmp/agent/net-snmp-agent-includes.h>
 #include <net-snmp/library/large_fd_set.h>
+#include <net-snmp/library/fd_event_epoll.h>
 #include <net-snmp/library/snmp_assert.h>
 #include "agent_global_vars.h"
 
@@ -121,6 +122,7 @@ netsnmp_feature_child_of(check_requests_error, snmp_agent);
 netsnmp_feature_child_of(request_set_error_idx, snmp_agent);
 netsnmp_feature_child_of(set_agent_uptime, snmp_agent);
 netsnmp_feature_child_of(agent_check_and_process, snmp_agent);
+netsnmp_feature_want(fd_event_epoll);
 
 netsnmp_feature_child_of(dump_sess_list, agent_debugging_utilities);
 
@@ -268,6 +270,202 @@ _dump_pdu_stats(void)
 }
 #endif /* NETSNMP_NO_PDU_STATS */
 
+/*
+ * Per-PDU arena.  The request info, the request array and the GETBULK
+ * varbind cache of an agent session (and data list nodes handlers
+ * create with netsnmp_agent_arena_data_list()) are carved out of a short
+ * chain of chunks owned by the session, which free_agent_snmp_session()
+ * releases in one step.  Released chunks are kept on per-size free lists
+ * and reused for the next PDU.
+ */
+struct netsnmp_agent_arena_s {
+    struct netsnmp_agent_arena_s *next;
+    size_t          size;       /* usable bytes following the header */
+    size_t          used;
+};
+
+#define AGENT_ARENA_ALIGN    16
+#define AGENT_ARENA_HDR_SIZE \
+    ((sizeof(netsnmp_agent_arena) + AGENT_ARENA_ALIGN - 1) & \
+     ~(size_t)(AGENT_ARENA_ALIGN - 1))
+#define AGENT_ARENA_BUCKETS  3
+#define AGENT_ARENA_FREE_MAX 8  /* chunks kept per bucket */
+
+static const size_t agent_arena_chunk_size[AGENT_ARENA_BUCKETS] =
+    { 2048, 8192, 32768 };
+static netsnmp_agent_arena *agent_arena_free[AGENT_ARENA_BUCKETS];
+static int      agent_arena_free_count[AGENT_ARENA_BUCKETS];
+
+static netsnmp_agent_arena *
+_agent_arena_new_chunk(size_t size)
+{
+    netsnmp_agent_arena *chunk;
+    int             i;
+
+    for (i = 0; i < AGENT_ARENA_BUCKETS; i++) {
+        if (size > agent_arena_chunk_size[i] - AGENT_ARENA_HDR_SIZE)
+            continue;
+        if (agent_arena_free[i]) {
+            chunk = agent_arena_free[i];
+            agent_arena_free[i] = chunk->next;
+            agent_arena_free_count[i]--;
+        } else {
+            chunk = (netsnmp_agent_arena *)malloc(agent_arena_chunk_size[i]);
+            if (chunk == NULL)
+                return NULL;
+            chunk->size = agent_arena_chunk_size[i] - AGENT_ARENA_HDR_SIZE;
+        }
+        chunk->next = NULL;
+        chunk->used = 0;
+        return chunk;
+    }
+
+    /* too big for the free lists: allocated for this PDU only */
+    chunk = (netsnmp_agent_arena *)malloc(AGENT_ARENA_HDR_SIZE + size);
+    if (chunk == NULL)
+        return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+static void
+_agent_arena_release(netsnmp_agent_arena *arena)
+{
+    netsnmp_agent_arena *next;
+    int             i;
+
+    for (; arena; arena = next) {
+        next = arena->next;
+        for (i = 0; i < AGENT_ARENA_BUCKETS; i++)
+            if (arena->size + AGENT_ARENA_HDR_SIZE ==
+                agent_arena_chunk_size[i])
+                break;
+        if (i < AGENT_ARENA_BUCKETS &&
+            agent_arena_free_count[i] < AGENT_ARENA_FREE_MAX) {
+            arena->next = agent_arena_free[i];
+            agent_arena_free[i] = arena;
+            agent_arena_free_count[i]++;
+        } else
+            free(arena);
+    }
+}
+
+static void
+_agent_arena_shutdown(void)
+{
+    netsnmp_agent_arena *chunk;
+    int             i;
+
+    for (i = 0; i < AGENT_ARENA_BUCKETS; i++) {
+        while ((chunk = agent_arena_free[i]) != NULL) {
+            agent_arena_free[i] = chunk->next;
+            free(chunk);
+        }
+        agent_arena_free_count[i] = 0;
+    }
+}
+
+static int
+_agent_arena_owns(const netsnmp_agent_arena *arena, const void *ptr)
+{
+    const u_char   *p = (const u_char *) ptr;
+
+    for (; arena; arena = arena->next)
+        if (p >= (const u_char *) arena + AGENT_ARENA_HDR_SIZE &&
+            p < (const u_char *) arena + AGENT_ARENA_HDR_SIZE + arena->used)
+            return 1;
+    return 0;
+}
+
+/**
+ * Allocates zeroed memory that lives as long as the agent session of
+ * the current PDU.  It must not be passed to free(); it is released
+ * together with the session.
+ *
+ * @param asp  the agent session
+ * @param size number of bytes needed
+ *
+ * @return pointer to the memory, or NULL if out of memory.
+ */
+void *
+netsnmp_agent_arena_alloc(netsnmp_agent_session *asp, size_t size)
+{
+    netsnmp_agent_arena *chunk;
+    u_char         *p;
+
+    if (asp == NULL)
+        return NULL;
+
+    size = (size + AGENT_ARENA_ALIGN - 1) & ~(size_t)(AGENT_ARENA_ALIGN - 1);
+    chunk = asp->arena;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        chunk = _agent_arena_new_chunk(size);
+        if (chunk == NULL)
+            return NULL;
+        chunk->next = asp->arena;
+        asp->arena = chunk;
+    }
+    p = (u_char *) chunk + AGENT_ARENA_HDR_SIZE + chunk->used;
+    chunk->used += size;
+    memset(p, 0, size);
+    return p;
+}
+
+/**
+ * Creates a data list node, like netsnmp_create_data_list(), whose node
+ * and name copy are allocated from the arena of the PDU being processed.
+ * Pass the result to netsnmp_agent_add_list_data() as usual; the data
+ * free function is still called when the request info is released.
+ * Falls back to a heap allocated node if the request info is not
+ * attached to an agent session.
+ */
+netsnmp_data_list *
+netsnmp_agent_arena_data_list(netsnmp_agent_request_info *ari,
+                              const char *name, void *data,
+                              Netsnmp_Free_List_Data * free_func)
+{
+    netsnmp_data_list *node;
+    size_t          len;
+
+    if (!name)
+        return NULL;
+    if (!ari || !ari->asp)
+        return netsnmp_create_data_list(name, data, free_func);
+
+    len = strlen(name) + 1;
+    node = (netsnmp_data_list *)
+        netsnmp_agent_arena_alloc(ari->asp, sizeof(*node) + len);
+    if (!node)
+        return NULL;
+    node->name = (char *) (node + 1);
+    memcpy(node->name, name, len);
+    node->data = data;
+    node->free_func = free_func;
+    return node;
+}
+
+/*
+ * Frees a list of agent data nodes, leaving the ones living in the
+ * session's arena to be released with it.
+ */
+static void
+_agent_free_list_data(netsnmp_agent_session *asp, netsnmp_data_list *head)
+{
+    netsnmp_data_list *next;
+
+    for (; head; head = next) {
+        next = head->next;
+        if (asp && _agent_arena_owns(asp->arena, head)) {
+            if (head->free_func)
+                (head->free_func) (head->data);
+        } else {
+            netsnmp_free_list_data(head);
+            free(head);
+        }
+    }
+}
 
 NETSNMP_INLINE void
 netsnmp_agent_add_list_data(netsnmp_agent_request_info *ari,
@@ -287,9 +485,28 @@ NETSNMP_INLINE int
 netsnmp_agent_remove_list_data(netsnmp_agent_request_info *ari,
                                const char * name)
 {
+    netsnmp_data_list *node, *prev;
+
     if ((NULL == ari) || (NULL == ari->agent_data))
         return 1;
 
+    if (ari->asp && ari->asp->arena) {
+        for (node = ari->agent_data, prev = NULL; node;
+             prev = node, node = node->next) {
+            if (name && node->name && strcmp(node->name, name) == 0)
+                break;
+        }
+        if (node && _agent_arena_owns(ari->asp->arena, node)) {
+            if (prev)
+                prev->next = node->next;
+            else
+                ari->agent_data = node->next;
+            node->next = NULL;
+            _agent_free_list_data(ari->asp, node);
+            return 0;
+        }
+    }
+
     return netsnmp_remove_list_node(&ari->agent_data, name);
 }
 #endif /* NETSNMP_FEATURE_REMOVE_AGENT_REMOVE_LIST_DATA */
@@ -316,7 +533,7 @@ NETSNMP_INLINE void
 netsnmp_free_agent_data_sets(netsnmp_agent_request_info *ari)
 {
     if (ari) {
-        netsnmp_free_all_list_data(ari->agent_data);
+        _agent_free_list_data(ari->asp, ari->agent_data);
     }
 }
 
@@ -325,8 +542,10 @@ netsnmp_free_agent_request_info(netsnmp_agent_request_info *ari)
 {
     if (ari) {
         if (ari->agent_data) {
-            netsnmp_free_all_list_data(ari->agent_data);
+            _agent_free_list_data(ari->asp, ari->agent_data);
 	}
+        if (ari->asp && _agent_arena_owns(ari->asp->arena, ari))
+            return;             /* released with the session */
         SNMP_FREE(ari);
     }
 }
@@ -451,6 +670,7 @@ typedef struct agent_set_cache_s {
     netsnmp_request_info *requests;
     netsnmp_variable_list *saved_vars;
     netsnmp_data_list *agent_data;
+    netsnmp_agent_arena *arena;     /* holds requests and agent_data */
 
     /*
      * list 
@@ -464,6 +684,8 @@ agent_set_cache *
 save_set_cache(netsnmp_agent_session *asp)
 {
     agent_set_cache *ptr;
+    netsnmp_agent_request_info *reqinfo;
+    netsnmp_agent_arena *arena;
 
     if (!asp || !asp->reqinfo || !asp->pdu)
         return NULL;
@@ -472,6 +694,23 @@ save_set_cache(netsnmp_agent_session *asp)
     if (ptr == NULL)
         return NULL;
 
+    /*
+     * the request info stays with this session, so move it out of the
+     * arena that is handed over to the cache.  Do that first, so that
+     * nothing has been handed over yet if it fails.
+     */
+    arena = asp->arena;
+    asp->arena = NULL;
+    reqinfo = (netsnmp_agent_request_info *)
+        netsnmp_agent_arena_alloc(asp, sizeof(netsnmp_agent_request_info));
+    if (reqinfo == NULL) {
+        asp->arena = arena;
+        free(ptr);
+        return NULL;
+    }
+    memcpy(reqinfo, asp->reqinfo, sizeof(netsnmp_agent_request_info));
+    reqinfo->agent_data = NULL;
+
     /*
      * Save the important information 
      */
@@ -486,14 +725,17 @@ save_set_cache(netsnmp_agent_session *asp)
     ptr->requests = asp->requests;
     ptr->saved_vars = asp->pdu->variables; /* requests contains pointers to variables */
     ptr->vbcount = asp->vbcount;
+    ptr->arena = arena;
 
     /*
      * make the agent forget about what we've saved 
      */
     asp->treecache = NULL;
     asp->reqinfo->agent_data = NULL;
+    asp->reqinfo = reqinfo;
     asp->pdu->variables = NULL;
     asp->requests = NULL;
+    asp->bulkcache = NULL;
 
     ptr->next = Sets;
     Sets = ptr;
@@ -538,7 +780,6 @@ get_set_cache(netsnmp_agent_session *asp)
 		for (i = 0; i < asp->vbcount; i++) {
 		    netsnmp_free_request_data_sets(&asp->requests[i]);
 		}
-		free(asp->requests);
 	    }
 	    /*
 	     * If we replace asp->requests with the info from the set cache,
@@ -560,6 +801,18 @@ get_set_cache(netsnmp_agent_session *asp)
             }
             asp->requests = ptr->requests;
 
+            /*
+             * the cached requests live in the arena of the PDU that saved
+             * them; release it together with this one
+             */
+            if (ptr->arena) {
+                netsnmp_agent_arena *last = ptr->arena;
+                while (last->next)
+                    last = last->next;
+                last->next = asp->arena;
+                asp->arena = ptr->arena;
+            }
+
             netsnmp_assert(NULL != asp->reqinfo);
             asp->reqinfo->asp = asp;
             asp->reqinfo->agent_data = ptr->agent_data;
@@ -753,7 +1006,59 @@ _fix_endofmibview(netsnmp_agent_session *asp)
     }
 }
 
+/**
+ * Decide whether the event loop should use the epoll backend.
+ *
+ * Returns 1 if the "useEpoll" directive is set and epoll could be set up.
+ * If it is set but epoll is unavailable, a warning is logged once and the
+ * directive is cleared so that the caller keeps using select().
+ */
+int
+netsnmp_agent_use_epoll(void)
+{
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+    if (!netsnmp_ds_get_boolean(NETSNMP_DS_APPLICATION_ID,
+                                NETSNMP_DS_AGENT_USE_EPOLL)) {
+        if (netsnmp_epoll_active())
+            netsnmp_epoll_shutdown();
+        return 0;
+    }
+    if (netsnmp_epoll_init() == 0)
+        return 1;
+    snmp_log(LOG_WARNING,
+             "useEpoll: epoll is not available, using select() instead\n");
+    netsnmp_ds_set_boolean(NETSNMP_DS_APPLICATION_ID,
+                           NETSNMP_DS_AGENT_USE_EPOLL, 0);
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
+    return 0;
+}
+
 #ifndef NETSNMP_FEATURE_REMOVE_AGENT_CHECK_AND_PROCESS
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+/*
+ * agent_check_and_process() using the epoll backend, see fd_event_epoll.h
+ */
+static int
+_agent_check_and_process_epoll(int block)
+{
+    int             count;
+
+    count = netsnmp_epoll_dispatch(block);
+    if (count == 0) {
+        snmp_timeout();
+    } else if (count < 0) {
+        if (errno != EINTR)
+            snmp_log_perror("epoll_wait");
+        return -1;
+    }
+
+    snmp_store_if_needed();
+    run_alarms();
+    netsnmp_check_outstanding_agent_requests();
+    return count;
+}
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
+
 /**
  * This function checks for packets arriving on the SNMP port and
  * processes them(snmp_read) if some are found, using the select(). If block
@@ -777,6 +1082,11 @@ agent_check_and_process(int block)
     int                  count;
     int                  fakeblock = 0;
 
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+    if (netsnmp_agent_use_epoll())
+        return _agent_check_and_process_epoll(block);
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
+
     numfds = 0;
     netsnmp_large_fd_set_init(&readfds, FD_SETSIZE);
     netsnmp_large_fd_set_init(&writefds, FD_SETSIZE);
@@ -1554,6 +1864,7 @@ void
 shutdown_master_agent(void)
 {
     clear_nsap_list();
+    _agent_arena_shutdown();
 
 #ifndef NETSNMP_NO_PDU_STATS
     _pdu_stats_shutdown();
@@ -1584,7 +1895,8 @@ init_agent_snmp_session(netsnmp_session * session, netsnmp_pdu *pdu)
     asp->oldmode = 0;
     asp->treecache_num = -1;
     asp->treecache_len = 0;
-    asp->reqinfo = SNMP_MALLOC_TYPEDEF(netsnmp_agent_request_info);
+    asp->reqinfo = (netsnmp_agent_request_info *)
+        netsnmp_agent_arena_alloc(asp, sizeof(netsnmp_agent_request_info));
     asp->flags = SNMP_AGENT_FLAGS_NONE;
     DEBUGMSGTL(("verbose:asp", "asp %p reqinfo %p created\n",
                 asp, asp->reqinfo));
@@ -1609,21 +1921,21 @@ free_agent_snmp_session(netsnmp_agent_session *asp)
         snmp_free_pdu(asp->orig_pdu);
     if (asp->pdu)
         snmp_free_pdu(asp->pdu);
-    if (asp->reqinfo)
-        netsnmp_free_agent_request_info(asp->reqinfo);
+    if (asp->reqinfo && asp->reqinfo->agent_data)
+        _agent_free_list_data(asp, asp->reqinfo->agent_data);
     SNMP_FREE(asp->treecache);
-    SNMP_FREE(asp->bulkcache);
     if (asp->requests) {
         int             i;
         for (i = 0; i < asp->vbcount; i++) {
             netsnmp_free_request_data_sets(&asp->requests[i]);
         }
-        SNMP_FREE(asp->requests);
     }
     if (asp->cache_store) {
         netsnmp_free_cachemap(asp->cache_store);
         asp->cache_store = NULL;
     }
+    /* reqinfo, requests and bulkcache */
+    _agent_arena_release(asp->arena);
     SNMP_FREE(asp);
 }
 
@@ -2669,8 +2981,8 @@ netsnmp_create_subtree_cache(netsnmp_agent_session *asp)
                             asp->pdu->errindex));
             }
 
-            asp->bulkcache =
-                (netsnmp_variable_list **) malloc(
+            asp->bulkcache = (netsnmp_variable_list **)
+                netsnmp_agent_arena_alloc(asp,
                     (n + asp->pdu->errindex * r) * sizeof(struct varbind_list *));
 
             if (!asp->bulkcache) {
@@ -3756,7 +4068,9 @@ handle_pdu(netsnmp_agent_session *asp)
     case SNMP_MSG_INTERNAL_SET_RESERVE1:
 #endif /* NETSNMP_NO_WRITE_SUPPORT */
         asp->vbcount = count_varbinds(asp->pdu->variables);
-        asp->requests = calloc(asp->vbcount, sizeof(netsnmp_request_info));
+        asp->requests = (netsnmp_request_info *)
+            netsnmp_agent_arena_alloc(asp, asp->vbcount *
+                                      sizeof(netsnmp_request_info));
         /*
          * collect varbinds 
          */
@@ -129,6 +129,7 @@
 #include "agent_global_vars.h"
 
 #include <net-snmp/library/fd_event_manager.h>
+#include <net-snmp/library/fd_event_epoll.h>
 #include <net-snmp/library/large_fd_set.h>
 
 #include "m2m.h"
@@ -166,6 +167,7 @@
 #endif
 
 netsnmp_feature_want(logging_file);
+netsnmp_feature_want(fd_event_epoll);
 netsnmp_feature_want(logging_stdio);
 netsnmp_feature_want(logging_syslog);
 
@@ -1156,6 +1158,61 @@ static void join_stdin_waiter_thread(void)
 }
 #endif
 
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+/*
+ * One iteration of the main loop using the epoll backend instead of
+ * select(); see fd_event_epoll.h.
+ *
+ * Returns 1 if the caller should go on with its per-iteration
+ * housekeeping, 0 if the wait was interrupted by a signal and -1 on error.
+ */
+static int
+receive_epoll(void)
+{
+    int             count;
+#ifndef NETSNMP_FEATURE_REMOVE_REGISTER_SIGNAL
+    int             i;
+
+    for (i = 0; i < NUM_EXTERNAL_SIGS; i++) {
+        if (external_signal_scheduled[i]) {
+            external_signal_scheduled[i]--;
+            external_signal_handler[i](i);
+        }
+    }
+#endif /* NETSNMP_FEATURE_REMOVE_REGISTER_SIGNAL */
+
+    count = netsnmp_epoll_dispatch(1);
+    DEBUGMSGTL(("snmpd/select", "epoll returned, count = %d\n", count));
+
+    if (count == 0) {
+        snmp_timeout();
+    } else if (count < 0) {
+        DEBUGMSGTL(("snmpd/select", "  errno = %d\n", errno));
+        if (errno == EINTR)
+            return 0;
+        snmp_log_perror("epoll_wait");
+        return -1;
+    }
+    return 1;
+}
+
+static int
+snmpd_use_epoll(void)
+{
+#ifdef	USING_SMUX_MODULE
+    if (smux_listen_sd >= 0 &&
+        netsnmp_ds_get_boolean(NETSNMP_DS_APPLICATION_ID,
+                               NETSNMP_DS_AGENT_USE_EPOLL)) {
+        snmp_log(LOG_WARNING,
+                 "useEpoll: not supported together with SMUX, using select() instead\n");
+        netsnmp_ds_set_boolean(NETSNMP_DS_APPLICATION_ID,
+                               NETSNMP_DS_AGENT_USE_EPOLL, 0);
+    }
+#endif                          /* USING_SMUX_MODULE */
+    return netsnmp_agent_use_epoll();
+}
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
+
 /*******************************************************************-o-******
  * receive
  *
@@ -1215,6 +1272,17 @@ receive(void)
 #endif
         }
 
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+        if (snmpd_use_epoll()) {
+            count = receive_epoll();
+            if (count < 0)
+                return -1;
+            if (count == 0)
+                continue;
+            goto housekeeping;
+        }
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
+
         /*
          * default to sleeping for a really long time. INT_MAX
          * should be sufficient (eg we don't care if time_t is
@@ -1335,6 +1403,9 @@ receive(void)
                 return -1;
             }                   /* endif -- count>0 */
 
+#ifndef NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL
+    housekeeping:
+#endif /* NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL */
         /*
          * see if persistent store needs to be saved
          */
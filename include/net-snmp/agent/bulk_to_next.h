@@ -20,6 +20,27 @@ void            netsnmp_init_bulk_to_next_helper(void);
 void            netsnmp_bulk_to_next_fix_requests(netsnmp_request_info
                                                   *requests);
 
+/*
+ * GETBULK fast path for table helpers: answer several repetitions of a
+ * request in one pass instead of one repetition per getnext loop.
+ */
+int             netsnmp_bulk_to_next_repeatable(netsnmp_agent_request_info
+                                                *reqinfo,
+                                                netsnmp_request_info
+                                                *request);
+int             netsnmp_bulk_to_next_advance(netsnmp_request_info *request,
+                                             const oid *name,
+                                             size_t name_len);
+void            netsnmp_bulk_to_next_trim_data(netsnmp_request_info
+                                               *request, const char *name);
+int             netsnmp_bulk_to_next_call_batch(netsnmp_mib_handler *handler,
+                                                netsnmp_handler_registration
+                                                *reginfo,
+                                                netsnmp_agent_request_info
+                                                *reqinfo,
+                                                netsnmp_request_info **batch,
+                                                int count);
+
 Netsnmp_Node_Handler netsnmp_bulk_to_next_helper;
 
 #ifdef __cplusplus
@@ -66,6 +66,7 @@ extern          "C" {
 	netsnmp_cache *next, *prev;
         oid *rootoid;
         int  rootoid_len;
+        u_long   reload_id;     /* pending background reload alarm id */
 
     };
 
@@ -120,6 +121,7 @@ extern          "C" {
 #define NETSNMP_CACHE_PRELOAD                               0x0010
 #define NETSNMP_CACHE_AUTO_RELOAD                           0x0020
 #define NETSNMP_CACHE_RESET_TIMER_ON_USE                    0x0040
+#define NETSNMP_CACHE_BACKGROUND_RELOAD                     0x0080
 
 #define NETSNMP_CACHE_HINT_HANDLER_ARGS                     0x1000
 
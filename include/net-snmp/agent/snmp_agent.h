@@ -212,8 +212,11 @@ extern          "C" {
         netsnmp_cachemap *cache_store;
         int             vbcount;
         int             flags;
+        struct netsnmp_agent_arena_s *arena; /* memory for this PDU */
     } netsnmp_agent_session;
 
+    typedef struct netsnmp_agent_arena_s netsnmp_agent_arena;
+
     /*
      * Address cache handling functions.  
      */
@@ -247,6 +250,7 @@ extern          "C" {
     int             init_master_agent(void);
     void            shutdown_master_agent(void);
     int             agent_check_and_process(int block);
+    int             netsnmp_agent_use_epoll(void);
     void            netsnmp_check_delegated_requests(void);
     void            netsnmp_check_outstanding_agent_requests(void);
 
@@ -325,6 +329,13 @@ extern          "C" {
     void
         netsnmp_free_agent_request_info(netsnmp_agent_request_info *ari);
 
+    void           *netsnmp_agent_arena_alloc(netsnmp_agent_session *asp,
+                                              size_t size);
+    netsnmp_data_list *
+        netsnmp_agent_arena_data_list(netsnmp_agent_request_info *ari,
+                                      const char *name, void *data,
+                                      Netsnmp_Free_List_Data *free_func);
+
 
 #ifndef NETSNMP_NO_PDU_STATS
     /*
@@ -27,6 +27,8 @@ extern          "C" {
         void           *data;   /* the data to store */
 
         struct netsnmp_table_row_s *next, *prev;        /* if used in a list */
+        void          **columns;        /* table_dataset columns, by number */
+        unsigned int    columns_len;
     } netsnmp_table_row;
 
     typedef struct netsnmp_table_data_s {
@@ -36,6 +38,7 @@ extern          "C" {
         int             store_indexes;
         netsnmp_table_row *first_row;
         netsnmp_table_row *last_row;
+        netsnmp_container *container;   /* rows ordered by index_oid */
     } netsnmp_table_data;
 
 /* =================================
@@ -105,6 +108,10 @@ extern          "C" {
                                               netsnmp_table_data    *table,
                                               oid *  searchfor,
                                               size_t searchfor_len);
+    netsnmp_table_row *netsnmp_table_data_row_next_byoid(
+                                              netsnmp_table_data    *table,
+                                              oid *  instance,
+                                              size_t len);
 
     int netsnmp_table_data_num_rows(netsnmp_table_data *table);
 
@@ -131,6 +131,22 @@ typedef struct netsnmp_interface_stats_s {
     unsigned int     onucast;
 } netsnmp_interface_stats;
 
+/*
+ * where the 64-bit counters of an entry are kept by users that don't
+ * keep them in its netsnmp_interface_stats, see
+ * netsnmp_access_interface_entry_copy_to()
+ */
+typedef struct netsnmp_interface_counters_s {
+    struct counter64 *ibytes;
+    struct counter64 *iucast;
+    struct counter64 *imcast;
+    struct counter64 *ibcast;
+    struct counter64 *obytes;
+    struct counter64 *oucast;
+    struct counter64 *omcast;
+    struct counter64 *obcast;
+} netsnmp_interface_counters;
+
 /*
  *
  * NOTE: if you add fields, update code dealing with
@@ -233,6 +249,7 @@ netsnmp_access_interface_container_load(netsnmp_container* container,
 #define NETSNMP_ACCESS_INTERFACE_LOAD_NO_STATS              0x0001
 #define NETSNMP_ACCESS_INTERFACE_LOAD_IP4_ONLY              0x0002
 #define NETSNMP_ACCESS_INTERFACE_LOAD_IP6_ONLY              0x0004
+#define NETSNMP_ACCESS_INTERFACE_LOAD_STATS_ONLY            0x0008
 
 void netsnmp_access_interface_container_free(netsnmp_container *container,
                                              u_int free_flags);
@@ -277,6 +294,24 @@ const char *netsnmp_access_interface_name_find(oid index);
  */
 int netsnmp_access_interface_entry_copy(netsnmp_interface_entry * lhs,
                                         netsnmp_interface_entry * rhs);
+int netsnmp_access_interface_entry_copy_stats(netsnmp_interface_entry * lhs,
+                                              netsnmp_interface_entry * rhs);
+int netsnmp_access_interface_entry_copy_to(netsnmp_interface_entry * lhs,
+                                           netsnmp_interface_entry * rhs,
+                                const netsnmp_interface_counters *counters);
+int netsnmp_access_interface_entry_copy_stats_to(netsnmp_interface_entry * lhs,
+                                                 netsnmp_interface_entry * rhs,
+                                const netsnmp_interface_counters *counters);
+
+/*
+ * interface change notifications
+ */
+typedef void (NetsnmpAccessInterfaceChange)(oid if_index,
+                                            netsnmp_interface_entry *entry,
+                                            void *data);
+int netsnmp_access_interface_monitor_start(NetsnmpAccessInterfaceChange *changed,
+                                           void *data);
+void netsnmp_access_interface_monitor_stop(void);
 
 /*
  * utility routines
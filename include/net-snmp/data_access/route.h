@@ -84,6 +84,8 @@ typedef struct netsnmp_route_s {
 /*
  * ACCESS function prototypes
  */
+void netsnmp_access_route_init(void);
+
 /*
  * ifcontainer init
  */
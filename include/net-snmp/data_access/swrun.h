@@ -51,6 +51,13 @@ extern "C" {
          */
         int32_t         hrSWRunPerfCPU;
         int32_t         hrSWRunPerfMem;
+
+        /*
+         * for arch loaders which update entries in place
+         * (NETSNMP_SWRUN_UPDATE)
+         */
+        u_long          start_time;
+        u_int           generation;
         
     } netsnmp_swrun_entry;
 
@@ -85,6 +92,8 @@ extern "C" {
 
     void netsnmp_swrun_entry_free(netsnmp_swrun_entry *entry);
 
+    u_int swrun_generation(void);
+
     int  swrun_count_processes( int include_kthreads );
     int  swrun_max_processes(   void );
     int  swrun_count_processes_by_name( char *name );
@@ -97,7 +106,8 @@ extern "C" {
 #define NETSNMP_SWRUN_NOFLAGS            0x00000000
 #define NETSNMP_SWRUN_ALL_OR_NONE        0x00000001
 #define NETSNMP_SWRUN_DONT_FREE_ITEMS    0x00000002
-/*#define NETSNMP_SWRUN_xx                0x00000004 */
+#define NETSNMP_SWRUN_UPDATE           0x00000004
+/*#define NETSNMP_SWRUN_xx                0x00000008 */
 
 #ifdef  __cplusplus
 }
@@ -472,6 +472,30 @@ SOFTWARE.
                                               int allow_realloc,
                                               u_char type, const double *data,
                                               size_t data_size);
+
+    /*
+     * Sizes of the encodings produced by the functions above, for callers
+     * that want to reserve the exact amount of buffer space before
+     * encoding.  Each returns the size of the complete type-length-value
+     * triple (asn_rbuild_length_size(): of the length field alone), or 0
+     * if the corresponding asn_realloc_rbuild_*() call would fail.
+     */
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_length_size(size_t length);
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_header_size(size_t length);
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_int_size(const long *data, size_t data_size);
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_unsigned_int_size(const u_long *data,
+                                                 size_t data_size);
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_unsigned_int64_size(u_char type,
+                                                   const struct counter64
+                                                   *data, size_t data_size);
+    NETSNMP_IMPORT
+    size_t          asn_rbuild_objid_size(const oid * objid,
+                                          size_t objidlength);
 #endif
 
 #ifdef __cplusplus
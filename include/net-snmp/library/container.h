@@ -117,6 +117,13 @@ extern "C" {
                                           netsnmp_container_obj_func *,
                                           void *context);
 
+    /*
+     * function returning an int which calls a function on some objects
+     */
+    typedef int (netsnmp_container_func_rc)(struct netsnmp_container_s *,
+                                            netsnmp_container_obj_func *,
+                                            void *context);
+
     /*
      * function returning an array of objects for an operation on an
      * ojbect and a container
@@ -294,6 +301,17 @@ extern "C" {
         */
        struct netsnmp_container_s *next, *prev;
 
+       /*
+        * OPTIONAL functions for loading many objects at once. After
+        * bulk_begin, insert only appends (without checking the key) and
+        * the appended objects are not seen by find, find_next,
+        * get_subset or iterators. bulk_end sorts them in, calls the
+        * function for each object dropped because its key was already
+        * present, and returns the number of objects dropped.
+        */
+       netsnmp_container_rc            *bulk_begin;
+       netsnmp_container_func_rc       *bulk_end;
+
     } netsnmp_container;
 
     /*
@@ -425,6 +443,25 @@ extern "C" {
     NETSNMP_IMPORT
     int CONTAINER_REMOVE(netsnmp_container *x, const void *k);
 
+    /*
+     * start a bulk load of all containers. Until CONTAINER_BULK_END,
+     * CONTAINER_INSERT appends to the containers which support it
+     * without checking for duplicate keys.  Returns -1 if none does,
+     * in which case inserts work as usual.
+     */
+    NETSNMP_IMPORT
+    int CONTAINER_BULK_BEGIN(netsnmp_container *x);
+
+    /*
+     * finish a bulk load: sort the appended items in, and remove items
+     * with a duplicate key in any container from all containers,
+     * keeping the item which was there or was inserted first.  f is
+     * called for each removed item.  Returns the number of items removed.
+     */
+    NETSNMP_IMPORT
+    int CONTAINER_BULK_END(netsnmp_container *x, netsnmp_container_obj_func *f,
+                           void *c);
+
     /*
      * remove item at given position
      */
@@ -485,6 +522,11 @@ extern "C" {
     /** Duplicate container meta-data. */
     int netsnmp_container_data_dup(netsnmp_container *dup,
                                    netsnmp_container *c);
+    /** Merge sorted and bulk loaded items; see container.c */
+    int netsnmp_container_bulk_merge(netsnmp_container *c,
+                                     void **sorted, size_t sorted_count,
+                                     void **pending, size_t pending_count,
+                                     void ***merged, size_t *kept);
 
     
     /*************************************************************************
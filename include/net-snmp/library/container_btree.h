@@ -0,0 +1,55 @@
+/*
+ * container_btree.h
+ *
+ * An ordered container kept in a B+tree.  Entries live in fixed size
+ * leaves which are chained in key order; inner nodes hold the smallest
+ * entry of each child and the number of entries below it, so that
+ * lookups, inserts and removes are O(log n) and entries can also be
+ * reached by position.
+ *
+ * When the container uses netsnmp_compare_netsnmp_index (the default
+ * for netsnmp_container_find()), the first few sub-identifiers of every
+ * index are copied into the nodes, so most comparisons made while
+ * searching are decided without following the entry pointers.
+ *
+ * The container is registered as "btree".  It can be used wherever a
+ * binary_array is used, except that CONTAINER_KEY_UNSORTED and
+ * insert_before are not supported.  To use it for all tables, register
+ * it under the table_container name before the tables are created:
+ *
+ *   netsnmp_container_register("table_container",
+ *                              netsnmp_container_get_btree_factory());
+ */
+
+#ifndef NETSNMP_CONTAINER_BTREE_H
+#define NETSNMP_CONTAINER_BTREE_H
+
+#include <net-snmp/library/container.h>
+#include <net-snmp/library/factory.h>
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+    /*
+     * get a container which uses a B+tree for storage
+     */
+    NETSNMP_IMPORT
+    netsnmp_container *netsnmp_container_get_btree(void);
+
+    /*
+     * get a factory for producing btree containers
+     */
+    NETSNMP_IMPORT
+    netsnmp_factory   *netsnmp_container_get_btree_factory(void);
+
+    /*
+     * initialize btree container. call at startup.
+     */
+    void netsnmp_container_btree_init(void);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif /** NETSNMP_CONTAINER_BTREE_H */
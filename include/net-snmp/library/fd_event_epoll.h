@@ -0,0 +1,63 @@
+/**************************************************************************
+ * UNIT: epoll(7) based event loop backend
+ *
+ * OVERVIEW: The select() based event loops (snmpd's receive() and
+ *           agent_check_and_process()) rebuild a large fd set from all
+ *           open sessions and all fds registered with the FD event
+ *           manager on every iteration, and snmp_read2() then walks every
+ *           session again to find the ones that are readable.  This unit
+ *           keeps those descriptors registered in an epoll set instead
+ *           and only refreshes the registrations when the session list
+ *           or the FD event manager registrations change.  snmp_alarm
+ *           and session request deadlines are delivered through a
+ *           timerfd, so the cost of one iteration depends on the number
+ *           of ready descriptors rather than on the number of sessions.
+ *
+ * LIMITATIONS: Only available where <sys/epoll.h> and <sys/timerfd.h>
+ *           exist (Linux).  Elsewhere netsnmp_epoll_init() fails and the
+ *           caller is expected to keep using select().
+ **************************************************************************/
+#ifndef FD_EVENT_EPOLL_H
+#define FD_EVENT_EPOLL_H
+
+#ifdef __cplusplus
+extern          "C" {
+#endif
+
+/*
+ * Create the epoll set and the timer.  Returns 0 on success and -1 if
+ * epoll is not supported on this platform or could not be set up.
+ * Calling it again after a successful call is harmless.
+ */
+NETSNMP_IMPORT
+int             netsnmp_epoll_init(void);
+
+/*
+ * Release the epoll set and the timer.
+ */
+NETSNMP_IMPORT
+void            netsnmp_epoll_shutdown(void);
+
+/*
+ * Returns 1 if netsnmp_epoll_init() has been called successfully.
+ */
+NETSNMP_IMPORT
+int             netsnmp_epoll_active(void);
+
+/*
+ * Wait for activity on the SNMP sessions and the fds registered with the
+ * FD event manager and dispatch it.  If block is zero, only events that
+ * are already pending are processed; otherwise the call waits until an
+ * event arrives or the next snmp_alarm / request deadline expires.
+ *
+ * Return value: the same as for select(): the number of descriptors that
+ * were dispatched, 0 if the timer expired (the caller should then call
+ * snmp_timeout()) and -1 on error with errno set.
+ */
+NETSNMP_IMPORT
+int             netsnmp_epoll_dispatch(int block);
+
+#ifdef __cplusplus
+}
+#endif
+#endif                          /* FD_EVENT_EPOLL_H */
@@ -61,6 +61,12 @@ int             unregister_readfd(int);
 int             unregister_writefd(int);
 int             unregister_exceptfd(int);
 
+/* Returns a counter that is bumped by every (un)registration above, so
+ * that event loops which keep their own copy of the registered fds (see
+ * fd_event_epoll.h) know when to refresh it. */
+NETSNMP_IMPORT
+unsigned int    netsnmp_external_event_generation(void);
+
 /*
  * External Event Info
  *
@@ -145,6 +145,39 @@ typedef struct netsnmp_priv_alg_info_s {
                                         u_int msglen, const u_char * MAC,
                                         u_int maclen);
 
+    /*
+     * HMAC state precomputed from a key, for the *_cached variants
+     */
+    typedef struct sc_hmac_cache_s sc_hmac_cache;
+
+    NETSNMP_IMPORT
+    int             sc_generate_keyed_hash_cached(sc_hmac_cache ** cache,
+                                                  const oid * authtype,
+                                                  size_t authtypelen,
+                                                  const u_char * key,
+                                                  u_int keylen,
+                                                  const u_char * message,
+                                                  u_int msglen,
+                                                  u_char * MAC,
+                                                  size_t * maclen);
+
+    NETSNMP_IMPORT
+    int             sc_check_keyed_hash_cached(sc_hmac_cache ** cache,
+                                               const oid * authtype,
+                                               size_t authtypelen,
+                                               const u_char * key,
+                                               u_int keylen,
+                                               const u_char * message,
+                                               u_int msglen,
+                                               const u_char * MAC,
+                                               u_int maclen);
+
+    NETSNMP_IMPORT
+    void            sc_hmac_cache_free(sc_hmac_cache ** cache);
+
+    NETSNMP_IMPORT
+    sc_hmac_cache  *sc_hmac_cache_ref(sc_hmac_cache ** cache);
+
     NETSNMP_IMPORT
     int             sc_encrypt(const oid * privtype, size_t privtypelen,
                                u_char * key, u_int keylen,
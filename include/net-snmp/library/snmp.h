@@ -364,6 +364,11 @@ SOFTWARE.
                                                u_char value_type,
                                                u_char * value,
                                                size_t value_length);
+    size_t          snmp_rbuild_var_op_size(const oid * name,
+                                            size_t name_len,
+                                            u_char value_type,
+                                            const u_char * value,
+                                            size_t value_length);
 #endif
 
 #ifdef __cplusplus
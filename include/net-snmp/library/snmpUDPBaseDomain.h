@@ -24,6 +24,22 @@ extern          "C" {
     int netsnmp_udpbase_send(netsnmp_transport *t, const void *buf, int size,
                              void **opaque, int *olength);
 
+/*
+ * Batched I/O for server transports (see udpBatchDepth).  The recv and
+ * send functions return -2 if the transport does not batch, in which case
+ * the caller does the I/O itself.
+ */
+    int netsnmp_udpbase_batch_recv(netsnmp_transport *t, void *buf, int size,
+                                   struct sockaddr *from, socklen_t *fromlen,
+                                   struct sockaddr *dstip, socklen_t *dstlen,
+                                   int *if_index);
+    int netsnmp_udpbase_batch_send(netsnmp_transport *t,
+                                   const struct in_addr *srcip, int if_index,
+                                   const struct sockaddr *to, socklen_t tolen,
+                                   const void *data, int len);
+    int netsnmp_udpbase_flush(netsnmp_transport *t);
+    int netsnmp_udpbase_close(netsnmp_transport *t);
+
 #if defined(HAVE_IP_PKTINFO) || defined(HAVE_IP_RECVDSTADDR)
     int netsnmp_udpbase_recvfrom(int s, void *buf, int len,
                                  struct sockaddr *from, socklen_t *fromlen,
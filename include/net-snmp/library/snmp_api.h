@@ -396,6 +396,8 @@ typedef struct request_list {
     int             netsnmp_oid_find_prefix(const oid * in_name1, size_t len1,
                                             const oid * in_name2, size_t len2);
     NETSNMP_IMPORT
+    const char     *netsnmp_oid_compare_impl(const char *impl);
+    NETSNMP_IMPORT
     void            init_snmp(const char *);
 
     NETSNMP_IMPORT
@@ -57,6 +57,10 @@ extern          "C" {
 #define		NETSNMP_TRANSPORT_FLAG_OPENED	 0x20  /* f_open called */
 #define		NETSNMP_TRANSPORT_FLAG_SHARED	 0x40
 #define		NETSNMP_TRANSPORT_FLAG_HOSTNAME	 0x80  /* for fmtaddr hook */
+#define		NETSNMP_TRANSPORT_FLAG_RECV_PENDING 0x100 /* f_recv has more
+                                                          datagrams buffered */
+#define		NETSNMP_TRANSPORT_FLAG_DEFER_SEND 0x200 /* f_send may queue
+                                                        until f_flush() */
 
 /*  The standard SNMP domains.  */
 
@@ -217,6 +221,12 @@ typedef struct netsnmp_transport_s {
     void           (*f_get_taddr)(struct netsnmp_transport_s *t,
                                   void **addr, size_t *addr_len);
 
+    /*  Optional: send anything f_send queued while
+        NETSNMP_TRANSPORT_FLAG_DEFER_SEND was set.  Datagram transports
+        that set this are read until NETSNMP_TRANSPORT_FLAG_RECV_PENDING
+        is clear once they become readable.  */
+    int             (*f_flush)(struct netsnmp_transport_s *);
+
 } netsnmp_transport;
 
 typedef struct netsnmp_transport_list_s {
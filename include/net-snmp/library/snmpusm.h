@@ -43,6 +43,7 @@ extern          "C" {
      * Structures.
      */
     struct usmStateReference;
+    struct sc_hmac_cache_s;
 
     /*
      * struct usmUser: a structure to represent a given user in a list 
@@ -82,6 +83,8 @@ extern          "C" {
         void           *usmDHUserPrivKeyChange;
         struct usmUser *next;
         struct usmUser *prev;
+        /* HMAC state for authKey, see sc_generate_keyed_hash_cached() */
+        struct sc_hmac_cache_s *authHmacCache;
     };
 
 #define USMUSER_FLAG_KEEP_MASTER_KEY             0x01
@@ -198,6 +198,13 @@ extern          "C" {
      * The status of this entry is created as invalid.
      */
 
+    NETSNMP_IMPORT
+    void            vacm_viewEntryChanged(struct vacm_viewEntry *);
+    /*
+     * Must be called after changing the viewMask of an existing
+     * viewEntry, as view lookups use a precompiled form of each view.
+     */
+
     NETSNMP_IMPORT
     void            vacm_destroyGroupEntry(int, const char *);
     NETSNMP_IMPORT
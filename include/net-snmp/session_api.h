@@ -175,6 +175,22 @@ extern          "C" {
                                                  netsnmp_large_fd_set *,
                                                  struct timeval *, int *, int);
 
+    /*
+     * Helpers for event loops that keep file descriptor registrations
+     * alive across iterations instead of rebuilding an fd_set each time
+     * (see fd_event_epoll.h).
+     */
+    NETSNMP_IMPORT
+    unsigned int    snmp_sessions_generation(void);
+    NETSNMP_IMPORT
+    unsigned int    snmp_sessions_timeouts(void);
+    NETSNMP_IMPORT
+    int             snmp_sessions_foreach_fd(void (*)(struct session_list *,
+                                                      int, void *),
+                                             void *);
+    NETSNMP_IMPORT
+    int             snmp_sessions_earliest_request(struct timeval *);
+
     /*
      * void snmp_timeout();
      *
@@ -3965,6 +3965,214 @@ asn_realloc_rbuild_double(u_char ** pkt, size_t * pkt_len,
 }
 
 #endif                          /* NETSNMP_WITH_OPAQUE_SPECIAL_TYPES */
+
+/**
+ * @internal
+ * computes the number of bytes asn_realloc_rbuild_length() uses to
+ * encode a length.
+ *
+ * @param length  IN - length to be encoded
+ *
+ * @return size of the length field
+ */
+size_t
+asn_rbuild_length_size(size_t length)
+{
+    size_t          size = 1;
+
+    if (length <= 0x7f)
+        return 1;
+    while (length > 0) {
+        size++;
+        length >>= 8;
+    }
+    return size;
+}
+
+/**
+ * @internal
+ * computes the size of the header asn_realloc_rbuild_header() builds.
+ *
+ * @param length  IN - length of the object following the header
+ *
+ * @return size of the type and length fields
+ */
+size_t
+asn_rbuild_header_size(size_t length)
+{
+    return 1 + asn_rbuild_length_size(length);
+}
+
+/**
+ * @internal
+ * computes the size of the object asn_realloc_rbuild_int() builds.
+ *
+ * @param intp    IN - pointer to start of long integer
+ * @param intsize IN - size of input buffer
+ *
+ * @return size of the encoded object, 0 on error
+ */
+size_t
+asn_rbuild_int_size(const long *intp, size_t intsize)
+{
+    long            integer;
+    int             testvalue;
+    u_char          top;
+    size_t          size = 1;
+
+    if (intsize != sizeof(long))
+        return 0;
+
+    integer = *intp;
+    if (integer > INT32_MAX)
+        integer &= 0xffffffff;
+    else if (integer < INT32_MIN)
+        integer = 0 - (integer & 0xffffffff);
+    testvalue = (integer < 0) ? -1 : 0;
+
+    top = (u_char) integer;
+    integer >>= 8;
+    while (integer != testvalue) {
+        top = (u_char) integer;
+        integer >>= 8;
+        size++;
+    }
+    if ((top & 0x80) != (testvalue & 0x80))
+        size++;
+
+    return asn_rbuild_header_size(size) + size;
+}
+
+/**
+ * @internal
+ * computes the size of the object asn_realloc_rbuild_unsigned_int() builds.
+ *
+ * @param intp    IN - pointer to start of unsigned int
+ * @param intsize IN - size of input buffer
+ *
+ * @return size of the encoded object, 0 on error
+ */
+size_t
+asn_rbuild_unsigned_int_size(const u_long *intp, size_t intsize)
+{
+    u_long          integer;
+    u_char          top;
+    size_t          size = 1;
+
+    if (intsize != sizeof(unsigned long))
+        return 0;
+
+    integer = *intp;
+    if (integer > UINT32_MAX)
+        integer &= 0xffffffff;
+
+    top = (u_char) integer;
+    integer >>= 8;
+    while (integer != 0) {
+        top = (u_char) integer;
+        integer >>= 8;
+        size++;
+    }
+    if (top & 0x80)
+        size++;
+
+    return asn_rbuild_header_size(size) + size;
+}
+
+/**
+ * @internal
+ * computes the size of the object asn_realloc_rbuild_unsigned_int64()
+ * builds.  Only the plain ASN_COUNTER64 encoding is supported; the
+ * Opaque wrapped types make this return 0.
+ *
+ * @param type        IN - type of object
+ * @param cp          IN - pointer to counter struct
+ * @param countersize IN - size of input buffer
+ *
+ * @return size of the encoded object, 0 on error
+ */
+size_t
+asn_rbuild_unsigned_int64_size(u_char type, const struct counter64 *cp,
+                               size_t countersize)
+{
+    u_long          low, high;
+    u_char          top;
+    size_t          size = 1;
+
+    if (type != ASN_COUNTER64 || countersize != sizeof(struct counter64))
+        return 0;
+
+    low = cp->low;
+    high = cp->high;
+    if (high > UINT32_MAX)
+        high &= 0xffffffff;
+    if (low > UINT32_MAX)
+        low &= 0xffffffff;
+
+    top = (u_char) low;
+    low >>= 8;
+    while (low != 0) {
+        top = (u_char) low;
+        low >>= 8;
+        size++;
+    }
+    if (high) {
+        if (size < 4)
+            size = 4;
+        do {
+            top = (u_char) high;
+            high >>= 8;
+            size++;
+        } while (high != 0);
+    }
+    if (top & 0x80)
+        size++;
+
+    return asn_rbuild_header_size(size) + size;
+}
+
+/**
+ * @internal
+ * computes the size of the object asn_realloc_rbuild_objid() builds.
+ *
+ * @param objid        IN - pointer to the object id
+ * @param objidlength  IN - length of the input
+ *
+ * @return size of the encoded object, 0 on error
+ */
+size_t
+asn_rbuild_objid_size(const oid * objid, size_t objidlength)
+{
+    size_t          i, size = 0;
+    oid             tmpint;
+
+    if (objidlength == 0) {
+        size = 2;
+    } else if (objid[0] > 2) {
+        return 0;
+    } else if (objidlength == 1) {
+        size = 1;
+    } else {
+        if ((objid[1] > 40) && (objid[0] < 2))
+            return 0;
+        for (i = 2; i < objidlength; i++) {
+            tmpint = objid[i];
+            if (tmpint > UINT32_MAX)
+                tmpint &= 0xffffffff;
+            do {
+                size++;
+                tmpint >>= 7;
+            } while (tmpint > 0);
+        }
+        tmpint = (objid[0] * 40) + objid[1];
+        do {
+            size++;
+            tmpint >>= 7;
+        } while (tmpint > 0);
+    }
+
+    return asn_rbuild_header_size(size) + size;
+}
 #endif                          /*  NETSNMP_USE_REVERSE_ASNENCODING  */
 /**
  * @}
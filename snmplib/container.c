@@ -18,6 +18,7 @@
 #include <net-snmp/net-snmp-includes.h>
 #include <net-snmp/library/container.h>
 #include <net-snmp/library/container_binary_array.h>
+#include <net-snmp/library/container_btree.h>
 #include <net-snmp/library/container_list_ssll.h>
 #include <net-snmp/library/container_null.h>
 
@@ -92,6 +93,9 @@ netsnmp_container_init_list(void)
      * register containers
      */
     netsnmp_container_binary_array_init();
+#ifndef NETSNMP_FEATURE_REMOVE_CONTAINER_BTREE
+    netsnmp_container_btree_init();
+#endif /* NETSNMP_FEATURE_REMOVE_CONTAINER_BTREE */
 #ifndef NETSNMP_FEATURE_REMOVE_CONTAINER_LINKED_LIST
     netsnmp_container_ssll_init();
 #endif /* NETSNMP_FEATURE_REMOVE_CONTAINER_LINKED_LIST */
@@ -389,6 +393,72 @@ int CONTAINER_REMOVE(netsnmp_container *x, const void *k)
     return rc;
 }
 
+/*
+ * items dropped by one container at the end of a bulk load are removed
+ * from the others before they are handed to the caller
+ */
+struct _bulk_reject {
+    netsnmp_container          *first;
+    netsnmp_container          *current;
+    netsnmp_container_obj_func *f;
+    void                       *context;
+};
+
+static void
+_bulk_reject(void *data, void *context)
+{
+    struct _bulk_reject *r = (struct _bulk_reject *)context;
+    netsnmp_container   *x;
+
+    for (x = r->first; x; x = x->next)
+        if (x != r->current)
+            x->remove(x, data); /** ignore remove errors in other containers */
+    if (r->f)
+        (*r->f) (data, r->context);
+}
+
+int CONTAINER_BULK_BEGIN(netsnmp_container *x)
+{
+    int rc = -1;
+
+    /** start at first container */
+    while(x->prev)
+        x = x->prev;
+    for(; x; x = x->next) {
+        if (NULL == x->bulk_begin)
+            continue;
+        if (x->bulk_begin(x) == 0)
+            rc = 0;
+    }
+    return rc;
+}
+
+int CONTAINER_BULK_END(netsnmp_container *x, netsnmp_container_obj_func *f,
+                       void *c)
+{
+    struct _bulk_reject r;
+    int rc2, rc = 0;
+
+    /** start at first container */
+    while(x->prev)
+        x = x->prev;
+    r.first = x;
+    r.f = f;
+    r.context = c;
+    for(; x; x = x->next) {
+        if (NULL == x->bulk_end)
+            continue;
+        r.current = x;
+        rc2 = x->bulk_end(x, _bulk_reject, &r);
+        if (rc2 > 0) {
+            DEBUGMSGTL(("container:bulk", "%d duplicates dropped from '%s'\n",
+                        rc2, x->container_name ? x->container_name : ""));
+            rc += rc2;
+        }
+    }
+    return rc;
+}
+
 int CONTAINER_REMOVE_AT(netsnmp_container *x, size_t pos, void **k)
 {
     int rc = 0;
@@ -576,6 +646,79 @@ netsnmp_container_data_dup(netsnmp_container *dup, netsnmp_container *c)
     return 0;
 }
 
+/*
+ * stable merge sort, so that of several items with the same key the one
+ * inserted first stays first
+ */
+static void
+_container_merge_sort(void **a, void **tmp, size_t n,
+                      netsnmp_container_compare *cmp)
+{
+    size_t half = n / 2, i, j, k;
+
+    if (n < 2)
+        return;
+    _container_merge_sort(a, tmp, half, cmp);
+    _container_merge_sort(a + half, tmp, n - half, cmp);
+    if (cmp(a[half - 1], a[half]) <= 0)
+        return; /* already in order, as loaded data often is */
+
+    memcpy(tmp, a, half * sizeof(void *));
+    for (i = 0, j = half, k = 0; i < half && j < n; )
+        a[k++] = cmp(a[j], tmp[i]) < 0 ? a[j++] : tmp[i++];
+    while (i < half)
+        a[k++] = tmp[i++];
+}
+
+/**
+ * For container implementations finishing a bulk load: sorts the
+ * pending items (in place) and merges them with the sorted ones into a
+ * new array of sorted_count + pending_count pointers, returned in
+ * *merged.  Unless the container allows duplicate keys, an item whose
+ * key is already present (in sorted, or earlier in pending) is left
+ * out.  The first *kept pointers of *merged are the items to keep; the
+ * rest are the items left out, last one found first.
+ *
+ * @return 0 on success, -1 if memory ran out (nothing is changed).
+ */
+int
+netsnmp_container_bulk_merge(netsnmp_container *c,
+                             void **sorted, size_t sorted_count,
+                             void **pending, size_t pending_count,
+                             void ***merged, size_t *kept)
+{
+    size_t  i = 0, j = 0, n = 0, r = sorted_count + pending_count;
+    void  **out, **tmp, *next;
+    int     dups = (c->flags & CONTAINER_KEY_ALLOW_DUPLICATES);
+
+    out = (void **)malloc((r ? r : 1) * sizeof(void *));
+    tmp = (void **)malloc((pending_count ? pending_count : 1) *
+                          sizeof(void *));
+    if (NULL == out || NULL == tmp) {
+        free(out);
+        free(tmp);
+        return -1;
+    }
+    _container_merge_sort(pending, tmp, pending_count, c->compare);
+    free(tmp);
+
+    while (i < sorted_count || j < pending_count) {
+        if (j >= pending_count ||
+            (i < sorted_count && c->compare(sorted[i], pending[j]) <= 0))
+            next = sorted[i++];
+        else
+            next = pending[j++];
+        if (!dups && n > 0 && c->compare(out[n - 1], next) == 0)
+            out[--r] = next;
+        else
+            out[n++] = next;
+    }
+
+    *merged = out;
+    *kept = n;
+    return 0;
+}
+
 /*------------------------------------------------------------------
  *
  * simple comparison routines
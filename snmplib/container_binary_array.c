@@ -45,6 +45,10 @@ typedef struct binary_array_table_s {
     size_t                     count;      /* Index of the next free entry */
     int                        dirty;
     void                     **data;       /* The table itself */
+    int                        bulk;       /* bulk load in progress */
+    size_t                     bulk_max;
+    size_t                     bulk_count;
+    void                     **bulk_data;  /* entries appended in bulk */
 } binary_array_table;
 
 typedef struct binary_array_iterator_s {
@@ -208,6 +212,7 @@ netsnmp_binary_array_release(netsnmp_container *c)
 {
     binary_array_table *t = (binary_array_table*)c->container_data;
     SNMP_FREE(t->data);
+    SNMP_FREE(t->bulk_data);
     SNMP_FREE(t);
     SNMP_FREE(c);
 }
@@ -243,7 +248,7 @@ netsnmp_binary_array_count(netsnmp_container *c)
     /*
      * return count
      */
-    return t ? t->count : 0;
+    return t ? t->count + t->bulk_count : 0;
 }
 
 NETSNMP_STATIC_INLINE void           *
@@ -354,6 +359,23 @@ netsnmp_binary_array_remove(netsnmp_container *c, const void *key, void **save)
 
     if (save)
         *save = NULL;
+
+    /*
+     * entries appended in bulk are only removed by pointer
+     */
+    if (t->bulk_count) {
+        size_t i;
+
+        for (i = 0; i < t->bulk_count; ++i)
+            if (t->bulk_data[i] == key) {
+                if (save)
+                    *save = t->bulk_data[i];
+                --t->bulk_count;
+                memmove(&t->bulk_data[i], &t->bulk_data[i + 1],
+                        sizeof(void*) * (t->bulk_count - i));
+                return 0;
+            }
+    }
     
     /*
      * if there is no data, return NULL;
@@ -373,6 +395,22 @@ netsnmp_binary_array_remove(netsnmp_container *c, const void *key, void **save)
     if ((index = binary_search(key, c, 1, NULL)) == -1)
         return -1;
 
+    /*
+     * among entries with the same key, prefer the one passed in
+     */
+    if ((c->flags & CONTAINER_KEY_ALLOW_DUPLICATES) &&
+        !(c->flags & CONTAINER_KEY_UNSORTED) && t->data[index] != key) {
+        size_t i;
+
+        for (i = index; i > 0 && c->compare(t->data[i - 1], key) == 0; --i)
+            if (t->data[i - 1] == key)
+                return netsnmp_binary_array_remove_at(c, i - 1, save);
+        for (i = index + 1; i < t->count && c->compare(t->data[i], key) == 0;
+             ++i)
+            if (t->data[i] == key)
+                return netsnmp_binary_array_remove_at(c, i, save);
+    }
+
     return netsnmp_binary_array_remove_at(c, (size_t)index, save);
 }
 
@@ -389,6 +427,8 @@ netsnmp_binary_array_for_each(netsnmp_container *c,
 
     for (i = 0; i < t->count; ++i)
         (*fe) (t->data[i], context);
+    for (i = 0; i < t->bulk_count; ++i)
+        (*fe) (t->bulk_data[i], context);
 }
 
 NETSNMP_STATIC_INLINE void
@@ -403,10 +443,14 @@ netsnmp_binary_array_clear(netsnmp_container *c,
 
         for (i = 0; i < t->count; ++i)
             (*fe) (t->data[i], context);
+        for (i = 0; i < t->bulk_count; ++i)
+            (*fe) (t->bulk_data[i], context);
     }
 
     t->count = 0;
     t->dirty = 0;
+    t->bulk = 0;
+    t->bulk_count = 0;
     ++c->sync;
 }
 
@@ -477,6 +521,112 @@ netsnmp_binary_array_insert_before(netsnmp_container *c, size_t index,
     return 0;
 }
 
+/**********************************************************************
+ *
+ * Bulk loading
+ *
+ */
+static int
+netsnmp_binary_array_bulk_append(binary_array_table *t, void *entry)
+{
+    if (t->bulk_count == t->bulk_max) {
+        size_t new_max = t->bulk_max > 0 ? 2 * t->bulk_max : 64;
+        void **new_data = (void**) realloc(t->bulk_data,
+                                           new_max * sizeof(void*));
+        if (new_data == NULL) {
+            snmp_log(LOG_ERR, "malloc failed in bulk append\n");
+            return -1;
+        }
+        t->bulk_data = new_data;
+        t->bulk_max = new_max;
+    }
+    t->bulk_data[t->bulk_count++] = entry;
+    return 0;
+}
+
+static int
+netsnmp_binary_array_bulk_begin(netsnmp_container *c)
+{
+    binary_array_table *t = (binary_array_table*)c->container_data;
+
+    t->bulk = 1;
+    return 0;
+}
+
+NETSNMP_STATIC_INLINE int
+netsnmp_binary_array_insert(netsnmp_container *c, const void *const_entry);
+
+static int
+netsnmp_binary_array_bulk_end(netsnmp_container *c,
+                              netsnmp_container_obj_func *f, void *context)
+{
+    binary_array_table *t = (binary_array_table*)c->container_data;
+    void          **merged;
+    size_t          count, kept, i;
+    int             dropped = 0;
+
+    t->bulk = 0;
+    count = t->bulk_count;
+    if (0 == count)
+        return 0;
+
+    if (c->flags & CONTAINER_KEY_UNSORTED) {
+        /*
+         * no order and no key checks; just move the entries over
+         */
+        if (t->max_size < t->count + count) {
+            merged = (void**) realloc(t->data,
+                                      (t->count + count) * sizeof(void*));
+            if (merged != NULL) {
+                t->data = merged;
+                t->max_size = t->count + count;
+            }
+        }
+        if (t->max_size >= t->count + count) {
+            memcpy(&t->data[t->count], t->bulk_data, count * sizeof(void*));
+            t->count += count;
+            t->bulk_count = 0;
+            t->dirty = 1;
+            ++c->sync;
+            return 0;
+        }
+    } else {
+        if (t->dirty)
+            Sort_Array(c);
+        if (netsnmp_container_bulk_merge(c, t->data, t->count, t->bulk_data,
+                                         count, &merged, &kept) == 0) {
+            free(t->data);
+            t->data = merged;
+            t->max_size = t->count + count;
+            t->count = kept;
+            t->bulk_count = 0;
+            ++c->sync;
+            for (i = t->max_size; i > kept; ) {
+                if (f)
+                    (*f) (merged[--i], context);
+                else
+                    --i;
+                ++dropped;
+            }
+            return dropped;
+        }
+    }
+
+    /*
+     * out of memory: insert the entries one at a time
+     */
+    snmp_log(LOG_WARNING, "bulk load of %s falls back to single inserts\n",
+             c->container_name ? c->container_name : "container");
+    t->bulk_count = 0;
+    for (i = 0; i < count; ++i)
+        if (netsnmp_binary_array_insert(c, t->bulk_data[i]) != 0) {
+            if (f)
+                (*f) (t->bulk_data[i], context);
+            ++dropped;
+        }
+    return dropped;
+}
+
 NETSNMP_STATIC_INLINE int
 netsnmp_binary_array_insert(netsnmp_container *c, const void *const_entry)
 {
@@ -488,6 +638,9 @@ netsnmp_binary_array_insert(netsnmp_container *c, const void *const_entry)
     if (NULL == entry)
         return -1;
 
+    if (t->bulk)
+        return netsnmp_binary_array_bulk_append(t, entry);
+
     /*
      * check key if we have at least 1 item and duplicates aren't allowed
      */
@@ -780,6 +933,8 @@ netsnmp_container_get_binary_array(void)
     c->get_at = netsnmp_binary_array_get_at;
     c->remove_at = netsnmp_binary_array_remove_at;
     c->insert_before = _ba_insert_before;
+    c->bulk_begin = netsnmp_binary_array_bulk_begin;
+    c->bulk_end = netsnmp_binary_array_bulk_end;
 
     return c;
 }
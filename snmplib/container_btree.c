@@ -0,0 +1,1316 @@
+/*
+ * container_btree.c
+ *
+ * see comments in header file.
+ */
+
+#include <net-snmp/net-snmp-config.h>
+#include <net-snmp/net-snmp-features.h>
+
+#if HAVE_IO_H
+#include <io.h>
+#endif
+#include <stdio.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_MALLOC_H
+#include <malloc.h>
+#endif
+#include <sys/types.h>
+#if HAVE_STRING_H
+#include <string.h>
+#else
+#include <strings.h>
+#endif
+
+#include <net-snmp/net-snmp-includes.h>
+#include <net-snmp/types.h>
+#include <net-snmp/library/snmp_api.h>
+#include <net-snmp/library/container.h>
+#include <net-snmp/library/container_btree.h>
+#include <net-snmp/library/tools.h>
+#include <net-snmp/library/snmp_assert.h>
+
+netsnmp_feature_child_of(container_btree, container_types);
+
+#ifndef NETSNMP_FEATURE_REMOVE_CONTAINER_BTREE
+
+/*
+ * slots per node, and the fill level below which a node is merged with
+ * or refilled from a neighbour.
+ */
+#define BT_FANOUT      32
+#define BT_MIN         (BT_FANOUT / 2)
+
+/*
+ * leading sub-identifiers of a netsnmp_index kept in the nodes
+ */
+#define BT_PREFIX      4
+#define BT_KEY_MORE    0x80     /* index continues after the inline part */
+#define BT_UNDECIDED   2
+
+typedef struct btree_key_s {
+    u_int           sub[BT_PREFIX];
+    u_char          len;        /* inline sub-ids, plus BT_KEY_MORE */
+} btree_key;
+
+/*
+ * Slot i of a leaf holds an entry.  Slot i of an inner node holds
+ * child[i], the number of entries below it, and its smallest entry
+ * (with key prefix), so data[0] of any node is the smallest entry
+ * below it.
+ */
+typedef struct btree_node_s {
+    u_short         leaf;
+    u_short         count;      /* slots in use */
+    btree_key       key[BT_FANOUT];
+    void           *data[BT_FANOUT];
+    struct btree_node_s *next;  /* next leaf, in key order */
+} btree_node;
+
+typedef struct btree_inner_s {
+    btree_node      node;
+    btree_node     *child[BT_FANOUT];
+    size_t          size[BT_FANOUT];
+} btree_inner;
+
+#define BT_INNER(n)    ((btree_inner *)(n))
+
+typedef struct btree_table_s {
+    btree_node     *root;
+    btree_node     *first;      /* leftmost leaf */
+    size_t          count;
+    int             prefix;     /* entries carry key prefixes */
+    int             bulk;       /* bulk load in progress */
+    size_t          bulk_max;
+    size_t          bulk_count;
+    void          **bulk_data;  /* entries appended in bulk */
+    btree_node     *spare[2];   /* inner and leaf nodes set aside */
+    int             spare_count[2];
+} btree_table;
+
+typedef struct btree_iterator_s {
+    netsnmp_iterator base;
+
+    size_t           pos;
+    btree_node      *leaf;      /* leaf holding pos, if known */
+    int              slot;
+} btree_iterator;
+
+static netsnmp_iterator *_bt_iterator_get(netsnmp_container *c);
+
+/**********************************************************************
+ *
+ * keys
+ *
+ */
+static void
+_bt_key_set(btree_key *k, const void *entry)
+{
+    const netsnmp_index *idx = (const netsnmp_index *)entry;
+    size_t          i;
+
+    for (i = 0; i < idx->len && i < BT_PREFIX; ++i) {
+        if ((oid)(u_int)idx->oids[i] != idx->oids[i])
+            break;
+        k->sub[i] = (u_int)idx->oids[i];
+    }
+    k->len = (u_char)i;
+    if (i < idx->len)
+        k->len |= BT_KEY_MORE;
+}
+
+/*
+ * compares the inline parts of two keys the way snmp_oid_compare()
+ * compares the full indexes, or returns BT_UNDECIDED.
+ */
+NETSNMP_STATIC_INLINE int
+_bt_key_compare(const btree_key *a, const btree_key *b)
+{
+    int             na = a->len & ~BT_KEY_MORE;
+    int             nb = b->len & ~BT_KEY_MORE;
+    int             n = na < nb ? na : nb;
+    int             i;
+
+    for (i = 0; i < n; ++i)
+        if (a->sub[i] != b->sub[i])
+            return a->sub[i] < b->sub[i] ? -1 : 1;
+
+    if (na == n && !(a->len & BT_KEY_MORE))
+        return (nb == n && !(b->len & BT_KEY_MORE)) ? 0 : -1;
+    if (nb == n && !(b->len & BT_KEY_MORE))
+        return 1;
+    return BT_UNDECIDED;
+}
+
+/*
+ * compares the entry in slot i of n with key; k is the key prefix, or
+ * NULL if prefixes are not to be used.
+ */
+NETSNMP_STATIC_INLINE int
+_bt_compare(netsnmp_container_compare *cmp, btree_node *n, int i,
+            const void *key, const btree_key *k)
+{
+    if (k) {
+        int rc = _bt_key_compare(&n->key[i], k);
+        if (BT_UNDECIDED != rc)
+            return rc;
+    }
+    return cmp(n->data[i], key);
+}
+
+/*
+ * returns the first slot from 'from' on whose entry sorts after key
+ * (upper) or not before it (lower).
+ */
+static int
+_bt_slot(netsnmp_container_compare *cmp, btree_node *n, int from,
+         const void *key, const btree_key *k, int upper)
+{
+    int             lo = from, hi = n->count, mid, rc;
+
+    while (lo < hi) {
+        mid = (lo + hi) >> 1;
+        rc = _bt_compare(cmp, n, mid, key, k);
+        if (rc < 0 || (upper && 0 == rc))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/**********************************************************************
+ *
+ * nodes
+ *
+ */
+static btree_node *
+_bt_node_new(int leaf)
+{
+    btree_node     *n;
+
+    if (leaf)
+        n = (btree_node *)calloc(1, sizeof(btree_node));
+    else
+        n = (btree_node *)calloc(1, sizeof(btree_inner));
+    if (NULL == n) {
+        snmp_log(LOG_ERR, "couldn't allocate btree node\n");
+        return NULL;
+    }
+    n->leaf = leaf ? 1 : 0;
+    return n;
+}
+
+static void
+_bt_node_free(btree_node *n)
+{
+    int             i;
+
+    if (NULL == n)
+        return;
+    if (!n->leaf)
+        for (i = 0; i < n->count; ++i)
+            _bt_node_free(BT_INNER(n)->child[i]);
+    free(n);
+}
+
+static size_t
+_bt_node_size(btree_node *n)
+{
+    size_t          size = 0;
+    int             i;
+
+    if (n->leaf)
+        return n->count;
+    for (i = 0; i < n->count; ++i)
+        size += BT_INNER(n)->size[i];
+    return size;
+}
+
+/*
+ * moves cnt slots from src to dst (which may be the same node)
+ */
+static void
+_bt_move(btree_node *dst, int di, btree_node *src, int si, int cnt)
+{
+    if (cnt <= 0)
+        return;
+    memmove(&dst->key[di], &src->key[si], cnt * sizeof(btree_key));
+    memmove(&dst->data[di], &src->data[si], cnt * sizeof(void *));
+    if (!dst->leaf) {
+        memmove(&BT_INNER(dst)->child[di], &BT_INNER(src)->child[si],
+                cnt * sizeof(btree_node *));
+        memmove(&BT_INNER(dst)->size[di], &BT_INNER(src)->size[si],
+                cnt * sizeof(size_t));
+    }
+}
+
+/*
+ * sets aside the nodes an insert may need: a leaf, and an inner node for
+ * each level above it plus a new root.  Splitting can then not fail
+ * half way up the tree.  The spare nodes are chained through next.
+ */
+static int
+_bt_reserve(btree_table *t)
+{
+    btree_node     *n;
+    int             leaf, need[2];
+
+    need[1] = 1;
+    need[0] = 1;
+    for (n = t->root; !n->leaf; n = BT_INNER(n)->child[0])
+        ++need[0];
+
+    for (leaf = 0; leaf < 2; ++leaf)
+        while (t->spare_count[leaf] < need[leaf]) {
+            n = _bt_node_new(leaf);
+            if (NULL == n)
+                return -1;
+            n->next = t->spare[leaf];
+            t->spare[leaf] = n;
+            ++t->spare_count[leaf];
+        }
+    return 0;
+}
+
+static btree_node *
+_bt_spare(btree_table *t, int leaf)
+{
+    btree_node     *n = t->spare[leaf];
+
+    netsnmp_assert(NULL != n);
+    t->spare[leaf] = n->next;
+    --t->spare_count[leaf];
+    n->next = NULL;
+    return n;
+}
+
+static void
+_bt_spare_free(btree_table *t)
+{
+    btree_node     *n;
+    int             leaf;
+
+    for (leaf = 0; leaf < 2; ++leaf)
+        while (NULL != (n = t->spare[leaf])) {
+            t->spare[leaf] = n->next;
+            free(n);
+        }
+    t->spare_count[0] = t->spare_count[1] = 0;
+}
+
+/*
+ * copies the smallest entry of child i into its slot
+ */
+NETSNMP_STATIC_INLINE void
+_bt_refresh(btree_node *n, int i)
+{
+    btree_node     *child = BT_INNER(n)->child[i];
+
+    if (child->count) {
+        n->data[i] = child->data[0];
+        n->key[i] = child->key[0];
+    }
+}
+
+/*
+ * makes room for a slot at *pos in *n, splitting it if it is full (with
+ * a node set aside by _bt_reserve).  *n and *pos are updated to where the
+ * slot ended up; the new right sibling is returned in *split.
+ */
+static void
+_bt_open(btree_table *t, btree_node **n, int *pos, btree_node **split)
+{
+    btree_node     *left = *n, *right;
+
+    *split = NULL;
+    if (left->count == BT_FANOUT) {
+        right = _bt_spare(t, left->leaf);
+        _bt_move(right, 0, left, BT_MIN, BT_FANOUT - BT_MIN);
+        right->count = BT_FANOUT - BT_MIN;
+        left->count = BT_MIN;
+        if (left->leaf) {
+            right->next = left->next;
+            left->next = right;
+        }
+        *split = right;
+        if (*pos > BT_MIN) {
+            *n = right;
+            *pos -= BT_MIN;
+        }
+    }
+    _bt_move(*n, *pos + 1, *n, *pos, (*n)->count - *pos);
+    ++(*n)->count;
+}
+
+/**********************************************************************
+ *
+ * tree
+ *
+ */
+NETSNMP_STATIC_INLINE const btree_key *
+_bt_search_key(netsnmp_container *c, const void *key, btree_key *k)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    if (t->prefix && c->compare != netsnmp_compare_netsnmp_index)
+        t->prefix = 0; /* compare changed; prefixes are stale */
+    if (!t->prefix)
+        return NULL;
+    _bt_key_set(k, key);
+    return k;
+}
+
+/*
+ * finds the first entry not before key (or after it, if upper).  The
+ * returned slot may be one past the end of the leaf, and the position
+ * of the entry in the container is returned in *ord if requested.
+ */
+static btree_node *
+_bt_search(netsnmp_container *c, netsnmp_container_compare *cmp,
+           const void *key, const btree_key *k, int upper,
+           int *slot, size_t *ord)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n = t->root;
+    size_t          o = 0;
+    int             i, j;
+
+    while (!n->leaf) {
+        i = _bt_slot(cmp, n, 1, key, k, upper) - 1;
+        if (ord)
+            for (j = 0; j < i; ++j)
+                o += BT_INNER(n)->size[j];
+        n = BT_INNER(n)->child[i];
+    }
+    *slot = _bt_slot(cmp, n, 0, key, k, upper);
+    if (ord)
+        *ord = o + *slot;
+    return n;
+}
+
+/*
+ * moves on to the next leaf if slot is past the end of n
+ */
+NETSNMP_STATIC_INLINE btree_node *
+_bt_fix(btree_node *n, int *slot)
+{
+    while (n && *slot >= n->count) {
+        *slot -= n->count;
+        n = n->next;
+    }
+    return n;
+}
+
+/*
+ * finds the leaf and slot holding the entry at position pos
+ */
+static btree_node *
+_bt_locate(btree_table *t, size_t pos, int *slot)
+{
+    btree_node     *n = t->root;
+    int             i;
+
+    while (!n->leaf) {
+        for (i = 0; i < n->count - 1 && pos >= BT_INNER(n)->size[i]; ++i)
+            pos -= BT_INNER(n)->size[i];
+        n = BT_INNER(n)->child[i];
+    }
+    *slot = (int)pos;
+    return n;
+}
+
+/*
+ * inserts entry below n, after any entries with the same key.  Returns
+ * the new right sibling if n was split.  The nodes needed for splits
+ * must have been set aside with _bt_reserve.
+ */
+static void
+_bt_insert_below(netsnmp_container *c, btree_node *n, void *entry,
+                 const btree_key *k, btree_node **split)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *right = NULL;
+    int             i;
+
+    if (n->leaf) {
+        i = _bt_slot(c->compare, n, 0, entry, k, 1);
+        _bt_open(t, &n, &i, split);
+        n->data[i] = entry;
+        if (k)
+            n->key[i] = *k;
+        return;
+    }
+
+    i = _bt_slot(c->compare, n, 1, entry, k, 1) - 1;
+    _bt_insert_below(c, BT_INNER(n)->child[i], entry, k, &right);
+    if (NULL == right) {
+        ++BT_INNER(n)->size[i];
+        _bt_refresh(n, i);
+        *split = NULL;
+        return;
+    }
+
+    BT_INNER(n)->size[i] = _bt_node_size(BT_INNER(n)->child[i]);
+    _bt_refresh(n, i);
+    ++i;
+    _bt_open(t, &n, &i, split);
+    BT_INNER(n)->child[i] = right;
+    BT_INNER(n)->size[i] = _bt_node_size(right);
+    _bt_refresh(n, i);
+}
+
+/*
+ * evens out children i and the one next to it after i underflowed
+ */
+static void
+_bt_rebalance(btree_node *n, int i)
+{
+    btree_inner    *p = BT_INNER(n);
+    btree_node     *l, *r;
+    size_t          w;
+
+    if (i > 0)
+        --i;
+    if (i + 1 >= n->count)
+        return;
+    l = p->child[i];
+    r = p->child[i + 1];
+
+    if (l->count + r->count <= BT_FANOUT) {
+        /*
+         * merge the right node into the left one
+         */
+        _bt_move(l, l->count, r, 0, r->count);
+        l->count += r->count;
+        if (l->leaf)
+            l->next = r->next;
+        p->size[i] += p->size[i + 1];
+        free(r);
+        _bt_move(n, i + 1, n, i + 2, n->count - i - 2);
+        --n->count;
+    } else if (l->count < r->count) {
+        w = r->leaf ? 1 : BT_INNER(r)->size[0];
+        _bt_move(l, l->count, r, 0, 1);
+        ++l->count;
+        _bt_move(r, 0, r, 1, r->count - 1);
+        --r->count;
+        p->size[i] += w;
+        p->size[i + 1] -= w;
+        _bt_refresh(n, i + 1);
+    } else {
+        w = l->leaf ? 1 : BT_INNER(l)->size[l->count - 1];
+        _bt_move(r, 1, r, 0, r->count);
+        _bt_move(r, 0, l, l->count - 1, 1);
+        ++r->count;
+        --l->count;
+        p->size[i] -= w;
+        p->size[i + 1] += w;
+        _bt_refresh(n, i + 1);
+    }
+}
+
+static void *
+_bt_remove_below(btree_node *n, size_t pos)
+{
+    void           *entry;
+    btree_node     *child;
+    int             i;
+
+    if (n->leaf) {
+        entry = n->data[pos];
+        _bt_move(n, (int)pos, n, (int)pos + 1, n->count - (int)pos - 1);
+        --n->count;
+        return entry;
+    }
+
+    for (i = 0; i < n->count - 1 && pos >= BT_INNER(n)->size[i]; ++i)
+        pos -= BT_INNER(n)->size[i];
+    child = BT_INNER(n)->child[i];
+    entry = _bt_remove_below(child, pos);
+    --BT_INNER(n)->size[i];
+    _bt_refresh(n, i);
+    if (child->count < BT_MIN)
+        _bt_rebalance(n, i);
+    return entry;
+}
+
+static int
+_bt_insert_entry(netsnmp_container *c, const void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *right = NULL, *root;
+    btree_key       key;
+    const btree_key *k = NULL;
+    void           *entry = NETSNMP_REMOVE_CONST(void *, data);
+
+    if (NULL == entry)
+        return -1;
+
+    if (NULL == t->root) {
+        t->root = t->first = _bt_node_new(1);
+        if (NULL == t->root)
+            return -1;
+    }
+    if (0 == t->count)
+        t->prefix = (c->compare == netsnmp_compare_netsnmp_index);
+    k = _bt_search_key(c, entry, &key);
+
+    /*
+     * check key if we have at least 1 item and duplicates aren't allowed
+     */
+    if (!(c->flags & CONTAINER_KEY_ALLOW_DUPLICATES) && t->count) {
+        int         slot;
+        btree_node *n = _bt_search(c, c->compare, entry, k, 0, &slot, NULL);
+
+        n = _bt_fix(n, &slot);
+        if (n && 0 == _bt_compare(c->compare, n, slot, entry, k)) {
+            DEBUGMSGTL(("container","not inserting duplicate key\n"));
+            return -1;
+        }
+    }
+
+    if (_bt_reserve(t) != 0)
+        return -1;
+    _bt_insert_below(c, t->root, entry, k, &right);
+    if (right) {
+        root = _bt_spare(t, 0);
+        root->count = 2;
+        BT_INNER(root)->child[0] = t->root;
+        BT_INNER(root)->child[1] = right;
+        BT_INNER(root)->size[0] = _bt_node_size(t->root);
+        BT_INNER(root)->size[1] = _bt_node_size(right);
+        _bt_refresh(root, 0);
+        _bt_refresh(root, 1);
+        t->root = root;
+    }
+
+    ++t->count;
+    ++c->sync;
+    return 0;
+}
+
+static int
+_bt_remove_at(netsnmp_container *c, size_t pos, void **save)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *root;
+    void           *entry;
+
+    if (save)
+        *save = NULL;
+    if (pos >= t->count)
+        return -1;
+
+    entry = _bt_remove_below(t->root, pos);
+    while (!t->root->leaf && 1 == t->root->count) {
+        root = t->root;
+        t->root = BT_INNER(root)->child[0];
+        free(root);
+    }
+    --t->count;
+    ++c->sync;
+
+    if (save)
+        *save = entry;
+    return 0;
+}
+
+static int
+_bt_get_at(netsnmp_container *c, size_t pos, void **entry)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n;
+    int             slot;
+
+    if (pos >= t->count || NULL == entry)
+        return -1;
+
+    n = _bt_locate(t, pos, &slot);
+    *entry = n->data[slot];
+    return 0;
+}
+
+/**********************************************************************
+ *
+ * container
+ *
+ */
+static void *
+_bt_find(netsnmp_container *c, const void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n;
+    btree_key       key;
+    const btree_key *k;
+    int             slot;
+
+    if (!t->count || NULL == data)
+        return NULL;
+
+    k = _bt_search_key(c, data, &key);
+    n = _bt_search(c, c->compare, data, k, 0, &slot, NULL);
+    n = _bt_fix(n, &slot);
+    if (NULL == n || _bt_compare(c->compare, n, slot, data, k) != 0)
+        return NULL;
+    return n->data[slot];
+}
+
+static void *
+_bt_find_next(netsnmp_container *c, const void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n;
+    btree_key       key;
+    int             slot = 0;
+
+    if (!t->count)
+        return NULL;
+
+    /*
+     * the first entry after the key skips any duplicates of it
+     */
+    if (NULL == data)
+        n = t->first;
+    else
+        n = _bt_search(c, c->compare, data, _bt_search_key(c, data, &key),
+                       1, &slot, NULL);
+    n = _bt_fix(n, &slot);
+    return n ? n->data[slot] : NULL;
+}
+
+/**********************************************************************
+ *
+ * bulk loading
+ *
+ */
+
+/*
+ * frees the first cnt nodes of a level of a tree under construction
+ */
+static void
+_bt_build_free(btree_node **level, size_t cnt)
+{
+    size_t          i;
+
+    for (i = 0; i < cnt; ++i)
+        _bt_node_free(level[i]);
+}
+
+/*
+ * builds a tree over n sorted entries, filling the nodes evenly from
+ * the leaves up.  Returns the root, or NULL if memory runs out.
+ */
+static btree_node *
+_bt_build(void **entries, size_t n, int prefix, btree_node **first)
+{
+    btree_node    **level, *node, *prev = NULL;
+    size_t          nodes, parents, i, pos, cnt;
+    int             j;
+
+    nodes = n ? (n + BT_FANOUT - 1) / BT_FANOUT : 1;
+    level = (btree_node **)calloc(nodes, sizeof(btree_node *));
+    if (NULL == level)
+        return NULL;
+
+    for (i = 0, pos = 0; i < nodes; ++i) {
+        node = _bt_node_new(1);
+        if (NULL == node) {
+            _bt_build_free(level, i);
+            free(level);
+            return NULL;
+        }
+        cnt = n / nodes + (i < n % nodes);
+        for (j = 0; j < (int)cnt; ++j, ++pos) {
+            node->data[j] = entries[pos];
+            if (prefix)
+                _bt_key_set(&node->key[j], entries[pos]);
+        }
+        node->count = (u_short)cnt;
+        if (prev)
+            prev->next = node;
+        prev = level[i] = node;
+    }
+    *first = level[0];
+
+    /*
+     * parents are stored over the children already taken
+     */
+    for (; nodes > 1; nodes = parents) {
+        parents = (nodes + BT_FANOUT - 1) / BT_FANOUT;
+        for (i = 0, pos = 0; i < parents; ++i) {
+            cnt = nodes / parents + (i < nodes % parents);
+            node = _bt_node_new(0);
+            if (NULL == node) {
+                _bt_build_free(level, i);
+                _bt_build_free(&level[pos], nodes - pos);
+                free(level);
+                return NULL;
+            }
+            for (j = 0; j < (int)cnt; ++j, ++pos) {
+                BT_INNER(node)->child[j] = level[pos];
+                BT_INNER(node)->size[j] = _bt_node_size(level[pos]);
+                _bt_refresh(node, j);
+            }
+            node->count = (u_short)cnt;
+            level[i] = node;
+        }
+    }
+
+    node = level[0];
+    free(level);
+    return node;
+}
+
+static int
+_bt_bulk_begin(netsnmp_container *c)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    t->bulk = 1;
+    return 0;
+}
+
+static int
+_bt_bulk_append(btree_table *t, void *entry)
+{
+    if (t->bulk_count == t->bulk_max) {
+        size_t new_max = t->bulk_max > 0 ? 2 * t->bulk_max : 64;
+        void **new_data = (void **)realloc(t->bulk_data,
+                                           new_max * sizeof(void *));
+        if (NULL == new_data) {
+            snmp_log(LOG_ERR, "malloc failed in btree bulk append\n");
+            return -1;
+        }
+        t->bulk_data = new_data;
+        t->bulk_max = new_max;
+    }
+    t->bulk_data[t->bulk_count++] = entry;
+    return 0;
+}
+
+/*
+ * merges the appended entries with the ones in the tree and rebuilds
+ * it, which is cheaper than inserting them one by one.
+ */
+static int
+_bt_bulk_end(netsnmp_container *c, netsnmp_container_obj_func *f,
+             void *context)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n, *root, *first = NULL;
+    void          **current, **merged;
+    size_t          count, kept, i;
+    int             j, prefix, dropped = 0;
+
+    t->bulk = 0;
+    count = t->bulk_count;
+    if (0 == count)
+        return 0;
+
+    current = (void **)malloc((t->count ? t->count : 1) * sizeof(void *));
+    if (NULL != current) {
+        for (n = t->count ? t->first : NULL, i = 0; n; n = n->next)
+            for (j = 0; j < n->count; ++j)
+                current[i++] = n->data[j];
+        if (netsnmp_container_bulk_merge(c, current, t->count, t->bulk_data,
+                                         count, &merged, &kept) == 0) {
+            prefix = (c->compare == netsnmp_compare_netsnmp_index);
+            root = _bt_build(merged, kept, prefix, &first);
+            if (NULL != root) {
+                _bt_node_free(t->root);
+                t->root = root;
+                t->first = first;
+                t->prefix = prefix;
+                t->bulk_count = 0;
+                ++c->sync;
+                for (i = t->count + count; i > kept; ) {
+                    if (f)
+                        (*f) (merged[--i], context);
+                    else
+                        --i;
+                    ++dropped;
+                }
+                t->count = kept;
+                free(merged);
+                free(current);
+                return dropped;
+            }
+            free(merged);
+        }
+        free(current);
+    }
+
+    /*
+     * out of memory: insert the entries one at a time
+     */
+    snmp_log(LOG_WARNING, "bulk load of %s falls back to single inserts\n",
+             c->container_name ? c->container_name : "container");
+    t->bulk_count = 0;
+    for (i = 0; i < count; ++i)
+        if (_bt_insert_entry(c, t->bulk_data[i]) != 0) {
+            if (f)
+                (*f) (t->bulk_data[i], context);
+            ++dropped;
+        }
+    return dropped;
+}
+
+static int
+_bt_insert(netsnmp_container *c, const void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    if (t->bulk && NULL != data)
+        return _bt_bulk_append(t, NETSNMP_REMOVE_CONST(void *, data));
+    return _bt_insert_entry(c, data);
+}
+
+static int
+_bt_remove(netsnmp_container *c, const void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n;
+    btree_key       key;
+    const btree_key *k;
+    size_t          pos, first;
+    int             slot;
+
+    /*
+     * entries appended in bulk are only removed by pointer
+     */
+    for (pos = 0; pos < t->bulk_count; ++pos)
+        if (t->bulk_data[pos] == data) {
+            --t->bulk_count;
+            memmove(&t->bulk_data[pos], &t->bulk_data[pos + 1],
+                    (t->bulk_count - pos) * sizeof(void *));
+            return 0;
+        }
+
+    if (!t->count)
+        return 0;
+    if (NULL == data)
+        return -1;
+
+    k = _bt_search_key(c, data, &key);
+    n = _bt_search(c, c->compare, data, k, 0, &slot, &first);
+    n = _bt_fix(n, &slot);
+    if (NULL == n || _bt_compare(c->compare, n, slot, data, k) != 0)
+        return -1;
+
+    /*
+     * among entries with the same key, prefer the one passed in
+     */
+    for (pos = first; n && n->data[slot] != data; ++pos) {
+        ++slot;
+        n = _bt_fix(n, &slot);
+        if (NULL == n || _bt_compare(c->compare, n, slot, data, k) != 0) {
+            pos = first;
+            break;
+        }
+    }
+
+    return _bt_remove_at(c, pos, NULL);
+}
+
+static void
+_bt_release(netsnmp_container *c)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    if (t) {
+        _bt_node_free(t->root);
+        _bt_spare_free(t);
+        SNMP_FREE(t->bulk_data);
+    }
+    SNMP_FREE(t);
+    SNMP_FREE(c);
+}
+
+static int
+_bt_free(netsnmp_container *c)
+{
+    _bt_release(c);
+    return 0;
+}
+
+static size_t
+_bt_size(netsnmp_container *c)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    return t ? t->count + t->bulk_count : 0;
+}
+
+static void
+_bt_for_each(netsnmp_container *c, netsnmp_container_obj_func *f,
+             void *context)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    btree_node     *n;
+    int             i;
+
+    for (n = t->count ? t->first : NULL; n; n = n->next)
+        for (i = 0; i < n->count; ++i)
+            (*f) (n->data[i], context);
+    for (i = 0; i < (int)t->bulk_count; ++i)
+        (*f) (t->bulk_data[i], context);
+}
+
+static void
+_bt_clear(netsnmp_container *c, netsnmp_container_obj_func *f,
+          void *context)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+
+    if (NULL != f)
+        _bt_for_each(c, f, context);
+
+    _bt_node_free(t->root);
+    t->root = t->first = NULL;
+    t->count = 0;
+    t->bulk = 0;
+    t->bulk_count = 0;
+    ++c->sync;
+}
+
+static netsnmp_void_array *
+_bt_get_subset(netsnmp_container *c, void *data)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    netsnmp_void_array *va;
+    btree_node     *n, *start;
+    int             slot, start_slot;
+    size_t          len;
+
+    if (NULL == data || NULL == c->ncompare || !t->count)
+        return NULL;
+
+    /*
+     * the prefixes are no help for partial keys
+     */
+    n = _bt_search(c, c->ncompare, data, NULL, 0, &slot, NULL);
+    n = _bt_fix(n, &slot);
+    start = n;
+    start_slot = slot;
+    for (len = 0; n && 0 == c->ncompare(n->data[slot], data); ++len) {
+        ++slot;
+        n = _bt_fix(n, &slot);
+    }
+    if (0 == len)
+        return NULL;
+
+    va = SNMP_MALLOC_TYPEDEF(netsnmp_void_array);
+    if (NULL == va)
+        return NULL;
+    va->array = (void **)malloc(len * sizeof(void *));
+    if (NULL == va->array) {
+        free(va);
+        return NULL;
+    }
+    va->size = len;
+
+    for (n = start, slot = start_slot, len = 0; len < va->size; ++len) {
+        va->array[len] = n->data[slot];
+        ++slot;
+        n = _bt_fix(n, &slot);
+    }
+
+    return va;
+}
+
+static int
+_bt_options(netsnmp_container *c, int set, u_int flags)
+{
+    if (set) {
+        /** entries are always kept sorted */
+        if ((flags & CONTAINER_KEY_ALLOW_DUPLICATES) == flags)
+            c->flags = flags;
+        else
+            flags = (u_int)-1; /* unsupported flag */
+    }
+    else
+        return ((c->flags & flags) == flags);
+    return flags;
+}
+
+static netsnmp_container *
+_bt_duplicate(netsnmp_container *c, void *ctx, u_int flags)
+{
+    btree_table    *t = (btree_table *)c->container_data;
+    netsnmp_container *dup;
+    btree_node     *n;
+    int             i;
+
+    if (flags) {
+        snmp_log(LOG_ERR, "btree duplicate does not support flags yet\n");
+        return NULL;
+    }
+
+    dup = netsnmp_container_get_btree();
+    if (NULL == dup) {
+        snmp_log(LOG_ERR, "no memory for btree duplicate\n");
+        return NULL;
+    }
+    /*
+     * deal with container stuff
+     */
+    if (netsnmp_container_data_dup(dup, c) != 0) {
+        _bt_release(dup);
+        return NULL;
+    }
+
+    /*
+     * shallow copy of the entries, which are already in order
+     */
+    for (n = t->count ? t->first : NULL; n; n = n->next)
+        for (i = 0; i < n->count; ++i)
+            if (_bt_insert_entry(dup, n->data[i]) != 0) {
+                snmp_log(LOG_ERR, "no memory for btree duplicate\n");
+                _bt_release(dup);
+                return NULL;
+            }
+
+    return dup;
+}
+
+netsnmp_container *
+netsnmp_container_get_btree(void)
+{
+    /*
+     * allocate memory
+     */
+    netsnmp_container *c = SNMP_MALLOC_TYPEDEF(netsnmp_container);
+    if (NULL == c) {
+        snmp_log(LOG_ERR, "couldn't allocate memory\n");
+        return NULL;
+    }
+
+    c->container_data = SNMP_MALLOC_TYPEDEF(btree_table);
+    if (NULL == c->container_data) {
+        snmp_log(LOG_ERR, "couldn't allocate memory\n");
+        free(c);
+        return NULL;
+    }
+
+    netsnmp_init_container(c, NULL, _bt_free, _bt_size, NULL, _bt_insert,
+                           _bt_remove, _bt_find);
+    c->find_next = _bt_find_next;
+    c->get_subset = _bt_get_subset;
+    c->get_iterator = _bt_iterator_get;
+    c->for_each = _bt_for_each;
+    c->clear = _bt_clear;
+    c->options = _bt_options;
+    c->duplicate = _bt_duplicate;
+    c->get_at = _bt_get_at;
+    c->remove_at = _bt_remove_at;
+    c->bulk_begin = _bt_bulk_begin;
+    c->bulk_end = _bt_bulk_end;
+
+    return c;
+}
+
+netsnmp_factory *
+netsnmp_container_get_btree_factory(void)
+{
+    static netsnmp_factory f = { "btree",
+                                 (netsnmp_factory_produce_f*)
+                                 netsnmp_container_get_btree };
+
+    return &f;
+}
+
+void
+netsnmp_container_btree_init(void)
+{
+    netsnmp_container_register("btree",
+                               netsnmp_container_get_btree_factory());
+}
+
+/**********************************************************************
+ *
+ * iterator
+ *
+ */
+NETSNMP_STATIC_INLINE btree_table *
+_bt_it2cont(btree_iterator *it)
+{
+    if(NULL == it) {
+        netsnmp_assert(NULL != it);
+        return NULL;
+    }
+    if(NULL == it->base.container) {
+        netsnmp_assert(NULL != it->base.container);
+        return NULL;
+    }
+    if(NULL == it->base.container->container_data) {
+        netsnmp_assert(NULL != it->base.container->container_data);
+        return NULL;
+    }
+
+    return (btree_table*)(it->base.container->container_data);
+}
+
+static void *
+_bt_iterator_position(btree_iterator *it)
+{
+    btree_table    *t = _bt_it2cont(it);
+    if (NULL == t)
+        return t; /* msg already logged */
+
+    if(it->base.container->sync != it->base.sync) {
+        DEBUGMSGTL(("container:iterator", "out of sync\n"));
+        return NULL;
+    }
+
+    if(0 == t->count) {
+        DEBUGMSGTL(("container:iterator", "empty\n"));
+        return NULL;
+    }
+    else if(it->pos >= t->count) {
+        DEBUGMSGTL(("container:iterator", "end of container\n"));
+        return NULL;
+    }
+
+    if (NULL == it->leaf)
+        it->leaf = _bt_locate(t, it->pos, &it->slot);
+    return it->leaf->data[it->slot];
+}
+
+static void *
+_bt_iterator_curr(btree_iterator *it)
+{
+    if(NULL == it) {
+        netsnmp_assert(NULL != it);
+        return NULL;
+    }
+
+    return _bt_iterator_position(it);
+}
+
+static void *
+_bt_iterator_first(btree_iterator *it)
+{
+    if(NULL == it) {
+        netsnmp_assert(NULL != it);
+        return NULL;
+    }
+
+    it->pos = 0;
+    it->leaf = NULL;
+    return _bt_iterator_position(it);
+}
+
+static void *
+_bt_iterator_next(btree_iterator *it)
+{
+    if(NULL == it) {
+        netsnmp_assert(NULL != it);
+        return NULL;
+    }
+
+    ++it->pos;
+    if (it->base.container->sync != it->base.sync)
+        it->leaf = NULL;
+    else if (it->leaf) {
+        ++it->slot;
+        it->leaf = _bt_fix(it->leaf, &it->slot);
+    }
+
+    return _bt_iterator_position(it);
+}
+
+static void *
+_bt_iterator_last(btree_iterator *it)
+{
+    btree_table    *t = _bt_it2cont(it);
+    if(NULL == t) {
+        netsnmp_assert(NULL != t);
+        return NULL;
+    }
+
+    it->pos = t->count - 1;
+    it->leaf = NULL;
+    return _bt_iterator_position(it);
+}
+
+static int
+_bt_iterator_remove(btree_iterator *it)
+{
+    btree_table    *t = _bt_it2cont(it);
+    if(NULL == t) {
+        netsnmp_assert(NULL != t);
+        return -1;
+    }
+
+    /*
+     * since this iterator was used for the remove, keep it in sync with
+     * the container. Also, back up one so that next will be the position
+     * that was just removed.
+     */
+    ++it->base.sync;
+    it->leaf = NULL;
+    return _bt_remove_at(it->base.container, it->pos--, NULL);
+}
+
+static int
+_bt_iterator_reset(btree_iterator *it)
+{
+    btree_table    *t = _bt_it2cont(it);
+    if(NULL == t) {
+        netsnmp_assert(NULL != t);
+        return -1;
+    }
+
+    /*
+     * save sync count, to make sure container doesn't change while
+     * iterator is in use.
+     */
+    it->base.sync = it->base.container->sync;
+
+    it->pos = 0;
+    it->leaf = NULL;
+
+    return 0;
+}
+
+static int
+_bt_iterator_release(netsnmp_iterator *it)
+{
+    free(it);
+
+    return 0;
+}
+
+static netsnmp_iterator *
+_bt_iterator_get(netsnmp_container *c)
+{
+    btree_iterator *it;
+
+    if(NULL == c)
+        return NULL;
+
+    it = SNMP_MALLOC_TYPEDEF(btree_iterator);
+    if(NULL == it)
+        return NULL;
+
+    it->base.container = c;
+
+    it->base.first = (netsnmp_iterator_rtn*)_bt_iterator_first;
+    it->base.next = (netsnmp_iterator_rtn*)_bt_iterator_next;
+    it->base.curr = (netsnmp_iterator_rtn*)_bt_iterator_curr;
+    it->base.last = (netsnmp_iterator_rtn*)_bt_iterator_last;
+    it->base.remove = (netsnmp_iterator_rc*)_bt_iterator_remove;
+    it->base.reset = (netsnmp_iterator_rc*)_bt_iterator_reset;
+    it->base.release = (netsnmp_iterator_rc*)_bt_iterator_release;
+
+    (void)_bt_iterator_reset(it);
+
+    return (netsnmp_iterator *)it;
+}
+
+#else  /* NETSNMP_FEATURE_REMOVE_CONTAINER_BTREE */
+netsnmp_feature_unused(container_btree);
+#endif /* NETSNMP_FEATURE_REMOVE_CONTAINER_BTREE */
@@ -0,0 +1,508 @@
+/* UNIT: epoll(7) based event loop backend                                */
+/*
+ * See fd_event_epoll.h for an overview.
+ *
+ * Every descriptor we watch has a slot in fd_table, indexed by the fd.
+ * A slot records which users want the fd (an SNMP session and/or read,
+ * write or exception callbacks registered with the FD event manager) and
+ * what has been registered with the kernel.  The epoll_event data carries
+ * the fd plus a per-registration serial number, so that events which were
+ * already queued for a descriptor that got closed and reused by somebody
+ * else while we were dispatching are recognized and dropped.
+ */
+#include <net-snmp/net-snmp-config.h>
+
+#include <errno.h>
+#if HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#if TIME_WITH_SYS_TIME
+# include <sys/time.h>
+# include <time.h>
+#else
+# if HAVE_SYS_TIME_H
+#  include <sys/time.h>
+# else
+#  include <time.h>
+# endif
+#endif
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H)
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#endif
+
+#include <net-snmp/net-snmp-includes.h>
+#include <net-snmp/net-snmp-features.h>
+#include <net-snmp/library/snmp_api.h>
+#include <net-snmp/library/snmp_alarm.h>
+#include <net-snmp/library/fd_event_manager.h>
+#include <net-snmp/library/fd_event_epoll.h>
+#include <net-snmp/library/large_fd_set.h>
+
+netsnmp_feature_child_of(fd_event_epoll, libnetsnmp);
+netsnmp_feature_require(fd_event_manager);
+
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_SYS_TIMERFD_H) \
+    && !defined(NETSNMP_FEATURE_REMOVE_FD_EVENT_EPOLL)
+
+#define EPOLL_WANT_SESSION  0x01
+#define EPOLL_WANT_READ     0x02
+#define EPOLL_WANT_WRITE    0x04
+#define EPOLL_WANT_EXCEPT   0x08
+#define EPOLL_SLOT_RENEW    0x100   /* owner changed; refresh the serial */
+
+#define EPOLL_MAX_EVENTS    64
+
+typedef struct epoll_fd_slot_s {
+    unsigned int         want;      /* EPOLL_WANT_* */
+    unsigned int         events;    /* registered with the kernel; 0 = none */
+    unsigned int         serial;
+    struct session_list *slp;
+} epoll_fd_slot;
+
+static int            epoll_fd = -1;
+static int            timer_fd = -1;
+static epoll_fd_slot *fd_table;
+static int            fd_table_size;
+static unsigned int   next_serial;
+static unsigned int   sessions_gen;
+static unsigned int   external_gen;
+static unsigned int   timeouts_seen;
+static int            sessions_dirty = 1;
+static int            external_dirty = 1;
+static int            sessions_check;
+static int            timer_armed;
+static struct timeval timer_deadline;
+static netsnmp_large_fd_set session_fds;
+
+static epoll_fd_slot *
+_epoll_slot(int fd)
+{
+    if (fd < 0)
+        return NULL;
+
+    if (fd >= fd_table_size) {
+        int             newsize = fd_table_size ? 2 * fd_table_size : 64;
+        epoll_fd_slot  *tmp;
+
+        while (newsize <= fd)
+            newsize *= 2;
+        tmp = (epoll_fd_slot *) realloc(fd_table, newsize * sizeof(*tmp));
+        if (tmp == NULL) {
+            snmp_log(LOG_ERR, "epoll: cannot grow fd table to %d\n", newsize);
+            return NULL;
+        }
+        memset(tmp + fd_table_size, 0,
+               (newsize - fd_table_size) * sizeof(*tmp));
+        fd_table = tmp;
+        fd_table_size = newsize;
+    }
+    return &fd_table[fd];
+}
+
+static uint64_t
+_epoll_data(int fd, unsigned int serial)
+{
+    return ((uint64_t) serial << 32) | (uint32_t) fd;
+}
+
+/*
+ * Bring the kernel's view of fd in line with slot->want.
+ */
+static void
+_epoll_apply(int fd, epoll_fd_slot *slot, int probe)
+{
+    struct epoll_event ev;
+    unsigned int    events = 0;
+    int             renew = (slot->want & EPOLL_SLOT_RENEW) != 0;
+
+    slot->want &= ~EPOLL_SLOT_RENEW;
+
+    if (slot->want & (EPOLL_WANT_SESSION | EPOLL_WANT_READ))
+        events |= EPOLLIN;
+    if (slot->want & EPOLL_WANT_WRITE)
+        events |= EPOLLOUT;
+    if (slot->want & EPOLL_WANT_EXCEPT)
+        events |= EPOLLPRI;
+
+    if (events == 0) {
+        if (slot->events) {
+            /* ENOENT/EBADF: already gone because the fd was closed */
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+            DEBUGMSGTL(("fd_event_epoll", "removed fd %d\n", fd));
+        }
+        memset(slot, 0, sizeof(*slot));
+        return;
+    }
+
+    if (slot->events == events && !renew && !probe)
+        return;
+    if (slot->events == 0 || renew)
+        slot->serial = ++next_serial;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u64 = _epoll_data(fd, slot->serial);
+
+    /*
+     * Try to add even if we think the fd is registered: the kernel drops
+     * a registration by itself when the descriptor is closed, and a new
+     * session or callback may have been handed the same fd number since
+     * we last looked.
+     */
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0) {
+        DEBUGMSGTL(("fd_event_epoll", "added fd %d (events 0x%x)\n",
+                    fd, events));
+    } else if (errno == EEXIST) {
+        if ((slot->events != events || renew) &&
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev) < 0) {
+            snmp_log(LOG_ERR, "epoll: cannot modify fd %d: %s\n", fd,
+                     strerror(errno));
+            slot->want = 0;
+            events = 0;
+        }
+    } else {
+        snmp_log(LOG_ERR, "epoll: cannot add fd %d: %s\n", fd,
+                 strerror(errno));
+        slot->want = 0;
+        events = 0;
+    }
+    slot->events = events;
+}
+
+static void
+_epoll_session_cb(struct session_list *slp, int fd, void *arg)
+{
+    epoll_fd_slot  *slot = _epoll_slot(fd);
+
+    if (slot == NULL)
+        return;
+    if (slot->slp != slp)
+        slot->want |= EPOLL_SLOT_RENEW;
+    slot->want |= EPOLL_WANT_SESSION;
+    slot->slp = slp;
+}
+
+/*
+ * Refresh the registrations if the session list or the FD event manager
+ * registrations changed since the last call.  Once fds may have been
+ * closed and reused, every registration is re-added to the kernel; a
+ * plain re-check of the session list (sessions_check) only touches the
+ * slots whose wanted events changed.  A request that timed out may have
+ * had its session's transport closed from the timeout callback (e.g. an
+ * AgentX subagent that stopped answering), which leaves the session
+ * behind with sock == -1, so that calls for a re-check too.
+ */
+static void
+_epoll_sync(void)
+{
+    unsigned int    clear = 0;
+    int             i, probe;
+
+    if (snmp_sessions_generation() != sessions_gen)
+        sessions_dirty = 1;
+    if (netsnmp_external_event_generation() != external_gen)
+        external_dirty = 1;
+    if (snmp_sessions_timeouts() != timeouts_seen) {
+        timeouts_seen = snmp_sessions_timeouts();
+        sessions_check = 1;
+    }
+    if (!sessions_dirty && !external_dirty && !sessions_check)
+        return;
+    probe = sessions_dirty || external_dirty;
+    if (sessions_check)
+        sessions_dirty = 1;
+
+    if (sessions_dirty)
+        clear |= EPOLL_WANT_SESSION;
+    if (external_dirty)
+        clear |= EPOLL_WANT_READ | EPOLL_WANT_WRITE | EPOLL_WANT_EXCEPT;
+    for (i = 0; i < fd_table_size; i++)
+        fd_table[i].want &= ~clear;
+
+    if (sessions_dirty) {
+        /* may close sessions marked for deletion, so don't hold the lock */
+        snmp_sessions_foreach_fd(_epoll_session_cb, NULL);
+        sessions_gen = snmp_sessions_generation();
+    }
+    if (external_dirty) {
+        epoll_fd_slot  *slot;
+
+        for (i = 0; i < external_readfdlen; i++)
+            if ((slot = _epoll_slot(external_readfd[i])))
+                slot->want |= EPOLL_WANT_READ;
+        for (i = 0; i < external_writefdlen; i++)
+            if ((slot = _epoll_slot(external_writefd[i])))
+                slot->want |= EPOLL_WANT_WRITE;
+        for (i = 0; i < external_exceptfdlen; i++)
+            if ((slot = _epoll_slot(external_exceptfd[i])))
+                slot->want |= EPOLL_WANT_EXCEPT;
+        external_gen = netsnmp_external_event_generation();
+    }
+
+    for (i = 0; i < fd_table_size; i++) {
+        epoll_fd_slot  *slot = &fd_table[i];
+
+        if (!(slot->want & EPOLL_WANT_SESSION))
+            slot->slp = NULL;
+        if (slot->want || slot->events)
+            _epoll_apply(i, slot, probe);
+    }
+    sessions_dirty = external_dirty = sessions_check = 0;
+}
+
+/*
+ * Arm the timer for the earliest snmp_alarm or request retransmission
+ * deadline, the same set of deadlines snmp_select_info() considers.
+ * snmp_sessions_earliest_request() keeps the request deadline up to date
+ * as requests come and go, so this does not walk the sessions.
+ */
+static void
+_epoll_arm_timer(void)
+{
+    struct itimerspec its;
+    struct timeval  now, deadline, alarm_tm, delta;
+    int             have;
+
+    netsnmp_get_monotonic_clock(&now);
+    have = snmp_sessions_earliest_request(&deadline);
+    if (netsnmp_ds_get_boolean(NETSNMP_DS_LIBRARY_ID,
+                               NETSNMP_DS_LIB_ALARM_DONT_USE_SIG) &&
+        netsnmp_get_next_alarm_time(&alarm_tm, &now)) {
+        if (!have || timercmp(&alarm_tm, &deadline, <))
+            deadline = alarm_tm;
+        have = 1;
+    }
+
+    memset(&its, 0, sizeof(its));
+    if (!have) {
+        if (timer_armed) {
+            timerfd_settime(timer_fd, 0, &its, NULL);
+            timer_armed = 0;
+        }
+        return;
+    }
+    if (timer_armed && !timercmp(&deadline, &timer_deadline, !=))
+        return;
+
+    NETSNMP_TIMERSUB(&deadline, &now, &delta);
+    if (delta.tv_sec < 0 || (delta.tv_sec == 0 && delta.tv_usec <= 0)) {
+        its.it_value.tv_nsec = 1;   /* a zero it_value disarms the timer */
+    } else {
+        its.it_value.tv_sec = delta.tv_sec;
+        its.it_value.tv_nsec = delta.tv_usec * 1000;
+    }
+    if (timerfd_settime(timer_fd, 0, &its, NULL) < 0) {
+        snmp_log(LOG_ERR, "epoll: cannot arm timer: %s\n", strerror(errno));
+        return;
+    }
+    DEBUGMSGTL(("fd_event_epoll", "timer due in %ld.%06ld sec\n",
+                (long) delta.tv_sec, (long) delta.tv_usec));
+    timer_deadline = deadline;
+    timer_armed = 1;
+}
+
+static void
+_epoll_dispatch_external(int fd, int *lens, int *fds,
+                         void (**funcs) (int, void *), void **data)
+{
+    int             i;
+
+    for (i = 0; i < *lens; i++) {
+        if (fds[i] == fd) {
+            DEBUGMSGTL(("fd_event_epoll", "external fd %d\n", fd));
+            funcs[i] (fd, data[i]);
+            return;
+        }
+    }
+}
+
+/*
+ * Look up the slot an event refers to; NULL if the registration it was
+ * queued for is gone.
+ */
+static epoll_fd_slot *
+_epoll_event_slot(const struct epoll_event *ev)
+{
+    int             fd = (int) (uint32_t) ev->data.u64;
+    unsigned int    serial = (unsigned int) (ev->data.u64 >> 32);
+
+    _epoll_sync();
+    if (fd < 0 || fd >= fd_table_size || fd_table[fd].events == 0 ||
+        fd_table[fd].serial != serial)
+        return NULL;
+    return &fd_table[fd];
+}
+
+int
+netsnmp_epoll_init(void)
+{
+    struct epoll_event ev;
+
+    if (epoll_fd >= 0)
+        return 0;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        snmp_log(LOG_ERR, "epoll_create1: %s\n", strerror(errno));
+        return -1;
+    }
+    timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer_fd < 0) {
+        snmp_log(LOG_ERR, "timerfd_create: %s\n", strerror(errno));
+        close(epoll_fd);
+        epoll_fd = -1;
+        return -1;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u64 = _epoll_data(timer_fd, 0);
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd, &ev) < 0) {
+        snmp_log(LOG_ERR, "epoll: cannot add timer: %s\n", strerror(errno));
+        netsnmp_epoll_shutdown();
+        return -1;
+    }
+
+    netsnmp_large_fd_set_init(&session_fds, FD_SETSIZE);
+    sessions_dirty = external_dirty = 1;
+    timer_armed = 0;
+    DEBUGMSGTL(("fd_event_epoll", "initialized (epoll fd %d, timer fd %d)\n",
+                epoll_fd, timer_fd));
+    return 0;
+}
+
+void
+netsnmp_epoll_shutdown(void)
+{
+    if (timer_fd >= 0)
+        close(timer_fd);
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+        netsnmp_large_fd_set_cleanup(&session_fds);
+    }
+    timer_fd = epoll_fd = -1;
+    SNMP_FREE(fd_table);
+    fd_table_size = 0;
+}
+
+int
+netsnmp_epoll_active(void)
+{
+    return epoll_fd >= 0;
+}
+
+int
+netsnmp_epoll_dispatch(int block)
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    int             n, i, count = 0;
+
+    if (epoll_fd < 0) {
+        errno = EBADF;
+        return -1;
+    }
+
+    _epoll_sync();
+    if (block)
+        _epoll_arm_timer();
+
+    n = epoll_wait(epoll_fd, events, EPOLL_MAX_EVENTS, block ? -1 : 0);
+    DEBUGMSGTL(("fd_event_epoll", "epoll_wait returned %d\n", n));
+    if (n <= 0)
+        return n;
+
+    for (i = 0; i < n; i++) {
+        epoll_fd_slot  *slot;
+        int             fd = (int) (uint32_t) events[i].data.u64;
+        unsigned int    ev = events[i].events;
+
+        if (fd == timer_fd) {
+            uint64_t        expirations;
+
+            if (read(timer_fd, &expirations, sizeof(expirations)) < 0 &&
+                errno != EAGAIN)
+                snmp_log(LOG_ERR, "epoll: timer read: %s\n", strerror(errno));
+            timer_armed = 0;
+            continue;
+        }
+
+        if ((ev & (EPOLLIN | EPOLLERR | EPOLLHUP)) &&
+            (slot = _epoll_event_slot(&events[i])) &&
+            (slot->want & EPOLL_WANT_SESSION)) {
+            struct session_list *slp = slot->slp;
+            unsigned int    gen = snmp_sessions_generation();
+
+            DEBUGMSGTL(("fd_event_epoll", "session fd %d\n", fd));
+            NETSNMP_LARGE_FD_SET(fd, &session_fds);
+            snmp_res_lock(MT_LIBRARY_ID, MT_LIB_SESSION);
+            snmp_sess_read2(slp, &session_fds);
+            snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_SESSION);
+            NETSNMP_LARGE_FD_CLR(fd, &session_fds);
+            if (gen == snmp_sessions_generation() &&
+                (slp->transport == NULL || slp->transport->sock < 0))
+                sessions_check = 1;     /* peer went away */
+            count++;
+        }
+        if ((ev & (EPOLLIN | EPOLLERR | EPOLLHUP)) &&
+            (slot = _epoll_event_slot(&events[i])) &&
+            (slot->want & EPOLL_WANT_READ)) {
+            _epoll_dispatch_external(fd, &external_readfdlen,
+                                     external_readfd, external_readfdfunc,
+                                     external_readfd_data);
+            count++;
+        }
+        if ((ev & (EPOLLOUT | EPOLLERR)) &&
+            (slot = _epoll_event_slot(&events[i])) &&
+            (slot->want & EPOLL_WANT_WRITE)) {
+            _epoll_dispatch_external(fd, &external_writefdlen,
+                                     external_writefd, external_writefdfunc,
+                                     external_writefd_data);
+            count++;
+        }
+        if ((ev & EPOLLPRI) &&
+            (slot = _epoll_event_slot(&events[i])) &&
+            (slot->want & EPOLL_WANT_EXCEPT)) {
+            _epoll_dispatch_external(fd, &external_exceptfdlen,
+                                     external_exceptfd,
+                                     external_exceptfdfunc,
+                                     external_exceptfd_data);
+            count++;
+        }
+    }
+    return count;
+}
+
+#else  /* HAVE_SYS_EPOLL_H && HAVE_SYS_TIMERFD_H */
+
+int
+netsnmp_epoll_init(void)
+{
+    DEBUGMSGTL(("fd_event_epoll", "epoll is not available\n"));
+    return -1;
+}
+
+void
+netsnmp_epoll_shutdown(void)
+{
+}
+
+int
+netsnmp_epoll_active(void)
+{
+    return 0;
+}
+
+int
+netsnmp_epoll_dispatch(int block)
+{
+    errno = EBADF;
+    return -1;
+}
+
+#endif /* HAVE_SYS_EPOLL_H && HAVE_SYS_TIMERFD_H */
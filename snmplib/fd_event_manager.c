@@ -24,6 +24,7 @@ void   *external_writefd_data[NUM_EXTERNAL_FDS];
 void   *external_exceptfd_data[NUM_EXTERNAL_FDS];
 
 static int external_fd_unregistered;
+static unsigned int external_fd_generation;
 
 /*
  * Register a given fd for read events.  Call callback when events
@@ -37,6 +38,7 @@ register_readfd(int fd, void (*func) (int, void *), void *data)
         external_readfdfunc[external_readfdlen] = func;
         external_readfd_data[external_readfdlen] = data;
         external_readfdlen++;
+        external_fd_generation++;
         DEBUGMSGTL(("fd_event_manager:register_readfd", "registered fd %d\n", fd));
         return FD_REGISTERED_OK;
     } else {
@@ -57,6 +59,7 @@ register_writefd(int fd, void (*func) (int, void *), void *data)
         external_writefdfunc[external_writefdlen] = func;
         external_writefd_data[external_writefdlen] = data;
         external_writefdlen++;
+        external_fd_generation++;
         DEBUGMSGTL(("fd_event_manager:register_writefd", "registered fd %d\n", fd));
         return FD_REGISTERED_OK;
     } else {
@@ -78,6 +81,7 @@ register_exceptfd(int fd, void (*func) (int, void *), void *data)
         external_exceptfdfunc[external_exceptfdlen] = func;
         external_exceptfd_data[external_exceptfdlen] = data;
         external_exceptfdlen++;
+        external_fd_generation++;
         DEBUGMSGTL(("fd_event_manager:register_exceptfd", "registered fd %d\n", fd));
         return FD_REGISTERED_OK;
     } else {
@@ -105,6 +109,7 @@ unregister_readfd(int fd)
             }
             DEBUGMSGTL(("fd_event_manager:unregister_readfd", "unregistered fd %d\n", fd));
             external_fd_unregistered = 1;
+            external_fd_generation++;
             return FD_UNREGISTERED_OK;
         }
     }
@@ -129,6 +134,7 @@ unregister_writefd(int fd)
             }
             DEBUGMSGTL(("fd_event_manager:unregister_writefd", "unregistered fd %d\n", fd));
             external_fd_unregistered = 1;
+            external_fd_generation++;
             return FD_UNREGISTERED_OK;
         }
     }
@@ -154,12 +160,23 @@ unregister_exceptfd(int fd)
             DEBUGMSGTL(("fd_event_manager:unregister_exceptfd", "unregistered fd %d\n",
                         fd));
             external_fd_unregistered = 1;
+            external_fd_generation++;
             return FD_UNREGISTERED_OK;
         }
     }
     return FD_NO_SUCH_REGISTRATION;
 }
 
+/*
+ * Returns a counter that changes whenever an fd is registered or
+ * unregistered, for event loops that cache the registrations.
+ */
+unsigned int
+netsnmp_external_event_generation(void)
+{
+    return external_fd_generation;
+}
+
 /* 
  * NET-SNMP External Event Info 
  */
@@ -691,6 +691,274 @@ sc_get_openssl_privfn(int priv_type)
 
     return fn;
 }
+
+static EVP_MD_CTX *
+_sc_md_ctx_new(void)
+{
+    EVP_MD_CTX     *cptr;
+
+#if defined(HAVE_EVP_MD_CTX_NEW)
+    cptr = EVP_MD_CTX_new();
+#elif defined(HAVE_EVP_MD_CTX_CREATE)
+    cptr = EVP_MD_CTX_create();
+#else
+    cptr = malloc(sizeof(*cptr));
+    if (cptr == NULL)
+        return NULL;
+#if defined(OLD_DES)
+    memset(cptr, 0, sizeof(*cptr));
+#else
+    EVP_MD_CTX_init(cptr);
+#endif
+#endif
+    return cptr;
+}
+
+static void
+_sc_md_ctx_free(EVP_MD_CTX *cptr)
+{
+    if (cptr == NULL)
+        return;
+#if defined(HAVE_EVP_MD_CTX_FREE)
+    EVP_MD_CTX_free(cptr);
+#elif defined(HAVE_EVP_MD_CTX_DESTROY)
+    EVP_MD_CTX_destroy(cptr);
+#else
+#if !defined(OLD_DES)
+    EVP_MD_CTX_cleanup(cptr);
+#endif
+    free(cptr);
+#endif
+}
+#endif /* openssl */
+
+/*
+ * The HMAC state for one key: the digest contexts after the inner
+ * (key ^ ipad) and outer (key ^ opad) blocks (RFC 2104), which each
+ * message only has to be copied from.  The key and auth type it was
+ * computed for are kept, so that a changed key is noticed.
+ *
+ * A cache is never changed once it has been stored in a cache pointer;
+ * a new one takes its place instead.  Only the count of its holders
+ * (cache pointers and callers signing with it) changes, under the
+ * MT_LIB_HMACCACHE lock, and it is freed when that drops to zero.
+ */
+struct sc_hmac_cache_s {
+    int             refcnt;
+    int             auth_type;
+    u_int           keylen;
+#ifdef NETSNMP_USE_OPENSSL
+    u_char          key[EVP_MAX_MD_SIZE];
+    const EVP_MD   *hashfn;
+    EVP_MD_CTX     *inner;
+    EVP_MD_CTX     *outer;
+#endif
+};
+
+/*
+ * frees a cache nobody holds any more
+ */
+static void
+_sc_hmac_cache_destroy(sc_hmac_cache *hc)
+{
+    if (hc == NULL)
+        return;
+#ifdef NETSNMP_USE_OPENSSL
+    _sc_md_ctx_free(hc->inner);
+    _sc_md_ctx_free(hc->outer);
+#endif
+    SNMP_ZERO(hc, sizeof(*hc));
+    free(hc);
+}
+
+/*
+ * drops one hold on a cache
+ */
+static void
+_sc_hmac_cache_release(sc_hmac_cache *hc)
+{
+    int             refcnt;
+
+    if (hc == NULL)
+        return;
+    snmp_res_lock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    refcnt = --hc->refcnt;
+    snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    if (refcnt == 0)
+        _sc_hmac_cache_destroy(hc);
+}
+
+/*******************************************************************-o-******
+ * sc_hmac_cache_free
+ *
+ * Parameters:
+ *	**cache		Cache set up by sc_generate_keyed_hash_cached() or
+ *			sc_check_keyed_hash_cached(); set to NULL.
+ *
+ * The cache itself is freed once no other holder uses it any more.
+ */
+void
+sc_hmac_cache_free(sc_hmac_cache **cache)
+{
+    sc_hmac_cache  *hc;
+
+    if (cache == NULL)
+        return;
+    snmp_res_lock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    hc = *cache;
+    *cache = NULL;
+    snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    _sc_hmac_cache_release(hc);
+}
+
+/*******************************************************************-o-******
+ * sc_hmac_cache_ref
+ *
+ * Parameters:
+ *	**cache		Cache set up by sc_generate_keyed_hash_cached() or
+ *			sc_check_keyed_hash_cached().
+ *
+ * Returns:
+ *	The cache in *cache (or NULL), to be stored in another cache
+ *	pointer and released from there with sc_hmac_cache_free().
+ */
+sc_hmac_cache *
+sc_hmac_cache_ref(sc_hmac_cache **cache)
+{
+    sc_hmac_cache  *hc;
+
+    if (cache == NULL)
+        return NULL;
+    snmp_res_lock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    hc = *cache;
+    if (hc)
+        hc->refcnt++;
+    snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    return hc;
+}
+
+#ifdef NETSNMP_USE_OPENSSL
+/* largest block size of the supported digests (SHA-384/512) */
+#define SC_HMAC_MAX_BLOCK_SIZE 128
+
+/*
+ * returns the cached HMAC state for the key, held for the caller (see
+ * _sc_hmac_cache_release()), after replacing the cache in *cache with a
+ * new one if it was set up for another key.  Returns NULL if no cache
+ * can be used for this key.
+ */
+static sc_hmac_cache *
+_sc_hmac_cache_get(sc_hmac_cache **cache, int auth_type,
+                   const EVP_MD *hashfn, const u_char *key, u_int keylen)
+{
+    sc_hmac_cache  *hc, *old;
+    u_char          pad[SC_HMAC_MAX_BLOCK_SIZE];
+    u_char          khash[EVP_MAX_MD_SIZE];
+    unsigned int    khash_len;
+    int             block, i, refcnt;
+
+    snmp_res_lock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    hc = *cache;
+    if (hc && hc->auth_type == auth_type && hc->keylen == keylen &&
+        memcmp(hc->key, key, keylen) == 0)
+        hc->refcnt++;
+    else
+        hc = NULL;
+    snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    if (hc)
+        return hc;
+
+    block = EVP_MD_block_size(hashfn);
+    if (keylen > sizeof(hc->key) || block <= 0 || block > (int)sizeof(pad))
+        return NULL;
+
+    hc = (sc_hmac_cache *) calloc(1, sizeof(*hc));
+    if (hc == NULL)
+        return NULL;
+    hc->auth_type = auth_type;
+    hc->keylen = keylen;
+    memcpy(hc->key, key, keylen);
+    hc->hashfn = hashfn;
+    hc->inner = _sc_md_ctx_new();
+    hc->outer = _sc_md_ctx_new();
+    if (!hc->inner || !hc->outer)
+        goto fail;
+
+    /*
+     * keys longer than the block size are hashed first
+     */
+    if (keylen > (u_int)block) {
+        if (!EVP_DigestInit_ex(hc->inner, hashfn, NULL) ||
+            !EVP_DigestUpdate(hc->inner, key, keylen) ||
+            !EVP_DigestFinal_ex(hc->inner, khash, &khash_len))
+            goto fail;
+        key = khash;
+        keylen = khash_len;
+    }
+
+    memset(pad, 0x36, block);
+    for (i = 0; i < (int)keylen; i++)
+        pad[i] ^= key[i];
+    if (!EVP_DigestInit_ex(hc->inner, hashfn, NULL) ||
+        !EVP_DigestUpdate(hc->inner, pad, block))
+        goto fail;
+
+    memset(pad, 0x5c, block);
+    for (i = 0; i < (int)keylen; i++)
+        pad[i] ^= key[i];
+    if (!EVP_DigestInit_ex(hc->outer, hashfn, NULL) ||
+        !EVP_DigestUpdate(hc->outer, pad, block))
+        goto fail;
+
+    memset(pad, 0, sizeof(pad));
+    memset(khash, 0, sizeof(khash));
+
+    /*
+     * publish it: one hold for *cache, one for the caller
+     */
+    hc->refcnt = 2;
+    snmp_res_lock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    old = *cache;
+    *cache = hc;
+    refcnt = old ? --old->refcnt : 1;
+    snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_HMACCACHE);
+    if (refcnt == 0)
+        _sc_hmac_cache_destroy(old);
+    return hc;
+
+  fail:
+    memset(pad, 0, sizeof(pad));
+    memset(khash, 0, sizeof(khash));
+    _sc_hmac_cache_destroy(hc);
+    return NULL;
+}
+
+/*
+ * HMAC of message with the cached state, which is only copied from so
+ * that concurrent callers can share it; returns 1 on success
+ */
+static int
+_sc_hmac_cache_sign(const sc_hmac_cache *hc, const u_char *message,
+                    u_int msglen, u_char *MAC, unsigned int *maclen)
+{
+    EVP_MD_CTX     *ctx;
+    u_char          ihash[EVP_MAX_MD_SIZE];
+    unsigned int    ihash_len;
+    int             ok;
+
+    ctx = _sc_md_ctx_new();
+    if (ctx == NULL)
+        return 0;
+    ok = EVP_MD_CTX_copy_ex(ctx, hc->inner) &&
+        EVP_DigestUpdate(ctx, message, msglen) &&
+        EVP_DigestFinal_ex(ctx, ihash, &ihash_len) &&
+        EVP_MD_CTX_copy_ex(ctx, hc->outer) &&
+        EVP_DigestUpdate(ctx, ihash, ihash_len) &&
+        EVP_DigestFinal_ex(ctx, MAC, maclen);
+    _sc_md_ctx_free(ctx);
+    memset(ihash, 0, sizeof(ihash));
+    return ok;
+}
 #endif /* openssl */
 
 
@@ -726,6 +994,29 @@ sc_generate_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
                        const u_char * key, u_int keylen,
                        const u_char * message, u_int msglen,
                        u_char * MAC, size_t * maclen)
+{
+    return sc_generate_keyed_hash_cached(NULL, authtypeOID, authtypeOIDlen,
+                                         key, keylen, message, msglen,
+                                         MAC, maclen);
+}
+
+/*******************************************************************-o-******
+ * sc_generate_keyed_hash_cached
+ *
+ * Like sc_generate_keyed_hash(), with the HMAC state derived from the key
+ * kept in *cache (which should start out NULL) for the next call with
+ * the same key.  A cache set up for a different key or transform is
+ * replaced, never changed, so other threads may keep signing with it.
+ * It must be released with sc_hmac_cache_free().  cache may be NULL.
+ *
+ * Only OpenSSL builds use the cache.
+ */
+int
+sc_generate_keyed_hash_cached(sc_hmac_cache ** cache,
+                              const oid * authtypeOID, size_t authtypeOIDlen,
+                              const u_char * key, u_int keylen,
+                              const u_char * message, u_int msglen,
+                              u_char * MAC, size_t * maclen)
 #if  defined(NETSNMP_USE_INTERNAL_MD5) || defined(NETSNMP_USE_OPENSSL) || defined(NETSNMP_USE_PKCS11) || defined(NETSNMP_USE_INTERNAL_CRYPTO)
 {
     int             rval = SNMPERR_SUCCESS, auth_type;
@@ -737,6 +1028,7 @@ sc_generate_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
 #endif
 #ifdef NETSNMP_USE_OPENSSL
     const EVP_MD   *hashfn;
+    sc_hmac_cache  *hc = NULL;
 #elif defined(NETSNMP_USE_PKCS11)
     u_long          ck_type;
 #endif
@@ -781,7 +1073,18 @@ sc_generate_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
         QUITFUN(SNMPERR_GENERR, sc_generate_keyed_hash_quit);
     }
 
-    HMAC(hashfn, key, keylen, message, msglen, buf, &buf_len);
+    if (cache)
+        hc = _sc_hmac_cache_get(cache, auth_type, hashfn, key, keylen);
+    if (hc) {
+        int             ok;
+
+        ok = _sc_hmac_cache_sign(hc, message, msglen, buf, &buf_len);
+        _sc_hmac_cache_release(hc);
+        if (!ok) {
+            QUITFUN(SNMPERR_GENERR, sc_generate_keyed_hash_quit);
+        }
+    } else
+        HMAC(hashfn, key, keylen, message, msglen, buf, &buf_len);
     if (buf_len != properlength) {
         QUITFUN(rval, sc_generate_keyed_hash_quit);
     }
@@ -855,7 +1158,7 @@ sc_generate_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
   sc_generate_keyed_hash_quit:
     memset(buf, 0, SNMP_MAXBUF_SMALL);
     return rval;
-}                               /* end sc_generate_keyed_hash() */
+}                               /* end sc_generate_keyed_hash_cached() */
 
 #else
                 _SCAPI_NOT_CONFIGURED
@@ -1076,6 +1379,24 @@ sc_check_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
                     const u_char * key, u_int keylen,
                     const u_char * message, u_int msglen,
                     const u_char * MAC, u_int maclen)
+{
+    return sc_check_keyed_hash_cached(NULL, authtypeOID, authtypeOIDlen,
+                                      key, keylen, message, msglen,
+                                      MAC, maclen);
+}
+
+/*******************************************************************-o-******
+ * sc_check_keyed_hash_cached
+ *
+ * Like sc_check_keyed_hash(), with a cache as for
+ * sc_generate_keyed_hash_cached().
+ */
+int
+sc_check_keyed_hash_cached(sc_hmac_cache ** cache,
+                           const oid * authtypeOID, size_t authtypeOIDlen,
+                           const u_char * key, u_int keylen,
+                           const u_char * message, u_int msglen,
+                           const u_char * MAC, u_int maclen)
 #if defined(NETSNMP_USE_INTERNAL_MD5) || defined(NETSNMP_USE_OPENSSL) || defined(NETSNMP_USE_PKCS11) || defined(NETSNMP_USE_INTERNAL_CRYPTO)
 {
     int             rval = SNMPERR_SUCCESS, auth_type, auth_size;
@@ -1117,8 +1438,9 @@ sc_check_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
      * the result with the given MAC which may be shorter than
      * the full hash length.
      */
-    rval = sc_generate_keyed_hash(authtypeOID, authtypeOIDlen, key, keylen,
-                                  message, msglen, buf, &buf_len);
+    rval = sc_generate_keyed_hash_cached(cache, authtypeOID, authtypeOIDlen,
+                                         key, keylen, message, msglen,
+                                         buf, &buf_len);
     QUITFUN(rval, sc_check_keyed_hash_quit);
 
     if (maclen > msglen) {
@@ -1134,7 +1456,7 @@ sc_check_keyed_hash(const oid * authtypeOID, size_t authtypeOIDlen,
 
     return rval;
 
-}                               /* end sc_check_keyed_hash() */
+}                               /* end sc_check_keyed_hash_cached() */
 
 #else
 _SCAPI_NOT_CONFIGURED
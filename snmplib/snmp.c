@@ -461,4 +461,69 @@ snmp_realloc_rbuild_var_op(u_char ** pkt, size_t * pkt_len,
     return rc;
 }
 
+/*
+ * Returns the number of bytes snmp_realloc_rbuild_var_op() will use to
+ * encode the given variable binding, or 0 if it can not be computed in
+ * advance (the Opaque wrapped special types) or the encoding would fail.
+ */
+size_t
+snmp_rbuild_var_op_size(const oid * var_name, size_t var_name_len,
+                        u_char var_val_type,
+                        const u_char * var_val, size_t var_val_len)
+{
+    size_t          name_size, val_size;
+
+    switch (var_val_type) {
+    case ASN_INTEGER:
+        val_size = asn_rbuild_int_size((const long *) var_val, var_val_len);
+        break;
+
+    case ASN_GAUGE:
+    case ASN_COUNTER:
+    case ASN_TIMETICKS:
+    case ASN_UINTEGER:
+        val_size = asn_rbuild_unsigned_int_size((const u_long *) var_val,
+                                                var_val_len);
+        break;
+
+    case ASN_COUNTER64:
+        val_size = asn_rbuild_unsigned_int64_size(var_val_type,
+                                                  (const struct counter64 *)
+                                                  var_val, var_val_len);
+        break;
+
+    case ASN_OCTET_STR:
+    case ASN_IPADDRESS:
+    case ASN_OPAQUE:
+    case ASN_NSAP:
+    case ASN_BIT_STR:
+        val_size = asn_rbuild_header_size(var_val_len) + var_val_len;
+        break;
+
+    case ASN_OBJECT_ID:
+        val_size = asn_rbuild_objid_size((const oid *) var_val,
+                                         var_val_len / sizeof(oid));
+        break;
+
+    case ASN_NULL:
+    case SNMP_NOSUCHOBJECT:
+    case SNMP_NOSUCHINSTANCE:
+    case SNMP_ENDOFMIBVIEW:
+        val_size = 2;
+        break;
+
+    default:
+        return 0;
+    }
+    if (val_size == 0)
+        return 0;
+
+    name_size = asn_rbuild_objid_size(var_name, var_name_len);
+    if (name_size == 0)
+        return 0;
+
+    return asn_rbuild_header_size(name_size + val_size) + name_size +
+        val_size;
+}
+
 #endif                          /* NETSNMP_USE_REVERSE_ASNENCODING */
@@ -215,6 +215,9 @@ struct snmp_internal_session {
     size_t        obuf_size;    /* size of buffer for packet data */
     u_char       *opacket;      /* send packet data (within obuf) */
     size_t        opacket_len;  /* length of data */
+
+    u_char       *spare_obuf;      /* send buffer kept for the next packet */
+    size_t        spare_obuf_size; /* size of spare_obuf */
 };
 
 /*
@@ -320,6 +323,15 @@ static const char *secLevelName[] = {
  * use token in comments to individually protect these resources 
  */
 struct session_list *Sessions = NULL;   /* MT_LIB_SESSION */
+static unsigned int Sessions_generation = 0;    /* MT_LIB_SESSION */
+static unsigned int Sessions_timeouts = 0;      /* MT_LIB_SESSION */
+/*
+ * outstanding requests of all sessions, and the earliest expiry time
+ * among them while Requests_earliest_valid is set
+ */
+static unsigned int Requests_pending = 0;       /* MT_LIB_SESSION */
+static int      Requests_earliest_valid = 1;    /* MT_LIB_SESSION */
+static struct timeval Requests_earliest;        /* MT_LIB_SESSION */
 static long     Reqid = 0;      /* MT_LIB_REQUESTID */
 static long     Msgid = 0;      /* MT_LIB_MESSAGEID */
 static long     Sessid = 0;     /* MT_LIB_SESSIONID */
@@ -350,6 +362,8 @@ static int      snmp_resend_request(struct session_list *slp,
                                     int incr_retries);
 static void     register_default_handlers(void);
 static struct session_list *snmp_sess_copy(netsnmp_session * pss);
+static void     _requests_expiry_add(const struct timeval *expire);
+static void     _requests_expiry_drop(const struct timeval *expire);
 
 /*
  * return configured max message size for outgoing packets
@@ -818,6 +832,8 @@ register_default_handlers(void)
 		      NETSNMP_DS_LIBRARY_ID, NETSNMP_DS_LIB_CLIENTSENDBUF);
     netsnmp_ds_register_config(ASN_INTEGER, "snmp", "clientRecvBuf",
 		      NETSNMP_DS_LIBRARY_ID, NETSNMP_DS_LIB_CLIENTRECVBUF);
+    netsnmp_ds_register_config(ASN_INTEGER, "snmp", "udpBatchDepth",
+		      NETSNMP_DS_LIBRARY_ID, NETSNMP_DS_LIB_UDP_BATCH_DEPTH);
     netsnmp_ds_register_config(ASN_INTEGER, "snmp", "sendMessageMaxSize",
                                NETSNMP_DS_LIBRARY_ID,
                                NETSNMP_DS_LIB_MSG_SEND_MAX);
@@ -994,6 +1010,7 @@ void  snmp_session_insert(struct session_list *slp)
     snmp_res_lock(MT_LIBRARY_ID, MT_LIB_SESSION);
     slp->next = Sessions;
     Sessions = slp;
+    Sessions_generation++;
     snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_SESSION);
 }
 
@@ -1947,6 +1964,8 @@ snmp_sess_close(struct session_list *slp)
         netsnmp_request_list *rp, *orp;
 
         SNMP_FREE(isp->packet);
+        SNMP_FREE(isp->obuf);
+        SNMP_FREE(isp->spare_obuf);
 
         /*
          * Free each element in the input request list.  
@@ -1960,6 +1979,7 @@ snmp_sess_close(struct session_list *slp)
                               slp->session, orp->pdu->reqid,
                               orp->pdu, orp->cb_data);
             }
+            _requests_expiry_drop(&orp->expireM);
             snmp_free_pdu(orp->pdu);
             free((char *) orp);
         }
@@ -2022,6 +2042,8 @@ snmp_close(netsnmp_session * session)
                 oslp = slp;
             }
         }
+        if (slp != NULL)
+            Sessions_generation++;
         snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_SESSION);
     }                           /*END MTCRITICAL_RESOURCE */
     if (slp == NULL) {
@@ -2039,6 +2061,7 @@ snmp_close_sessions(void)
     while (Sessions) {
         slp = Sessions;
         Sessions = Sessions->next;
+        Sessions_generation++;
         snmp_sess_close(slp);
     }
     snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_SESSION);
@@ -3411,6 +3434,105 @@ snmp_pdu_build(netsnmp_pdu *pdu, u_char * cp, size_t * out_length)
 }
 
 #ifdef NETSNMP_USE_REVERSE_ASNENCODING
+/*
+ * Room reserved in front of the variable-bindings for the PDU header
+ * fields, so that they normally fit without growing the buffer again.
+ */
+#define PDU_HEADER_RESERVE 64
+
+/*
+ * varbind sizes kept on the stack; longer lists use a heap array
+ */
+#define VB_SIZES_LOCAL     64
+
+/*
+ * Encodes the variable-bindings of a PDU in list order.  The encoded size
+ * of every varbind is computed first, the buffer is grown once so that
+ * the whole list fits and each varbind is then written straight into
+ * its final position.  This avoids the repeated grow-and-move cycles of
+ * asn_realloc() and the re-walks of the list needed to emit it back to
+ * front.  The bytes produced are exactly those of the reverse encoder,
+ * which is used (with reallocation disabled) to fill each varbind's slot.
+ *
+ * Returns 1 on success.  Returns 0 if a varbind's size can not be known
+ * in advance or the buffer can not be grown; *offset is unchanged then
+ * and the caller has to fall back to the reverse encoder.
+ */
+static int
+_snmp_pdu_build_varbinds_forward(u_char ** pkt, size_t * pkt_len,
+                                 size_t * offset, netsnmp_pdu *pdu)
+{
+    netsnmp_variable_list *vp;
+    size_t          total = 0, size, pos, slot_end, slot_off;
+    size_t          sizes_local[VB_SIZES_LOCAL], *sizes = sizes_local, *p;
+    size_t          n = 0, max = VB_SIZES_LOCAL;
+    int             rc = 0;
+
+    for (vp = pdu->variables; vp; vp = vp->next_variable) {
+        if (ASN_PRIV_STOP == vp->type)
+            break;
+        size = snmp_rbuild_var_op_size(vp->name, vp->name_length, vp->type,
+                                       (u_char *) vp->val.string,
+                                       vp->val_len);
+        if (size == 0)
+            goto out;
+        if (n == max) {
+            p = (size_t *) malloc(2 * max * sizeof(size_t));
+            if (p == NULL)
+                goto out;
+            memcpy(p, sizes, n * sizeof(size_t));
+            if (sizes != sizes_local)
+                free(sizes);
+            sizes = p;
+            max *= 2;
+        }
+        sizes[n++] = size;
+        total += size;
+    }
+
+    if (*pkt_len - *offset < total + PDU_HEADER_RESERVE) {
+        size_t          new_len = *offset + total + PDU_HEADER_RESERVE;
+        u_char         *new_pkt = (u_char *) realloc(*pkt, new_len);
+
+        if (new_pkt == NULL)
+            goto out;
+        memmove(new_pkt + new_len - *offset, new_pkt + *pkt_len - *offset,
+                *offset);
+        *pkt = new_pkt;
+        *pkt_len = new_len;
+    }
+
+    pos = *pkt_len - *offset - total;
+    for (vp = pdu->variables, n = 0; vp; vp = vp->next_variable) {
+        if (ASN_PRIV_STOP == vp->type)
+            break;
+        size = sizes[n++];
+        slot_end = pos + size;
+        slot_off = 0;
+        DEBUGDUMPSECTION("send", "VarBind");
+        if (!snmp_realloc_rbuild_var_op(pkt, &slot_end, &slot_off, 0,
+                                        vp->name, &vp->name_length,
+                                        vp->type,
+                                        (u_char *) vp->val.string,
+                                        vp->val_len) || slot_off != size) {
+            DEBUGINDENTLESS();
+            DEBUGMSGTL(("snmp_pdu_realloc_rbuild",
+                        "varbind size mismatch, encoding backwards\n"));
+            goto out;
+        }
+        DEBUGINDENTLESS();
+        pos += size;
+    }
+    DEBUGINDENTLESS();
+
+    *offset += total;
+    rc = 1;
+  out:
+    if (sizes != sizes_local)
+        free(sizes);
+    return rc;
+}
+
 /*
  * On error, returns 0 (likely an encoding problem).  
  */
@@ -3427,6 +3549,9 @@ snmp_pdu_realloc_rbuild(u_char ** pkt, size_t * pkt_len, size_t * offset,
     int             i, wrapped = 0, notdone, final, rc = 0;
 
     DEBUGMSGTL(("snmp_pdu_realloc_rbuild", "starting\n"));
+    if (_snmp_pdu_build_varbinds_forward(pkt, pkt_len, offset, pdu))
+        goto build_header;
+
     for (vp = pdu->variables, i = VPCACHE_SIZE - 1; vp;
          vp = vp->next_variable, i--) {
         /*
@@ -3500,6 +3625,7 @@ snmp_pdu_realloc_rbuild(u_char ** pkt, size_t * pkt_len, size_t * offset,
         }
     } while (notdone);
 
+  build_header:
     /*
      * Save current location and build SEQUENCE tag and length placeholder for
      * variable-bindings sequence (actual length will be inserted later).  
@@ -4957,6 +5083,34 @@ netsnmp_build_packet(struct snmp_internal_session *isp, netsnmp_session *sp,
     return result;
 }
 
+/*
+ * largest send buffer a session keeps for its next packet
+ */
+#define SPARE_OBUF_MAX 4096
+
+/*
+ * Done with the packet in isp->obuf.  The buffer is kept as the session's
+ * spare send buffer, so that a session sending a stream of similar
+ * packets (e.g. an agent answering requests) does not allocate and grow
+ * a new buffer for each of them.  Larger buffers are freed, so that idle
+ * sessions (e.g. one per AgentX subagent) don't each hold on to one.
+ */
+static void
+_sess_release_obuf(struct snmp_internal_session *isp)
+{
+    if (isp->obuf) {
+        if (isp->spare_obuf == NULL && isp->obuf_size <= SPARE_OBUF_MAX) {
+            isp->spare_obuf = isp->obuf;
+            isp->spare_obuf_size = isp->obuf_size;
+        } else
+            free(isp->obuf);
+        isp->obuf = NULL;
+    }
+    isp->obuf_size = 0;
+    isp->opacket = NULL; /* opacket was in obuf, so no free needed */
+    isp->opacket_len = 0;
+}
+
 int
 _build_initial_pdu_packet(struct session_list *slp, netsnmp_pdu *pdu, int bulk)
 {
@@ -4984,7 +5138,7 @@ _build_initial_pdu_packet(struct session_list *slp, netsnmp_pdu *pdu, int bulk)
         return SNMPERR_GENERR;
     }
 
-    SNMP_FREE(isp->obuf); /* should already be NULL */
+    _sess_release_obuf(isp); /* should already be NULL */
 
     session->s_snmp_errno = 0;
     session->s_errno = 0;
@@ -5063,11 +5217,20 @@ _build_initial_pdu_packet(struct session_list *slp, netsnmp_pdu *pdu, int bulk)
     netsnmp_assert(pdu->msgMaxSize > 0);
 
     /*
-     * allocate initial packet buffer. Buffer will be grown as needed
+     * allocate initial packet buffer, reusing the one left over from the
+     * previous packet if there is one. Buffer will be grown as needed
      * while building the packet.
      */
-    pktbuf_len = SNMP_MIN_MAX_LEN;
-    if ((pktbuf = (u_char *)malloc(pktbuf_len)) == NULL) {
+    if (isp->spare_obuf) {
+        pktbuf = isp->spare_obuf;
+        pktbuf_len = isp->spare_obuf_size;
+        isp->spare_obuf = NULL;
+        isp->spare_obuf_size = 0;
+    } else {
+        pktbuf_len = SNMP_MIN_MAX_LEN;
+        pktbuf = (u_char *)malloc(pktbuf_len);
+    }
+    if (pktbuf == NULL) {
         DEBUGMSGTL(("sess_async_send",
                     "couldn't malloc initial packet buffer\n"));
         session->s_snmp_errno = SNMPERR_MALLOC;
@@ -5305,9 +5468,7 @@ _sess_async_send(struct session_list *slp,
                                     &(pdu->transport_data),
                                     &(pdu->transport_data_length));
 
-    SNMP_FREE(isp->obuf);
-    isp->opacket = NULL; /* opacket was in obuf, so no free needed */
-    isp->opacket_len = 0;
+    _sess_release_obuf(isp);
 
     if (result < 0) {
         session->s_snmp_errno = SNMPERR_BAD_SENDTO;
@@ -5377,6 +5538,7 @@ _sess_async_send(struct session_list *slp,
             isp->requests = rp;
             isp->requestsEnd = rp;
         }
+        _requests_expiry_add(&rp->expireM);
         snmp_res_unlock(MT_LIBRARY_ID, MT_LIB_SESSION);
     } else {
         /*
@@ -5628,6 +5790,31 @@ _sess_process_packet_parse_pdu(struct session_list *slp, netsnmp_session * sp,
   return pdu;
 }
 
+/*
+ * Keep track of the earliest request expiry time as requests are queued,
+ * resent and removed, so that snmp_sessions_earliest_request() only has
+ * to look at all the sessions after the earliest request went away.
+ */
+static void
+_requests_expiry_add(const struct timeval *expire)
+{
+    if (Requests_pending++ == 0) {
+        Requests_earliest = *expire;
+        Requests_earliest_valid = 1;
+    } else if (Requests_earliest_valid &&
+               timercmp(expire, &Requests_earliest, <))
+        Requests_earliest = *expire;
+}
+
+static void
+_requests_expiry_drop(const struct timeval *expire)
+{
+    if (Requests_pending > 0)
+        Requests_pending--;
+    if (!timercmp(expire, &Requests_earliest, >))
+        Requests_earliest_valid = 0;
+}
+
 /* Remove request @rp from session @isp. @orp is the request before @rp. */
 static void
 remove_request(struct snmp_internal_session *isp,
@@ -5639,6 +5826,7 @@ remove_request(struct snmp_internal_session *isp,
         isp->requests = rp->next_request;
     if (isp->requestsEnd == rp)
         isp->requestsEnd = orp;
+    _requests_expiry_drop(&rp->expireM);
     snmp_free_pdu(rp->pdu);
 }
 
@@ -6088,20 +6276,38 @@ _sess_read(struct session_list *slp, netsnmp_large_fd_set * fdset)
 
     if (!(transport->flags & NETSNMP_TRANSPORT_FLAG_STREAM)) {
         snmp_rcv_packet rcvp;
-        memset(&rcvp, 0x0, sizeof(rcvp));
 
-        /** read the packet */
-        rc = _sess_read_dgram_packet(slp, fdset, &rcvp);
-        if (-1 == rc) /* protocol error */
-            return -1;
-        else if (-2 == rc) /* no packet to process */
-            return 0;
+        /*
+         * Transports with f_flush may hand out several datagrams per
+         * wakeup (NETSNMP_TRANSPORT_FLAG_RECV_PENDING) and hold back the
+         * responses until they are flushed below.
+         */
+        if (transport->f_flush)
+            transport->flags |= NETSNMP_TRANSPORT_FLAG_DEFER_SEND;
+
+        do {
+            memset(&rcvp, 0x0, sizeof(rcvp));
+
+            /** read the packet */
+            rc = _sess_read_dgram_packet(slp, fdset, &rcvp);
+            if (-1 == rc) /* protocol error */
+                break;
+            else if (-2 == rc) { /* no packet to process */
+                rc = 0;
+                continue;
+            }
+
+            rc = _sess_process_packet(slp, sp, isp, transport,
+                                      rcvp.opaque, rcvp.olength,
+                                      rcvp.packet, rcvp.packet_len);
+            SNMP_FREE(rcvp.packet);
+            /** opaque is freed in _sess_process_packet */
+        } while (transport->flags & NETSNMP_TRANSPORT_FLAG_RECV_PENDING);
 
-        rc = _sess_process_packet(slp, sp, isp, transport,
-                                  rcvp.opaque, rcvp.olength,
-                                  rcvp.packet, rcvp.packet_len);
-        SNMP_FREE(rcvp.packet);
-        /** opaque is freed in _sess_process_packet */
+        if (transport->f_flush) {
+            transport->flags &= ~NETSNMP_TRANSPORT_FLAG_DEFER_SEND;
+            transport->f_flush(transport);
+        }
         return rc;
     }
 
@@ -6619,6 +6825,109 @@ snmp_sess_select_info2_flags(struct session_list *sessp, int *numfds,
     return active;
 }
 
+/**
+ * Returns a counter that changes whenever a session is added to or removed
+ * from the list of open sessions.  Event loops that keep their file
+ * descriptor registrations across iterations (see fd_event_epoll.c) use it
+ * to find out when they have to resynchronize with the session list.
+ */
+unsigned int
+snmp_sessions_generation(void)
+{
+    return Sessions_generation;
+}
+
+/**
+ * Returns a counter that changes whenever a request times out for good.
+ * The callbacks called for such a request may close the transport of
+ * their session (the AgentX master does), so event loops that keep their
+ * registrations check the session sockets again when it changes.
+ */
+unsigned int
+snmp_sessions_timeouts(void)
+{
+    return Sessions_timeouts;
+}
+
+/**
+ * Invoke a function for each open session that owns a socket.
+ *
+ * Sessions whose transport has been marked for deletion are closed on
+ * the way, as snmp_sess_select_info2_flags() does.
+ *
+ * @param fn   Called with the session, its socket and arg.
+ * @param arg  Passed unchanged to fn.
+ *
+ * @return Number of sessions passed to fn.
+ */
+int
+snmp_sessions_foreach_fd(void (*fn) (struct session_list *, int, void *),
+                         void *arg)
+{
+    struct session_list *slp, *next = NULL;
+    int             active = 0;
+
+    for (slp = Sessions; slp; slp = next) {
+        next = slp->next;
+
+        if (slp->transport == NULL)
+            continue;           /* close in progress */
+
+        if (slp->transport->sock == -1) {
+            DEBUGMSGTL(("sess_foreach", "delete session %p\n", slp));
+            snmp_close(slp->session);
+            continue;
+        }
+
+        (*fn) (slp, slp->transport->sock, arg);
+        active++;
+    }
+    return active;
+}
+
+/**
+ * Find the expiry time of the earliest outstanding request of all
+ * open sessions.
+ *
+ * @param[out] earliest  Monotonic time at which the first request times out.
+ *
+ * @return 1 if *earliest has been set, 0 if no request is outstanding.
+ */
+int
+snmp_sessions_earliest_request(struct timeval *earliest)
+{
+    struct session_list *slp;
+    netsnmp_request_list *rp;
+    int             found = 0;
+
+    if (Requests_pending == 0) {
+        Requests_earliest_valid = 1;
+        return 0;
+    }
+    if (Requests_earliest_valid) {
+        *earliest = Requests_earliest;
+        return 1;
+    }
+
+    for (slp = Sessions; slp; slp = slp->next) {
+        if (slp->internal == NULL)
+            continue;
+        for (rp = slp->internal->requests; rp; rp = rp->next_request) {
+            if (!timerisset(&rp->expireM))
+                continue;
+            if (!found || timercmp(&rp->expireM, earliest, <)) {
+                *earliest = rp->expireM;
+                found = 1;
+            }
+        }
+    }
+    if (found) {
+        Requests_earliest = *earliest;
+        Requests_earliest_valid = 1;
+    }
+    return found;
+}
+
 /*
  * snmp_timeout should be called whenever the timeout from snmp_select_info
  * expires, but it is idempotent, so snmp_timeout can be polled (probably a
@@ -6721,7 +7030,9 @@ snmp_resend_request(struct session_list *slp, netsnmp_request_list *orp,
         tv.tv_usec += rp->timeout;
         tv.tv_sec += tv.tv_usec / 1000000L;
         tv.tv_usec %= 1000000L;
+        _requests_expiry_drop(&rp->expireM);
         rp->expireM = tv;
+        _requests_expiry_add(&rp->expireM);
         if (rp->callback)
             rp->callback(NETSNMP_CALLBACK_OP_RESEND, sp,
                          rp->pdu->reqid, rp->pdu, rp->cb_data);
@@ -6787,6 +7098,7 @@ snmp_sess_timeout(struct session_list *slp)
                 /*
                  * No more chances, delete this entry 
                  */
+                Sessions_timeouts++;
                 if (callback) {
                     callback(NETSNMP_CALLBACK_OP_TIMED_OUT, sp,
                              rp->pdu->reqid, rp->pdu, magic);
@@ -6809,6 +7121,170 @@ snmp_sess_timeout(struct session_list *slp)
     }
 }
 
+/*
+ * Finding the first differing sub-identifier of two OIDs is the inner
+ * loop of all the OID compares below.  On x86 it is done 16 or 32 bytes
+ * at a time with SSE2 or AVX2 when the CPU has them (picked on first
+ * use); the byte compare masks give the first differing byte, and hence
+ * the first differing sub-identifier, for any size of oid.  Define
+ * NETSNMP_NO_SIMD_OID_COMPARE to build only the plain loop.
+ */
+#if !defined(NETSNMP_NO_SIMD_OID_COMPARE) && \
+    (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__GNUC__) && __GNUC__ >= 5) || defined(__clang__))
+#define NETSNMP_SIMD_OID_COMPARE 1
+#include <immintrin.h>
+#endif
+
+/*
+ * OIDs shorter than this are compared with the plain loop, since the
+ * vector code would mostly run its scalar tail anyway
+ */
+#define OID_MISMATCH_MIN_LEN    4
+
+typedef size_t (oid_mismatch_func)(const oid *, const oid *, size_t);
+
+/*
+ * returns the index of the first sub-identifier in which name1 and name2
+ * differ, or len if the first len sub-identifiers are equal.
+ */
+NETSNMP_STATIC_INLINE size_t
+_oid_mismatch_scalar(const oid * name1, const oid * name2, size_t len)
+{
+    size_t          i;
+
+    for (i = 0; i < len; i++)
+        if (name1[i] != name2[i])
+            break;
+    return i;
+}
+
+static size_t
+_oid_mismatch_plain(const oid * name1, const oid * name2, size_t len)
+{
+    return _oid_mismatch_scalar(name1, name2, len);
+}
+
+#ifdef NETSNMP_SIMD_OID_COMPARE
+__attribute__((target("sse2")))
+static size_t
+_oid_mismatch_sse2(const oid * name1, const oid * name2, size_t len)
+{
+    const size_t    step = sizeof(__m128i) / sizeof(oid);
+    size_t          i;
+    unsigned int    diff;
+
+    for (i = 0; i + step <= len; i += step) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(name1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(name2 + i));
+
+        diff = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xffff;
+        if (diff)
+            return i + __builtin_ctz(diff) / sizeof(oid);
+    }
+    return i + _oid_mismatch_scalar(name1 + i, name2 + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t
+_oid_mismatch_avx2(const oid * name1, const oid * name2, size_t len)
+{
+    const size_t    step = sizeof(__m256i) / sizeof(oid);
+    size_t          i;
+    unsigned int    diff;
+
+    for (i = 0; i + step <= len; i += step) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(name1 + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(name2 + i));
+
+        diff = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+        if (diff)
+            return i + __builtin_ctz(diff) / sizeof(oid);
+    }
+    /*
+     * not through the SSE2 version: mixing its legacy encoded
+     * instructions with the dirty upper halves here is slow
+     */
+    if (i + step / 2 <= len) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(name1 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(name2 + i));
+
+        diff = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) ^ 0xffff;
+        if (diff)
+            return i + __builtin_ctz(diff) / sizeof(oid);
+        i += step / 2;
+    }
+    return i + _oid_mismatch_scalar(name1 + i, name2 + i, len - i);
+}
+#endif /* NETSNMP_SIMD_OID_COMPARE */
+
+static const struct {
+    const char        *name;
+    oid_mismatch_func *func;
+} _oid_mismatch_impls[] = {
+#ifdef NETSNMP_SIMD_OID_COMPARE
+    { "avx2", _oid_mismatch_avx2 },
+    { "sse2", _oid_mismatch_sse2 },
+#endif
+    { "scalar", _oid_mismatch_plain },
+};
+
+static size_t   _oid_mismatch_init(const oid *, const oid *, size_t);
+static oid_mismatch_func *_oid_mismatch = _oid_mismatch_init;
+
+static int
+_oid_mismatch_supported(const char *name)
+{
+#ifdef NETSNMP_SIMD_OID_COMPARE
+    __builtin_cpu_init();
+    if (strcmp(name, "avx2") == 0)
+        return __builtin_cpu_supports("avx2");
+    if (strcmp(name, "sse2") == 0)
+        return __builtin_cpu_supports("sse2");
+#endif
+    return strcmp(name, "scalar") == 0;
+}
+
+/**
+ * Selects the code used to compare OIDs.
+ *
+ * @param impl "avx2", "sse2" or "scalar", or NULL for the fastest one the
+ *             CPU supports.
+ *
+ * @return the name of the implementation now in use, or NULL if impl is
+ *         not available (in which case nothing changes).
+ */
+const char *
+netsnmp_oid_compare_impl(const char *impl)
+{
+    size_t          i;
+
+    for (i = 0; i < sizeof(_oid_mismatch_impls) /
+             sizeof(_oid_mismatch_impls[0]); i++) {
+        if (impl && strcmp(impl, _oid_mismatch_impls[i].name) != 0)
+            continue;
+        if (!_oid_mismatch_supported(_oid_mismatch_impls[i].name))
+            continue;
+        _oid_mismatch = _oid_mismatch_impls[i].func;
+        DEBUGMSGTL(("snmp_oid_compare", "using %s\n",
+                    _oid_mismatch_impls[i].name));
+        return _oid_mismatch_impls[i].name;
+    }
+    return NULL;
+}
+
+static size_t
+_oid_mismatch_init(const oid * name1, const oid * name2, size_t len)
+{
+    netsnmp_oid_compare_impl(NULL);
+    return _oid_mismatch(name1, name2, len);
+}
+
+#define OID_MISMATCH(name1, name2, len)                         \
+    ((len) < OID_MISMATCH_MIN_LEN ?                             \
+     _oid_mismatch_scalar(name1, name2, len) :                  \
+     _oid_mismatch(name1, name2, len))
+
 /*
  * lexicographical compare two object identifiers.
  * * Returns -1 if name1 < name2,
@@ -6823,9 +7299,7 @@ snmp_oid_ncompare(const oid * in_name1,
                   size_t len1,
                   const oid * in_name2, size_t len2, size_t max_len)
 {
-    register int    len;
-    register const oid *name1 = in_name1;
-    register const oid *name2 = in_name2;
+    size_t          i;
     size_t          min_len;
 
     /*
@@ -6839,24 +7313,19 @@ snmp_oid_ncompare(const oid * in_name1,
     if (min_len > max_len)
         min_len = max_len;
 
-    len = min_len;
-
     /*
      * find first non-matching OID 
      */
-    while (len-- > 0) {
+    i = OID_MISMATCH(in_name1, in_name2, min_len);
+    if (i < min_len) {
         /*
          * these must be done in seperate comparisons, since
          * subtracting them and using that result has problems with
          * subids > 2^31. 
          */
-        if (*(name1) != *(name2)) {
-            if (*(name1) < *(name2))
-                return -1;
-            return 1;
-        }
-        name1++;
-        name2++;
+        if (in_name1[i] < in_name2[i])
+            return -1;
+        return 1;
     }
 
     if (min_len != max_len) {
@@ -6883,9 +7352,7 @@ int
 snmp_oid_compare(const oid * in_name1,
                  size_t len1, const oid * in_name2, size_t len2)
 {
-    register int    len;
-    register const oid *name1 = in_name1;
-    register const oid *name2 = in_name2;
+    size_t          len, i;
 
     /*
      * len = minimum of len1 and len2 
@@ -6897,19 +7364,16 @@ snmp_oid_compare(const oid * in_name1,
     /*
      * find first non-matching OID 
      */
-    while (len-- > 0) {
+    i = OID_MISMATCH(in_name1, in_name2, len);
+    if (i < len) {
         /*
          * these must be done in seperate comparisons, since
          * subtracting them and using that result has problems with
          * subids > 2^31. 
          */
-        if (*(name1) != *(name2)) {
-            if (*(name1) < *(name2))
-                return -1;
-            return 1;
-        }
-        name1++;
-        name2++;
+        if (in_name1[i] < in_name2[i])
+            return -1;
+        return 1;
     }
     /*
      * both OIDs equal up to length of shorter OID 
@@ -6933,40 +7397,35 @@ netsnmp_oid_compare_ll(const oid * in_name1,
                        size_t len1, const oid * in_name2, size_t len2,
                        size_t *offpt)
 {
-    register int    len;
-    register const oid *name1 = in_name1;
-    register const oid *name2 = in_name2;
-    int initlen;
+    size_t          len, i;
 
     /*
      * len = minimum of len1 and len2 
      */
     if (len1 < len2)
-        initlen = len = len1;
+        len = len1;
     else
-        initlen = len = len2;
+        len = len2;
     /*
      * find first non-matching OID 
      */
-    while (len-- > 0) {
+    i = OID_MISMATCH(in_name1, in_name2, len);
+    if (i < len) {
         /*
          * these must be done in seperate comparisons, since
          * subtracting them and using that result has problems with
          * subids > 2^31. 
          */
-        if (*(name1) != *(name2)) {
-            *offpt = initlen - len;
-            if (*(name1) < *(name2))
-                return -1;
-            return 1;
-        }
-        name1++;
-        name2++;
+        *offpt = i + 1;
+        if (in_name1[i] < in_name2[i])
+            return -1;
+        return 1;
     }
     /*
-     * both OIDs equal up to length of shorter OID 
+     * both OIDs equal up to length of shorter OID (one past it, as
+     * callers have always been told)
      */
-    *offpt = initlen - len;
+    *offpt = len + 1;
     if (len1 < len2)
         return -1;
     if (len2 < len1)
@@ -7013,10 +7472,6 @@ int
 netsnmp_oid_equals(const oid * in_name1,
                    size_t len1, const oid * in_name2, size_t len2)
 {
-    register const oid *name1 = in_name1;
-    register const oid *name2 = in_name2;
-    register int    len = len1;
-
     /*
      * len = minimum of len1 and len2 
      */
@@ -7027,20 +7482,13 @@ netsnmp_oid_equals(const oid * in_name1,
      */
     if (len1 == 0)
         return 0;   /* Two null OIDs are (trivially) the same */
-    if (!name1 || !name2)
+    if (!in_name1 || !in_name2)
         return 1;   /* Otherwise something's wrong, so report a non-match */
     /*
      * find first non-matching OID 
      */
-    while (len-- > 0) {
-        /*
-         * these must be done in seperate comparisons, since
-         * subtracting them and using that result has problems with
-         * subids > 2^31. 
-         */
-        if (*(name1++) != *(name2++))
-            return 1;
-    }
+    if (OID_MISMATCH(in_name1, in_name2, len1) != len1)
+        return 1;
     return 0;
 }
 
@@ -96,6 +96,7 @@ struct usmStateReference {
     u_char         *usr_priv_key;
     size_t          usr_priv_key_length;
     u_int           usr_sec_level;
+    struct sc_hmac_cache_s *usr_hmac_cache;
 };
 
 oid    usmNoAuthProtocol[10] = { NETSNMP_USMAUTH_BASE_OID,
@@ -229,6 +230,24 @@ static struct usmUser *noNameUser = NULL;
  */
 static struct usmUser *userList = NULL;
 
+/*
+ * Hashed index over userList, keyed on (engineID, name), so that the
+ * lookup done for every incoming message doesn't have to walk the whole
+ * list.  There is at most one user per key in the list, since
+ * usm_add_user_to_list() replaces duplicates.  If the index can't be
+ * allocated, it is rebuilt on the next lookup and the list is searched
+ * until then.
+ */
+#define USM_USER_HASH_SIZE 1024
+
+struct usm_user_hash {
+    struct usmUser       *user;
+    struct usm_user_hash *next;
+};
+
+static struct usm_user_hash **userHash = NULL;
+static int      userHashValid = 0;
+
 /*
  * Set a given field of the secStateRef.
  *
@@ -320,6 +339,7 @@ usm_free_usmStateReference(void *old)
     SNMP_FREE(ref->usr_engine_id);
     SNMP_FREE(ref->usr_auth_protocol);
     SNMP_FREE(ref->usr_priv_protocol);
+    sc_hmac_cache_free(&ref->usr_hmac_cache);
 
     if (ref->usr_auth_key_length && ref->usr_auth_key) {
         SNMP_ZERO(ref->usr_auth_key, ref->usr_auth_key_length);
@@ -422,6 +442,8 @@ usm_clone_usmStateReference(struct usmStateReference *from, struct usmStateRefer
         *to = NULL;
         return -1;
     }
+    cloned_usmStateRef->usr_hmac_cache =
+        sc_hmac_cache_ref(&from->usr_hmac_cache);
 
     return 0;
 
@@ -463,15 +485,141 @@ emergency_print(u_char * field, u_int length)
 }                               /* end emergency_print() */
 #endif                          /* NETSNMP_ENABLE_TESTING_CODE */
 
+static u_int
+usm_user_hash_key(const u_char * engineID, size_t engineIDLen,
+                  const char *name)
+{
+    u_int           h = 2166136261U;
+    size_t          i;
+
+    for (i = 0; engineID && i < engineIDLen; i++)
+        h = (h ^ engineID[i]) * 16777619U;
+    h = (h ^ (engineID ? 1 : 0)) * 16777619U;
+    for (; *name; name++)
+        h = (h ^ (u_char) *name) * 16777619U;
+    return h % USM_USER_HASH_SIZE;
+}
+
+/*
+ * returns 1 if user has the given engineID and name
+ */
+static int
+usm_user_matches(const struct usmUser *user, const u_char * engineID,
+                 size_t engineIDLen, const char *name)
+{
+    return user->name && !strcmp(user->name, name) &&
+        user->engineIDLen == engineIDLen &&
+        ((user->engineID == NULL && engineID == NULL) ||
+         (user->engineID != NULL && engineID != NULL &&
+          memcmp(user->engineID, engineID, engineIDLen) == 0));
+}
+
+static void
+usm_user_hash_clear(void)
+{
+    struct usm_user_hash *hp, *next;
+    int             i;
+
+    if (userHash) {
+        for (i = 0; i < USM_USER_HASH_SIZE; i++)
+            for (hp = userHash[i]; hp; hp = next) {
+                next = hp->next;
+                free(hp);
+            }
+        free(userHash);
+        userHash = NULL;
+    }
+    userHashValid = 0;
+}
+
+static struct usm_user_hash **
+usm_user_hash_find(const u_char * engineID, size_t engineIDLen,
+                   const char *name)
+{
+    struct usm_user_hash **hpp;
+
+    hpp = &userHash[usm_user_hash_key(engineID, engineIDLen, name)];
+    for (; *hpp; hpp = &(*hpp)->next)
+        if (usm_user_matches((*hpp)->user, engineID, engineIDLen, name))
+            break;
+    return hpp;
+}
+
+/*
+ * enters user into the index, replacing any user with the same key
+ */
+static void
+usm_user_hash_add(struct usmUser *user)
+{
+    struct usm_user_hash **hpp;
+
+    if (!userHashValid || user->name == NULL)
+        return;
+    hpp = usm_user_hash_find(user->engineID, user->engineIDLen, user->name);
+    if (*hpp == NULL) {
+        *hpp = (struct usm_user_hash *) calloc(1, sizeof(**hpp));
+        if (*hpp == NULL) {
+            usm_user_hash_clear();
+            return;
+        }
+    }
+    (*hpp)->user = user;
+}
+
+static void
+usm_user_hash_remove(struct usmUser *user)
+{
+    struct usm_user_hash **hpp, *hp;
+
+    if (!userHashValid || user->name == NULL)
+        return;
+    hpp = usm_user_hash_find(user->engineID, user->engineIDLen, user->name);
+    if ((hp = *hpp) != NULL && hp->user == user) {
+        *hpp = hp->next;
+        free(hp);
+    }
+}
+
+/*
+ * (re)builds the index if necessary; returns 1 if it can be used
+ */
+static int
+usm_user_hash_ready(void)
+{
+    struct usmUser *ptr;
+
+    if (userHashValid)
+        return 1;
+    userHash = (struct usm_user_hash **)
+        calloc(USM_USER_HASH_SIZE, sizeof(*userHash));
+    if (userHash == NULL)
+        return 0;
+    userHashValid = 1;
+    for (ptr = userList; ptr != NULL && userHashValid; ptr = ptr->next)
+        usm_user_hash_add(ptr);
+    return userHashValid;
+}
+
 static struct usmUser *
 usm_get_user_from_list(u_char * engineID, size_t engineIDLen,
                        char *name, struct usmUser *puserList,
                        int use_default)
 {
     struct usmUser *ptr;
+    struct usm_user_hash *hp;
     char            noName[] = "";
     if (name == NULL)
         name = noName;
+    if (puserList != NULL && puserList == userList &&
+        usm_user_hash_ready()) {
+        hp = *usm_user_hash_find(engineID, engineIDLen, name);
+        if (hp != NULL) {
+            DEBUGMSGTL(("usm", "match on user %s\n", hp->user->name));
+            return hp->user;
+        }
+        return (use_default && !*name) ? noNameUser : NULL;
+    }
+
     for (ptr = puserList; ptr != NULL; ptr = ptr->next) {
         if (ptr->name && !strcmp(ptr->name, name)) {
           DEBUGMSGTL(("usm", "match on user %s\n", ptr->name));
@@ -623,6 +771,11 @@ struct usmUser *
 usm_add_user(struct usmUser *user)
 {
     struct usmUser *uptr;
+
+    /*
+     * done first, since a user with the same key is freed by the list code
+     */
+    usm_user_hash_add(user);
     uptr = usm_add_user_to_list(user, userList);
     if (uptr != NULL)
         userList = uptr;
@@ -650,6 +803,9 @@ usm_remove_usmUser_from_list(struct usmUser *user, struct usmUser **ppuserList)
     if (*ppuserList == NULL)
         return SNMPERR_USM_UNKNOWNSECURITYNAME;
 
+    if (ppuserList == &userList)
+        usm_user_hash_remove(user);
+
     /*
      * find the user in the list
      */
@@ -729,6 +885,9 @@ usm_free_user(struct usmUser *user)
     if (user == NULL)
         return NULL;
 
+    usm_user_hash_remove(user);
+    sc_hmac_cache_free(&user->authHmacCache);
+
     SNMP_FREE(user->engineID);
     SNMP_FREE(user->name);
     SNMP_FREE(user->secName);
@@ -1344,6 +1503,7 @@ usm_generate_out_msg(int msgProcModel,  /* (UNUSED) */
     u_int           theEngineIDLength = 0;
     u_char         *theAuthKey = NULL;
     u_int           theAuthKeyLength = 0;
+    sc_hmac_cache **theHmacCache = NULL;
     const oid      *theAuthProtocol = NULL;
     u_int           theAuthProtocolLength = 0;
     u_char         *thePrivKey = NULL;
@@ -1377,6 +1537,7 @@ usm_generate_out_msg(int msgProcModel,  /* (UNUSED) */
         theAuthProtocolLength = ref->usr_auth_protocol_length;
         theAuthKey = ref->usr_auth_key;
         theAuthKeyLength = ref->usr_auth_key_length;
+        theHmacCache = &ref->usr_hmac_cache;
         thePrivProtocol = ref->usr_priv_protocol;
         thePrivProtocolLength = ref->usr_priv_protocol_length;
         thePrivKey = ref->usr_priv_key;
@@ -1406,6 +1567,7 @@ usm_generate_out_msg(int msgProcModel,  /* (UNUSED) */
         theSecLevel = secLevel;
         theEngineIDLength = secEngineIDLen;
         if (user) {
+            theHmacCache = &user->authHmacCache;
             theAuthProtocol = user->authProtocol;
             theAuthProtocolLength = user->authProtocolLen;
             theAuthKey = user->authKey;
@@ -1715,9 +1877,12 @@ usm_generate_out_msg(int msgProcModel,  /* (UNUSED) */
             return SNMPERR_USM_GENERICERROR;
         }
 
-        if (sc_generate_keyed_hash(theAuthProtocol, theAuthProtocolLength,
-                                   theAuthKey, theAuthKeyLength,
-                                   ptr, ptr_len, temp_sig, &temp_sig_len)
+        if (sc_generate_keyed_hash_cached(theHmacCache,
+                                          theAuthProtocol,
+                                          theAuthProtocolLength,
+                                          theAuthKey, theAuthKeyLength,
+                                          ptr, ptr_len,
+                                          temp_sig, &temp_sig_len)
             != SNMP_ERR_NOERROR) {
             /*
              * FIX temp_sig_len defined?!
@@ -1836,6 +2001,7 @@ usm_rgenerate_out_msg(int msgProcModel, /* (UNUSED) */
     u_int           theEngineIDLength = 0;
     u_char         *theAuthKey = NULL;
     u_int           theAuthKeyLength = 0;
+    sc_hmac_cache **theHmacCache = NULL;
     const oid      *theAuthProtocol = NULL;
     u_int           theAuthProtocolLength = 0;
     u_char         *thePrivKey = NULL;
@@ -1874,6 +2040,7 @@ usm_rgenerate_out_msg(int msgProcModel, /* (UNUSED) */
         theAuthProtocolLength = ref->usr_auth_protocol_length;
         theAuthKey = ref->usr_auth_key;
         theAuthKeyLength = ref->usr_auth_key_length;
+        theHmacCache = &ref->usr_hmac_cache;
         thePrivProtocol = ref->usr_priv_protocol;
         thePrivProtocolLength = ref->usr_priv_protocol_length;
         thePrivKey = ref->usr_priv_key;
@@ -1903,6 +2070,7 @@ usm_rgenerate_out_msg(int msgProcModel, /* (UNUSED) */
         theSecLevel = secLevel;
         theEngineIDLength = secEngineIDLen;
         if (user) {
+            theHmacCache = &user->authHmacCache;
             theAuthProtocol = user->authProtocol;
             theAuthProtocolLength = user->authProtocolLen;
             theAuthKey = user->authKey;
@@ -2236,10 +2404,12 @@ usm_rgenerate_out_msg(int msgProcModel, /* (UNUSED) */
             return SNMPERR_USM_GENERICERROR;
         }
 
-        if (sc_generate_keyed_hash(theAuthProtocol, theAuthProtocolLength,
-                                   theAuthKey, theAuthKeyLength,
-                                   proto_msg, proto_msg_len,
-                                   temp_sig, &temp_sig_len)
+        if (sc_generate_keyed_hash_cached(theHmacCache,
+                                          theAuthProtocol,
+                                          theAuthProtocolLength,
+                                          theAuthKey, theAuthKeyLength,
+                                          proto_msg, proto_msg_len,
+                                          temp_sig, &temp_sig_len)
             != SNMP_ERR_NOERROR) {
             SNMP_FREE(temp_sig);
             DEBUGMSGTL(("usm", "Signing failed.\n"));
@@ -2971,10 +3141,12 @@ usm_process_in_msg(int msgProcModel,    /* (UNUSED) */
      */
     if (secLevel == SNMP_SEC_LEVEL_AUTHNOPRIV
         || secLevel == SNMP_SEC_LEVEL_AUTHPRIV) {
-        if (sc_check_keyed_hash(user->authProtocol, user->authProtocolLen,
-                                user->authKey, user->authKeyLen,
-                                wholeMsg, wholeMsgLen,
-                                signature, signature_length)
+        if (sc_check_keyed_hash_cached(&user->authHmacCache,
+                                       user->authProtocol,
+                                       user->authProtocolLen,
+                                       user->authKey, user->authKeyLen,
+                                       wholeMsg, wholeMsgLen,
+                                       signature, signature_length)
             != SNMP_ERR_NOERROR) {
             DEBUGMSGTL(("usm", "Verification failed.\n"));
             snmp_increment_statistic(STAT_USMSTATSWRONGDIGESTS);
@@ -3012,6 +3184,8 @@ usm_process_in_msg(int msgProcModel,    /* (UNUSED) */
         error = SNMPERR_USM_GENERICERROR;
         goto err;
     }
+    /* lets the response be signed without looking up the user again */
+    (*secStateRef)->usr_hmac_cache = sc_hmac_cache_ref(&user->authHmacCache);
 
     if (usm_set_usmStateReference_priv_protocol(*secStateRef,
                                                 user->privProtocol,
@@ -3782,6 +3956,7 @@ clear_user_list(void)
 {
     struct usmUser *tmp = userList, *next = NULL;
 
+    usm_user_hash_clear();
     while (tmp != NULL) {
 	next = tmp->next;
 	usm_free_user(tmp);
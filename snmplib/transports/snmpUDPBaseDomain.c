@@ -133,6 +133,40 @@ static LPFN_WSARECVMSG pfWSARecvMsg;
 static LPFN_WSASENDMSG pfWSASendMsg;
 #endif
 
+#if !defined(WIN32)
+/*
+ * Fill in the destination (local) address and the interface index of a
+ * received datagram from its control messages.
+ */
+static void
+_udpbase_recv_dstaddr(struct msghdr *msg, struct sockaddr *dstip,
+                      int *if_index)
+{
+    struct cmsghdr *cm;
+
+    for (cm = CMSG_FIRSTHDR(msg); cm != NULL; cm = CMSG_NXTHDR(msg, cm)) {
+#if defined(HAVE_IP_PKTINFO)
+        if (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_PKTINFO) {
+            struct in_pktinfo* src = (struct in_pktinfo *)CMSG_DATA(cm);
+            netsnmp_assert(dstip->sa_family == AF_INET);
+            ((struct sockaddr_in*)dstip)->sin_addr = src->ipi_addr;
+            *if_index = src->ipi_ifindex;
+            DEBUGMSGTL(("udpbase:recv",
+                        "got destination (local) addr %s, iface %d\n",
+                        inet_ntoa(src->ipi_addr), *if_index));
+        }
+#elif defined(HAVE_IP_RECVDSTADDR)
+        if (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVDSTADDR) {
+            struct in_addr* src = (struct in_addr *)CMSG_DATA(cm);
+            ((struct sockaddr_in*)dstip)->sin_addr = *src;
+            DEBUGMSGTL(("netsnmp_udp", "got destination (local) addr %s\n",
+                        inet_ntoa(*src)));
+        }
+#endif
+    }
+}
+#endif /* !defined(WIN32) */
+
 int
 netsnmp_udpbase_recvfrom(int s, void *buf, int len, struct sockaddr *from,
                          socklen_t *fromlen, struct sockaddr *dstip,
@@ -142,7 +176,6 @@ netsnmp_udpbase_recvfrom(int s, void *buf, int len, struct sockaddr *from,
 #if !defined(WIN32)
     struct iovec iov;
     char cmsg[CMSG_SPACE(cmsg_data_size)];
-    struct cmsghdr *cm;
     struct msghdr msg;
 
     iov.iov_base = buf;
@@ -198,26 +231,7 @@ netsnmp_udpbase_recvfrom(int s, void *buf, int len, struct sockaddr *from,
     }
 
 #if !defined(WIN32)
-    for (cm = CMSG_FIRSTHDR(&msg); cm != NULL; cm = CMSG_NXTHDR(&msg, cm)) {
-#if defined(HAVE_IP_PKTINFO)
-        if (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_PKTINFO) {
-            struct in_pktinfo* src = (struct in_pktinfo *)CMSG_DATA(cm);
-            netsnmp_assert(dstip->sa_family == AF_INET);
-            ((struct sockaddr_in*)dstip)->sin_addr = src->ipi_addr;
-            *if_index = src->ipi_ifindex;
-            DEBUGMSGTL(("udpbase:recv",
-                        "got destination (local) addr %s, iface %d\n",
-                        inet_ntoa(src->ipi_addr), *if_index));
-        }
-#elif defined(HAVE_IP_RECVDSTADDR)
-        if (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_RECVDSTADDR) {
-            struct in_addr* src = (struct in_addr *)CMSG_DATA(cm);
-            ((struct sockaddr_in*)dstip)->sin_addr = *src;
-            DEBUGMSGTL(("netsnmp_udp", "got destination (local) addr %s\n",
-                        inet_ntoa(*src)));
-        }
-#endif
-    }
+    _udpbase_recv_dstaddr(&msg, dstip, if_index);
 #else /* !defined(WIN32) */
     for (cm = WSA_CMSG_FIRSTHDR(&msg); cm; cm = WSA_CMSG_NXTHDR(&msg, cm)) {
         if (cm->cmsg_level == IPPROTO_IP && cm->cmsg_type == IP_PKTINFO) {
@@ -418,6 +432,380 @@ int netsnmp_udpbase_sendto(int fd, const struct in_addr *srcip, int if_index,
 }
 #endif /* HAVE_IP_PKTINFO || HAVE_IP_RECVDSTADDR */
 
+#if defined(HAVE_RECVMMSG) && defined(HAVE_SENDMMSG) && \
+    defined(HAVE_IP_PKTINFO) && !defined(WIN32)
+#define netsnmp_udpbase_batching_defined
+
+/*
+ * Batched datagram I/O (udpBatchDepth).
+ *
+ * A server transport with f_flush set receives up to udpBatchDepth
+ * datagrams with one recvmmsg() call.  They are handed out one at a time
+ * by netsnmp_udpbase_batch_recv(), which sets
+ * NETSNMP_TRANSPORT_FLAG_RECV_PENDING while more are buffered so that
+ * _sess_read() keeps reading until the batch is empty.  _sess_read() also
+ * sets NETSNMP_TRANSPORT_FLAG_DEFER_SEND meanwhile; the responses are then
+ * queued by netsnmp_udpbase_batch_send() and sent with one sendmmsg()
+ * call from netsnmp_udpbase_flush().
+ *
+ * The buffers are kept per socket and released by netsnmp_udpbase_close().
+ */
+#define UDPBASE_BATCH_MAX       256
+#define UDPBASE_BATCH_SLOT      SNMP_MAX_RCV_MSG_SIZE
+#define UDPBASE_BATCH_CMSG      CMSG_SPACE(sizeof(struct in_pktinfo))
+
+typedef struct udpbase_batch_tx_s {
+    void                    *data;
+    int                      len;
+    netsnmp_sockaddr_storage to;
+    socklen_t                tolen;
+    struct in_addr           srcip;
+    int                      if_index;
+} udpbase_batch_tx;
+
+typedef struct udpbase_batch_s {
+    int                       sock;
+    int                       depth;
+    int                       rx_count;
+    int                       rx_next;
+    int                       tx_count;
+    int                       tx_disabled;
+    struct mmsghdr           *msgs;     /* depth for rx, then depth for tx */
+    struct iovec             *iov;
+    char                     *cmsg;
+    netsnmp_sockaddr_storage *from;
+    u_char                   *rx_buf;
+    udpbase_batch_tx         *tx;
+    netsnmp_sockaddr_storage  local;    /* getsockname() of sock */
+    socklen_t                 local_len;
+    struct udpbase_batch_s   *next;
+} udpbase_batch;
+
+static udpbase_batch *udpbase_batches = NULL;
+
+static void
+_udpbase_batch_free(udpbase_batch *b)
+{
+    int             i;
+
+    for (i = 0; i < b->tx_count; i++)
+        free(b->tx[i].data);
+    free(b->msgs);
+    free(b->iov);
+    free(b->cmsg);
+    free(b->from);
+    free(b->rx_buf);
+    free(b->tx);
+    free(b);
+}
+
+/*
+ * Returns the batch state of a server transport, allocating it on first
+ * use, or NULL if the transport is not batched.
+ */
+static udpbase_batch *
+_udpbase_batch_get(netsnmp_transport *t)
+{
+    udpbase_batch  *b;
+    int             depth;
+
+    if (NULL == t || t->sock < 0 || NULL == t->f_flush)
+        return NULL;
+
+    for (b = udpbase_batches; b; b = b->next)
+        if (b->sock == t->sock)
+            return b;
+
+    depth = netsnmp_ds_get_int(NETSNMP_DS_LIBRARY_ID,
+                               NETSNMP_DS_LIB_UDP_BATCH_DEPTH);
+    if (depth < 2)
+        return NULL;
+    if (depth > UDPBASE_BATCH_MAX)
+        depth = UDPBASE_BATCH_MAX;
+
+    b = SNMP_MALLOC_TYPEDEF(udpbase_batch);
+    if (NULL == b)
+        return NULL;
+    b->sock = t->sock;
+    b->depth = depth;
+    b->msgs = calloc(2 * depth, sizeof(*b->msgs));
+    b->iov = calloc(2 * depth, sizeof(*b->iov));
+    b->cmsg = calloc(2 * depth, UDPBASE_BATCH_CMSG);
+    b->from = calloc(depth, sizeof(*b->from));
+    b->rx_buf = malloc((size_t)depth * UDPBASE_BATCH_SLOT);
+    b->tx = calloc(depth, sizeof(*b->tx));
+    if (!b->msgs || !b->iov || !b->cmsg || !b->from || !b->rx_buf || !b->tx) {
+        _udpbase_batch_free(b);
+        return NULL;
+    }
+
+    b->local_len = sizeof(b->local);
+    if (getsockname(t->sock, &b->local.sa, &b->local_len) < 0)
+        b->local_len = 0;
+
+#ifdef HAVE_SO_BINDTODEVICE
+    {
+        /*
+         * netsnmp_udpbase_sendto() avoids IP_PKTINFO on sockets that are
+         * bound to a device (VRF); keep sending one datagram at a time there.
+         */
+        char            iface[IFNAMSIZ];
+        socklen_t       ifacelen = IFNAMSIZ;
+
+        if (getsockopt(t->sock, SOL_SOCKET, SO_BINDTODEVICE, iface,
+                       &ifacelen) == 0 && ifacelen > 0)
+            b->tx_disabled = 1;
+    }
+#endif /* HAVE_SO_BINDTODEVICE */
+
+    DEBUGMSGTL(("udpbase:batch", "fd %d: batch depth %d\n", b->sock, depth));
+    b->next = udpbase_batches;
+    udpbase_batches = b;
+    return b;
+}
+
+int
+netsnmp_udpbase_batch_recv(netsnmp_transport *t, void *buf, int size,
+                           struct sockaddr *from, socklen_t *fromlen,
+                           struct sockaddr *dstip, socklen_t *dstlen,
+                           int *if_index)
+{
+    udpbase_batch  *b = _udpbase_batch_get(t);
+    struct mmsghdr *m;
+    int             i, n, len;
+
+    if (NULL == b)
+        return -2;
+
+    if (b->rx_next >= b->rx_count) {
+        b->rx_count = b->rx_next = 0;
+        for (i = 0; i < b->depth; i++) {
+            m = &b->msgs[i];
+            memset(m, 0, sizeof(*m));
+            b->iov[i].iov_base = b->rx_buf + (size_t)i * UDPBASE_BATCH_SLOT;
+            b->iov[i].iov_len = UDPBASE_BATCH_SLOT;
+            m->msg_hdr.msg_name = &b->from[i];
+            m->msg_hdr.msg_namelen = sizeof(b->from[i]);
+            m->msg_hdr.msg_iov = &b->iov[i];
+            m->msg_hdr.msg_iovlen = 1;
+            m->msg_hdr.msg_control = b->cmsg + i * UDPBASE_BATCH_CMSG;
+            m->msg_hdr.msg_controllen = UDPBASE_BATCH_CMSG;
+        }
+        n = recvmmsg(b->sock, b->msgs, b->depth, MSG_DONTWAIT, NULL);
+        if (n <= 0) {
+            t->flags &= ~NETSNMP_TRANSPORT_FLAG_RECV_PENDING;
+            if (n == 0)
+                errno = EAGAIN;
+            return -1;
+        }
+        DEBUGMSGTL(("udpbase:batch", "recvmmsg fd %d got %d datagrams\n",
+                    b->sock, n));
+        b->rx_count = n;
+    }
+
+    m = &b->msgs[b->rx_next++];
+    if (b->rx_next < b->rx_count)
+        t->flags |= NETSNMP_TRANSPORT_FLAG_RECV_PENDING;
+    else
+        t->flags &= ~NETSNMP_TRANSPORT_FLAG_RECV_PENDING;
+
+    len = m->msg_len;
+    if (len > size || (m->msg_hdr.msg_flags & MSG_TRUNC)) {
+        DEBUGMSGTL(("udpbase:batch", "fd %d: datagram truncated\n", b->sock));
+        if (len > size)
+            len = size;
+    }
+    memcpy(buf, m->msg_hdr.msg_iov->iov_base, len);
+
+    if (*fromlen > m->msg_hdr.msg_namelen)
+        *fromlen = m->msg_hdr.msg_namelen;
+    memcpy(from, m->msg_hdr.msg_name, *fromlen);
+
+    if (dstip != NULL) {
+        if (*dstlen > b->local_len)
+            *dstlen = b->local_len;
+        memcpy(dstip, &b->local, *dstlen);
+        _udpbase_recv_dstaddr(&m->msg_hdr, dstip, if_index);
+    }
+    return len;
+}
+
+int
+netsnmp_udpbase_batch_send(netsnmp_transport *t, const struct in_addr *srcip,
+                           int if_index, const struct sockaddr *to,
+                           socklen_t tolen, const void *data, int len)
+{
+    udpbase_batch    *b;
+    udpbase_batch_tx *tx;
+
+    if (NULL == t || !(t->flags & NETSNMP_TRANSPORT_FLAG_DEFER_SEND))
+        return -2;
+    b = _udpbase_batch_get(t);
+    if (NULL == b || b->tx_disabled || tolen > sizeof(tx->to))
+        return -2;
+
+    if (b->tx_count >= b->depth)
+        netsnmp_udpbase_flush(t);
+
+    tx = &b->tx[b->tx_count];
+    tx->data = netsnmp_memdup(data, len);
+    if (NULL == tx->data)
+        return -2;
+    tx->len = len;
+    memcpy(&tx->to, to, tolen);
+    tx->tolen = tolen;
+    tx->srcip.s_addr = srcip ? srcip->s_addr : INADDR_ANY;
+    tx->if_index = if_index;
+    b->tx_count++;
+    return len;
+}
+
+int
+netsnmp_udpbase_flush(netsnmp_transport *t)
+{
+    udpbase_batch  *b;
+    struct mmsghdr *msgs;
+    int             i, n, rc, sent = 0, dropped = 0;
+
+    if (NULL == t || t->sock < 0)
+        return 0;
+    for (b = udpbase_batches; b; b = b->next)
+        if (b->sock == t->sock)
+            break;
+    if (NULL == b || 0 == b->tx_count)
+        return 0;
+
+    msgs = b->msgs + b->depth;
+    for (i = 0; i < b->tx_count; i++) {
+        udpbase_batch_tx *tx = &b->tx[i];
+        struct msghdr    *mh = &msgs[i].msg_hdr;
+        struct iovec     *iov = &b->iov[b->depth + i];
+
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        iov->iov_base = tx->data;
+        iov->iov_len = tx->len;
+        mh->msg_name = &tx->to;
+        mh->msg_namelen = tx->tolen;
+        mh->msg_iov = iov;
+        mh->msg_iovlen = 1;
+        if (tx->srcip.s_addr != INADDR_ANY) {
+            char              *cmsg = b->cmsg + (b->depth + i) *
+                                          UDPBASE_BATCH_CMSG;
+            struct cmsghdr    *cm;
+            struct in_pktinfo  ipi;
+
+            memset(cmsg, 0, UDPBASE_BATCH_CMSG);
+            mh->msg_control = cmsg;
+            mh->msg_controllen = UDPBASE_BATCH_CMSG;
+            cm = CMSG_FIRSTHDR(mh);
+            cm->cmsg_len = CMSG_LEN(sizeof(ipi));
+            cm->cmsg_level = SOL_IP;
+            cm->cmsg_type = IP_PKTINFO;
+            memset(&ipi, 0, sizeof(ipi));
+#ifdef HAVE_STRUCT_IN_PKTINFO_IPI_SPEC_DST
+            ipi.ipi_spec_dst.s_addr = tx->srcip.s_addr;
+#endif
+            memcpy(CMSG_DATA(cm), &ipi, sizeof(ipi));
+        }
+    }
+
+    while (sent < b->tx_count) {
+        udpbase_batch_tx *tx;
+
+        n = sendmmsg(b->sock, msgs + sent, b->tx_count - sent, MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n > 0) {
+            sent += n;
+            continue;
+        }
+        /*
+         * The datagram at msgs[sent] failed.  Send it on its own the way
+         * the transport's f_send would have, so that the retries of
+         * netsnmp_udpbase_sendto() (e.g. for a broadcast source address)
+         * apply, and carry on with the rest.
+         */
+        DEBUGMSGTL(("udpbase:batch", "sendmmsg fd %d failed at %d: %s\n",
+                    b->sock, sent, strerror(errno)));
+        tx = &b->tx[sent];
+        do {
+            if (tx->to.sa.sa_family == AF_INET)
+                rc = netsnmp_udpbase_sendto(b->sock, &tx->srcip,
+                                            tx->if_index, &tx->to.sa,
+                                            tx->data, tx->len);
+            else
+                rc = sendto(b->sock, tx->data, tx->len, 0, &tx->to.sa,
+                            tx->tolen);
+        } while (rc < 0 && errno == EINTR);
+        if (rc < 0) {
+            DEBUGMSGTL(("udpbase:batch", "fd %d: dropped datagram %d: %s\n",
+                        b->sock, sent, strerror(errno)));
+            dropped++;
+        }
+        sent++;
+    }
+    if (dropped)
+        snmp_log(LOG_WARNING, "udp: could not send %d of %d responses\n",
+                 dropped, b->tx_count);
+    DEBUGMSGTL(("udpbase:batch", "sendmmsg fd %d sent %d datagrams\n",
+                b->sock, b->tx_count - dropped));
+
+    for (i = 0; i < b->tx_count; i++)
+        SNMP_FREE(b->tx[i].data);
+    b->tx_count = 0;
+    return sent - dropped;
+}
+
+int
+netsnmp_udpbase_close(netsnmp_transport *t)
+{
+    udpbase_batch **prevNext, *b;
+
+    if (t != NULL && t->sock >= 0) {
+        for (prevNext = &udpbase_batches; (b = *prevNext) != NULL;
+             prevNext = &b->next) {
+            if (b->sock == t->sock) {
+                *prevNext = b->next;
+                _udpbase_batch_free(b);
+                break;
+            }
+        }
+    }
+    return netsnmp_socketbase_close(t);
+}
+#endif /* HAVE_RECVMMSG && HAVE_SENDMMSG && HAVE_IP_PKTINFO && !WIN32 */
+
+#ifndef netsnmp_udpbase_batching_defined
+int
+netsnmp_udpbase_batch_recv(netsnmp_transport *t, void *buf, int size,
+                           struct sockaddr *from, socklen_t *fromlen,
+                           struct sockaddr *dstip, socklen_t *dstlen,
+                           int *if_index)
+{
+    return -2;
+}
+
+int
+netsnmp_udpbase_batch_send(netsnmp_transport *t, const struct in_addr *srcip,
+                           int if_index, const struct sockaddr *to,
+                           socklen_t tolen, const void *data, int len)
+{
+    return -2;
+}
+
+int
+netsnmp_udpbase_flush(netsnmp_transport *t)
+{
+    return 0;
+}
+
+int
+netsnmp_udpbase_close(netsnmp_transport *t)
+{
+    return netsnmp_socketbase_close(t);
+}
+#endif /* !netsnmp_udpbase_batching_defined */
+
 /*
  * You can write something into opaque that will subsequently get passed back 
  * to your send function if you like.  For instance, you might want to
@@ -443,14 +831,23 @@ netsnmp_udpbase_recv(netsnmp_transport *t, void *buf, int size,
             from = &addr_pair->remote_addr.sa;
 
 	while (rc < 0) {
-#ifdef netsnmp_udpbase_recvfrom_sendto_defined
             socklen_t local_addr_len = sizeof(addr_pair->local_addr);
-            rc = netsnmp_udp_recvfrom(t->sock, buf, size, from, &fromlen,
-                                      &addr_pair->local_addr.sa,
-                                      &local_addr_len, &(addr_pair->if_index));
+
+            rc = netsnmp_udpbase_batch_recv(t, buf, size, from, &fromlen,
+                                            &addr_pair->local_addr.sa,
+                                            &local_addr_len,
+                                            &addr_pair->if_index);
+            if (rc == -2) {
+#ifdef netsnmp_udpbase_recvfrom_sendto_defined
+                rc = netsnmp_udp_recvfrom(t->sock, buf, size, from, &fromlen,
+                                          &addr_pair->local_addr.sa,
+                                          &local_addr_len,
+                                          &(addr_pair->if_index));
 #else
-            rc = recvfrom(t->sock, buf, size, MSG_DONTWAIT, from, &fromlen);
+                rc = recvfrom(t->sock, buf, size, MSG_DONTWAIT, from,
+                              &fromlen);
 #endif /* netsnmp_udpbase_recvfrom_sendto_defined */
+            }
 	    if (rc < 0 && errno != EINTR) {
 		break;
 	    }
@@ -512,6 +909,12 @@ netsnmp_udpbase_send(netsnmp_transport *t, const void *buf, int size,
                         size, buf, str, t->sock));
             free(str);
         }
+        rc = netsnmp_udpbase_batch_send(t,
+                    addr_pair ? &(addr_pair->local_addr.sin.sin_addr) : NULL,
+                    addr_pair ? addr_pair->if_index : 0, to,
+                    sizeof(struct sockaddr_in), buf, size);
+        if (rc == -2)
+            rc = -1;
 	while (rc < 0) {
 #ifdef netsnmp_udpbase_recvfrom_sendto_defined
             rc = netsnmp_udp_sendto(t->sock,
@@ -121,7 +121,7 @@ int netsnmp_udp_sendto(int fd, const struct in_addr *srcip, int if_index,
  */
 
 static netsnmp_transport *
-netsnmp_udp_transport_base(netsnmp_transport *t)
+netsnmp_udp_transport_base(netsnmp_transport *t, int local)
 {
     if (NULL == t) {
         return NULL;
@@ -141,10 +141,12 @@ netsnmp_udp_transport_base(netsnmp_transport *t)
     t->msgMaxSize = 0xffff - 8 - 20;
     t->f_recv     = netsnmp_udpbase_recv;
     t->f_send     = netsnmp_udpbase_send;
-    t->f_close    = netsnmp_socketbase_close;
+    t->f_close    = netsnmp_udpbase_close;
     t->f_accept   = NULL;
     t->f_fmtaddr  = netsnmp_udp_fmtaddr;
     t->f_get_taddr = netsnmp_ipv4_get_taddr;
+    if (local)
+        t->f_flush = netsnmp_udpbase_flush;
 
     return t;
 }
@@ -161,7 +163,7 @@ netsnmp_udp_transport(const struct netsnmp_ep *ep, int local)
 
     t = netsnmp_udpipv4base_transport(ep, local);
     if (NULL != t) {
-        netsnmp_udp_transport_base(t);
+        netsnmp_udp_transport_base(t, local);
     }
     return t;
 }
@@ -181,7 +183,7 @@ netsnmp_udp_transport_with_source(const struct netsnmp_ep *ep, int local,
 
     t = netsnmp_udpipv4base_transport_with_source(ep, local, src_addr);
     if (NULL != t) {
-        netsnmp_udp_transport_base(t);
+        netsnmp_udp_transport_base(t, local);
     }
     return t;
 }
@@ -619,7 +621,7 @@ netsnmp_udp_create_tspec(netsnmp_tdomain_spec *tspec)
 {
     netsnmp_transport *t = netsnmp_udpipv4base_tspec_transport(tspec);
     if (NULL != t) {
-        netsnmp_udp_transport_base(t);
+        netsnmp_udp_transport_base(t, tspec->flags & NETSNMP_TSPEC_LOCAL);
     }
     return t;
 
@@ -111,7 +111,10 @@ netsnmp_udp6_recv(netsnmp_transport *t, void *buf, int size,
         }
 
 	while (rc < 0) {
-	  rc = recvfrom(t->sock, buf, size, 0, from, &fromlen);
+	  rc = netsnmp_udpbase_batch_recv(t, buf, size, from, &fromlen,
+                                          NULL, NULL, NULL);
+	  if (rc == -2)
+	      rc = recvfrom(t->sock, buf, size, 0, from, &fromlen);
 	  if (rc < 0 && errno != EINTR) {
 	    break;
 	  }
@@ -162,6 +165,10 @@ netsnmp_udp6_send(netsnmp_transport *t, const void *buf, int size,
                         size, buf, str, t->sock));
             free(str);
         }
+	rc = netsnmp_udpbase_batch_send(t, NULL, 0, to,
+                                        sizeof(struct sockaddr_in6), buf, size);
+	if (rc == -2)
+	    rc = -1;
 	while (rc < 0) {
 	    rc = sendto(t->sock, buf, size, 0, to,sizeof(struct sockaddr_in6));
 	    if (rc < 0 && errno != EINTR) {
@@ -250,7 +257,9 @@ netsnmp_udp6_transport_init(const struct netsnmp_ep *ep, int flags)
     t->msgMaxSize = 0xffff - 8 - 40;
     t->f_recv     = netsnmp_udp6_recv;
     t->f_send     = netsnmp_udp6_send;
-    t->f_close    = netsnmp_socketbase_close;
+    t->f_close    = netsnmp_udpbase_close;
+    if (local)
+        t->f_flush = netsnmp_udpbase_flush;
     t->f_accept   = NULL;
     t->f_fmtaddr  = netsnmp_udp6_fmtaddr;
     t->f_get_taddr = netsnmp_ipv6_get_taddr;
@@ -75,6 +75,441 @@ static struct vacm_groupEntry *groupList = NULL, *groupScanPtr = NULL;
 #define VIEW_MASK(viewPtr, idx, mask) \
     ((idx >= viewPtr->viewMaskLen) ? mask : (viewPtr->viewMask[idx] & mask))
 
+/*
+ * Hashed indexes over viewList, groupList and accessList.
+ *
+ * The lists are kept sorted, so the entries sharing a key form one
+ * contiguous run and an index node only has to point at the first entry
+ * of its run.  Views are indexed by name, groups by (securityModel,
+ * securityName) and access entries by group name; the other access
+ * fields need prefix and range matches (RFC 3415 section 4) and are
+ * checked against the entries of the group's run.
+ *
+ * An index that can't be allocated is dropped and rebuilt by the next
+ * lookup, which searches the whole list if that fails again.
+ */
+#define VACM_HASH_SIZE 1024
+
+struct vacm_view_compiled;
+
+struct vacm_index_node {
+    void                      *first;
+    struct vacm_index_node    *next;
+    struct vacm_view_compiled *view;    /* views only */
+};
+
+struct vacm_index {
+    struct vacm_index_node **bucket;
+    int             valid;
+    u_int           (*hash)(const void *entry);
+    int             (*same)(const void *a, const void *b);
+    void           *(*next)(const void *entry);
+};
+
+/*
+ * The compiled form of a view's run, for VACM_MODE_FIND lookups.  The
+ * entries without wildcards in their mask are found with a binary search
+ * per subtree length (the run is sorted by length, then subtree); the
+ * others are checked one by one.  pos is the position in the run, which
+ * decides between entries with identical subtrees.
+ */
+struct vacm_view_ref {
+    struct vacm_viewEntry *vp;
+    int             pos;
+};
+
+struct vacm_view_len {
+    size_t          len;
+    int             start;
+};
+
+struct vacm_view_compiled {
+    struct vacm_view_ref *exact;
+    int             nexact;
+    struct vacm_view_len *lens;
+    int             nlens;
+    struct vacm_view_ref *masked;
+    int             nmasked;
+};
+
+static u_int
+_vacm_hash_bytes(u_int h, const void *data, size_t len)
+{
+    const u_char   *cp = (const u_char *) data;
+
+    while (len--)
+        h = (h ^ *cp++) * 16777619U;
+    return h;
+}
+
+static u_int
+_vacm_view_hash(const void *entry)
+{
+    const struct vacm_viewEntry *vp = (const struct vacm_viewEntry *) entry;
+
+    return _vacm_hash_bytes(2166136261U, vp->viewName,
+                            (u_char) vp->viewName[0] + 1);
+}
+
+static int
+_vacm_view_same(const void *a, const void *b)
+{
+    const struct vacm_viewEntry *va = (const struct vacm_viewEntry *) a;
+    const struct vacm_viewEntry *vb = (const struct vacm_viewEntry *) b;
+
+    return !memcmp(va->viewName, vb->viewName, (u_char) va->viewName[0] + 1);
+}
+
+static void *
+_vacm_view_next(const void *entry)
+{
+    return ((const struct vacm_viewEntry *) entry)->next;
+}
+
+static u_int
+_vacm_group_hash(const void *entry)
+{
+    const struct vacm_groupEntry *gp = (const struct vacm_groupEntry *) entry;
+
+    return _vacm_hash_bytes(2166136261U ^ (u_int) gp->securityModel,
+                            gp->securityName,
+                            (u_char) gp->securityName[0] + 1);
+}
+
+static int
+_vacm_group_same(const void *a, const void *b)
+{
+    const struct vacm_groupEntry *ga = (const struct vacm_groupEntry *) a;
+    const struct vacm_groupEntry *gb = (const struct vacm_groupEntry *) b;
+
+    return ga->securityModel == gb->securityModel &&
+        !memcmp(ga->securityName, gb->securityName,
+                (u_char) ga->securityName[0] + 1);
+}
+
+static void *
+_vacm_group_next(const void *entry)
+{
+    return ((const struct vacm_groupEntry *) entry)->next;
+}
+
+static u_int
+_vacm_access_hash(const void *entry)
+{
+    const struct vacm_accessEntry *ap = (const struct vacm_accessEntry *) entry;
+
+    return _vacm_hash_bytes(2166136261U, ap->groupName,
+                            (u_char) ap->groupName[0] + 1);
+}
+
+static int
+_vacm_access_same(const void *a, const void *b)
+{
+    const struct vacm_accessEntry *aa = (const struct vacm_accessEntry *) a;
+    const struct vacm_accessEntry *ab = (const struct vacm_accessEntry *) b;
+
+    return !memcmp(aa->groupName, ab->groupName,
+                   (u_char) aa->groupName[0] + 1);
+}
+
+static void *
+_vacm_access_next(const void *entry)
+{
+    return ((const struct vacm_accessEntry *) entry)->next;
+}
+
+static struct vacm_index viewIndex = {
+    NULL, 0, _vacm_view_hash, _vacm_view_same, _vacm_view_next
+};
+static struct vacm_index groupIndex = {
+    NULL, 0, _vacm_group_hash, _vacm_group_same, _vacm_group_next
+};
+static struct vacm_index accessIndex = {
+    NULL, 0, _vacm_access_hash, _vacm_access_same, _vacm_access_next
+};
+
+static void
+_vacm_index_clear(struct vacm_index *idx)
+{
+    struct vacm_index_node *np, *next;
+    int             i;
+
+    if (idx->bucket) {
+        for (i = 0; i < VACM_HASH_SIZE; i++)
+            for (np = idx->bucket[i]; np; np = next) {
+                next = np->next;
+                free(np->view);
+                free(np);
+            }
+        free(idx->bucket);
+        idx->bucket = NULL;
+    }
+    idx->valid = 0;
+}
+
+/*
+ * returns the slot holding the node for the key of entry
+ */
+static struct vacm_index_node **
+_vacm_index_slot(struct vacm_index *idx, const void *entry)
+{
+    struct vacm_index_node **npp;
+
+    npp = &idx->bucket[idx->hash(entry) % VACM_HASH_SIZE];
+    while (*npp && !idx->same((*npp)->first, entry))
+        npp = &(*npp)->next;
+    return npp;
+}
+
+/*
+ * (re)builds the index for the list starting at head if necessary;
+ * returns 1 if it can be used
+ */
+static int
+_vacm_index_ready(struct vacm_index *idx, void *head)
+{
+    struct vacm_index_node **npp;
+    void           *entry, *prev = NULL;
+
+    if (idx->valid)
+        return 1;
+    idx->bucket = (struct vacm_index_node **)
+        calloc(VACM_HASH_SIZE, sizeof(*idx->bucket));
+    if (idx->bucket == NULL)
+        return 0;
+    for (entry = head; entry; prev = entry, entry = idx->next(entry)) {
+        if (prev && idx->same(prev, entry))
+            continue;
+        npp = _vacm_index_slot(idx, entry);
+        if (*npp == NULL &&
+            (*npp = (struct vacm_index_node *)
+             calloc(1, sizeof(**npp))) == NULL) {
+            _vacm_index_clear(idx);
+            return 0;
+        }
+        (*npp)->first = entry;
+    }
+    idx->valid = 1;
+    return 1;
+}
+
+/*
+ * returns the first entry with the key of entry, or NULL
+ */
+static struct vacm_index_node *
+_vacm_index_find(struct vacm_index *idx, const void *entry)
+{
+    return *_vacm_index_slot(idx, entry);
+}
+
+/*
+ * updates the index after entry has been linked into its list
+ */
+static void
+_vacm_index_insert(struct vacm_index *idx, void *entry)
+{
+    struct vacm_index_node **npp;
+
+    if (!idx->valid)
+        return;
+    npp = _vacm_index_slot(idx, entry);
+    if (*npp == NULL) {
+        *npp = (struct vacm_index_node *) calloc(1, sizeof(**npp));
+        if (*npp == NULL) {
+            _vacm_index_clear(idx);
+            return;
+        }
+        (*npp)->first = entry;
+        return;
+    }
+    if ((*npp)->first == idx->next(entry))
+        (*npp)->first = entry;
+    SNMP_FREE((*npp)->view);
+}
+
+/*
+ * updates the index after entry has been unlinked from its list (its
+ * next pointer must still be intact)
+ */
+static void
+_vacm_index_remove(struct vacm_index *idx, void *entry)
+{
+    struct vacm_index_node **npp, *np;
+    void           *next;
+
+    if (!idx->valid)
+        return;
+    npp = _vacm_index_slot(idx, entry);
+    if ((np = *npp) == NULL)
+        return;
+    SNMP_FREE(np->view);
+    if (np->first != entry)
+        return;
+    next = idx->next(entry);
+    if (next && idx->same(next, entry)) {
+        np->first = next;
+    } else {
+        *npp = np->next;
+        free(np);
+    }
+}
+
+/*
+ * returns 1 if the OID prefix given by subtree and mode matches vp
+ */
+static int
+_vacm_view_match(struct vacm_viewEntry *vp, oid * viewSubtree,
+                 size_t viewSubtreeLen, int mode)
+{
+    int             mask = 0x80;
+    unsigned int    oidpos, maskpos = 0;
+
+    if (viewSubtreeLen < (vp->viewSubtreeLen - 1))
+        return 0;
+    for (oidpos = 0; oidpos < vp->viewSubtreeLen - 1; oidpos++) {
+        if (mode==VACM_MODE_IGNORE_MASK || (VIEW_MASK(vp, maskpos, mask) != 0)) {
+            if (viewSubtree[oidpos] !=
+                vp->viewSubtree[oidpos + 1])
+                return 0;
+        }
+        if (mask == 1) {
+            mask = 0x80;
+            maskpos++;
+        } else
+            mask >>= 1;
+    }
+    return 1;
+}
+
+/*
+ * returns 1 if vp is longer than vpret or (equal and lexicographically
+ * greater)
+ */
+static int
+_vacm_view_better(struct vacm_viewEntry *vp, struct vacm_viewEntry *vpret)
+{
+    return vpret == NULL
+        || vp->viewSubtreeLen > vpret->viewSubtreeLen
+        || (vp->viewSubtreeLen == vpret->viewSubtreeLen
+            && snmp_oid_compare(vp->viewSubtree + 1,
+                                vp->viewSubtreeLen - 1,
+                                vpret->viewSubtree + 1,
+                                vpret->viewSubtreeLen - 1) > 0);
+}
+
+/*
+ * returns 1 if the mask of vp has no wildcards within its subtree
+ */
+static int
+_vacm_view_exact(struct vacm_viewEntry *vp)
+{
+    size_t          i;
+
+    for (i = 0; i + 1 < vp->viewSubtreeLen; i++)
+        if (VIEW_MASK(vp, i / 8, (0x80 >> (i % 8))) == 0)
+            return 0;
+    return 1;
+}
+
+static struct vacm_view_compiled *
+_vacm_view_compile(struct vacm_index_node *np)
+{
+    struct vacm_view_compiled *cv;
+    struct vacm_viewEntry *vp;
+    int             n = 0;
+
+    for (vp = (struct vacm_viewEntry *) np->first;
+         vp && _vacm_view_same(vp, np->first); vp = vp->next)
+        n++;
+    cv = (struct vacm_view_compiled *)
+        calloc(1, sizeof(*cv) + n * (2 * sizeof(struct vacm_view_ref) +
+                                     sizeof(struct vacm_view_len)));
+    if (cv == NULL)
+        return NULL;
+    cv->exact = (struct vacm_view_ref *) (cv + 1);
+    cv->masked = cv->exact + n;
+    cv->lens = (struct vacm_view_len *) (cv->masked + n);
+
+    for (n = 0, vp = (struct vacm_viewEntry *) np->first;
+         vp && _vacm_view_same(vp, np->first); vp = vp->next, n++) {
+        if (!_vacm_view_exact(vp)) {
+            cv->masked[cv->nmasked].vp = vp;
+            cv->masked[cv->nmasked++].pos = n;
+            continue;
+        }
+        if (cv->nlens == 0 ||
+            cv->lens[cv->nlens - 1].len != vp->viewSubtreeLen - 1) {
+            cv->lens[cv->nlens].len = vp->viewSubtreeLen - 1;
+            cv->lens[cv->nlens++].start = cv->nexact;
+        }
+        cv->exact[cv->nexact].vp = vp;
+        cv->exact[cv->nexact++].pos = n;
+    }
+    return cv;
+}
+
+/*
+ * VACM_MODE_FIND lookup in the compiled form of a view.  Returns 0 if
+ * the compiled form is not available, or is found to be out of date.
+ */
+static int
+_vacm_view_find(struct vacm_index_node *np, oid * viewSubtree,
+                size_t viewSubtreeLen, struct vacm_viewEntry **found)
+{
+    struct vacm_view_compiled *cv;
+    struct vacm_view_ref *best = NULL, *ref;
+    int             i, lo, hi, mid, end;
+    size_t          len;
+
+    if (np->view == NULL && (np->view = _vacm_view_compile(np)) == NULL)
+        return 0;
+    cv = np->view;
+
+    /*
+     * the longest exact entry covering the OID
+     */
+    for (i = cv->nlens - 1; i >= 0 && best == NULL; i--) {
+        len = cv->lens[i].len;
+        if (len > viewSubtreeLen)
+            continue;
+        lo = cv->lens[i].start;
+        end = hi = i + 1 < cv->nlens ? cv->lens[i + 1].start : cv->nexact;
+        while (lo < hi) {
+            mid = (lo + hi) / 2;
+            if (snmp_oid_compare(cv->exact[mid].vp->viewSubtree + 1, len,
+                                 viewSubtree, len) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < end &&
+            snmp_oid_compare(cv->exact[lo].vp->viewSubtree + 1, len,
+                             viewSubtree, len) == 0)
+            best = &cv->exact[lo];
+    }
+    if (best && !_vacm_view_exact(best->vp)) {
+        /*
+         * the mask was changed without vacm_viewEntryChanged()
+         */
+        SNMP_FREE(np->view);
+        return 0;
+    }
+
+    for (i = 0; i < cv->nmasked; i++) {
+        ref = &cv->masked[i];
+        if (!_vacm_view_match(ref->vp, viewSubtree, viewSubtreeLen,
+                              VACM_MODE_FIND))
+            continue;
+        if (best == NULL || _vacm_view_better(ref->vp, best->vp) ||
+            (ref->pos < best->pos &&
+             !_vacm_view_better(best->vp, ref->vp)))
+            best = ref;
+    }
+
+    *found = best ? best->vp : NULL;
+    return 1;
+}
+
 /**
  * Initilizes the VACM code.
  * Specifically:
@@ -202,6 +637,7 @@ vacm_parse_config_view(const char *token, const char *line)
     vptr->viewMaskLen = sizeof(vptr->viewMask);
     line =
         read_config_read_octet_string(line, &viewMask, &vptr->viewMaskLen);
+    vacm_viewEntryChanged(vptr);
 }
 
 /*
@@ -432,13 +868,27 @@ vacm_parse_config_group(const char *token, const char *line)
         read_config_read_octet_string(line, (u_char **) & groupName, &len);
 }
 
+/*
+ * returns the index node of the view with the given (length prefixed)
+ * name, or NULL
+ */
+static struct vacm_index_node *
+_vacm_view_node(const char *view)
+{
+    struct vacm_viewEntry key;
+
+    memcpy(key.viewName, view, (u_char) view[0] + 1);
+    return _vacm_index_find(&viewIndex, &key);
+}
+
 struct vacm_viewEntry *
 netsnmp_view_get(struct vacm_viewEntry *head, const char *viewName,
                   oid * viewSubtree, size_t viewSubtreeLen, int mode)
 {
     struct vacm_viewEntry *vp, *vpret = NULL;
+    struct vacm_index_node *np;
     char            view[VACMSTRINGLEN];
-    int             found, glen;
+    int             glen, run = 0;
     int count=0;
 
     glen = (int) strlen(viewName);
@@ -446,47 +896,31 @@ netsnmp_view_get(struct vacm_viewEntry *head, const char *viewName,
         return NULL;
     view[0] = glen;
     strlcpy(view + 1, viewName, sizeof(view) - 1);
+    if (head && head == viewList && _vacm_index_ready(&viewIndex, viewList)) {
+        np = _vacm_view_node(view);
+        if (np && mode == VACM_MODE_FIND &&
+            _vacm_view_find(np, viewSubtree, viewSubtreeLen, &vpret)) {
+            DEBUGMSGTL(("vacm:getView", ", %s\n", (vpret) ? "found" : "none"));
+            return vpret;
+        }
+        head = np ? (struct vacm_viewEntry *) np->first : NULL;
+        run = 1;
+    }
     for (vp = head; vp; vp = vp->next) {
+        if (run && memcmp(view, vp->viewName, glen + 1))
+            break;
         if (!memcmp(view, vp->viewName, glen + 1)
-            && viewSubtreeLen >= (vp->viewSubtreeLen - 1)) {
-            int             mask = 0x80;
-            unsigned int    oidpos, maskpos = 0;
-            found = 1;
-
-            for (oidpos = 0;
-                 found && oidpos < vp->viewSubtreeLen - 1;
-                 oidpos++) {
-                if (mode==VACM_MODE_IGNORE_MASK || (VIEW_MASK(vp, maskpos, mask) != 0)) {
-                    if (viewSubtree[oidpos] !=
-                        vp->viewSubtree[oidpos + 1])
-                        found = 0;
-                }
-                if (mask == 1) {
-                    mask = 0x80;
-                    maskpos++;
-                } else
-                    mask >>= 1;
-            }
-
-            if (found) {
-                /*
-                 * match successful, keep this node if its longer than
-                 * the previous or (equal and lexicographically greater
-                 * than the previous). 
-                 */
-                count++;
-                if (mode == VACM_MODE_CHECK_SUBTREE) {
-                    vpret = vp;
-                } else if (vpret == NULL
-                           || vp->viewSubtreeLen > vpret->viewSubtreeLen
-                           || (vp->viewSubtreeLen == vpret->viewSubtreeLen
-                               && snmp_oid_compare(vp->viewSubtree + 1,
-                                                   vp->viewSubtreeLen - 1,
-                                                   vpret->viewSubtree + 1,
-                                                   vpret->viewSubtreeLen - 1) >
-                               0)) {
-                    vpret = vp;
-                }
+            && _vacm_view_match(vp, viewSubtree, viewSubtreeLen, mode)) {
+            /*
+             * match successful, keep this node if its longer than
+             * the previous or (equal and lexicographically greater
+             * than the previous). 
+             */
+            count++;
+            if (mode == VACM_MODE_CHECK_SUBTREE) {
+                vpret = vp;
+            } else if (_vacm_view_better(vp, vpret)) {
+                vpret = vp;
             }
         }
     }
@@ -512,8 +946,9 @@ int
 netsnmp_view_exists(struct vacm_viewEntry *head, const char *viewName)
 {
     struct vacm_viewEntry *vp;
+    struct vacm_index_node *np;
     char                   view[VACMSTRINGLEN];
-    int                    len, count = 0;
+    int                    len, count = 0, run = 0;
 
     len = (int) strlen(viewName);
     if (len < 0 || len > VACM_MAX_STRING)
@@ -521,9 +956,16 @@ netsnmp_view_exists(struct vacm_viewEntry *head, const char *viewName)
     view[0] = len;
     strcpy(view + 1, viewName);
     DEBUGMSGTL(("9:vacm:view_exists", "checking %s\n", viewName));
+    if (head && head == viewList && _vacm_index_ready(&viewIndex, viewList)) {
+        np = _vacm_view_node(view);
+        head = np ? (struct vacm_viewEntry *) np->first : NULL;
+        run = 1;
+    }
     for (vp = head; vp; vp = vp->next) {
         if (memcmp(view, vp->viewName, len + 1) == 0)
             ++count;
+        else if (run)
+            break;
     }
 
     return count;
@@ -553,8 +995,9 @@ netsnmp_view_subtree_check(struct vacm_viewEntry *head, const char *viewName,
                            oid * viewSubtree, size_t viewSubtreeLen)
 {
     struct vacm_viewEntry *vp, *vpShorter = NULL, *vpLonger = NULL;
+    struct vacm_index_node *np;
     char            view[VACMSTRINGLEN];
-    int             found, glen;
+    int             found, glen, run = 0;
 
     glen = (int) strlen(viewName);
     if (glen < 0 || glen > VACM_MAX_STRING)
@@ -562,7 +1005,14 @@ netsnmp_view_subtree_check(struct vacm_viewEntry *head, const char *viewName,
     view[0] = glen;
     strlcpy(view + 1, viewName, sizeof(view) - 1);
     DEBUGMSGTL(("9:vacm:checkSubtree", "view %s\n", viewName));
+    if (head && head == viewList && _vacm_index_ready(&viewIndex, viewList)) {
+        np = _vacm_view_node(view);
+        head = np ? (struct vacm_viewEntry *) np->first : NULL;
+        run = 1;
+    }
     for (vp = head; vp; vp = vp->next) {
+        if (run && memcmp(view, vp->viewName, glen + 1))
+            break;
         if (!memcmp(view, vp->viewName, glen + 1)) {
             /*
              * If the subtree defined in the view is shorter than or equal
@@ -749,9 +1199,27 @@ netsnmp_view_create(struct vacm_viewEntry **head, const char *viewName,
         op->next = vp;
     else
         *head = vp;
+    if (head == &viewList)
+        _vacm_index_insert(&viewIndex, vp);
     return vp;
 }
 
+/*
+ * Must be called after the mask of an entry in the global view list has
+ * been changed, so that the compiled form of its view is rebuilt.
+ */
+void
+vacm_viewEntryChanged(struct vacm_viewEntry *vp)
+{
+    struct vacm_index_node *np;
+
+    if (vp == NULL || !viewIndex.valid)
+        return;
+    np = _vacm_index_find(&viewIndex, vp);
+    if (np)
+        SNMP_FREE(np->view);
+}
+
 void
 netsnmp_view_destroy(struct vacm_viewEntry **head, const char *viewName,
                       oid * viewSubtree, size_t viewSubtreeLen)
@@ -777,6 +1245,8 @@ netsnmp_view_destroy(struct vacm_viewEntry **head, const char *viewName,
             return;
         lastvp->next = vp->next;
     }
+    if (head == &viewList)
+        _vacm_index_remove(&viewIndex, vp);
     if (vp->reserved)
         free(vp->reserved);
     free(vp);
@@ -787,6 +1257,8 @@ void
 netsnmp_view_clear(struct vacm_viewEntry **head)
 {
     struct vacm_viewEntry *vp;
+    if (head == &viewList)
+        _vacm_index_clear(&viewIndex);
     while ((vp = (*head))) {
         (*head) = vp->next;
         if (vp->reserved)
@@ -798,7 +1270,8 @@ netsnmp_view_clear(struct vacm_viewEntry **head)
 struct vacm_groupEntry *
 vacm_getGroupEntry(int securityModel, const char *securityName)
 {
-    struct vacm_groupEntry *vp;
+    struct vacm_groupEntry *vp, key;
+    struct vacm_index_node *np;
     char            secname[VACMSTRINGLEN];
     int             glen;
 
@@ -808,6 +1281,21 @@ vacm_getGroupEntry(int securityModel, const char *securityName)
     secname[0] = glen;
     strlcpy(secname + 1, securityName, sizeof(secname) - 1);
 
+    if (_vacm_index_ready(&groupIndex, groupList)) {
+        /*
+         * the list is sorted by model, so SNMP_SEC_MODEL_ANY (0) entries
+         * come first
+         */
+        memcpy(key.securityName, secname, glen + 1);
+        key.securityModel = SNMP_SEC_MODEL_ANY;
+        np = _vacm_index_find(&groupIndex, &key);
+        if (np == NULL && securityModel != SNMP_SEC_MODEL_ANY) {
+            key.securityModel = securityModel;
+            np = _vacm_index_find(&groupIndex, &key);
+        }
+        return np ? (struct vacm_groupEntry *) np->first : NULL;
+    }
+
     for (vp = groupList; vp; vp = vp->next) {
         if ((securityModel == vp->securityModel
              || vp->securityModel == SNMP_SEC_MODEL_ANY)
@@ -877,6 +1365,7 @@ vacm_createGroupEntry(int securityModel, const char *securityName)
         groupList = gp;
     else
         og->next = gp;
+    _vacm_index_insert(&groupIndex, gp);
     return gp;
 }
 
@@ -900,6 +1389,7 @@ vacm_destroyGroupEntry(int securityModel, const char *securityName)
             return;
         lastvp->next = vp->next;
     }
+    _vacm_index_remove(&groupIndex, vp);
     if (vp->reserved)
         free(vp->reserved);
     free(vp);
@@ -911,6 +1401,7 @@ void
 vacm_destroyAllGroupEntries(void)
 {
     struct vacm_groupEntry *gp;
+    _vacm_index_clear(&groupIndex);
     while ((gp = groupList)) {
         groupList = gp->next;
         if (gp->reserved)
@@ -963,10 +1454,11 @@ vacm_getAccessEntry(const char *groupName,
                     const char *contextPrefix,
                     int securityModel, int securityLevel)
 {
-    struct vacm_accessEntry *vp, *best=NULL;
+    struct vacm_accessEntry *vp, *best=NULL, *head = accessList;
+    struct vacm_index_node *np;
     char            group[VACMSTRINGLEN];
     char            context[VACMSTRINGLEN];
-    int             glen, clen;
+    int             glen, clen, run = 0;
 
     glen = (int) strlen(groupName);
     if (glen < 0 || glen > VACM_MAX_STRING)
@@ -979,7 +1471,17 @@ vacm_getAccessEntry(const char *groupName,
     strlcpy(group + 1, groupName, sizeof(group) - 1);
     context[0] = clen;
     strlcpy(context + 1, contextPrefix, sizeof(context) - 1);
-    for (vp = accessList; vp; vp = vp->next) {
+    if (_vacm_index_ready(&accessIndex, accessList)) {
+        struct vacm_accessEntry key;
+
+        memcpy(key.groupName, group, glen + 1);
+        np = _vacm_index_find(&accessIndex, &key);
+        head = np ? (struct vacm_accessEntry *) np->first : NULL;
+        run = 1;
+    }
+    for (vp = head; vp; vp = vp->next) {
+        if (run && memcmp(vp->groupName, group, glen + 1))
+            break;
         if ((securityModel == vp->securityModel
              || vp->securityModel == SNMP_SEC_MODEL_ANY)
             && securityLevel >= vp->securityLevel
@@ -1075,6 +1577,7 @@ vacm_createAccessEntry(const char *groupName,
         accessList = vp;
     else
         op->next = vp;
+    _vacm_index_insert(&accessIndex, vp);
     return vp;
 }
 
@@ -1104,6 +1607,7 @@ vacm_destroyAccessEntry(const char *groupName,
             return;
         lastvp->next = vp->next;
     }
+    _vacm_index_remove(&accessIndex, vp);
     if (vp->reserved)
         free(vp->reserved);
     free(vp);
@@ -1114,6 +1618,7 @@ void
 vacm_destroyAllAccessEntries(void)
 {
     struct vacm_accessEntry *ap;
+    _vacm_index_clear(&accessIndex);
     while ((ap = accessList)) {
         accessList = ap->next;
         if (ap->reserved)
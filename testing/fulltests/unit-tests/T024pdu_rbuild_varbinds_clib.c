@@ -0,0 +1,123 @@
+/* HEADER Encoding varbinds in list order */
+
+#ifdef NETSNMP_USE_REVERSE_ASNENCODING
+{
+    /*
+     * snmp_pdu_realloc_rbuild() writes the variable-bindings front to back
+     * into a presized buffer.  Check that the result is byte for byte the
+     * same as encoding every varbind back to front with
+     * snmp_realloc_rbuild_var_op(), for a list long enough to have needed
+     * more than one pass of the old varbind cache.
+     */
+    static const oid base[] = { 1, 3, 6, 1, 4, 1, 8072, 9999, 1 };
+    static const oid objid_val[] = { 1, 3, 6, 1, 2, 1, 1, 2, 0 };
+    static const long ints[] = { 0, 1, -1, 127, 128, -128, -129,
+                                 0x7fffffffL, -0x7fffffffL - 1 };
+    static const u_long uints[] = { 0, 127, 128, 255, 256, 0xffffffffUL };
+    static const u_char ipaddr[] = { 192, 0, 2, 1 };
+    netsnmp_pdu *pdu;
+    netsnmp_variable_list *vp, *vps[200];
+    struct counter64 c64;
+    oid name[MAX_OID_LEN];
+    u_char *pkt, *ref;
+    size_t pkt_len, pkt_off, ref_len, ref_off, start;
+    char str[300];
+    int n, rc;
+
+    pdu = snmp_pdu_create(SNMP_MSG_RESPONSE);
+    pdu->reqid = 0x12345678;
+    memcpy(name, base, sizeof(base));
+    for (n = 0; n < 180; n++) {
+        name[OID_LENGTH(base)] = n * 1000;
+        name[OID_LENGTH(base) + 1] = n;
+        switch (n % 8) {
+        case 0:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_INTEGER, &ints[n % 9], sizeof(long));
+            break;
+        case 1:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  n & 1 ? ASN_COUNTER : ASN_GAUGE,
+                                  &uints[n % 6], sizeof(u_long));
+            break;
+        case 2:
+            c64.high = n & 4 ? 0x80000000UL : 0;
+            c64.low = uints[n % 6];
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_COUNTER64, &c64, sizeof(c64));
+            break;
+        case 3:
+            /* strings around the short/long form length boundaries */
+            memset(str, 'a' + n % 26, sizeof(str));
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_OCTET_STR, str, (n * 7) % 300);
+            break;
+        case 4:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_OBJECT_ID, objid_val,
+                                  sizeof(objid_val));
+            break;
+        case 5:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_IPADDRESS, ipaddr, sizeof(ipaddr));
+            break;
+        case 6:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  ASN_TIMETICKS, &uints[n % 6],
+                                  sizeof(u_long));
+            break;
+        default:
+            snmp_pdu_add_variable(pdu, name, OID_LENGTH(base) + 2,
+                                  n & 1 ? SNMP_ENDOFMIBVIEW : ASN_NULL,
+                                  NULL, 0);
+            break;
+        }
+    }
+
+    /* reference encoding, built back to front */
+    ref_len = 16;
+    ref = malloc(ref_len);
+    ref_off = 0;
+    for (n = 0, vp = pdu->variables; vp; vp = vp->next_variable)
+        vps[n++] = vp;
+    rc = 1;
+    while (rc && n-- > 0)
+        rc = snmp_realloc_rbuild_var_op(&ref, &ref_len, &ref_off, 1,
+                                        vps[n]->name, &vps[n]->name_length,
+                                        vps[n]->type,
+                                        (u_char *) vps[n]->val.string,
+                                        vps[n]->val_len);
+    start = 0;
+    rc = rc && asn_realloc_rbuild_sequence(&ref, &ref_len, &ref_off, 1,
+                                           ASN_SEQUENCE | ASN_CONSTRUCTOR,
+                                           ref_off - start);
+    rc = rc && asn_realloc_rbuild_int(&ref, &ref_len, &ref_off, 1,
+                                      ASN_INTEGER, &pdu->errindex,
+                                      sizeof(pdu->errindex));
+    rc = rc && asn_realloc_rbuild_int(&ref, &ref_len, &ref_off, 1,
+                                      ASN_INTEGER, &pdu->errstat,
+                                      sizeof(pdu->errstat));
+    rc = rc && asn_realloc_rbuild_int(&ref, &ref_len, &ref_off, 1,
+                                      ASN_INTEGER, &pdu->reqid,
+                                      sizeof(pdu->reqid));
+    rc = rc && asn_realloc_rbuild_sequence(&ref, &ref_len, &ref_off, 1,
+                                           (u_char) pdu->command,
+                                           ref_off - start);
+    OK(rc, "reference encoding");
+
+    pkt_len = 16;
+    pkt = malloc(pkt_len);
+    pkt_off = 0;
+    rc = snmp_pdu_realloc_rbuild(&pkt, &pkt_len, &pkt_off, pdu);
+    OK(rc, "snmp_pdu_realloc_rbuild()");
+    OKF(pkt_off == ref_off, ("encoded length %" NETSNMP_PRIz "u <> %"
+                             NETSNMP_PRIz "u", pkt_off, ref_off));
+    OK(pkt_off == ref_off &&
+       memcmp(pkt + pkt_len - pkt_off, ref + ref_len - ref_off,
+              ref_off) == 0, "encoded PDU matches the reverse encoding");
+
+    free(pkt);
+    free(ref);
+    snmp_free_pdu(pdu);
+}
+#endif /* NETSNMP_USE_REVERSE_ASNENCODING */
@@ -0,0 +1,195 @@
+/* HEADER VACM lookups through the hashed indexes */
+
+/*
+ * netsnmp_view_get() only uses the view index and its compiled form for
+ * the global view list.  Build the same views in the global list and in
+ * a private one (as snmpNotifyFilterTable does) and check that both give
+ * the same answers, also after a mask has been changed and entries have
+ * been destroyed.
+ */
+static const oid sub_a[] = { 1, 3, 6, 1, 2, 1 };
+static const oid sub_b[] = { 1, 3, 6, 1, 2, 1, 2, 2, 1, 2 };
+static const oid sub_c[] = { 1, 3, 6, 1, 2, 1, 2, 2, 1, 1, 3 };
+static const oid sub_d[] = { 1, 3, 6, 1, 4, 1 };
+static const oid sub_e[] = { 1, 3, 6, 1, 2, 1, 2, 2, 1 };
+static const struct {
+    const char *name;
+    const oid  *subtree;
+    size_t      len;
+    int         type;
+    u_char      mask;           /* first mask byte, 0 = no mask */
+} views[] = {
+    { "v1", sub_a, OID_LENGTH(sub_a), SNMP_VIEW_INCLUDED, 0 },
+    { "v1", sub_b, OID_LENGTH(sub_b), SNMP_VIEW_EXCLUDED, 0 },
+    { "v1", sub_c, OID_LENGTH(sub_c), SNMP_VIEW_EXCLUDED, 0xfe },
+    { "v1", sub_d, OID_LENGTH(sub_d), SNMP_VIEW_INCLUDED, 0 },
+    { "v2", sub_b, OID_LENGTH(sub_b), SNMP_VIEW_INCLUDED, 0 },
+    { "v2", sub_b, OID_LENGTH(sub_b), SNMP_VIEW_EXCLUDED, 0 },
+    { "v2", sub_c, OID_LENGTH(sub_c), SNMP_VIEW_INCLUDED, 0xff },
+    { "v10", sub_d, OID_LENGTH(sub_d), SNMP_VIEW_INCLUDED, 0xf0 },
+};
+static const char *names[] = { "v1", "v2", "v10", "nope" };
+struct vacm_viewEntry pviews[sizeof(views) / sizeof(views[0])];
+struct vacm_viewEntry *priv = NULL, **pvpp, *vp, *gvp, *pvp;
+struct vacm_groupEntry *gp;
+struct vacm_accessEntry *ap;
+oid name[MAX_OID_LEN + 1];
+size_t i, j, k, len;
+int mismatch;
+
+#define CHECK_VIEWS(what)                                               \
+    mismatch = 0;                                                       \
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++) {            \
+        for (j = 0; j < sizeof(views) / sizeof(views[0]); j++) {        \
+            for (k = 0; k < 4; k++) {                                   \
+                len = views[j].len;                                     \
+                memcpy(name, views[j].subtree, len * sizeof(oid));      \
+                if (k & 1)                                              \
+                    name[len++] = 1;                                    \
+                if (k & 2)                                              \
+                    name[len - 1] += 1;                                 \
+                gvp = vacm_getViewEntry(names[i], name, len,            \
+                                        VACM_MODE_FIND);                \
+                pvp = netsnmp_view_get(priv, names[i], name, len,       \
+                                       VACM_MODE_FIND);                 \
+                if ((gvp == NULL) != (pvp == NULL) ||                   \
+                    (gvp && (gvp->viewType != pvp->viewType ||          \
+                             snmp_oid_compare(gvp->viewSubtree,         \
+                                              gvp->viewSubtreeLen,      \
+                                              pvp->viewSubtree,         \
+                                              pvp->viewSubtreeLen))))   \
+                    mismatch++;                                         \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+    OKF(mismatch == 0, ("%s: %d mismatches", what, mismatch))
+
+init_snmp("vacm-index-test");
+
+memset(pviews, 0, sizeof(pviews));
+for (i = 0, pvpp = &priv; i < sizeof(views) / sizeof(views[0]); i++) {
+    gvp = vacm_createViewEntry(views[i].name,
+                               NETSNMP_REMOVE_CONST(oid *, views[i].subtree),
+                               views[i].len);
+    OK(gvp != NULL, "created view entry");
+    if (!gvp)
+        break;
+    pvp = &pviews[i];
+    memcpy(pvp, gvp, sizeof(*pvp));
+    pvp->next = NULL;
+    *pvpp = pvp;
+    pvpp = &pvp->next;
+    gvp->viewType = pvp->viewType = views[i].type;
+    if (views[i].mask) {
+        gvp->viewMask[0] = pvp->viewMask[0] = views[i].mask;
+        gvp->viewMaskLen = pvp->viewMaskLen = 1;
+        vacm_viewEntryChanged(gvp);
+    }
+}
+
+CHECK_VIEWS("initial views");
+
+/* turn an exact entry into a wildcard one */
+vacm_scanViewInit();
+while ((vp = vacm_scanViewNext()) != NULL)
+    if (vp->viewMaskLen == 0) {
+        vp->viewMask[0] = 0xbf;
+        vp->viewMaskLen = 1;
+        vacm_viewEntryChanged(vp);
+        break;
+    }
+for (pvp = priv; pvp; pvp = pvp->next)
+    if (pvp->viewMaskLen == 0) {
+        pvp->viewMask[0] = 0xbf;
+        pvp->viewMaskLen = 1;
+        break;
+    }
+
+CHECK_VIEWS("changed mask");
+
+/*
+ * vacm_destroyViewEntry() takes the subtree with its length in front and
+ * destroys the first matching entry
+ */
+name[0] = OID_LENGTH(sub_a);
+memcpy(name + 1, sub_a, sizeof(sub_a));
+vacm_destroyViewEntry("v1", name, OID_LENGTH(sub_a) + 1);
+name[0] = OID_LENGTH(sub_b);
+memcpy(name + 1, sub_b, sizeof(sub_b));
+vacm_destroyViewEntry("v2", name, OID_LENGTH(sub_b) + 1);
+for (pvpp = &priv; *pvpp; )
+    if (*pvpp == &pviews[0] || *pvpp == &pviews[4])
+        *pvpp = (*pvpp)->next;
+    else
+        pvpp = &(*pvpp)->next;
+
+CHECK_VIEWS("destroyed entries");
+
+gvp = vacm_getViewEntry("v2", NETSNMP_REMOVE_CONST(oid *, sub_b),
+                        OID_LENGTH(sub_b), VACM_MODE_FIND);
+OK(gvp && gvp->viewType == SNMP_VIEW_EXCLUDED, "duplicate entry remains");
+OK(vacm_checkSubtree("v2", NETSNMP_REMOVE_CONST(oid *, sub_e),
+                     OID_LENGTH(sub_e)) == VACM_SUBTREE_UNKNOWN,
+   "v2 subtree partly in view");
+OK(vacm_checkSubtree("v1", NETSNMP_REMOVE_CONST(oid *, sub_d),
+                     OID_LENGTH(sub_d)) == VACM_SUCCESS,
+   "v1 subtree in view");
+OK(vacm_checkSubtree("nope", NETSNMP_REMOVE_CONST(oid *, sub_d),
+                     OID_LENGTH(sub_d)) == VACM_NOTINVIEW,
+   "unknown view");
+
+vacm_destroyAllViewEntries();
+OK(vacm_getViewEntry("v1", NETSNMP_REMOVE_CONST(oid *, sub_d),
+                     OID_LENGTH(sub_d), VACM_MODE_FIND) == NULL,
+   "all views destroyed");
+
+/* groups: SNMP_SEC_MODEL_ANY entries win over model specific ones */
+gp = vacm_createGroupEntry(SNMP_SEC_MODEL_USM, "alice");
+if (gp)
+    strcpy(gp->groupName + 1, "g-usm");
+OK(vacm_getGroupEntry(SNMP_SEC_MODEL_USM, "alice") == gp,
+   "model specific group found");
+OK(vacm_getGroupEntry(SNMP_SEC_MODEL_SNMPv2c, "alice") == NULL,
+   "no group for other models");
+gp = vacm_createGroupEntry(SNMP_SEC_MODEL_ANY, "alice");
+OK(vacm_getGroupEntry(SNMP_SEC_MODEL_USM, "alice") == gp &&
+   vacm_getGroupEntry(SNMP_SEC_MODEL_SNMPv2c, "alice") == gp,
+   "any-model group preferred");
+vacm_destroyGroupEntry(SNMP_SEC_MODEL_ANY, "alice");
+OK(vacm_getGroupEntry(SNMP_SEC_MODEL_SNMPv2c, "alice") == NULL &&
+   vacm_getGroupEntry(SNMP_SEC_MODEL_USM, "alice") != NULL,
+   "group index updated on destroy");
+vacm_destroyAllGroupEntries();
+OK(vacm_getGroupEntry(SNMP_SEC_MODEL_USM, "alice") == NULL,
+   "all groups destroyed");
+
+/* access: prefix and exact context matches within one group */
+ap = vacm_createAccessEntry("g1", "ctx", SNMP_SEC_MODEL_ANY,
+                            SNMP_SEC_LEVEL_NOAUTH);
+if (ap)
+    ap->contextMatch = CONTEXT_MATCH_PREFIX;
+OK(vacm_getAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_AUTHPRIV) == ap, "prefix match");
+ap = vacm_createAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                            SNMP_SEC_LEVEL_AUTHNOPRIV);
+if (ap)
+    ap->contextMatch = CONTEXT_MATCH_EXACT;
+vacm_createAccessEntry("g0", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_NOAUTH);
+vacm_createAccessEntry("g2", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_NOAUTH);
+OK(vacm_getAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_AUTHPRIV) == ap, "exact match preferred");
+OK(vacm_getAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_NOAUTH) != ap, "level respected");
+OK(vacm_getAccessEntry("g3", "ctx-a", SNMP_SEC_MODEL_USM,
+                       SNMP_SEC_LEVEL_AUTHPRIV) == NULL, "unknown group");
+vacm_destroyAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                        SNMP_SEC_LEVEL_AUTHNOPRIV);
+ap = vacm_getAccessEntry("g1", "ctx-a", SNMP_SEC_MODEL_USM,
+                         SNMP_SEC_LEVEL_AUTHPRIV);
+OK(ap && ap->contextMatch == CONTEXT_MATCH_PREFIX,
+   "access index updated on destroy");
+vacm_destroyAllAccessEntries();
+
+snmp_shutdown("vacm-index-test");
@@ -0,0 +1,185 @@
+/* HEADER Testing the btree container against a binary array */
+
+/*
+ * Keys are the base 7 digits of the entry number, so many of them share
+ * their first sub-identifiers, optionally followed by a sub-identifier
+ * that cannot be a digit.  That gives unique keys both shorter and
+ * longer than the prefix the btree keeps inline, some of which end in a
+ * sub-identifier that does not fit in 32 bits.
+ */
+#define BT_TEST_N 3000
+static const char test_name[] = "btree-container-test";
+static oid      keys[BT_TEST_N][8];
+static netsnmp_index idx[BT_TEST_N], probe, dups[4];
+static oid      probe_oids[8];
+netsnmp_container *bt, *ba, *dup;
+netsnmp_iterator *it, *it2;
+netsnmp_void_array *vb, *va;
+netsnmp_index  *ip, *jp;
+void           *vp, *wp;
+size_t          i, j, k, len;
+int             mismatch;
+
+#define CHECK_SAME(what)                                                \
+    mismatch = (CONTAINER_SIZE(bt) != CONTAINER_SIZE(ba));              \
+    it = CONTAINER_ITERATOR(bt);                                        \
+    it2 = CONTAINER_ITERATOR(ba);                                       \
+    for (ip = ITERATOR_FIRST(it), jp = ITERATOR_FIRST(it2), k = 0;      \
+         ip || jp; ip = ITERATOR_NEXT(it), jp = ITERATOR_NEXT(it2), ++k) { \
+        vp = NULL;                                                      \
+        if (ip != jp || CONTAINER_GET_AT(bt, k, &vp) != 0 || vp != ip)  \
+            mismatch++;                                                 \
+    }                                                                   \
+    ITERATOR_RELEASE(it);                                               \
+    ITERATOR_RELEASE(it2);                                              \
+    for (i = 0; i < BT_TEST_N; ++i) {                                   \
+        if (CONTAINER_FIND(bt, &idx[i]) != CONTAINER_FIND(ba, &idx[i]) || \
+            CONTAINER_NEXT(bt, &idx[i]) != CONTAINER_NEXT(ba, &idx[i])) \
+            mismatch++;                                                 \
+        /* a key between entries: replace the last sub-id */            \
+        memcpy(probe_oids, idx[i].oids, idx[i].len * sizeof(oid));      \
+        probe_oids[idx[i].len - 1] = 7;                                 \
+        probe.len = idx[i].len;                                         \
+        if (CONTAINER_FIND(bt, &probe) != CONTAINER_FIND(ba, &probe) || \
+            CONTAINER_NEXT(bt, &probe) != CONTAINER_NEXT(ba, &probe))   \
+            mismatch++;                                                 \
+    }                                                                   \
+    if (CONTAINER_FIRST(bt) != CONTAINER_FIRST(ba))                     \
+        mismatch++;                                                     \
+    OKF(mismatch == 0, ("%s: %d mismatches", what, mismatch))
+
+init_snmp(test_name);
+
+bt = netsnmp_container_find("btree");
+ba = netsnmp_container_get_binary_array();
+OK(bt != NULL, "btree container found");
+if (bt) {
+ba->compare = netsnmp_compare_netsnmp_index;
+bt->ncompare = ba->ncompare = netsnmp_ncompare_netsnmp_index;
+
+for (i = 0; i < BT_TEST_N; ++i) {
+    oid             digits[8];
+
+    for (k = i, len = 0; k || !len; k /= 7)
+        digits[len++] = k % 7;
+    for (j = 0; j < len; ++j)
+        keys[i][j] = digits[len - 1 - j];
+    if (i % 3 == 1)
+        keys[i][len++] = (oid)-1;
+    else if (i % 3 == 2)
+        keys[i][len++] = 100;
+    idx[i].oids = keys[i];
+    idx[i].len = len;
+}
+probe.oids = probe_oids;
+
+/* insert in a scattered order */
+for (i = 0, mismatch = 0; i < BT_TEST_N; ++i) {
+    j = (i * 1237) % BT_TEST_N;
+    if (CONTAINER_INSERT(bt, &idx[j]) != 0)
+        mismatch++;
+    CONTAINER_INSERT(ba, &idx[j]);
+}
+OKF(mismatch == 0, ("inserts: %d failed", mismatch));
+OK(CONTAINER_INSERT(bt, &idx[0]) != 0 &&
+   CONTAINER_INSERT(bt, &idx[1234]) != 0, "duplicate keys rejected");
+
+CHECK_SAME("after inserts");
+
+/* subsets by leading sub-identifiers */
+mismatch = 0;
+for (i = 0; i < 8; ++i) {
+    probe_oids[0] = i;
+    probe.len = 1;
+    vb = CONTAINER_GET_SUBSET(bt, &probe);
+    va = CONTAINER_GET_SUBSET(ba, &probe);
+    if ((vb == NULL) != (va == NULL) ||
+        (vb && (vb->size != va->size ||
+                memcmp(vb->array, va->array, vb->size * sizeof(void *)))))
+        mismatch++;
+    if (vb) {
+        free(vb->array);
+        free(vb);
+    }
+    if (va) {
+        free(va->array);
+        free(va);
+    }
+}
+OKF(mismatch == 0, ("subsets: %d mismatches", mismatch));
+
+/* remove two thirds, again in a scattered order */
+for (i = 0, mismatch = 0; i < BT_TEST_N; ++i) {
+    j = (i * 1237) % BT_TEST_N;
+    if (j % 3 == 0)
+        continue;
+    if (CONTAINER_REMOVE(bt, &idx[j]) != 0)
+        mismatch++;
+    CONTAINER_REMOVE(ba, &idx[j]);
+}
+OKF(mismatch == 0, ("removes: %d failed", mismatch));
+
+CHECK_SAME("after removes");
+
+/* a copy keeps the order */
+dup = CONTAINER_DUP(bt, NULL, 0);
+OK(dup && CONTAINER_SIZE(dup) == CONTAINER_SIZE(bt) &&
+   CONTAINER_FIRST(dup) == CONTAINER_FIRST(bt), "duplicate container");
+if (dup)
+    CONTAINER_FREE(dup);
+
+/* remove every other entry through the iterators */
+it = CONTAINER_ITERATOR(bt);
+for (ip = ITERATOR_FIRST(it), k = 0; ip; ip = ITERATOR_NEXT(it), ++k)
+    if (k & 1)
+        ITERATOR_REMOVE(it);
+ITERATOR_RELEASE(it);
+it2 = CONTAINER_ITERATOR(ba);
+for (jp = ITERATOR_FIRST(it2), k = 0; jp; jp = ITERATOR_NEXT(it2), ++k)
+    if (k & 1)
+        ITERATOR_REMOVE(it2);
+ITERATOR_RELEASE(it2);
+
+CHECK_SAME("after iterator removes");
+
+/* everything out by position, then back in */
+while (CONTAINER_SIZE(bt) > 0 &&
+       CONTAINER_REMOVE_AT(bt, CONTAINER_SIZE(bt) / 2, &vp) == 0)
+    CONTAINER_REMOVE(ba, vp);
+OK(CONTAINER_SIZE(bt) == 0 && CONTAINER_FIRST(bt) == NULL,
+   "emptied by position");
+for (i = 0; i < BT_TEST_N; ++i) {
+    CONTAINER_INSERT(bt, &idx[BT_TEST_N - 1 - i]);
+    CONTAINER_INSERT(ba, &idx[BT_TEST_N - 1 - i]);
+}
+
+CHECK_SAME("after reinserting");
+
+CONTAINER_CLEAR(bt, NULL, NULL);
+OK(CONTAINER_SIZE(bt) == 0 && CONTAINER_FIRST(bt) == NULL, "cleared");
+
+/* duplicate keys, when allowed */
+CONTAINER_SET_OPTIONS(bt, CONTAINER_KEY_ALLOW_DUPLICATES, mismatch);
+OK(mismatch >= 0, "duplicates allowed");
+for (i = 0; i < 4; ++i) {
+    dups[i] = idx[100];
+    CONTAINER_INSERT(bt, &dups[i]);
+}
+CONTAINER_INSERT(bt, &idx[99]);
+CONTAINER_INSERT(bt, &idx[101]);
+OK(CONTAINER_FIND(bt, &idx[100]) == &dups[0], "first duplicate found");
+OK(CONTAINER_NEXT(bt, &idx[100]) == &idx[101], "next skips duplicates");
+CONTAINER_REMOVE(bt, &dups[2]);
+wp = NULL;
+CONTAINER_GET_AT(bt, 3, &wp);
+OK(CONTAINER_SIZE(bt) == 5 && wp == &dups[3], "removed the given duplicate");
+CONTAINER_SET_OPTIONS(bt, CONTAINER_KEY_UNSORTED, mismatch);
+OK(mismatch < 0, "unsorted is not supported");
+
+CONTAINER_CLEAR(bt, NULL, NULL);
+CONTAINER_FREE(bt);
+}
+CONTAINER_CLEAR(ba, NULL, NULL);
+CONTAINER_FREE(ba);
+
+snmp_shutdown(test_name);
@@ -0,0 +1,158 @@
+/* HEADER Bulk loading containers */
+
+/*
+ * Load the same entries, some of them with duplicate keys, into a
+ * binary_array and a btree in bulk, and check the result against a
+ * binary_array loaded one entry at a time.
+ */
+#define BULK_TEST_N 500
+static const char test_name[] = "container-bulk-test";
+static const char *types[] = { "binary_array", "btree" };
+static oid      keys[BULK_TEST_N][3];
+static netsnmp_index idx[BULK_TEST_N], extra;
+static oid      extra_oids[] = { 0, 5, 5000 };
+static oid      chain_oids[][3] = { { 1, 2 }, { 1, 3, 1 }, { 2 }, { 5, 5 } };
+netsnmp_container *ref, *c, *c2;
+netsnmp_iterator *it, *it2;
+netsnmp_index  *ip, *jp, *chain[5];
+size_t          i, j, t;
+int             rc, mismatch;
+
+init_snmp(test_name);
+
+/*
+ * the second half repeats the odd keys of the first half
+ */
+for (i = 0; i < BULK_TEST_N; ++i) {
+    j = (i * 37) % (BULK_TEST_N / 2);
+    if (i >= BULK_TEST_N / 2)
+        j = (j % 2) ? j : j + BULK_TEST_N;
+    keys[i][0] = 1;
+    keys[i][1] = j;
+    keys[i][2] = j % 3;
+    idx[i].oids = keys[i];
+    idx[i].len = 3;
+}
+extra.oids = extra_oids;
+extra.len = 3;
+
+ref = netsnmp_container_get_binary_array();
+ref->compare = netsnmp_compare_netsnmp_index;
+for (i = 0; i < BULK_TEST_N; ++i)
+    CONTAINER_INSERT(ref, &idx[i]);
+
+for (t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+    c = netsnmp_container_find(types[t]);
+    OKF(c != NULL, ("%s: container found", types[t]));
+    if (!c)
+        continue;
+    c->compare = netsnmp_compare_netsnmp_index;
+
+    /* entries loaded beforehand win over the bulk loaded ones */
+    CONTAINER_INSERT(c, &idx[1]);
+    CONTAINER_INSERT(c, &idx[3]);
+
+    OKF(CONTAINER_BULK_BEGIN(c) == 0, ("%s: bulk load started", types[t]));
+    for (i = 0, mismatch = 0; i < BULK_TEST_N; ++i)
+        if (i != 1 && i != 3 && CONTAINER_INSERT(c, &idx[i]) != 0)
+            mismatch++;
+    /* and everything once more, which is all dropped */
+    for (i = BULK_TEST_N; i > 0; --i)
+        if (i - 1 != 1 && i - 1 != 3 && CONTAINER_INSERT(c, &idx[i - 1]) != 0)
+            mismatch++;
+    OKF(mismatch == 0 && CONTAINER_SIZE(c) == 2 * BULK_TEST_N - 2,
+        ("%s: appended %d entries", types[t], (int)CONTAINER_SIZE(c)));
+    OKF(CONTAINER_FIND(c, &idx[0]) == NULL &&
+        CONTAINER_FIND(c, &idx[1]) == &idx[1],
+        ("%s: appended entries are not visible yet", types[t]));
+
+    /* an entry removed again before the end */
+    CONTAINER_REMOVE(c, &idx[10]);
+    CONTAINER_REMOVE(c, &idx[10]);
+
+    rc = CONTAINER_BULK_END(c, NULL, NULL);
+    OKF(rc == BULK_TEST_N + BULK_TEST_N / 4 - 3,
+        ("%s: %d dropped", types[t], rc));
+
+    /* the same entries in the same order as inserting them one by one */
+    CONTAINER_INSERT(c, &idx[10]);
+    mismatch = (CONTAINER_SIZE(c) != CONTAINER_SIZE(ref));
+    it = CONTAINER_ITERATOR(c);
+    it2 = CONTAINER_ITERATOR(ref);
+    for (ip = ITERATOR_FIRST(it), jp = ITERATOR_FIRST(it2); ip || jp;
+         ip = ITERATOR_NEXT(it), jp = ITERATOR_NEXT(it2))
+        if (ip != jp)
+            mismatch++;
+    ITERATOR_RELEASE(it);
+    ITERATOR_RELEASE(it2);
+    for (i = 0; i < BULK_TEST_N; ++i)
+        if (CONTAINER_FIND(c, &idx[i]) != CONTAINER_FIND(ref, &idx[i]) ||
+            CONTAINER_NEXT(c, &idx[i]) != CONTAINER_NEXT(ref, &idx[i]))
+            mismatch++;
+    OKF(mismatch == 0, ("%s: %d mismatches with single inserts", types[t],
+                        mismatch));
+
+    /* a second bulk load only adds the new entries */
+    CONTAINER_BULK_BEGIN(c);
+    CONTAINER_INSERT(c, &extra);
+    CONTAINER_INSERT(c, &idx[20]);
+    rc = CONTAINER_BULK_END(c, NULL, NULL);
+    OKF(rc == 1 && CONTAINER_FIRST(c) == &extra &&
+        CONTAINER_SIZE(c) == CONTAINER_SIZE(ref) + 1,
+        ("%s: reloaded, %d dropped", types[t], rc));
+
+    /* entries still pending are cleared too */
+    CONTAINER_BULK_BEGIN(c);
+    CONTAINER_INSERT(c, &idx[30]);
+    CONTAINER_CLEAR(c, NULL, NULL);
+    OKF(CONTAINER_SIZE(c) == 0 && CONTAINER_BULK_END(c, NULL, NULL) == 0 &&
+        CONTAINER_SIZE(c) == 0, ("%s: cleared", types[t]));
+
+    /*
+     * with a second index on the index length: the last two entries
+     * are rejected by one index each, and must be dropped from both
+     * (and freed, exactly once)
+     */
+    c2 = netsnmp_container_find(types[t]);
+    c2->compare = netsnmp_compare_ulong; /* len is the first member */
+    netsnmp_container_add_index(c, c2);
+    CONTAINER_BULK_BEGIN(c);
+    for (i = 0; i < 5; ++i) {
+        chain[i] = SNMP_MALLOC_TYPEDEF(netsnmp_index);
+        chain[i]->oids = chain_oids[i < 4 ? i : 0];
+        chain[i]->len = i == 1 ? 3 : i == 2 ? 1 : 2;
+        CONTAINER_INSERT(c, chain[i]);
+    }
+    rc = CONTAINER_BULK_END(c, netsnmp_container_simple_free, NULL);
+    OKF(rc == 2 && CONTAINER_SIZE(c) == 3 && CONTAINER_SIZE(c2) == 3 &&
+        CONTAINER_FIND(c, chain[0]) == chain[0] &&
+        CONTAINER_FIND(c2, chain[0]) == chain[0],
+        ("%s: %d dropped from two indexes", types[t], rc));
+    CONTAINER_CLEAR(c, netsnmp_container_simple_free, NULL);
+
+    CONTAINER_FREE(c);
+}
+
+/* duplicates are kept when allowed, after the ones already there */
+c = netsnmp_container_find("btree");
+if (c) {
+    CONTAINER_SET_OPTIONS(c, CONTAINER_KEY_ALLOW_DUPLICATES, rc);
+    extra = idx[1];
+    CONTAINER_INSERT(c, &extra);
+    CONTAINER_BULK_BEGIN(c);
+    for (i = 0; i < BULK_TEST_N; ++i)
+        CONTAINER_INSERT(c, &idx[i]);
+    rc = CONTAINER_BULK_END(c, NULL, NULL);
+    for (i = 0, ip = NULL; i < CONTAINER_SIZE(c) && ip != &extra; ++i)
+        CONTAINER_GET_AT(c, i, (void **)&ip);
+    jp = NULL;
+    CONTAINER_GET_AT(c, i, (void **)&jp);
+    OK(rc == 0 && CONTAINER_SIZE(c) == BULK_TEST_N + 1 &&
+       CONTAINER_FIND(c, &idx[1]) == &extra && jp == &idx[1],
+       "btree: duplicates kept in order");
+    CONTAINER_FREE(c);
+}
+
+CONTAINER_FREE(ref);
+
+snmp_shutdown(test_name);
@@ -0,0 +1,102 @@
+/* HEADER OID compares with each compare implementation */
+
+/*
+ * Run the OID compares with every implementation the CPU supports and
+ * check them against a plain loop, on random OIDs which differ in a
+ * random sub-identifier (sometimes only in its high bytes).  Then time
+ * compares of realistic OIDs (10-30 sub-identifiers, under a common
+ * prefix) with each implementation; the timings are only reported.
+ */
+#define OIDCMP_PAIRS   20000
+#define OIDCMP_ROUNDS  50
+static const char *impls[] = { "scalar", "sse2", "avx2" };
+static const oid prefix[] = { 1, 3, 6, 1, 2, 1, 4, 24, 4, 1 };
+static oid      a[40], b[40], names[64][30];
+static size_t   name_len[64];
+unsigned long   seed = 1;
+size_t          t, n, i, len_a, len_b, pos, off, want_off;
+int             want, mismatch, rc;
+const char     *impl;
+struct timeval  start, end;
+double          usec;
+
+#define RAND() (seed = seed * 1103515245 + 12345, (seed >> 8) & 0xffffff)
+
+init_snmp("oid-compare-test");
+
+for (t = 0; t < sizeof(impls) / sizeof(impls[0]); ++t) {
+    impl = netsnmp_oid_compare_impl(impls[t]);
+    if (NULL == impl) {
+        printf("# %s is not available\n", impls[t]);
+        continue;
+    }
+
+    for (n = 0, mismatch = 0; n < OIDCMP_PAIRS; ++n) {
+        len_a = RAND() % 40;
+        len_b = (RAND() & 1) ? len_a : RAND() % 40;
+        for (i = 0; i < 40; ++i)
+            a[i] = b[i] = RAND() % 8;
+        if (RAND() & 1) {
+            pos = RAND() % 40;
+            if (RAND() & 1)
+                b[pos] += (oid)1 << (8 * (RAND() % sizeof(oid)));
+            else
+                b[pos] = RAND();
+        }
+
+        /* what the plain loop says */
+        for (i = 0; i < len_a && i < len_b && a[i] == b[i]; ++i)
+            ;
+        if (i < len_a && i < len_b)
+            want = a[i] < b[i] ? -1 : 1;
+        else
+            want = len_a < len_b ? -1 : len_a > len_b;
+        want_off = i + 1;   /* one past an equal prefix, too */
+
+        if (snmp_oid_compare(a, len_a, b, len_b) != want ||
+            snmp_oid_compare(b, len_b, a, len_a) != -want)
+            mismatch++;
+        if (netsnmp_oid_equals(a, len_a, b, len_b) != (want != 0))
+            mismatch++;
+        rc = netsnmp_oid_compare_ll(a, len_a, b, len_b, &off);
+        if (rc != want || off != want_off)
+            mismatch++;
+        if ((snmp_oidtree_compare(a, len_a, b, len_b) == 0) !=
+            (i >= len_a || i >= len_b))
+            mismatch++;
+        rc = snmp_oid_ncompare(a, len_a, b, len_b, 12);
+        if (rc != ((i < 12 || len_a < 12 || len_b < 12) ? want : 0))
+            mismatch++;
+    }
+    OKF(mismatch == 0, ("%s: %d mismatches", impl, mismatch));
+}
+
+/*
+ * index OIDs of a table below a common prefix, as the agent compares
+ * them when looking up table rows
+ */
+for (n = 0; n < 64; ++n) {
+    name_len[n] = 10 + RAND() % 21;
+    memcpy(names[n], prefix, sizeof(prefix));
+    for (i = OID_LENGTH(prefix); i < name_len[n]; ++i)
+        names[n][i] = (i + 3 < name_len[n]) ? 1 + (n & 1) : RAND() % 256;
+}
+for (t = 0; t < sizeof(impls) / sizeof(impls[0]); ++t) {
+    impl = netsnmp_oid_compare_impl(impls[t]);
+    if (NULL == impl)
+        continue;
+    rc = 0;
+    gettimeofday(&start, NULL);
+    for (n = 0; n < OIDCMP_ROUNDS * 64; ++n)
+        for (i = 0; i < 64; ++i)
+            rc += snmp_oid_compare(names[n % 64], name_len[n % 64],
+                                   names[i], name_len[i]);
+    gettimeofday(&end, NULL);
+    usec = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_usec - start.tv_usec);
+    printf("# %s: %.1f ns per snmp_oid_compare (%d)\n", impl,
+           usec * 1000 / (OIDCMP_ROUNDS * 64 * 64), rc);
+}
+
+OK(netsnmp_oid_compare_impl(NULL) != NULL, "default compare selected");
+
+snmp_shutdown("oid-compare-test");
@@ -0,0 +1,145 @@
+/* HEADER Testing the table_data row index */
+
+/*
+ * Add rows to a table_data in a scattered order and check that the row
+ * list stays ordered and that rows are found by index, before and after
+ * removing some of them.  Then check the column lookups of table_dataset
+ * rows.
+ */
+#define TD_TEST_N 200
+static oid      instance[2], probe[3];
+netsnmp_table_data *td;
+netsnmp_table_data_set *tds;
+netsnmp_table_row *rows[TD_TEST_N], *row, *prev, *clone;
+netsnmp_table_data_set_storage *data;
+int32_t         ival;
+int             i, j, ncols, mismatch;
+
+init_agent("snmpd");
+init_snmp("snmpd");
+
+td = netsnmp_create_table_data("table_data index unit-test");
+netsnmp_table_data_add_index(td, ASN_INTEGER);
+netsnmp_table_data_add_index(td, ASN_INTEGER);
+
+for (i = 0, mismatch = 0; i < TD_TEST_N; ++i) {
+    j = (i * 37) % TD_TEST_N;
+    rows[j] = netsnmp_create_table_data_row();
+    ival = j / 10;
+    netsnmp_table_row_add_index(rows[j], ASN_INTEGER, &ival, sizeof(ival));
+    ival = j % 10;
+    netsnmp_table_row_add_index(rows[j], ASN_INTEGER, &ival, sizeof(ival));
+    if (netsnmp_table_data_add_row(td, rows[j]) != SNMPERR_SUCCESS)
+        mismatch++;
+}
+OKF(mismatch == 0, ("added rows: %d failed", mismatch));
+
+/* a row which already exists is refused */
+row = netsnmp_create_table_data_row();
+netsnmp_table_row_add_index(row, ASN_INTEGER, &ival, sizeof(ival));
+netsnmp_table_row_add_index(row, ASN_INTEGER, &ival, sizeof(ival));
+OK(netsnmp_table_data_add_row(td, row) != SNMPERR_SUCCESS,
+   "duplicate row refused");
+netsnmp_table_data_delete_row(row);
+
+/* remove every third row */
+for (i = 0; i < TD_TEST_N; i += 3)
+    netsnmp_table_data_remove_and_delete_row(td, rows[i]);
+OK(netsnmp_table_data_num_rows(td) == TD_TEST_N - (TD_TEST_N + 2) / 3,
+   "row count");
+
+mismatch = 0;
+for (row = td->first_row, prev = NULL, j = 0; row;
+     prev = row, row = row->next, ++j) {
+    if (row->prev != prev ||
+        (prev && snmp_oid_compare(prev->index_oid, prev->index_oid_len,
+                                  row->index_oid, row->index_oid_len) >= 0))
+        mismatch++;
+}
+OKF(mismatch == 0 && td->last_row == prev &&
+    j == netsnmp_table_data_num_rows(td), ("row list: %d mismatches",
+                                           mismatch));
+
+for (i = 0, mismatch = 0; i < TD_TEST_N; ++i) {
+    instance[0] = i / 10;
+    instance[1] = i % 10;
+    row = netsnmp_table_data_get_from_oid(td, instance, 2);
+    if (row != (i % 3 ? rows[i] : NULL))
+        mismatch++;
+    /* the next row, from the row itself and from a shorter index */
+    for (j = i + 1; j < TD_TEST_N && j % 3 == 0; ++j)
+        ;
+    if (netsnmp_table_data_row_next_byoid(td, instance, 2) !=
+        (j < TD_TEST_N ? rows[j] : NULL))
+        mismatch++;
+    probe[0] = i;
+    j = i * 10 + (i * 10 % 3 == 0);
+    if (netsnmp_table_data_row_next_byoid(td, probe, 1) !=
+        (i < TD_TEST_N / 10 ? rows[j] : NULL))
+        mismatch++;
+}
+OKF(mismatch == 0, ("lookups: %d mismatches", mismatch));
+
+/* the first row, removed and added again */
+row = rows[1];
+netsnmp_table_data_remove_row(td, row);
+instance[0] = 0;
+instance[1] = 1;
+OK(netsnmp_table_data_get_from_oid(td, instance, 2) == NULL &&
+   td->first_row == rows[2] && rows[2]->prev == NULL, "first row removed");
+OK(netsnmp_table_data_add_row(td, row) == SNMPERR_SUCCESS &&
+   td->first_row == row && row->next == rows[2], "first row added again");
+
+while (td->first_row)
+    netsnmp_table_data_remove_and_delete_row(td, td->first_row);
+OK(netsnmp_table_data_num_rows(td) == 0 && td->last_row == NULL,
+   "table emptied");
+netsnmp_table_data_delete_table(td);
+
+/* dataset columns */
+tds = netsnmp_create_table_data_set("table_dataset column unit-test");
+netsnmp_table_dataset_add_index(tds, ASN_INTEGER);
+row = netsnmp_create_table_data_row();
+ival = 1;
+netsnmp_table_row_add_index(row, ASN_INTEGER, &ival, sizeof(ival));
+netsnmp_table_dataset_add_row(tds, row);
+for (i = 2, ncols = 0, mismatch = 0; i < 300; i += 7, ++ncols) {
+    ival = i;
+    if (netsnmp_set_row_column(row, i, ASN_INTEGER, &ival, sizeof(ival)) !=
+        SNMPERR_SUCCESS)
+        mismatch++;
+}
+/* updates must change the existing columns, in a clone too */
+ival = -1;
+netsnmp_set_row_column(row, 9, ASN_INTEGER, &ival, sizeof(ival));
+clone = netsnmp_table_data_set_clone_row(row);
+for (i = 2; i < 300; i += 7) {
+    ival = -i;
+    netsnmp_set_row_column(clone, i, ASN_INTEGER, &ival, sizeof(ival));
+}
+for (j = 0; j < 2; ++j) {
+    for (data = (j ? clone : row)->data, i = 0; data; data = data->next, ++i)
+        ;
+    if (i != ncols)
+        mismatch++;
+    for (i = 1; i < 300; ++i) {
+        data = netsnmp_table_data_set_find_column(
+            (netsnmp_table_data_set_storage *) (j ? clone : row)->data, i);
+        if ((i % 7 == 2) != (data != NULL))
+            mismatch++;
+        if (!data)
+            continue;
+        memcpy(&ival, data->data.string, sizeof(ival));
+        if (ival != (j ? -i : i == 9 ? -1 : i))
+            mismatch++;
+    }
+}
+netsnmp_table_dataset_delete_row(clone);
+OKF(mismatch == 0, ("columns: %d mismatches", mismatch));
+
+netsnmp_delete_table_data_set(tds);
+
+snmp_shutdown("snmpd");
+shutdown_agent();
+
+OK(TRUE, "done");
@@ -0,0 +1,98 @@
+/* HEADER Testing the agent registry lookup index */
+
+/*
+ * Register instances in two contexts, in a scattered order, and check
+ * that every registered OID is found in its own context only, before
+ * and after unregistering some of them and after registering more in
+ * the other context.  Unregistered OIDs fall into the top level
+ * registrations that every context gets.
+ */
+#define REG_TEST_N 100
+static oid      name[] = { 1, 3, 6, 1, 3, 331, 0 };
+netsnmp_handler_registration *regs[2][REG_TEST_N];
+netsnmp_subtree *sub;
+const char     *contexts[2] = { "", "registry-unit-test" };
+char            label[32];
+int             c, i, j, mismatch;
+
+init_agent("snmpd");
+init_snmp("snmpd");
+netsnmp_set_lookup_cache_size(-1);
+
+for (c = 0, mismatch = 0; c < 2; ++c) {
+    for (i = 0; i < REG_TEST_N; ++i) {
+        j = (i * 37) % REG_TEST_N;
+        name[6] = j;
+        snprintf(label, sizeof(label), "registry.%d.%d", c, j);
+        regs[c][j] = netsnmp_create_handler_registration(label, NULL, name,
+                                                         OID_LENGTH(name),
+                                                         HANDLER_CAN_RONLY);
+        if (c)
+            regs[c][j]->contextName = strdup(contexts[c]);
+        if (netsnmp_register_instance(regs[c][j]) != MIB_REGISTERED_OK)
+            mismatch++;
+    }
+}
+OKF(mismatch == 0, ("registrations: %d failed", mismatch));
+
+/* unregister the odd instances of the default context */
+for (i = 1; i < REG_TEST_N; i += 2) {
+    netsnmp_unregister_handler(regs[0][i]);
+    regs[0][i] = NULL;
+}
+
+for (c = 0, mismatch = 0; c < 2; ++c) {
+    for (i = 0; i < REG_TEST_N; ++i) {
+        name[6] = i;
+        sub = netsnmp_subtree_find(name, OID_LENGTH(name), NULL, contexts[c]);
+        if (regs[c][i] ? !sub || sub->reginfo != regs[c][i] :
+            sub && sub->reginfo->rootoid_len == OID_LENGTH(name))
+            mismatch++;
+    }
+}
+OKF(mismatch == 0, ("lookups after unregistration: %d mismatches",
+                    mismatch));
+
+/* move the odd instances from the second context to the default one */
+for (i = 1, mismatch = 0; i < REG_TEST_N; i += 2) {
+    netsnmp_unregister_handler(regs[1][i]);
+    name[6] = i;
+    snprintf(label, sizeof(label), "registry.0.%d", i);
+    regs[1][i] = NULL;
+    regs[0][i] = netsnmp_create_handler_registration(label, NULL, name,
+                                                     OID_LENGTH(name),
+                                                     HANDLER_CAN_RONLY);
+    if (netsnmp_register_instance(regs[0][i]) != MIB_REGISTERED_OK)
+        mismatch++;
+}
+OKF(mismatch == 0, ("registrations moved: %d failed", mismatch));
+
+for (c = 0, mismatch = 0; c < 2; ++c) {
+    for (i = 0; i < REG_TEST_N; ++i) {
+        name[6] = i;
+        sub = netsnmp_subtree_find(name, OID_LENGTH(name), NULL, contexts[c]);
+        if (regs[c][i] ? !sub || sub->reginfo != regs[c][i] :
+            sub && sub->reginfo->rootoid_len == OID_LENGTH(name))
+            mismatch++;
+    }
+}
+OKF(mismatch == 0, ("lookups after moving: %d mismatches", mismatch));
+
+for (c = 0; c < 2; ++c)
+    for (i = 0; i < REG_TEST_N; ++i)
+        if (regs[c][i])
+            netsnmp_unregister_handler(regs[c][i]);
+for (c = 0, mismatch = 0; c < 2; ++c) {
+    for (i = 0; i < REG_TEST_N; ++i) {
+        name[6] = i;
+        sub = netsnmp_subtree_find(name, OID_LENGTH(name), NULL, contexts[c]);
+        if (sub && sub->reginfo->rootoid_len == OID_LENGTH(name))
+            mismatch++;
+    }
+}
+OKF(mismatch == 0, ("all unregistered: %d left", mismatch));
+
+snmp_shutdown("snmpd");
+shutdown_agent();
+
+OK(TRUE, "done");